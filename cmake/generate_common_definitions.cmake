@@ -0,0 +1,371 @@
+set(current_dir ${CMAKE_CURRENT_LIST_DIR})
+
+# The common definitions file is written with one XML element per line, and
+# only uses a small part of the ADM, so it is read line by line with regular
+# expressions. Anything unexpected is an error rather than being ignored, so
+# that changes to the file can't silently go missing from the generated tables.
+
+set(_cd_hex "[0-9a-fA-F]")
+set(_cd_hex4 "${_cd_hex}${_cd_hex}${_cd_hex}${_cd_hex}")
+set(_cd_hex2 "${_cd_hex}${_cd_hex}")
+set(_cd_hex8 "${_cd_hex4}${_cd_hex4}")
+
+function(_cd_error message line)
+  message(FATAL_ERROR "common definitions: ${message}: ${line}")
+endfunction()
+
+# get the value of the attribute called name from line
+function(_cd_attribute line name out)
+  if(NOT line MATCHES " ${name}=\"([^\"]*)\"")
+    _cd_error("missing attribute ${name}" "${line}")
+  endif()
+  set(${out} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+endfunction()
+
+# check that value can be written into a C++ string literal unchanged
+function(_cd_check_string value line)
+  if(value MATCHES "[\\\\&<>]")
+    _cd_error("unsupported characters in string" "${line}")
+  endif()
+endfunction()
+
+# turn a number like 30 or -30.5 into a float literal
+function(_cd_float value line out)
+  if(NOT value MATCHES "^-?[0-9]+(\\.[0-9]+)?$")
+    _cd_error("invalid number" "${line}")
+  endif()
+  if(NOT value MATCHES "\\.")
+    string(APPEND value ".0")
+  endif()
+  set(${out} "${value}f" PARENT_SCOPE)
+endfunction()
+
+function(_cd_int value line)
+  if(NOT value MATCHES "^-?[0-9]+$")
+    _cd_error("invalid integer" "${line}")
+  endif()
+endfunction()
+
+# join the elements of the list in list_var with separator; this is
+# list(JOIN), which needs CMake 3.12
+function(_cd_join list_var separator out)
+  string(REPLACE ";" "${separator}" joined "${${list_var}}")
+  set(${out} "${joined}" PARENT_SCOPE)
+endfunction()
+
+# replace each ID in the list ids_var with its index in the list all_ids
+function(_cd_resolve ids_var all_ids)
+  set(indices "")
+  foreach(id IN LISTS ${ids_var})
+    list(FIND ${all_ids} "${id}" index)
+    if(index EQUAL -1)
+      message(FATAL_ERROR "common definitions: unresolved reference to ${id}")
+    endif()
+    list(APPEND indices ${index})
+  endforeach()
+  _cd_join(indices ", " joined)
+  set(${ids_var} "${joined}" PARENT_SCOPE)
+endfunction()
+
+# append the resolved reference indices (given as a comma-separated string)
+# to the corresponding entries in the list entries_var, closing each entry
+function(_cd_close_entries entries_var refs)
+  string(REPLACE ", " ";" refs "${refs}")
+  set(closed "")
+  set(index 0)
+  foreach(entry IN LISTS ${entries_var})
+    list(GET refs ${index} ref)
+    list(APPEND closed "${entry}, ${ref}}")
+    math(EXPR index "${index} + 1")
+  endforeach()
+  set(${entries_var} "${closed}" PARENT_SCOPE)
+endfunction()
+
+function(generate_common_definitions)
+  set(options "")
+  set(oneValueArguments XML_FILE OUTPUT)
+  set(multiValueArguments "")
+  cmake_parse_arguments(GEN "${options}" "${oneValueArguments}"
+                        "${multiValueArguments}" ${ARGN})
+  foreach(arg ${oneValueArguments})
+    if(NOT GEN_${arg})
+      message(FATAL_ERROR
+        "Argument ${arg} not defined in call to generate_common_definitions")
+    endif()
+  endforeach()
+
+  set_property(
+    DIRECTORY
+    APPEND
+    PROPERTY CMAKE_CONFIGURE_DEPENDS ${GEN_XML_FILE})
+
+  file(STRINGS ${GEN_XML_FILE} lines)
+
+  set(pack_ids "")
+  set(pack_entries "")
+  set(pack_channel_refs "")
+  set(pack_pack_refs "")
+  set(channel_ids "")
+  set(channel_entries "")
+  set(direct_speakers_blocks "")
+  set(hoa_blocks "")
+  set(binaural_blocks "")
+  set(stream_ids "")
+  set(stream_entries "")
+  set(stream_channel_refs "")
+  set(stream_track_refs "")
+  set(track_ids "")
+  set(track_entries "")
+  set(track_stream_refs "")
+  set(direct_speakers_count 0)
+  set(hoa_count 0)
+  set(binaural_count 0)
+
+  set(element "")
+  foreach(line IN LISTS lines)
+    string(STRIP "${line}" line)
+
+    if(line MATCHES "^<audioPackFormat ")
+      _cd_attribute("${line}" audioPackFormatID id)
+      _cd_attribute("${line}" audioPackFormatName name)
+      _cd_check_string("${name}" "${line}")
+      if(NOT id MATCHES "^AP_(${_cd_hex4})(${_cd_hex4})$")
+        _cd_error("invalid audioPackFormatID" "${line}")
+      endif()
+      list(APPEND pack_ids ${id})
+      set(entry "{0x${CMAKE_MATCH_1}, 0x${CMAKE_MATCH_2}, \"${name}\"")
+      list(LENGTH pack_channel_refs channel_refs_begin)
+      list(LENGTH pack_pack_refs pack_refs_begin)
+      set(element pack)
+    elseif(line STREQUAL "</audioPackFormat>")
+      list(LENGTH pack_channel_refs channel_refs_end)
+      list(LENGTH pack_pack_refs pack_refs_end)
+      string(APPEND entry ", {${channel_refs_begin}, ${channel_refs_end}}")
+      string(APPEND entry ", {${pack_refs_begin}, ${pack_refs_end}}}")
+      list(APPEND pack_entries "${entry}")
+      set(element "")
+    elseif(line MATCHES "^<audioChannelFormatIDRef>([^<]*)</audioChannelFormatIDRef>$")
+      if(element STREQUAL "pack")
+        list(APPEND pack_channel_refs ${CMAKE_MATCH_1})
+      elseif(element STREQUAL "stream")
+        list(APPEND stream_channel_refs ${CMAKE_MATCH_1})
+        math(EXPR stream_channel_ref_count "${stream_channel_ref_count} + 1")
+      else()
+        _cd_error("unexpected reference" "${line}")
+      endif()
+    elseif(line MATCHES "^<audioPackFormatIDRef>([^<]*)</audioPackFormatIDRef>$")
+      if(NOT element STREQUAL "pack")
+        _cd_error("unexpected reference" "${line}")
+      endif()
+      list(APPEND pack_pack_refs ${CMAKE_MATCH_1})
+
+    elseif(line MATCHES "^<audioChannelFormat ")
+      _cd_attribute("${line}" audioChannelFormatID id)
+      _cd_attribute("${line}" audioChannelFormatName name)
+      _cd_attribute("${line}" typeDefinition channel_type)
+      _cd_check_string("${name}" "${line}")
+      if(NOT id MATCHES "^AC_(${_cd_hex4})(${_cd_hex4})$")
+        _cd_error("invalid audioChannelFormatID" "${line}")
+      endif()
+      list(APPEND channel_ids ${id})
+      set(entry "{0x${CMAKE_MATCH_1}, 0x${CMAKE_MATCH_2}, \"${name}\"")
+      if(channel_type STREQUAL "DirectSpeakers")
+        set(blocks_begin ${direct_speakers_count})
+      elseif(channel_type STREQUAL "HOA")
+        set(blocks_begin ${hoa_count})
+      elseif(channel_type STREQUAL "Binaural")
+        set(blocks_begin ${binaural_count})
+      else()
+        _cd_error("unsupported channel type" "${line}")
+      endif()
+      set(low_pass "false, 0.0f")
+      set(element channel)
+    elseif(line MATCHES "^<frequency typeDefinition=\"lowPass\">([^<]*)</frequency>$")
+      if(NOT element STREQUAL "channel")
+        _cd_error("unexpected frequency" "${line}")
+      endif()
+      _cd_float("${CMAKE_MATCH_1}" "${line}" value)
+      set(low_pass "true, ${value}")
+    elseif(line STREQUAL "</audioChannelFormat>")
+      if(channel_type STREQUAL "DirectSpeakers")
+        set(blocks_end ${direct_speakers_count})
+      elseif(channel_type STREQUAL "HOA")
+        set(blocks_end ${hoa_count})
+      else()
+        set(blocks_end ${binaural_count})
+      endif()
+      string(APPEND entry ", ${low_pass}, {${blocks_begin}, ${blocks_end}}}")
+      list(APPEND channel_entries "${entry}")
+      set(element "")
+
+    elseif(line MATCHES "^<audioBlockFormat ")
+      if(NOT element STREQUAL "channel")
+        _cd_error("unexpected audioBlockFormat" "${line}")
+      endif()
+      _cd_attribute("${line}" audioBlockFormatID block_id)
+      if(NOT block_id MATCHES "^AB_${_cd_hex8}_(${_cd_hex8})$")
+        _cd_error("invalid audioBlockFormatID" "${line}")
+      endif()
+      set(block_counter "0x${CMAKE_MATCH_1}")
+      set(speaker_label "")
+      set(position_azimuth "")
+      set(position_elevation "")
+      set(position_distance "")
+      set(screen_edge_lock "nullptr")
+      set(block_order "")
+      set(block_degree "")
+      set(normalization "")
+      if(line MATCHES "/>$")
+        if(NOT channel_type STREQUAL "Binaural")
+          _cd_error("empty audioBlockFormat" "${line}")
+        endif()
+        list(APPEND binaural_blocks "{${block_counter}}")
+        math(EXPR binaural_count "${binaural_count} + 1")
+      else()
+        set(element block)
+      endif()
+    elseif(line MATCHES "^<speakerLabel>([^<]*)</speakerLabel>$")
+      _cd_check_string("${CMAKE_MATCH_1}" "${line}")
+      if(NOT element STREQUAL "block" OR NOT speaker_label STREQUAL "")
+        _cd_error("unexpected speakerLabel" "${line}")
+      endif()
+      set(speaker_label "\"${CMAKE_MATCH_1}\"")
+    elseif(line MATCHES "^<position coordinate=\"(azimuth|elevation|distance)\"( screenEdgeLock=\"(left|right)\")?>([^<]*)</position>$")
+      if(NOT element STREQUAL "block")
+        _cd_error("unexpected position" "${line}")
+      endif()
+      set(coordinate ${CMAKE_MATCH_1})
+      if(CMAKE_MATCH_3)
+        if(NOT coordinate STREQUAL "azimuth")
+          _cd_error("unsupported screenEdgeLock" "${line}")
+        endif()
+        set(screen_edge_lock "\"${CMAKE_MATCH_3}\"")
+      endif()
+      _cd_float("${CMAKE_MATCH_4}" "${line}" position_${coordinate})
+    elseif(line MATCHES "^<(order|degree)>([^<]*)</(order|degree)>$")
+      if(NOT element STREQUAL "block")
+        _cd_error("unexpected ${CMAKE_MATCH_1}" "${line}")
+      endif()
+      _cd_int("${CMAKE_MATCH_2}" "${line}")
+      set(block_${CMAKE_MATCH_1} ${CMAKE_MATCH_2})
+    elseif(line MATCHES "^<normalization>(SN3D|N3D|FuMa)</normalization>$")
+      if(NOT element STREQUAL "block")
+        _cd_error("unexpected normalization" "${line}")
+      endif()
+      set(normalization "\"${CMAKE_MATCH_1}\"")
+    elseif(line STREQUAL "</audioBlockFormat>")
+      if(channel_type STREQUAL "DirectSpeakers")
+        if(speaker_label STREQUAL "" OR position_azimuth STREQUAL ""
+           OR position_elevation STREQUAL "" OR position_distance STREQUAL "")
+          _cd_error("incomplete DirectSpeakers block" "${block_id}")
+        endif()
+        list(APPEND direct_speakers_blocks
+          "{${block_counter}, ${speaker_label}, ${position_azimuth}, ${position_elevation}, ${position_distance}, ${screen_edge_lock}}")
+        math(EXPR direct_speakers_count "${direct_speakers_count} + 1")
+      elseif(channel_type STREQUAL "HOA")
+        if(block_order STREQUAL "" OR block_degree STREQUAL ""
+           OR normalization STREQUAL "")
+          _cd_error("incomplete HOA block" "${block_id}")
+        endif()
+        list(APPEND hoa_blocks
+          "{${block_counter}, ${block_order}, ${block_degree}, ${normalization}}")
+        math(EXPR hoa_count "${hoa_count} + 1")
+      else()
+        _cd_error("unexpected Binaural block content" "${block_id}")
+      endif()
+      set(element channel)
+
+    elseif(line MATCHES "^<audioStreamFormat ")
+      _cd_attribute("${line}" audioStreamFormatID id)
+      _cd_attribute("${line}" audioStreamFormatName name)
+      _cd_attribute("${line}" formatLabel format)
+      _cd_check_string("${name}" "${line}")
+      if(NOT id MATCHES "^AS_(${_cd_hex4})(${_cd_hex4})$")
+        _cd_error("invalid audioStreamFormatID" "${line}")
+      endif()
+      set(entry "{0x${CMAKE_MATCH_1}, 0x${CMAKE_MATCH_2}, \"${name}\"")
+      if(NOT format MATCHES "^${_cd_hex4}$")
+        _cd_error("invalid formatLabel" "${line}")
+      endif()
+      string(APPEND entry ", 0x${format}")
+      list(APPEND stream_ids ${id})
+      list(LENGTH stream_track_refs track_refs_begin)
+      set(stream_channel_ref_count 0)
+      set(element stream)
+    elseif(line MATCHES "^<audioTrackFormatIDRef>([^<]*)</audioTrackFormatIDRef>$")
+      if(NOT element STREQUAL "stream")
+        _cd_error("unexpected reference" "${line}")
+      endif()
+      list(APPEND stream_track_refs ${CMAKE_MATCH_1})
+    elseif(line STREQUAL "</audioStreamFormat>")
+      if(NOT stream_channel_ref_count EQUAL 1)
+        _cd_error("expected one audioChannelFormatIDRef" "${entry}")
+      endif()
+      list(LENGTH stream_track_refs track_refs_end)
+      string(APPEND entry ", {${track_refs_begin}, ${track_refs_end}}")
+      list(APPEND stream_entries "${entry}")
+      set(element "")
+
+    elseif(line MATCHES "^<audioTrackFormat ")
+      _cd_attribute("${line}" audioTrackFormatID id)
+      _cd_attribute("${line}" audioTrackFormatName name)
+      _cd_attribute("${line}" formatLabel format)
+      _cd_check_string("${name}" "${line}")
+      if(NOT id MATCHES "^AT_(${_cd_hex4})(${_cd_hex4})_(${_cd_hex2})$")
+        _cd_error("invalid audioTrackFormatID" "${line}")
+      endif()
+      set(entry "{0x${CMAKE_MATCH_1}, 0x${CMAKE_MATCH_2}, 0x${CMAKE_MATCH_3}")
+      string(APPEND entry ", \"${name}\"")
+      if(NOT format MATCHES "^${_cd_hex4}$")
+        _cd_error("invalid formatLabel" "${line}")
+      endif()
+      string(APPEND entry ", 0x${format}")
+      list(APPEND track_ids ${id})
+      list(LENGTH track_stream_refs track_stream_refs_begin)
+      set(element track)
+    elseif(line MATCHES "^<audioStreamFormatIDRef>([^<]*)</audioStreamFormatIDRef>$")
+      if(NOT element STREQUAL "track")
+        _cd_error("unexpected reference" "${line}")
+      endif()
+      list(APPEND track_stream_refs ${CMAKE_MATCH_1})
+    elseif(line STREQUAL "</audioTrackFormat>")
+      list(LENGTH track_stream_refs track_stream_refs_end)
+      math(EXPR track_stream_ref_count
+           "${track_stream_refs_end} - ${track_stream_refs_begin}")
+      if(NOT track_stream_ref_count EQUAL 1)
+        _cd_error("expected one audioStreamFormatIDRef" "${entry}")
+      endif()
+      list(APPEND track_entries "${entry}")
+      set(element "")
+
+    elseif(NOT line MATCHES "^(<\\?xml .*\\?>|</?ituADM( .*)?>|</?coreMetadata>|</?format>|</?audioFormatExtended( .*)?>|)$")
+      _cd_error("unsupported line" "${line}")
+    endif()
+  endforeach()
+
+  # stream and track formats reference exactly one other element, which is
+  # written as the last field of their entries rather than using a range
+  _cd_resolve(stream_channel_refs channel_ids)
+  _cd_resolve(track_stream_refs stream_ids)
+  _cd_close_entries(stream_entries "${stream_channel_refs}")
+  _cd_close_entries(track_entries "${track_stream_refs}")
+
+  _cd_resolve(pack_channel_refs channel_ids)
+  _cd_resolve(pack_pack_refs pack_ids)
+  _cd_resolve(stream_track_refs track_ids)
+
+  set(separator ",\n        ")
+  _cd_join(pack_entries "${separator}" CD_PACK_FORMATS)
+  _cd_join(channel_entries "${separator}" CD_CHANNEL_FORMATS)
+  _cd_join(stream_entries "${separator}" CD_STREAM_FORMATS)
+  _cd_join(track_entries "${separator}" CD_TRACK_FORMATS)
+  _cd_join(direct_speakers_blocks "${separator}" CD_DIRECT_SPEAKERS_BLOCKS)
+  _cd_join(hoa_blocks "${separator}" CD_HOA_BLOCKS)
+  _cd_join(binaural_blocks "${separator}" CD_BINAURAL_BLOCKS)
+  set(CD_PACK_FORMAT_CHANNEL_FORMAT_REFS "${pack_channel_refs}")
+  set(CD_PACK_FORMAT_PACK_FORMAT_REFS "${pack_pack_refs}")
+  set(CD_STREAM_FORMAT_TRACK_FORMAT_REFS "${stream_track_refs}")
+
+  configure_file("${current_dir}/common_definitions_data.cpp.in"
+                 "${GEN_OUTPUT}" @ONLY)
+endfunction()
@@ -7,10 +7,17 @@
 
 namespace adm {
 
-  /// @brief Load embedded common definitions file and create Document
+  /**
+   * @brief Create a Document containing the common definitions
+   *
+   * The common definitions are built from tables compiled into the library
+   * (generated from resources/common_definitions.xml), without parsing any
+   * XML. This is done once, on the first call; each call returns a new deep
+   * copy of the result, which may be modified freely.
+   */
   ADM_EXPORT std::shared_ptr<Document> getCommonDefinitions();
 
-  /// @brief Add embedded common definitions file to a Document
+  /// @brief Add a copy of the common definitions to a Document
   ADM_EXPORT void addCommonDefinitionsTo(std::shared_ptr<Document> document);
 
   /**
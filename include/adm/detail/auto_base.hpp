@@ -5,6 +5,7 @@
 #include "boost/optional.hpp"
 #include "boost/variant.hpp"
 #include <algorithm>
+#include <cstdint>
 
 // want to be able to override this from the tests
 #ifndef ADM_BASE_EXPORT
@@ -222,6 +223,94 @@ namespace adm {
       boost::optional<T> value_;
     };
 
+    /// storage for the flags saying which of the parameters in a
+    /// PackedDefaultParameters have been set
+    class PackedParameterFlags : public Flags {
+     public:
+      static constexpr bool has_get_set_has = true;
+      static constexpr bool has_isDefault_unset = true;
+      static constexpr unsigned next_bit = 0;
+
+     protected:
+      bool isSet(unsigned bit) const { return (flags_ >> bit) & 1u; }
+      void setFlag(unsigned bit) { flags_ |= 1u << bit; }
+      void clearFlag(unsigned bit) { flags_ &= ~(1u << bit); }
+
+     private:
+      uint32_t flags_ = 0;
+    };
+
+    /// one parameter in a PackedDefaultParameters; Base is the next
+    /// parameter, or PackedParameterFlags
+    template <typename T, typename Base,
+              typename Tag = typename detail::ParameterTraits<T>::tag>
+    class PackedDefaultParameter : public Base {
+      static constexpr unsigned bit = Base::next_bit;
+      static_assert(bit < 32, "too many parameters in PackedDefaultParameters");
+
+     public:
+      static constexpr unsigned next_bit = bit + 1;
+
+      T get(Tag) const { return value_; }
+      void set(T value) {
+        value_ = std::move(value);
+        this->setFlag(bit);
+      }
+      bool has(Tag) const { return true; }
+      bool isDefault(Tag) const { return !this->isSet(bit); }
+      void unset(Tag) {
+        value_ = getDefault<T>();
+        this->clearFlag(bit);
+      }
+
+     private:
+      T value_ = getDefault<T>();
+    };
+
+    template <typename T, typename Base>
+    class PackedDefaultParameterWithBase
+        : public PackedDefaultParameter<T, Base> {
+     public:
+      using Base::get;
+      using Base::set;
+      using Base::has;
+      using Base::isDefault;
+      using Base::unset;
+      using PackedDefaultParameter<T, Base>::get;
+      using PackedDefaultParameter<T, Base>::set;
+      using PackedDefaultParameter<T, Base>::has;
+      using PackedDefaultParameter<T, Base>::isDefault;
+      using PackedDefaultParameter<T, Base>::unset;
+    };
+
+    template <typename... Ts>
+    struct PackedDefaultParametersHelper;
+
+    template <typename T>
+    struct PackedDefaultParametersHelper<T> {
+      using type = PackedDefaultParameter<T, PackedParameterFlags>;
+    };
+
+    template <typename T, typename... Ts>
+    struct PackedDefaultParametersHelper<T, Ts...> {
+      using type = PackedDefaultParameterWithBase<
+          T, typename PackedDefaultParametersHelper<Ts...>::type>;
+    };
+
+    /// base class with set/get/has/isDefault/unset methods for several
+    /// parameters, which behave like DefaultParameter. combine these together
+    /// using HasParameters
+    ///
+    /// Rather than each parameter having its own boost::optional, the values
+    /// are stored next to each other (set to the default if they have not
+    /// been set), and which have been set is stored in a single bitmask, so
+    /// small parameters like floats and bools aren't padded out by their
+    /// flags. There can be up to 32 parameters; the values are laid out in
+    /// reverse order, so list the largest first to minimise padding.
+    template <typename... Ts>
+    using PackedDefaultParameters =
+        typename PackedDefaultParametersHelper<Ts...>::type;
+
     template <typename T>
     struct ParameterCompare {
       static bool compare(T const& lhs, T const& rhs) { return lhs == rhs; }
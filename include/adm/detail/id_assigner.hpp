@@ -1,7 +1,9 @@
 #pragma once
 
 #include "adm/elements_fwd.hpp"
-#include <memory>
+#include <cstddef>
+#include <map>
+#include <utility>
 #include "adm/export.h"
 
 namespace adm {
@@ -9,15 +11,38 @@ namespace adm {
   class Document;
 
   namespace detail {
+    /**
+     * @brief Set of the ID counters in use within a group of IDs.
+     *
+     * Counters are stored as runs of consecutive values, so that the next
+     * free counter can be found in logarithmic time, however the counters in
+     * use are distributed. Counters may be used more than once.
+     */
+    class CounterSet {
+     public:
+      ADM_EXPORT void insert(unsigned int counter);
+      ADM_EXPORT void erase(unsigned int counter);
+      /// the lowest counter which is not in use, and is >= preferred
+      ADM_EXPORT unsigned int nextFree(unsigned int preferred) const;
+      bool empty() const { return runs_.empty(); }
+
+     private:
+      /// start of each run -> one past the end of that run
+      std::map<unsigned int, unsigned int> runs_;
+      /// number of extra uses of counters which are used more than once
+      std::map<unsigned int, std::size_t> duplicates_;
+    };
+
     /**
      * @brief Assigns a unique ID to elements.
      *
-     * Uses lookups to find the next available element ID. 
-     * 
+     * Keeps track of the IDs in use in the Document (which must tell it about
+     * every ID added or removed), so that the next available element ID can
+     * be found without searching the document.
+     *
      * @note This class differs from IdReassigner in that it can
      * operate on a Document which already has elements with ID's
-     * which you wish to maintain. However, the trade-off is that
-     * it is less efficient.
+     * which you wish to maintain.
      */
     class IdAssigner {
      public:
@@ -31,13 +56,44 @@ namespace adm {
       ADM_EXPORT AudioTrackFormatId assignId(AudioTrackFormat& trackFormat);
       ADM_EXPORT AudioTrackUidId assignId(AudioTrackUid& trackUid);
 
-     protected:
-      const Document& document() const;
-
      private:
       friend class adm::Document;
-      ADM_EXPORT void document(Document* document_);
-      Document* document_;
+
+      ///@{
+      /// record that an element with this ID has been added to the document
+      ADM_EXPORT void addId(const AudioProgrammeId& id);
+      ADM_EXPORT void addId(const AudioContentId& id);
+      ADM_EXPORT void addId(const AudioObjectId& id);
+      ADM_EXPORT void addId(const AudioPackFormatId& id);
+      ADM_EXPORT void addId(const AudioChannelFormatId& id);
+      ADM_EXPORT void addId(const AudioStreamFormatId& id);
+      ADM_EXPORT void addId(const AudioTrackFormatId& id);
+      ADM_EXPORT void addId(const AudioTrackUidId& id);
+      ///@}
+
+      ///@{
+      /// record that an element with this ID has been removed from the
+      /// document
+      ADM_EXPORT void removeId(const AudioProgrammeId& id);
+      ADM_EXPORT void removeId(const AudioContentId& id);
+      ADM_EXPORT void removeId(const AudioObjectId& id);
+      ADM_EXPORT void removeId(const AudioPackFormatId& id);
+      ADM_EXPORT void removeId(const AudioChannelFormatId& id);
+      ADM_EXPORT void removeId(const AudioStreamFormatId& id);
+      ADM_EXPORT void removeId(const AudioTrackFormatId& id);
+      ADM_EXPORT void removeId(const AudioTrackUidId& id);
+      ///@}
+
+      CounterSet programmeValues_;
+      CounterSet contentValues_;
+      CounterSet objectValues_;
+      /// values for each TypeDescriptor
+      std::map<int, CounterSet> packFormatValues_;
+      std::map<int, CounterSet> channelFormatValues_;
+      std::map<int, CounterSet> streamFormatValues_;
+      /// counters for each TypeDescriptor and AudioTrackFormatIdValue
+      std::map<std::pair<int, unsigned int>, CounterSet> trackFormatCounters_;
+      CounterSet trackUidValues_;
     };
 
   }  // namespace detail
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <boost/functional/hash.hpp>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include "adm/elements/audio_programme_id.hpp"
+#include "adm/elements/audio_content_id.hpp"
+#include "adm/elements/audio_object_id.hpp"
+#include "adm/elements/audio_pack_format_id.hpp"
+#include "adm/elements/audio_channel_format_id.hpp"
+#include "adm/elements/audio_stream_format_id.hpp"
+#include "adm/elements/audio_track_format_id.hpp"
+#include "adm/elements/audio_track_uid_id.hpp"
+
+namespace adm {
+  namespace detail {
+
+    /// hash function for top-level element IDs, consistent with their
+    /// operator==
+    struct IdHash {
+      std::size_t operator()(const AudioProgrammeId& id) const {
+        return hashParts(id.get<AudioProgrammeIdValue>().get());
+      }
+      std::size_t operator()(const AudioContentId& id) const {
+        return hashParts(id.get<AudioContentIdValue>().get());
+      }
+      std::size_t operator()(const AudioObjectId& id) const {
+        return hashParts(id.get<AudioObjectIdValue>().get());
+      }
+      std::size_t operator()(const AudioPackFormatId& id) const {
+        return hashParts(id.get<TypeDescriptor>().get(),
+                         id.get<AudioPackFormatIdValue>().get());
+      }
+      std::size_t operator()(const AudioChannelFormatId& id) const {
+        return hashParts(id.get<TypeDescriptor>().get(),
+                         id.get<AudioChannelFormatIdValue>().get());
+      }
+      std::size_t operator()(const AudioStreamFormatId& id) const {
+        return hashParts(id.get<TypeDescriptor>().get(),
+                         id.get<AudioStreamFormatIdValue>().get());
+      }
+      std::size_t operator()(const AudioTrackFormatId& id) const {
+        return hashParts(id.get<TypeDescriptor>().get(),
+                         id.get<AudioTrackFormatIdValue>().get(),
+                         id.get<AudioTrackFormatIdCounter>().get());
+      }
+      std::size_t operator()(const AudioTrackUidId& id) const {
+        return hashParts(id.get<AudioTrackUidIdValue>().get());
+      }
+
+     private:
+      template <typename... Parts>
+      static std::size_t hashParts(Parts... parts) {
+        std::size_t seed = 0;
+        using expand = int[];
+        (void)expand{0, (boost::hash_combine(seed, parts), 0)...};
+        return seed;
+      }
+    };
+
+    /// index of the elements of one type in a Document by ID
+    ///
+    /// Documents are allowed to contain more than one element with the same
+    /// ID (for example, common definitions elements, which don't go through
+    /// ID assignment). In this case the index holds the first one that was
+    /// added, and the others are counted as shadowed; when the indexed element
+    /// is removed, the first remaining element with the same ID (in document
+    /// order) takes its place, so that lookups give the same result as a
+    /// linear search of the document.
+    template <typename Element>
+    class IdIndex {
+     public:
+      using Id = typename Element::id_type;
+
+      /// add an element which is not already in the index
+      void add(const std::shared_ptr<Element>& element) {
+        add(element, element->template get<Id>());
+      }
+
+      /// remove an element, which has ID id
+      ///
+      /// elements should be the elements of this type in the document, and is
+      /// only searched if another element has the same ID
+      template <typename Elements>
+      void remove(const Element* element, const Id& id,
+                  const Elements& elements) {
+        auto it = index_.find(id);
+        if (it == index_.end()) return;
+        if (it->second.get() != element) {
+          --shadowed_;
+          return;
+        }
+        index_.erase(it);
+        if (shadowed_) {
+          for (auto& other : elements) {
+            if (other.get() != element && other->template get<Id>() == id) {
+              index_.emplace(id, other);
+              --shadowed_;
+              break;
+            }
+          }
+        }
+      }
+
+      /// update the index after the ID of element has changed from oldId
+      template <typename Elements>
+      void changeId(const std::shared_ptr<Element>& element, const Id& oldId,
+                    const Elements& elements) {
+        remove(element.get(), oldId, elements);
+        add(element);
+      }
+
+      std::shared_ptr<Element> lookup(const Id& id) const {
+        auto it = index_.find(id);
+        if (it == index_.end()) return nullptr;
+        return it->second;
+      }
+
+      void reserve(std::size_t size) { index_.reserve(size); }
+
+      /// reserve space for n more elements, keeping amortised growth when
+      /// this is called for each element
+      void reserveMore(std::size_t n) {
+        auto size = index_.size() + n;
+        if (size > index_.bucket_count() * index_.max_load_factor()) {
+          index_.reserve(std::max(size, 2 * index_.size()));
+        }
+      }
+
+     private:
+      void add(const std::shared_ptr<Element>& element, const Id& id) {
+        if (!index_.emplace(id, element).second) ++shadowed_;
+      }
+
+      std::unordered_map<Id, std::shared_ptr<Element>, IdHash> index_;
+      /// number of elements not in index_ because an earlier element has the
+      /// same ID
+      std::size_t shadowed_ = 0;
+    };
+
+  }  // namespace detail
+}  // namespace adm
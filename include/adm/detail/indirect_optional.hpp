@@ -0,0 +1,90 @@
+#pragma once
+#include <memory>
+#include <utility>
+#include <boost/none.hpp>
+#include <boost/optional/bad_optional_access.hpp>
+
+namespace adm {
+  namespace detail {
+
+    /// An optional value which is stored in a separate allocation.
+    ///
+    /// This has the parts of the boost::optional interface used by libadm
+    /// elements, and the same value semantics (copies are deep), but only
+    /// takes up the space of a pointer when empty. Use it for large
+    /// parameters which are rarely set, so that elements which don't use them
+    /// (e.g. most audioBlockFormats) stay small.
+    template <typename T>
+    class IndirectOptional {
+     public:
+      IndirectOptional() = default;
+      // NOLINTNEXTLINE(google-explicit-constructor)
+      IndirectOptional(boost::none_t) {}
+      // NOLINTNEXTLINE(google-explicit-constructor)
+      IndirectOptional(T value) : value_(new T(std::move(value))) {}
+
+      IndirectOptional(const IndirectOptional& other)
+          : value_(other.value_ ? new T(*other.value_) : nullptr) {}
+      IndirectOptional(IndirectOptional&& other) noexcept = default;
+
+      IndirectOptional& operator=(const IndirectOptional& other) {
+        if (!other.value_)
+          value_.reset();
+        else if (value_)
+          *value_ = *other.value_;
+        else
+          value_.reset(new T(*other.value_));
+        return *this;
+      }
+      IndirectOptional& operator=(IndirectOptional&& other) noexcept =
+          default;
+
+      IndirectOptional& operator=(T value) {
+        if (value_)
+          *value_ = std::move(value);
+        else
+          value_.reset(new T(std::move(value)));
+        return *this;
+      }
+      IndirectOptional& operator=(boost::none_t) {
+        value_.reset();
+        return *this;
+      }
+
+      /// the value; throws boost::bad_optional_access if there isn't one
+      const T& get() const {
+        if (!value_) throw boost::bad_optional_access();
+        return *value_;
+      }
+      T& get() {
+        if (!value_) throw boost::bad_optional_access();
+        return *value_;
+      }
+
+      const T& operator*() const { return get(); }
+      T& operator*() { return get(); }
+      const T* operator->() const { return &get(); }
+      T* operator->() { return &get(); }
+
+      explicit operator bool() const { return value_ != nullptr; }
+      bool operator!() const { return value_ == nullptr; }
+
+      friend bool operator==(const IndirectOptional& value, boost::none_t) {
+        return !value;
+      }
+      friend bool operator==(boost::none_t, const IndirectOptional& value) {
+        return !value;
+      }
+      friend bool operator!=(const IndirectOptional& value, boost::none_t) {
+        return static_cast<bool>(value);
+      }
+      friend bool operator!=(boost::none_t, const IndirectOptional& value) {
+        return static_cast<bool>(value);
+      }
+
+     private:
+      std::unique_ptr<T> value_;
+    };
+
+  }  // namespace detail
+}  // namespace adm
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <boost/variant.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "adm/elements_fwd.hpp"
+
+namespace adm {
+  namespace detail {
+
+    /// the elements in a Document which may refer to each element
+    ///
+    /// This is used to find the references to an element which is being
+    /// removed from a document without searching every element. Each
+    /// (referrer, target) pair is recorded once when a reference is made,
+    /// and forgotten when the reference is removed, or by take() when the
+    /// target is removed. Entries for referrers which no longer exist are
+    /// dropped when the referrers of a target have doubled, so the index
+    /// stays proportional to the current references rather than their
+    /// history.
+    ///
+    /// An element may still be listed as a referrer of another which it no
+    /// longer refers to (e.g. after a removed element is added to a
+    /// different document), so users must check for this.
+    class ReferrerIndex {
+     public:
+      using Referrer = boost::variant<
+          std::weak_ptr<AudioProgramme>, std::weak_ptr<AudioContent>,
+          std::weak_ptr<AudioObject>, std::weak_ptr<AudioPackFormat>,
+          std::weak_ptr<AudioStreamFormat>, std::weak_ptr<AudioTrackFormat>,
+          std::weak_ptr<AudioTrackUid>>;
+
+      /// record that referrer may refer to target
+      template <typename Element, typename Target>
+      void add(const std::shared_ptr<Element>& referrer,
+               const Target* target) {
+        auto& entry = referrers_[target];
+        // assign rather than emplace, in case this replaces an expired
+        // referrer at the same address
+        entry.referrers[referrer.get()] = std::weak_ptr<Element>(referrer);
+        if (entry.referrers.size() >= entry.compactAt) compact(entry);
+      }
+
+      /// forget that referrer refers to target
+      void remove(const void* referrer, const void* target) {
+        auto it = referrers_.find(target);
+        if (it == referrers_.end()) return;
+        it->second.referrers.erase(referrer);
+        if (it->second.referrers.empty()) referrers_.erase(it);
+      }
+
+      /// forget and return the referrers of target
+      std::vector<Referrer> take(const void* target) {
+        std::vector<Referrer> referrers;
+        auto it = referrers_.find(target);
+        if (it != referrers_.end()) {
+          referrers.reserve(it->second.referrers.size());
+          for (auto& referrer : it->second.referrers)
+            referrers.push_back(std::move(referrer.second));
+          referrers_.erase(it);
+        }
+        return referrers;
+      }
+
+      /// the total number of (referrer, target) pairs recorded
+      std::size_t size() const {
+        std::size_t total = 0;
+        for (auto& entry : referrers_) total += entry.second.referrers.size();
+        return total;
+      }
+
+     private:
+      struct Entry {
+        std::unordered_map<const void*, Referrer> referrers;
+        /// compact when referrers reaches this size
+        std::size_t compactAt = 8;
+      };
+
+      struct ExpiredVisitor : public boost::static_visitor<bool> {
+        template <typename Element>
+        bool operator()(const std::weak_ptr<Element>& referrer) const {
+          return referrer.expired();
+        }
+      };
+
+      /// remove referrers which no longer exist from entry
+      static void compact(Entry& entry) {
+        for (auto it = entry.referrers.begin(); it != entry.referrers.end();) {
+          if (boost::apply_visitor(ExpiredVisitor{}, it->second))
+            it = entry.referrers.erase(it);
+          else
+            ++it;
+        }
+        entry.compactAt = std::max<std::size_t>(8, 2 * entry.referrers.size());
+      }
+
+      std::unordered_map<const void*, Entry> referrers_;
+    };
+
+  }  // namespace detail
+}  // namespace adm
@@ -1,13 +1,18 @@
 /// @file document.hpp
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "adm/elements.hpp"
 #include "adm/detail/auto_base.hpp"
 #include "adm/detail/id_assigner.hpp"
+#include "adm/detail/id_index.hpp"
 #include "adm/detail/named_type.hpp"
+#include "adm/detail/referrer_index.hpp"
 #include "adm/export.h"
 
 namespace adm {
@@ -82,6 +87,19 @@ namespace adm {
     ADM_EXPORT bool add(std::shared_ptr<AudioTrackUid> trackUid);
     ///@}
 
+    /**
+     * @brief Add several elements of the same type
+     *
+     * This has the same effect as calling add() for each element (including
+     * the IDs which are assigned), but all of the elements, and the elements
+     * they refer to, are checked before any are added, so if this throws
+     * then the document is not changed.
+     *
+     * @param elements range of `shared_ptr`s to elements
+     */
+    template <typename Range>
+    void addAll(const Range &elements);
+
     /** @name Remove ADM elements
      *
      * References from and to the ADM element will automatically be removed
@@ -106,6 +124,19 @@ namespace adm {
     ADM_EXPORT bool remove(std::shared_ptr<AudioTrackUid> trackUid);
     ///@}
 
+    /**
+     * @brief Remove several elements of the same type
+     *
+     * This has the same effect as calling remove() for each element, but
+     * the elements of that type in the document are only traversed once.
+     *
+     * @param elements range of `shared_ptr`s to elements; this may be a
+     * range of elements from this document, like `getElements<AudioObject>()`
+     * @returns the number of elements which were removed
+     */
+    template <typename Range>
+    std::size_t removeAll(const Range &elements);
+
     /**
      * @brief ADM elements getter template
      *
@@ -130,6 +161,7 @@ namespace adm {
      *
      * Lookup the first ADM element with the given Id.
      *
+     * Elements are indexed by Id, so this takes constant time on average.
      */
     ///@{
     /**
@@ -285,12 +317,188 @@ namespace adm {
     template <typename Element>
     bool checkParent(const std::shared_ptr<Element> &element, const char *type);
 
+    ///@{
+    /// set the parent of an element, via its attorney
+    static void setParent(const std::shared_ptr<AudioProgramme> &programme,
+                          std::weak_ptr<Document> document);
+    static void setParent(const std::shared_ptr<AudioContent> &content,
+                          std::weak_ptr<Document> document);
+    static void setParent(const std::shared_ptr<AudioObject> &object,
+                          std::weak_ptr<Document> document);
+    static void setParent(const std::shared_ptr<AudioPackFormat> &packFormat,
+                          std::weak_ptr<Document> document);
+    static void setParent(
+        const std::shared_ptr<AudioChannelFormat> &channelFormat,
+        std::weak_ptr<Document> document);
+    static void setParent(
+        const std::shared_ptr<AudioStreamFormat> &streamFormat,
+        std::weak_ptr<Document> document);
+    static void setParent(const std::shared_ptr<AudioTrackFormat> &trackFormat,
+                          std::weak_ptr<Document> document);
+    static void setParent(const std::shared_ptr<AudioTrackUid> &trackUid,
+                          std::weak_ptr<Document> document);
+    ///@}
+
+    struct PendingElements;
+
+    ///@{
+    /// find the elements which would be added by add()
+    void collect(const std::shared_ptr<AudioProgramme> &programme,
+                 PendingElements &pending);
+    void collect(const std::shared_ptr<AudioContent> &content,
+                 PendingElements &pending);
+    void collect(const std::shared_ptr<AudioObject> &object,
+                 PendingElements &pending);
+    void collect(const std::shared_ptr<AudioPackFormat> &packFormat,
+                 PendingElements &pending);
+    void collect(const std::shared_ptr<AudioChannelFormat> &channelFormat,
+                 PendingElements &pending);
+    void collect(const std::shared_ptr<AudioStreamFormat> &streamFormat,
+                 PendingElements &pending);
+    void collect(const std::shared_ptr<AudioTrackFormat> &trackFormat,
+                 PendingElements &pending);
+    void collect(const std::shared_ptr<AudioTrackUid> &trackUid,
+                 PendingElements &pending);
+    ///@}
+
+    /// assign IDs to and add collected elements
+    void commit(const PendingElements &pending);
+    template <typename Element>
+    void commit(const std::vector<std::shared_ptr<Element>> &elements,
+                std::vector<std::shared_ptr<Element>> &documentElements,
+                detail::IdIndex<Element> &index);
+
+    template <typename Element>
+    bool addElement(const std::shared_ptr<Element> &element,
+                    const char *type);
+    template <typename Element>
+    void addElements(const std::vector<std::shared_ptr<Element>> &elements);
+
+    ///@{
+    /// add elements of one type; see addAll
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioProgramme>> &programmes);
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioContent>> &contents);
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioObject>> &objects);
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioPackFormat>> &packFormats);
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioChannelFormat>>
+            &channelFormats);
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioStreamFormat>> &streamFormats);
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioTrackFormat>> &trackFormats);
+    ADM_EXPORT void addAllElements(
+        const std::vector<std::shared_ptr<AudioTrackUid>> &trackUids);
+    ///@}
+
+    template <typename Element>
+    bool removeFrom(const std::shared_ptr<Element> &element,
+                    std::vector<std::shared_ptr<Element>> &documentElements);
+    template <typename Element>
+    std::size_t removeFrom(
+        const std::vector<std::shared_ptr<Element>> &elements,
+        std::vector<std::shared_ptr<Element>> &documentElements);
+
+    ///@{
+    /// remove elements of one type; see removeAll
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioProgramme>> &programmes);
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioContent>> &contents);
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioObject>> &objects);
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioPackFormat>> &packFormats);
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioChannelFormat>>
+            &channelFormats);
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioStreamFormat>> &streamFormats);
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioTrackFormat>> &trackFormats);
+    ADM_EXPORT std::size_t removeElements(
+        const std::vector<std::shared_ptr<AudioTrackUid>> &trackUids);
+    ///@}
+
+    ///@{
+    /// finish removing an element which has been removed from its element
+    /// list: update the indexes, clear its parent, and remove references to
+    /// it from other elements in the document
+    void detach(const std::shared_ptr<AudioProgramme> &programme);
+    void detach(const std::shared_ptr<AudioContent> &content);
+    void detach(const std::shared_ptr<AudioObject> &object);
+    void detach(const std::shared_ptr<AudioPackFormat> &packFormat);
+    void detach(const std::shared_ptr<AudioChannelFormat> &channelFormat);
+    void detach(const std::shared_ptr<AudioStreamFormat> &streamFormat);
+    void detach(const std::shared_ptr<AudioTrackFormat> &trackFormat);
+    void detach(const std::shared_ptr<AudioTrackUid> &trackUid);
+    ///@}
+
+    ///@{
+    /// record the references from an element which has been added to this
+    /// document in referrers_
+    void indexReferences(const std::shared_ptr<AudioProgramme> &programme);
+    void indexReferences(const std::shared_ptr<AudioContent> &content);
+    void indexReferences(const std::shared_ptr<AudioObject> &object);
+    void indexReferences(const std::shared_ptr<AudioPackFormat> &packFormat);
+    void indexReferences(
+        const std::shared_ptr<AudioChannelFormat> &channelFormat);
+    void indexReferences(
+        const std::shared_ptr<AudioStreamFormat> &streamFormat);
+    void indexReferences(const std::shared_ptr<AudioTrackFormat> &trackFormat);
+    void indexReferences(const std::shared_ptr<AudioTrackUid> &trackUid);
+    ///@}
+
+    /// record that element, which is in this document, may now refer to
+    /// reference
+    template <typename Element, typename Reference>
+    void referenceAdded(const std::shared_ptr<Element> &element,
+                        const std::shared_ptr<Reference> &reference) {
+      referrers_.add(element, reference.get());
+    }
+
+    /// record that element, which is in this document, no longer refers to
+    /// reference
+    void referenceRemoved(const void *element, const void *reference) {
+      referrers_.remove(element, reference);
+    }
+
+    ///@{
+    /// update the ID index and the IDs known to idAssigner_ after the ID of
+    /// an element in this document has changed from oldId
+    ADM_EXPORT void idChanged(const std::shared_ptr<AudioProgramme> &programme,
+                              const AudioProgrammeId &oldId);
+    ADM_EXPORT void idChanged(const std::shared_ptr<AudioContent> &content,
+                              const AudioContentId &oldId);
+    ADM_EXPORT void idChanged(const std::shared_ptr<AudioObject> &object,
+                              const AudioObjectId &oldId);
+    ADM_EXPORT void idChanged(
+        const std::shared_ptr<AudioPackFormat> &packFormat,
+        const AudioPackFormatId &oldId);
+    ADM_EXPORT void idChanged(
+        const std::shared_ptr<AudioChannelFormat> &channelFormat,
+        const AudioChannelFormatId &oldId);
+    ADM_EXPORT void idChanged(
+        const std::shared_ptr<AudioStreamFormat> &streamFormat,
+        const AudioStreamFormatId &oldId);
+    ADM_EXPORT void idChanged(
+        const std::shared_ptr<AudioTrackFormat> &trackFormat,
+        const AudioTrackFormatId &oldId);
+    ADM_EXPORT void idChanged(const std::shared_ptr<AudioTrackUid> &trackUid,
+                              const AudioTrackUidId &oldId);
+    ///@}
+
     using detail::DocumentBase::get;
     using detail::DocumentBase::has;
     using detail::DocumentBase::isDefault;
     using detail::DocumentBase::unset;
 
     friend class detail::AddWrapperMethods<Document>;
+    friend class DocumentAttorney;
 
     std::vector<std::shared_ptr<AudioProgramme>> audioProgrammes_;
     std::vector<std::shared_ptr<AudioContent>> audioContents_;
@@ -300,7 +508,16 @@ namespace adm {
     std::vector<std::shared_ptr<AudioStreamFormat>> audioStreamFormats_;
     std::vector<std::shared_ptr<AudioTrackFormat>> audioTrackFormats_;
     std::vector<std::shared_ptr<AudioTrackUid>> audioTrackUids_;
+    detail::IdIndex<AudioProgramme> audioProgrammeIndex_;
+    detail::IdIndex<AudioContent> audioContentIndex_;
+    detail::IdIndex<AudioObject> audioObjectIndex_;
+    detail::IdIndex<AudioPackFormat> audioPackFormatIndex_;
+    detail::IdIndex<AudioChannelFormat> audioChannelFormatIndex_;
+    detail::IdIndex<AudioStreamFormat> audioStreamFormatIndex_;
+    detail::IdIndex<AudioTrackFormat> audioTrackFormatIndex_;
+    detail::IdIndex<AudioTrackUid> audioTrackUidIndex_;
     detail::IdAssigner idAssigner_;
+    detail::ReferrerIndex referrers_;
   };
 
   // ---- Implementation ---- //
@@ -317,4 +534,23 @@ namespace adm {
     return getElements(Tag());
   }
 
+  template <typename Range>
+  void Document::addAll(const Range &elements) {
+    using Element = typename std::decay<decltype(
+        *std::begin(elements))>::type::element_type;
+    std::vector<std::shared_ptr<Element>> toAdd(std::begin(elements),
+                                                std::end(elements));
+    addAllElements(toAdd);
+  }
+
+  template <typename Range>
+  std::size_t Document::removeAll(const Range &elements) {
+    using Element = typename std::decay<decltype(
+        *std::begin(elements))>::type::element_type;
+    // copy first, as elements may be a view of this document
+    std::vector<std::shared_ptr<Element>> toRemove(std::begin(elements),
+                                                   std::end(elements));
+    return removeElements(toRemove);
+  }
+
 }  // namespace adm
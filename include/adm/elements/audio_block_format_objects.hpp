@@ -2,6 +2,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <boost/variant.hpp>
 #include "adm/elements/channel_lock.hpp"
 #include "adm/elements/jump_position.hpp"
 #include "adm/elements/object_divergence.hpp"
@@ -10,6 +11,7 @@
 #include "adm/elements/common_parameters.hpp"
 #include "adm/elements_fwd.hpp"
 #include "adm/detail/auto_base.hpp"
+#include "adm/detail/indirect_optional.hpp"
 #include "adm/detail/named_option_helper.hpp"
 #include "adm/detail/named_type.hpp"
 #include "adm/export.h"
@@ -50,14 +52,14 @@ namespace adm {
     extern template class ADM_EXPORT_TEMPLATE_METHODS DefaultParameter<Depth>;
     extern template class ADM_EXPORT_TEMPLATE_METHODS DefaultParameter<Diffuse>;
 
+    // the parameters with defaults are packed together, as most blocks only
+    // set a few of them
     using AudioBlockFormatObjectsBase = HasParameters<
-        RequiredParameter<AudioBlockFormatId>, DefaultParameter<Rtime>,
-        OptionalParameter<Duration>, OptionalParameter<InitializeBlock>,
-        DefaultParameter<Width>, DefaultParameter<Height>,
-        DefaultParameter<Depth>, DefaultParameter<Diffuse>,
-        DefaultParameter<Gain>, DefaultParameter<Importance>,
-        DefaultParameter<HeadphoneVirtualise>, DefaultParameter<HeadLocked>,
-        DefaultParameter<ScreenRef>>;
+        RequiredParameter<AudioBlockFormatId>, OptionalParameter<Duration>,
+        OptionalParameter<InitializeBlock>,
+        PackedDefaultParameters<Rtime, Gain, HeadphoneVirtualise, Width,
+                                Height, Depth, Diffuse, Importance,
+                                HeadLocked, ScreenRef>>;
   }  // namespace detail
 
   /**
@@ -278,12 +280,14 @@ namespace adm {
     ADM_EXPORT void unset(detail::ParameterTraits<JumpPosition>::tag);
 
     boost::optional<Cartesian> cartesian_;
-    boost::optional<SphericalPosition> sphericalPosition_;
-    boost::optional<CartesianPosition> cartesianPosition_;
-    boost::optional<ScreenEdgeLock> screenEdgeLock_;
-    boost::optional<ChannelLock> channelLock_;
-    boost::optional<ObjectDivergence> objectDivergence_;
-    boost::optional<JumpPosition> jumpPosition_;
+    /// either no position, a SphericalPosition or a CartesianPosition
+    boost::variant<boost::blank, SphericalPosition, CartesianPosition>
+        position_;
+    // rarely used, so stored separately to keep blocks small
+    detail::IndirectOptional<ScreenEdgeLock> screenEdgeLock_;
+    detail::IndirectOptional<ChannelLock> channelLock_;
+    detail::IndirectOptional<ObjectDivergence> objectDivergence_;
+    detail::IndirectOptional<JumpPosition> jumpPosition_;
   };
 
   // ---- Implementation ---- //
@@ -0,0 +1,238 @@
+/// @file audio_block_format_objects_columns.hpp
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "adm/elements/audio_block_format_objects.hpp"
+#include "adm/elements/audio_channel_format.hpp"
+#include "adm/elements/time.hpp"
+#include "adm/export.h"
+
+namespace adm {
+
+  /**
+   * @brief Columnar storage for the audioBlockFormats of an Objects
+   * audioChannelFormat
+   *
+   * Each commonly used parameter is stored in its own contiguous array, so
+   * that code which scans one or two parameters over many blocks (e.g.
+   * positions or gains) only touches the memory holding them:
+   *
+   * - rtimes() and durations() hold times as FixedTime, with hasDuration()
+   *   saying which blocks have a duration;
+   * - cartesian() says which blocks have a CartesianPosition; azimuthOrX(),
+   *   elevationOrY() and distanceOrZ() hold the position components of
+   *   either type of position;
+   * - widths(), heights(), depths(), diffuses() and gains() hold the values
+   *   of those parameters, with gainIsDb() saying which gains are in dB.
+   *
+   * Parameters which have not been set hold their default values, so a scan
+   * doesn't need to check whether they were set. Whether they were set is
+   * kept in bitmaps, so that Row::isDefault and block() give the same
+   * results as for the original block.
+   *
+   * Blocks which use parameters not held in columns (e.g. JumpPosition,
+   * ScreenEdgeLock or ChannelLock), or a time which the columns can't
+   * represent exactly, are also kept whole in a separate sparse table;
+   * their column values are still filled in.
+   *
+   * Use operator[] to access a block through a Row, which has get, has and
+   * isDefault like AudioBlockFormatObjects, or block() to make a copy of a
+   * block.
+   *
+   * @code
+     AudioBlockFormatObjectsColumns columns(
+         channelFormat->getElements<AudioBlockFormatObjects>());
+     float maxAzimuth = -180.0f;
+     for (std::size_t i = 0; i < columns.size(); ++i) {
+       if (!columns.cartesian()[i])
+         maxAzimuth = std::max(maxAzimuth, columns.azimuthOrX()[i]);
+     }
+     @endcode
+   */
+  class AudioBlockFormatObjectsColumns {
+   public:
+    /// access to one block in the columns, without copying it
+    class Row {
+     public:
+      Row(const AudioBlockFormatObjectsColumns& columns, std::size_t index)
+          : columns_(&columns),
+            index_(index),
+            full_(columns.fullBlock(index)) {}
+
+      /// ADM parameter getter, as AudioBlockFormatObjects::get
+      template <typename Parameter>
+      Parameter get() const {
+        if (full_) return full_->template get<Parameter>();
+        return get(static_cast<Parameter*>(nullptr));
+      }
+
+      /// ADM parameter has, as AudioBlockFormatObjects::has
+      template <typename Parameter>
+      bool has() const {
+        if (full_) return full_->template has<Parameter>();
+        return has(static_cast<Parameter*>(nullptr));
+      }
+
+      /// ADM parameter isDefault, as AudioBlockFormatObjects::isDefault
+      template <typename Parameter>
+      bool isDefault() const {
+        if (full_) return full_->template isDefault<Parameter>();
+        return isDefault(static_cast<Parameter*>(nullptr));
+      }
+
+      /// the index of this block in the columns
+      std::size_t index() const { return index_; }
+
+      /// make a copy of this block
+      AudioBlockFormatObjects toBlock() const {
+        return columns_->block(index_);
+      }
+
+     private:
+      // parameters which are not in the columns have their default values
+      template <typename Parameter>
+      Parameter get(Parameter*) const {
+        return defaultBlock().template get<Parameter>();
+      }
+      template <typename Parameter>
+      bool has(Parameter*) const {
+        return defaultBlock().template has<Parameter>();
+      }
+      template <typename Parameter>
+      bool isDefault(Parameter*) const {
+        return defaultBlock().template isDefault<Parameter>();
+      }
+
+      AudioBlockFormatId get(AudioBlockFormatId*) const {
+        return columns_->ids_[index_];
+      }
+      Rtime get(Rtime*) const {
+        return Rtime{columns_->rtimes_[index_].asTime()};
+      }
+      Duration get(Duration*) const {
+        if (!columns_->hasDuration_[index_])
+          throw std::runtime_error("optional value for Duration not set");
+        return Duration{columns_->durations_[index_].asTime()};
+      }
+      Cartesian get(Cartesian*) const {
+        return Cartesian{columns_->cartesian_[index_]};
+      }
+      ADM_EXPORT SphericalPosition get(SphericalPosition*) const;
+      ADM_EXPORT CartesianPosition get(CartesianPosition*) const;
+      Position get(Position*) const {
+        if (columns_->cartesian_[index_]) return get<CartesianPosition>();
+        return get<SphericalPosition>();
+      }
+      Width get(Width*) const { return Width{columns_->widths_[index_]}; }
+      Height get(Height*) const { return Height{columns_->heights_[index_]}; }
+      Depth get(Depth*) const { return Depth{columns_->depths_[index_]}; }
+      Diffuse get(Diffuse*) const {
+        return Diffuse{columns_->diffuses_[index_]};
+      }
+      Gain get(Gain*) const {
+        double gain = columns_->gains_[index_];
+        return columns_->gainIsDb_[index_] ? Gain::fromDb(gain)
+                                           : Gain::fromLinear(gain);
+      }
+
+      bool has(Duration*) const { return columns_->hasDuration_[index_]; }
+      bool has(SphericalPosition*) const {
+        return !columns_->cartesian_[index_];
+      }
+      bool has(CartesianPosition*) const {
+        return columns_->cartesian_[index_];
+      }
+
+      bool isDefault(Rtime*) const { return !columns_->rtimeSet_[index_]; }
+      bool isDefault(Cartesian*) const {
+        return !columns_->cartesianSet_[index_];
+      }
+      bool isDefault(Width*) const { return !columns_->widthSet_[index_]; }
+      bool isDefault(Height*) const { return !columns_->heightSet_[index_]; }
+      bool isDefault(Depth*) const { return !columns_->depthSet_[index_]; }
+      bool isDefault(Diffuse*) const {
+        return !columns_->diffuseSet_[index_];
+      }
+      bool isDefault(Gain*) const { return !columns_->gainSet_[index_]; }
+
+      const AudioBlockFormatObjectsColumns* columns_;
+      std::size_t index_;
+      const AudioBlockFormatObjects* full_;
+    };
+
+    AudioBlockFormatObjectsColumns() = default;
+    /// store copies of blocks
+    ADM_EXPORT explicit AudioBlockFormatObjectsColumns(
+        BlockFormatsConstRange<AudioBlockFormatObjects> blocks);
+
+    /// add a copy of block after the existing blocks
+    ADM_EXPORT void add(const AudioBlockFormatObjects& block);
+    /// reserve space for size blocks in each column
+    ADM_EXPORT void reserve(std::size_t size);
+    /// remove all blocks
+    ADM_EXPORT void clear();
+
+    std::size_t size() const { return ids_.size(); }
+    bool empty() const { return ids_.empty(); }
+
+    Row operator[](std::size_t index) const { return Row{*this, index}; }
+    /// make a copy of the block at index
+    ADM_EXPORT AudioBlockFormatObjects block(std::size_t index) const;
+
+    const std::vector<AudioBlockFormatId>& ids() const { return ids_; }
+    const std::vector<FixedTime>& rtimes() const { return rtimes_; }
+    /// durations, or 0 for blocks without a duration
+    const std::vector<FixedTime>& durations() const { return durations_; }
+    const std::vector<bool>& hasDuration() const { return hasDuration_; }
+    const std::vector<bool>& cartesian() const { return cartesian_; }
+    const std::vector<float>& azimuthOrX() const { return azimuthOrX_; }
+    const std::vector<float>& elevationOrY() const { return elevationOrY_; }
+    const std::vector<float>& distanceOrZ() const { return distanceOrZ_; }
+    const std::vector<float>& widths() const { return widths_; }
+    const std::vector<float>& heights() const { return heights_; }
+    const std::vector<float>& depths() const { return depths_; }
+    const std::vector<float>& diffuses() const { return diffuses_; }
+    /// gains, as linear values or in dB according to gainIsDb()
+    const std::vector<double>& gains() const { return gains_; }
+    const std::vector<bool>& gainIsDb() const { return gainIsDb_; }
+
+   private:
+    /// the whole block at index, if it has parameters which are not in
+    /// the columns, otherwise nullptr
+    ADM_EXPORT const AudioBlockFormatObjects* fullBlock(
+        std::size_t index) const;
+    ADM_EXPORT static const AudioBlockFormatObjects& defaultBlock();
+
+    std::vector<AudioBlockFormatId> ids_;
+    std::vector<FixedTime> rtimes_;
+    std::vector<bool> rtimeSet_;
+    std::vector<FixedTime> durations_;
+    std::vector<bool> hasDuration_;
+    std::vector<bool> cartesian_;
+    std::vector<bool> cartesianSet_;
+    std::vector<float> azimuthOrX_;
+    std::vector<float> elevationOrY_;
+    std::vector<float> distanceOrZ_;
+    std::vector<bool> distanceOrZSet_;
+    std::vector<float> widths_;
+    std::vector<bool> widthSet_;
+    std::vector<float> heights_;
+    std::vector<bool> heightSet_;
+    std::vector<float> depths_;
+    std::vector<bool> depthSet_;
+    std::vector<float> diffuses_;
+    std::vector<bool> diffuseSet_;
+    std::vector<double> gains_;
+    std::vector<bool> gainIsDb_;
+    std::vector<bool> gainSet_;
+
+    /// which blocks are in fullBlocks_
+    std::vector<bool> isFull_;
+    /// blocks with parameters which are not in the columns, by index
+    std::vector<std::pair<std::size_t, AudioBlockFormatObjects>> fullBlocks_;
+  };
+
+}  // namespace adm
@@ -2,6 +2,7 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
 #include <memory>
@@ -24,6 +25,9 @@
 namespace adm {
 
   class Document;
+  namespace detail {
+    class BlockFormatLoader;
+  }
 
   /**
    * Helper to deduce the correct `IteratorRange` type for
@@ -159,6 +163,52 @@ namespace adm {
     ADM_EXPORT void add(AudioBlockFormatHoa blockFormat);
     ADM_EXPORT void add(AudioBlockFormatBinaural blockFormat);
 
+    /**
+     * @brief Add several AudioBlockFormats
+     *
+     * Equivalent to calling add() for each block in turn, but the IDs are
+     * checked and assigned in one pass, and the blocks are moved in without
+     * being copied; if there are no blocks of this type yet, the vector
+     * itself is taken over. If any block has an invalid ID, an exception is
+     * thrown and none of the blocks are added.
+     */
+    ADM_EXPORT void addBlocks(
+        std::vector<AudioBlockFormatDirectSpeakers> &&blockFormats);
+    ADM_EXPORT void addBlocks(
+        std::vector<AudioBlockFormatMatrix> &&blockFormats);
+    ADM_EXPORT void addBlocks(
+        std::vector<AudioBlockFormatObjects> &&blockFormats);
+    ADM_EXPORT void addBlocks(std::vector<AudioBlockFormatHoa> &&blockFormats);
+    ADM_EXPORT void addBlocks(
+        std::vector<AudioBlockFormatBinaural> &&blockFormats);
+
+    /**
+     * @brief Add copies of the AudioBlockFormats in [begin, end)
+     *
+     * As addBlocks(); use std::make_move_iterator to move the blocks rather
+     * than copying them.
+     */
+    template <typename Iterator>
+    void add(Iterator begin, Iterator end);
+
+    /**
+     * @brief Reserve space for AudioBlockFormats
+     *
+     * Reserve space for size audioBlockFormats of the type matching the
+     * typeDefinition of this AudioChannelFormat, so that adding them one at
+     * a time doesn't reallocate.
+     */
+    ADM_EXPORT void reserve(std::size_t size);
+
+    /**
+     * @brief Number of AudioBlockFormats which can be held without
+     * reallocating
+     *
+     * This is for AudioBlockFormats of the type matching the typeDefinition
+     * of this AudioChannelFormat.
+     */
+    ADM_EXPORT std::size_t capacity() const;
+
     /**
      * @brief AudioBlockFormat elements getter template
      *
@@ -205,6 +255,8 @@ namespace adm {
                                   TypeDescriptor channelType);
     ADM_EXPORT AudioChannelFormat(const AudioChannelFormat &) = default;
     ADM_EXPORT AudioChannelFormat(AudioChannelFormat &&) = default;
+    ADM_EXPORT AudioChannelFormat &operator=(
+        const AudioChannelFormat &) = default;
 
     ADM_EXPORT AudioChannelFormatId
         get(detail::ParameterTraits<AudioChannelFormatId>::tag) const;
@@ -244,6 +296,16 @@ namespace adm {
     template <typename BlockFormat>
     void assignId(BlockFormat &blockFormat, BlockFormat *previousBlock = nullptr);
 
+    /// check or assign the IDs of the blocks in [first, last), which are to
+    /// be added after previousBlock (if not nullptr)
+    template <typename BlockFormat>
+    void assignIds(BlockFormat *first, BlockFormat *last,
+                   const BlockFormat *previousBlock);
+
+    template <typename BlockFormat>
+    void appendBlockFormats(std::vector<BlockFormat> &storage,
+                            std::vector<BlockFormat> &&blockFormats);
+
     template <typename BlockFormat>
     bool idUsed(const AudioBlockFormatId &id);
 
@@ -282,6 +344,9 @@ namespace adm {
     BlockFormatsRange<AudioBlockFormatBinaural> get(
         detail::ParameterTraits<AudioBlockFormatBinaural>::tag);
 
+    /// create the blocks from blockFormatLoader_, if it is set
+    void loadBlockFormats() const;
+
     // ----- Common ----- //
     ADM_EXPORT void setParent(std::weak_ptr<Document> document);
 
@@ -297,6 +362,9 @@ namespace adm {
     std::vector<AudioBlockFormatObjects> audioBlockFormatsObjects_;
     std::vector<AudioBlockFormatHoa> audioBlockFormatsHoa_;
     std::vector<AudioBlockFormatBinaural> audioBlockFormatsBinaural_;
+    /// loads the blocks when they are first accessed, if they have not
+    /// been created yet; this is shared between copies
+    std::shared_ptr<const detail::BlockFormatLoader> blockFormatLoader_;
   };
 
   // ---- Implementation ---- //
@@ -385,43 +453,78 @@ namespace adm {
   template <typename BlockFormat>
   void AudioChannelFormat::assignId(BlockFormat &blockFormat,
                                     BlockFormat *previousBlock) {
-    auto thisId = blockFormat.template get<AudioBlockFormatId>();
+    assignIds(&blockFormat, &blockFormat + 1,
+              static_cast<const BlockFormat *>(previousBlock));
+  }
 
+  template <typename BlockFormat>
+  void AudioChannelFormat::assignIds(BlockFormat *first, BlockFormat *last,
+                                     const BlockFormat *previousBlock) {
     auto expectedTypeDescriptor = get<TypeDescriptor>();
     auto expectedValue = AudioBlockFormatIdValue(
         get<AudioChannelFormatId>().get<AudioChannelFormatIdValue>().get());
 
-    if (isUndefined(thisId)) {
-      AudioBlockFormatIdCounter counter;
-      if (previousBlock) {
-        auto prevId = previousBlock->template get<AudioBlockFormatId>();
-        counter = AudioBlockFormatIdCounter(
-            prevId.template get<AudioBlockFormatIdCounter>().get() + 1);
-      } else {
-        counter = AudioBlockFormatIdCounter(1u);
-      }
+    for (auto blockFormat = first; blockFormat != last; ++blockFormat) {
+      auto thisId = blockFormat->template get<AudioBlockFormatId>();
+
+      if (isUndefined(thisId)) {
+        AudioBlockFormatIdCounter counter;
+        if (previousBlock) {
+          auto prevId = previousBlock->template get<AudioBlockFormatId>();
+          counter = AudioBlockFormatIdCounter(
+              prevId.template get<AudioBlockFormatIdCounter>().get() + 1);
+        } else {
+          counter = AudioBlockFormatIdCounter(1u);
+        }
 
-      blockFormat.set(
-          AudioBlockFormatId(expectedTypeDescriptor, expectedValue, counter));
+        blockFormat->set(
+            AudioBlockFormatId(expectedTypeDescriptor, expectedValue, counter));
 
-    } else {
-      auto thisTypeDescriptor = thisId.template get<TypeDescriptor>();
-      if (thisTypeDescriptor != expectedTypeDescriptor)
-        throw std::runtime_error("Invalid ID - incorrect type descriptor");
-
-      auto thisValue = thisId.template get<AudioBlockFormatIdValue>();
-      if (thisValue != expectedValue)
-        throw std::runtime_error("Invalid ID - incorrect value");
-
-      if (previousBlock) {
-        auto currentCounter = thisId.template get<AudioBlockFormatIdCounter>();
-        auto previousCounter = previousBlock->template get<AudioBlockFormatId>()
-                                   .template get<AudioBlockFormatIdCounter>();
-        if (!detail::isValidCounterIncrement(previousCounter, currentCounter)) {
-          throw std::runtime_error("Invalid ID - unexpected counter");
+      } else {
+        auto thisTypeDescriptor = thisId.template get<TypeDescriptor>();
+        if (thisTypeDescriptor != expectedTypeDescriptor)
+          throw std::runtime_error("Invalid ID - incorrect type descriptor");
+
+        auto thisValue = thisId.template get<AudioBlockFormatIdValue>();
+        if (thisValue != expectedValue)
+          throw std::runtime_error("Invalid ID - incorrect value");
+
+        if (previousBlock) {
+          auto currentCounter =
+              thisId.template get<AudioBlockFormatIdCounter>();
+          auto previousCounter =
+              previousBlock->template get<AudioBlockFormatId>()
+                  .template get<AudioBlockFormatIdCounter>();
+          if (!detail::isValidCounterIncrement(previousCounter,
+                                               currentCounter)) {
+            throw std::runtime_error("Invalid ID - unexpected counter");
+          }
         }
       }
+      previousBlock = blockFormat;
     }
   }
 
+  template <typename BlockFormat>
+  void AudioChannelFormat::appendBlockFormats(
+      std::vector<BlockFormat> &storage,
+      std::vector<BlockFormat> &&blockFormats) {
+    loadBlockFormats();
+    assignIds(blockFormats.data(), blockFormats.data() + blockFormats.size(),
+              storage.empty() ? nullptr : &storage.back());
+    if (storage.empty()) {
+      storage = std::move(blockFormats);
+    } else {
+      storage.insert(storage.end(),
+                     std::make_move_iterator(blockFormats.begin()),
+                     std::make_move_iterator(blockFormats.end()));
+    }
+  }
+
+  template <typename Iterator>
+  void AudioChannelFormat::add(Iterator begin, Iterator end) {
+    using BlockFormat = typename std::iterator_traits<Iterator>::value_type;
+    addBlocks(std::vector<BlockFormat>(begin, end));
+  }
+
 }  // namespace adm
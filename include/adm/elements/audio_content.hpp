@@ -223,6 +223,7 @@ namespace adm {
     ADM_EXPORT explicit AudioContent(AudioContentName name);
     ADM_EXPORT AudioContent(const AudioContent&) = default;
     ADM_EXPORT AudioContent(AudioContent&&) = default;
+    ADM_EXPORT AudioContent& operator=(const AudioContent&) = default;
 
     using detail::AudioContentBase::get;
     using detail::AudioContentBase::has;
@@ -281,6 +281,7 @@ namespace adm {
     ADM_EXPORT explicit AudioObject(AudioObjectName name);
     ADM_EXPORT AudioObject(const AudioObject &) = default;
     ADM_EXPORT AudioObject(AudioObject &&) = default;
+    ADM_EXPORT AudioObject &operator=(const AudioObject &) = default;
 
     using detail::AudioObjectBase::get;
     using detail::AudioObjectBase::has;
@@ -78,6 +78,9 @@ namespace adm {
      * The actual copy constructor is private to ensure that an
      * AudioPackFormat can only be created as a `std::shared_ptr`. This is not a
      * deep copy! All referenced objects will be disconnected.
+     *
+     * If this is an AudioPackFormatHoa, the copy is also an
+     * AudioPackFormatHoa.
      */
     ADM_EXPORT std::shared_ptr<AudioPackFormat> copy() const;
 
@@ -186,6 +189,7 @@ namespace adm {
                                TypeDescriptor channelType);
     ADM_EXPORT AudioPackFormat(const AudioPackFormat &) = default;
     ADM_EXPORT AudioPackFormat(AudioPackFormat &&) = default;
+    ADM_EXPORT AudioPackFormat &operator=(const AudioPackFormat &) = default;
 
     ADM_EXPORT AudioPackFormatId
         get(detail::ParameterTraits<AudioPackFormatId>::tag) const;
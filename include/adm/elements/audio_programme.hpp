@@ -219,6 +219,7 @@ namespace adm {
     ADM_EXPORT explicit AudioProgramme(AudioProgrammeName name);
     ADM_EXPORT AudioProgramme(const AudioProgramme &) = default;
     ADM_EXPORT AudioProgramme(AudioProgramme &&) = default;
+    ADM_EXPORT AudioProgramme &operator=(const AudioProgramme &) = default;
 
     using detail::AudioProgrammeBase::get;
     using detail::AudioProgrammeBase::has;
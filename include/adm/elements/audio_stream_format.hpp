@@ -262,6 +262,8 @@ namespace adm {
                                  FormatDescriptor format);
     ADM_EXPORT AudioStreamFormat(const AudioStreamFormat &) = default;
     ADM_EXPORT AudioStreamFormat(AudioStreamFormat &&) = default;
+    ADM_EXPORT AudioStreamFormat &operator=(
+        const AudioStreamFormat &) = default;
 
     ADM_EXPORT AudioStreamFormatId
         get(detail::ParameterTraits<AudioStreamFormatId>::tag) const;
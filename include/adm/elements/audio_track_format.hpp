@@ -186,6 +186,8 @@ namespace adm {
                                 FormatDescriptor channelType);
     ADM_EXPORT AudioTrackFormat(const AudioTrackFormat &) = default;
     ADM_EXPORT AudioTrackFormat(AudioTrackFormat &&) = default;
+    ADM_EXPORT AudioTrackFormat &operator=(
+        const AudioTrackFormat &) = default;
 
     ADM_EXPORT AudioTrackFormatId
         get(detail::ParameterTraits<AudioTrackFormatId>::tag) const;
@@ -186,6 +186,7 @@ namespace adm {
     ADM_EXPORT AudioTrackUid();
     ADM_EXPORT AudioTrackUid(const AudioTrackUid &) = default;
     ADM_EXPORT AudioTrackUid(AudioTrackUid &&) = default;
+    ADM_EXPORT AudioTrackUid &operator=(const AudioTrackUid &) = default;
 
     ADM_EXPORT AudioTrackUidId
         get(detail::ParameterTraits<AudioTrackUidId>::tag) const;
@@ -7,6 +7,7 @@
 #include <iosfwd>
 #include "adm/elements/position_types.hpp"
 #include "adm/elements/screen_edge_lock.hpp"
+#include "adm/detail/indirect_optional.hpp"
 #include "adm/detail/named_option_helper.hpp"
 #include "adm/detail/type_traits.hpp"
 #include "adm/export.h"
@@ -114,7 +115,7 @@ namespace adm {
     Azimuth azimuth_;
     Elevation elevation_;
     boost::optional<Distance> distance_;
-    boost::optional<ScreenEdgeLock> screenEdgeLock_;
+    detail::IndirectOptional<ScreenEdgeLock> screenEdgeLock_;
 
     static const Distance distanceDefault_;
   };
@@ -214,7 +215,7 @@ namespace adm {
     X x_;
     Y y_;
     boost::optional<Z> z_;
-    boost::optional<ScreenEdgeLock> screenEdgeLock_;
+    detail::IndirectOptional<ScreenEdgeLock> screenEdgeLock_;
 
     static const Z zDefault_;
   };
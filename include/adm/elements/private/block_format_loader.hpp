@@ -0,0 +1,20 @@
+#pragma once
+
+namespace adm {
+
+  class AudioChannelFormat;
+
+  namespace detail {
+
+    /// audioBlockFormats of an AudioChannelFormat which are only created
+    /// when they are first accessed; see ParserOptions::lazy_block_formats
+    class BlockFormatLoader {
+     public:
+      virtual ~BlockFormatLoader() = default;
+
+      /// create the blocks and add them to channelFormat
+      virtual void load(AudioChannelFormat& channelFormat) const = 0;
+    };
+
+  }  // namespace detail
+}  // namespace adm
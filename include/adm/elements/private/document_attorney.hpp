@@ -0,0 +1,52 @@
+#pragma once
+#include <memory>
+#include "adm/document.hpp"
+
+// see:
+// https://en.wikibooks.org/wiki/More_C%2B%2B_Idioms/Friendship_and_the_Attorney-Client
+
+namespace adm {
+
+  /// gives elements access to the parts of Document which must be kept in
+  /// sync with them
+  class DocumentAttorney {
+   private:
+    friend class AudioProgramme;
+    friend class AudioContent;
+    friend class AudioObject;
+    friend class AudioPackFormat;
+    friend class AudioChannelFormat;
+    friend class AudioStreamFormat;
+    friend class AudioTrackFormat;
+    friend class AudioTrackUid;
+    template <typename T1, typename T2>
+    friend bool autoParent(T1& self, const std::shared_ptr<T2>& other);
+
+    /// tell the parent of element (if any) that its ID has changed from
+    /// oldId
+    template <typename Element, typename Id>
+    static void idChanged(Element& element, const Id& oldId) {
+      if (auto document = element.getParent().lock())
+        document->idChanged(element.shared_from_this(), oldId);
+    }
+
+    /// tell document, the parent of element, that element may now refer to
+    /// reference
+    template <typename Element, typename Reference>
+    static void referenceAdded(Document& document, Element& element,
+                               const std::shared_ptr<Reference>& reference) {
+      document.referenceAdded(element.shared_from_this(), reference);
+    }
+
+    /// tell the parent of element (if any) that element no longer refers
+    /// to reference
+    template <typename Element, typename Reference>
+    static void referenceRemoved(Element& element,
+                                 const std::shared_ptr<Reference>& reference) {
+      if (!reference) return;
+      if (auto document = element.getParent().lock())
+        document->referenceRemoved(&element, reference.get());
+    }
+  };
+
+}  // namespace adm
@@ -5,6 +5,7 @@
 #include "adm/elements/audio_content.hpp"
 #include "adm/elements/audio_object.hpp"
 #include "adm/elements/audio_pack_format.hpp"
+#include "adm/elements/audio_pack_format_hoa.hpp"
 #include "adm/elements/audio_programme.hpp"
 #include "adm/elements/audio_stream_format.hpp"
 #include "adm/elements/audio_track_format.hpp"
@@ -15,30 +16,60 @@
 
 namespace adm {
 
+  namespace xml {
+    class DocumentParser;
+  }
+  class FrameApplier;
+
   class AudioProgrammeAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
 
     static void setParent(const std::shared_ptr<AudioProgramme>& programme,
                           std::weak_ptr<Document> parent) {
       programme->setParent(std::move(parent));
     }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent and references of target
+    static void assignParameters(AudioProgramme& target,
+                                 const AudioProgramme& source) {
+      auto parent = std::move(target.parent_);
+      auto audioContents = std::move(target.audioContents_);
+      target = source;
+      target.parent_ = std::move(parent);
+      target.audioContents_ = std::move(audioContents);
+    }
   };
 
   class AudioContentAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
     friend class AudioProgramme;
 
     static void setParent(const std::shared_ptr<AudioContent>& content,
                           std::weak_ptr<Document> parent) {
       content->setParent(std::move(parent));
     }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent and references of target
+    static void assignParameters(AudioContent& target,
+                                 const AudioContent& source) {
+      auto parent = std::move(target.parent_);
+      auto audioObjects = std::move(target.audioObjects_);
+      target = source;
+      target.parent_ = std::move(parent);
+      target.audioObjects_ = std::move(audioObjects);
+    }
   };
 
   class AudioObjectAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
     friend class AudioContent;
     friend class AudioObject;
 
@@ -46,11 +77,30 @@ namespace adm {
                           std::weak_ptr<Document> parent) {
       object->setParent(std::move(parent));
     }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent and references of target
+    static void assignParameters(AudioObject& target,
+                                 const AudioObject& source) {
+      auto parent = std::move(target.parent_);
+      auto audioObjects = std::move(target.audioObjects_);
+      auto audioComplementaryObjects =
+          std::move(target.audioComplementaryObjects_);
+      auto audioPackFormats = std::move(target.audioPackFormats_);
+      auto audioTrackUids = std::move(target.audioTrackUids_);
+      target = source;
+      target.parent_ = std::move(parent);
+      target.audioObjects_ = std::move(audioObjects);
+      target.audioComplementaryObjects_ = std::move(audioComplementaryObjects);
+      target.audioPackFormats_ = std::move(audioPackFormats);
+      target.audioTrackUids_ = std::move(audioTrackUids);
+    }
   };
 
   class AudioPackFormatAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
     friend class AudioPackFormat;
     friend class AudioTrackUid;
     friend class AudioStreamFormat;
@@ -60,24 +110,62 @@ namespace adm {
                           std::weak_ptr<Document> parent) {
       packFormat->setParent(std::move(parent));
     }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent and references of target
+    static void assignParameters(AudioPackFormat& target,
+                                 const AudioPackFormat& source) {
+      auto parent = std::move(target.parent_);
+      auto audioChannelFormats = std::move(target.audioChannelFormats_);
+      auto audioPackFormats = std::move(target.audioPackFormats_);
+      // the parameters of HOA pack formats are held in the subclass
+      if (auto hoaTarget = dynamic_cast<AudioPackFormatHoa*>(&target)) {
+        *hoaTarget = dynamic_cast<const AudioPackFormatHoa&>(source);
+      } else {
+        target = source;
+      }
+      target.parent_ = std::move(parent);
+      target.audioChannelFormats_ = std::move(audioChannelFormats);
+      target.audioPackFormats_ = std::move(audioPackFormats);
+    }
   };
 
   class AudioChannelFormatAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
     friend class AudioPackFormat;
     friend class AudioStreamFormat;
+    friend class xml::DocumentParser;
 
     static void setParent(
         const std::shared_ptr<AudioChannelFormat>& channelFormat,
         std::weak_ptr<Document> parent) {
       channelFormat->setParent(std::move(parent));
     }
+
+    /// make the blocks of channelFormat (which must not have any) be
+    /// loaded by loader when they are first accessed
+    static void setBlockFormatLoader(
+        const std::shared_ptr<AudioChannelFormat>& channelFormat,
+        std::shared_ptr<const detail::BlockFormatLoader> loader) {
+      channelFormat->blockFormatLoader_ = std::move(loader);
+    }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent of target
+    static void assignParameters(AudioChannelFormat& target,
+                                 const AudioChannelFormat& source) {
+      auto parent = std::move(target.parent_);
+      target = source;
+      target.parent_ = std::move(parent);
+    }
   };
 
   class AudioStreamFormatAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
     friend class AudioTrackFormat;
 
     static void setParent(
@@ -85,11 +173,27 @@ namespace adm {
         std::weak_ptr<Document> parent) {
       streamFormat->setParent(std::move(parent));
     }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent and references of target
+    static void assignParameters(AudioStreamFormat& target,
+                                 const AudioStreamFormat& source) {
+      auto parent = std::move(target.parent_);
+      auto audioChannelFormat = std::move(target.audioChannelFormat_);
+      auto audioPackFormat = std::move(target.audioPackFormat_);
+      auto audioTrackFormats = std::move(target.audioTrackFormats_);
+      target = source;
+      target.parent_ = std::move(parent);
+      target.audioChannelFormat_ = std::move(audioChannelFormat);
+      target.audioPackFormat_ = std::move(audioPackFormat);
+      target.audioTrackFormats_ = std::move(audioTrackFormats);
+    }
   };
 
   class AudioTrackFormatAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
     friend class AudioTrackUid;
     friend class AudioStreamFormat;
 
@@ -97,17 +201,44 @@ namespace adm {
                           std::weak_ptr<Document> parent) {
       trackFormat->setParent(std::move(parent));
     }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent and references of target
+    static void assignParameters(AudioTrackFormat& target,
+                                 const AudioTrackFormat& source) {
+      auto parent = std::move(target.parent_);
+      auto audioStreamFormat = std::move(target.audioStreamFormat_);
+      target = source;
+      target.parent_ = std::move(parent);
+      target.audioStreamFormat_ = std::move(audioStreamFormat);
+    }
   };
 
   class AudioTrackUidAttorney {
    private:
     friend class Document;
+    friend class FrameApplier;
     friend class AudioObject;
 
     static void setParent(const std::shared_ptr<AudioTrackUid>& trackFormat,
                           std::weak_ptr<Document> parent) {
       trackFormat->setParent(std::move(parent));
     }
+
+    /// set the parameters (and sub-elements) of target to those of source,
+    /// keeping the parent and references of target
+    static void assignParameters(AudioTrackUid& target,
+                                 const AudioTrackUid& source) {
+      auto parent = std::move(target.parent_);
+      auto audioTrackFormat = std::move(target.audioTrackFormat_);
+      auto audioChannelFormat = std::move(target.audioChannelFormat_);
+      auto audioPackFormat = std::move(target.audioPackFormat_);
+      target = source;
+      target.parent_ = std::move(parent);
+      target.audioTrackFormat_ = std::move(audioTrackFormat);
+      target.audioChannelFormat_ = std::move(audioChannelFormat);
+      target.audioPackFormat_ = std::move(audioPackFormat);
+    }
   };
 
 }  // namespace adm
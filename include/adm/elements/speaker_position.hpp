@@ -4,6 +4,7 @@
 #include <vector>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
+#include "adm/detail/indirect_optional.hpp"
 #include "adm/detail/named_option_helper.hpp"
 #include "adm/elements/screen_edge_lock.hpp"
 #include "adm/elements/position_types.hpp"
@@ -146,7 +147,7 @@ namespace adm {
     boost::optional<Z> z_;
     boost::optional<ZMin> zMin_;
     boost::optional<ZMax> zMax_;
-    boost::optional<ScreenEdgeLock> screenEdgeLock_;
+    detail::IndirectOptional<ScreenEdgeLock> screenEdgeLock_;
   };
 
   // ---- Implementation ---- //
@@ -313,7 +314,7 @@ namespace adm {
     boost::optional<Distance> distance_;
     boost::optional<DistanceMin> distanceMin_;
     boost::optional<DistanceMax> distanceMax_;
-    boost::optional<ScreenEdgeLock> screenEdgeLock_;
+    detail::IndirectOptional<ScreenEdgeLock> screenEdgeLock_;
   };
 
   // ---- Implementation ---- //
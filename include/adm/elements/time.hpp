@@ -2,6 +2,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 #include <boost/variant.hpp>
@@ -42,6 +43,96 @@ namespace adm {
     int64_t _denominator;
   };
 
+  class Time;
+
+  /// @brief A time in seconds, as numerator / denominator, for cheap
+  /// comparison and arithmetic
+  ///
+  /// Unlike FractionalTime, the denominator acts as a fixed scale, and is
+  /// never normalised: times with the same denominator (e.g. two times in
+  /// nanoseconds, or two times at the same frame rate) are compared, added
+  /// and subtracted with a single integer operation. Times with different
+  /// denominators are compared exactly, and added or subtracted using their
+  /// lowest common denominator. As with std::chrono, overflow is not
+  /// checked.
+  class FixedTime {
+   public:
+    /// the denominator of times in nanoseconds
+    static constexpr int64_t nanosecondsDenominator = 1000000000;
+
+    FixedTime() : _numerator(0), _denominator(nanosecondsDenominator) {}
+    FixedTime(int64_t numerator, int64_t denominator)
+        : _numerator(numerator), _denominator(denominator) {
+      if (denominator < 1)
+        throw std::invalid_argument("FixedTime denominator must be positive");
+    }
+    explicit FixedTime(std::chrono::nanoseconds time)
+        : _numerator(time.count()), _denominator(nanosecondsDenominator) {}
+    explicit FixedTime(const FractionalTime& time)
+        : _numerator(time.numerator()), _denominator(time.denominator()) {}
+
+    int64_t numerator() const { return _numerator; }
+    int64_t denominator() const { return _denominator; }
+
+    bool isNanoseconds() const {
+      return _denominator == nanosecondsDenominator;
+    }
+
+    /// convert to nanoseconds, rounding in the same way as
+    /// Time::asNanoseconds
+    ADM_EXPORT std::chrono::nanoseconds asNanoseconds() const;
+    FractionalTime asFractional() const { return {_numerator, _denominator}; }
+    /// convert to a Time: in nanoseconds if the denominator is
+    /// nanosecondsDenominator, otherwise fractional
+    Time asTime() const;
+
+   private:
+    int64_t _numerator;
+    int64_t _denominator;
+  };
+
+  namespace detail {
+    /// compare times with different denominators; returns -1, 0 or 1
+    ADM_EXPORT int compareSlow(const FixedTime& a, const FixedTime& b);
+    /// a + b (or a - b if subtract) for times with different denominators
+    ADM_EXPORT FixedTime addSlow(const FixedTime& a, const FixedTime& b,
+                                 bool subtract);
+  }  // namespace detail
+
+  inline bool operator==(const FixedTime& a, const FixedTime& b) {
+    if (a.denominator() == b.denominator())
+      return a.numerator() == b.numerator();
+    return detail::compareSlow(a, b) == 0;
+  }
+  inline bool operator!=(const FixedTime& a, const FixedTime& b) {
+    return !(a == b);
+  }
+  inline bool operator<(const FixedTime& a, const FixedTime& b) {
+    if (a.denominator() == b.denominator())
+      return a.numerator() < b.numerator();
+    return detail::compareSlow(a, b) < 0;
+  }
+  inline bool operator>(const FixedTime& a, const FixedTime& b) {
+    return b < a;
+  }
+  inline bool operator<=(const FixedTime& a, const FixedTime& b) {
+    return !(b < a);
+  }
+  inline bool operator>=(const FixedTime& a, const FixedTime& b) {
+    return !(a < b);
+  }
+
+  inline FixedTime operator+(const FixedTime& a, const FixedTime& b) {
+    if (a.denominator() == b.denominator())
+      return {a.numerator() + b.numerator(), a.denominator()};
+    return detail::addSlow(a, b, false);
+  }
+  inline FixedTime operator-(const FixedTime& a, const FixedTime& b) {
+    if (a.denominator() == b.denominator())
+      return {a.numerator() - b.numerator(), a.denominator()};
+    return detail::addSlow(a, b, true);
+  }
+
   /// representation of ADM times; this can either be decimal times,
   /// represented as nanoseconds, or fractional times, represented as a
   /// FractionalTime
@@ -58,6 +149,13 @@ namespace adm {
     /// convert to nanoseconds, rounding down
     ADM_EXPORT std::chrono::nanoseconds asNanoseconds() const;
     ADM_EXPORT FractionalTime asFractional() const;
+    /// convert to a FixedTime with the same denominator, for comparison
+    /// and arithmetic
+    FixedTime asFixed() const {
+      if (auto ns = boost::get<std::chrono::nanoseconds>(&time))
+        return FixedTime{*ns};
+      return FixedTime{boost::get<FractionalTime>(time)};
+    }
 
     bool isNanoseconds() const {
       return time.type() == typeid(std::chrono::nanoseconds);
@@ -74,6 +172,11 @@ namespace adm {
     Variant time;
   };
 
+  inline Time FixedTime::asTime() const {
+    if (isNanoseconds()) return std::chrono::nanoseconds{_numerator};
+    return asFractional();
+  }
+
   /// @brief Tag for NamedType ::Start
   struct StartTag {};
   /// @brief NamedType for the start attribute
@@ -113,6 +216,18 @@ namespace adm {
 
   /// @brief Parse an adm timecode and convert it to a std::chrono::duration
   ADM_EXPORT Time parseTimecode(const std::string& timecode);
+  /// @brief Parse the adm timecode in [begin, end), without allocating
+  ADM_EXPORT Time parseTimecode(const char* begin, const char* end);
   /// @brief Format a std::chrono::duration object as an adm timecode string
   ADM_EXPORT std::string formatTimecode(const Time& time);
+
+  /// size of a buffer which can hold any timecode written by
+  /// formatTimecode(const Time&, char*), including the terminating null
+  constexpr std::size_t timecodeBufferSize = 72;
+  /// @brief Format time as an adm timecode, without allocating
+  ///
+  /// @param buffer destination for the null-terminated timecode, which must
+  /// have space for at least timecodeBufferSize characters
+  /// @returns the length of the timecode, not including the terminating null
+  ADM_EXPORT std::size_t formatTimecode(const Time& time, char* buffer);
 }  // namespace adm
@@ -1,14 +1,17 @@
 /// @file parse.hpp
 #pragma once
+#include <cstddef>
 #include <string>
 #include <memory>
 #include <iosfwd>
+#include <boost/optional.hpp>
 #include "adm/detail/enum_bitmask.hpp"
+#include "adm/elements/time.hpp"
+#include "adm/elements_fwd.hpp"
 #include "adm/export.h"
 
 namespace adm {
 
-  class Document;
   class FrameHeader;
 
   namespace xml {
@@ -30,7 +33,112 @@ namespace adm {
       recursive_node_search =
           0x1,  ///< recursively search whole xml for audioFormatExtended node
       permit_time_reference_mismatch =
-          0x2  ///< do not report a mismatch between the FrameHeader TimeReference and audioBlockFormat lstart/rtime lduration/duration as an error
+          0x2,  ///< do not report a mismatch between the FrameHeader TimeReference and audioBlockFormat lstart/rtime lduration/duration as an error
+      parallel =
+          0x4,  ///< parse the children of audioFormatExtended on a pool of threads; the result is the same as without this option. Ignored by parseXmlStreaming().
+      lazy_block_formats =
+          0x8  ///< keep the XML text of the audioBlockFormats in each audioChannelFormat, and only parse them when they are first accessed (e.g. with `getElements<AudioBlockFormatObjects>()`). Errors in audioBlockFormats are thrown from the first access rather than from parseXml(), and accessing the blocks of one audioChannelFormat from several threads at once is not safe until they have been loaded. A copy of the whole document is held while parsing; afterwards each audioChannelFormat keeps a copy of the text of its blocks until they are loaded. Ignored by parseXmlStreaming().
+    };
+
+    /**
+     * @brief Kinds of ADM element, for use in `ParseFilter`
+     *
+     * Like `ParserOptions`, values may be combined by `OR`-ing them.
+     *
+     * @ingroup xml
+     */
+    enum class ElementKinds : unsigned {
+      none = 0x0,
+      audioProgramme = 0x1,
+      audioContent = 0x2,
+      audioObject = 0x4,
+      audioPackFormat = 0x8,
+      audioChannelFormat = 0x10,
+      audioStreamFormat = 0x20,
+      audioTrackFormat = 0x40,
+      audioTrackUid = 0x80,
+      audioBlockFormat = 0x100
+    };
+
+    /**
+     * @brief Selects the parts of a document which are parsed
+     *
+     * Elements which are filtered out are skipped without being parsed or
+     * created, and references to skipped kinds of element are ignored
+     * rather than being reported as unresolved.
+     *
+     * @ingroup xml
+     */
+    struct ParseFilter {
+      /// kinds of element to skip; skipping audioChannelFormat also skips
+      /// the audioBlockFormats within it
+      ElementKinds skip = ElementKinds::none;
+      /// if set, audioBlockFormats with an rtime (or lstart) before this
+      /// are skipped
+      boost::optional<Time> blockStart;
+      /// if set, audioBlockFormats with an rtime (or lstart) at or after
+      /// this are skipped
+      boost::optional<Time> blockEnd;
+    };
+
+    /**
+     * @brief Receives elements from `parseXmlStreaming()` as they are parsed
+     *
+     * All functions do nothing by default, so derived classes only need to
+     * override those for the elements they are interested in.
+     *
+     * @ingroup xml
+     */
+    class StreamingParserHandler {
+     public:
+      virtual ~StreamingParserHandler() = default;
+
+      /**
+       * @brief Called for each top-level element once it has been parsed
+       * and added to the document.
+       *
+       * References between elements are resolved at the end of the
+       * document, so they are not available yet.
+       */
+      virtual void element(const std::shared_ptr<AudioProgramme>&) {}
+      virtual void element(const std::shared_ptr<AudioContent>&) {}
+      virtual void element(const std::shared_ptr<AudioObject>&) {}
+      virtual void element(const std::shared_ptr<AudioPackFormat>&) {}
+      virtual void element(const std::shared_ptr<AudioChannelFormat>&) {}
+      virtual void element(const std::shared_ptr<AudioStreamFormat>&) {}
+      virtual void element(const std::shared_ptr<AudioTrackFormat>&) {}
+      virtual void element(const std::shared_ptr<AudioTrackUid>&) {}
+
+      /**
+       * @brief Called for each audioBlockFormat as it is parsed.
+       *
+       * This is called before `element()` for the audioChannelFormat which
+       * contains the block, so sub-elements of the audioChannelFormat which
+       * come after the blocks (e.g. frequency) may not have been set yet.
+       *
+       * @param channelFormat the audioChannelFormat containing the block
+       * @param block the parsed block, which may be moved from
+       * @returns true if the block has been consumed, in which case it is
+       * not added to channelFormat; this allows documents with long
+       * audioChannelFormats to be processed without holding all of the
+       * blocks in memory.
+       */
+      virtual bool blockFormat(const std::shared_ptr<AudioChannelFormat>&,
+                               AudioBlockFormatDirectSpeakers&) {
+        return false;
+      }
+      virtual bool blockFormat(const std::shared_ptr<AudioChannelFormat>&,
+                               AudioBlockFormatObjects&) {
+        return false;
+      }
+      virtual bool blockFormat(const std::shared_ptr<AudioChannelFormat>&,
+                               AudioBlockFormatHoa&) {
+        return false;
+      }
+      virtual bool blockFormat(const std::shared_ptr<AudioChannelFormat>&,
+                               AudioBlockFormatBinaural&) {
+        return false;
+      }
     };
   }  // namespace xml
 
@@ -51,6 +159,18 @@ namespace adm {
       const std::string& filename,
       xml::ParserOptions options = xml::ParserOptions::none);
 
+  /**
+   * @brief Parse the parts of an XML file selected by a filter
+   *
+   * As `parseXml(const std::string&, xml::ParserOptions)`.
+   * @param filename XML file to read and parse
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      const std::string& filename, xml::ParserOptions options,
+      const xml::ParseFilter& filter);
+
   /**
    * @brief Parse an xml document containing an audioFormatExtended
    * node into an adm::Document, using a SADM FrameHeader to check for consistency.
@@ -64,6 +184,18 @@ namespace adm {
       const std::string& filename, FrameHeader const& header,
       xml::ParserOptions options = xml::ParserOptions::none);
 
+  /**
+   * @brief Parse the parts of a serial ADM frame file selected by a filter
+   *
+   * As `parseXml(const std::string&, FrameHeader const&, xml::ParserOptions)`.
+   * @param filename XML file to read and parse
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      const std::string& filename, FrameHeader const& header,
+      xml::ParserOptions options, const xml::ParseFilter& filter);
+
   /**
    * @brief Parse an XML representation of the Audio Definition Model
    *
@@ -75,6 +207,18 @@ namespace adm {
       std::istream& stream,
       xml::ParserOptions options = xml::ParserOptions::none);
 
+  /**
+   * @brief Parse the parts of an XML stream selected by a filter
+   *
+   * As `parseXml(std::istream&, xml::ParserOptions)`.
+   * @param stream input stream to parse XML data
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      std::istream& stream, xml::ParserOptions options,
+      const xml::ParseFilter& filter);
+
   /**
    * @brief Parse an xml document containing an audioFormatExtended
    * node into an adm::Document, using a SADM FrameHeader to check for consistency.
@@ -88,6 +232,139 @@ namespace adm {
       std::istream& stream, FrameHeader const& header,
       xml::ParserOptions options = xml::ParserOptions::none);
 
+  /**
+   * @brief Parse the parts of a serial ADM frame stream selected by a
+   * filter
+   *
+   * As `parseXml(std::istream&, FrameHeader const&, xml::ParserOptions)`.
+   * @param stream input stream to parse XML data
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      std::istream& stream, FrameHeader const& header,
+      xml::ParserOptions options, const xml::ParseFilter& filter);
+
+  /**
+   * @brief Parse an XML representation of the Audio Definition Model from
+   * memory
+   *
+   * The parser works in place, so this makes one copy of @a data; use
+   * `parseXmlInSitu()` to avoid this if the data may be modified.
+   * @param data XML data to parse, which need not be null-terminated
+   * @param size size of @a data in bytes
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXml(
+      const char* data, std::size_t size,
+      xml::ParserOptions options = xml::ParserOptions::none,
+      const xml::ParseFilter& filter = xml::ParseFilter());
+
+  /**
+   * @brief Parse an XML representation of the Audio Definition Model in
+   * place, without copying it
+   *
+   * @param data XML data to parse, which is modified by parsing and so can
+   * not be parsed again; `data[size]` must be `'\0'`
+   * @param size size of @a data in bytes, not including the terminating
+   * null character
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   * @throws std::invalid_argument if `data[size]` is not `'\0'`
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXmlInSitu(
+      char* data, std::size_t size,
+      xml::ParserOptions options = xml::ParserOptions::none,
+      const xml::ParseFilter& filter = xml::ParseFilter());
+
+  /**
+   * @brief Parse an XML file by mapping it into memory
+   *
+   * This avoids reading the file into a buffer before parsing it. The file
+   * is mapped copy-on-write, so it is not modified. On platforms without
+   * mmap, the file is read into memory instead.
+   * @param filename XML file to read and parse
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXmlMapped(
+      const std::string& filename,
+      xml::ParserOptions options = xml::ParserOptions::none,
+      const xml::ParseFilter& filter = xml::ParseFilter());
+
+  /**
+   * @brief Parse an XML representation of the Audio Definition Model
+   * incrementally
+   *
+   * The stream is read in small chunks rather than all at once, and each
+   * element is passed to @a handler as soon as it has been parsed, so that
+   * large documents can be processed in bounded memory if the handler
+   * consumes the audioBlockFormats.
+   *
+   * The result is the same as `parseXml(std::istream&)`, except that
+   * blocks which were consumed by the handler are not included, and that
+   * line numbers in error messages are relative to the start of the
+   * top-level element in which the error occurred.
+   *
+   * @param stream input stream to parse XML data
+   * @param handler receives the parsed elements
+   * @param options Options to influence the XML parser behaviour
+   * @param filter Selects the parts of the document to parse
+   */
+  ADM_EXPORT std::shared_ptr<Document> parseXmlStreaming(
+      std::istream& stream, xml::StreamingParserHandler& handler,
+      xml::ParserOptions options = xml::ParserOptions::none,
+      const xml::ParseFilter& filter = xml::ParseFilter());
+
+  /**
+   * @brief Parser for a series of XML documents, such as the frames of a
+   * serial ADM stream
+   *
+   * Each call to `parse()` gives the same result as the corresponding
+   * `parseXml()` function, but the input buffer, XML node pool and
+   * reference tables used while parsing are kept between calls rather than
+   * being allocated for each document. Once the parser has seen a document
+   * as large as the current one, parsing only allocates memory for the
+   * returned document.
+   *
+   * A ReusableParser must not be used from more than one thread at once.
+   */
+  class ReusableParser {
+   public:
+    /**
+     * @param options Options to influence the XML parser behaviour
+     * @param filter Selects the parts of each document to parse
+     */
+    ADM_EXPORT explicit ReusableParser(
+        xml::ParserOptions options = xml::ParserOptions::none,
+        const xml::ParseFilter& filter = xml::ParseFilter());
+    ADM_EXPORT ~ReusableParser();
+
+    ReusableParser(const ReusableParser&) = delete;
+    ReusableParser& operator=(const ReusableParser&) = delete;
+
+    /// parse a document read from stream, as with
+    /// `parseXml(std::istream&)`
+    ADM_EXPORT std::shared_ptr<Document> parse(std::istream& stream);
+    /// parse a serial ADM frame read from stream, as with
+    /// `parseXml(std::istream&, FrameHeader const&)`
+    ADM_EXPORT std::shared_ptr<Document> parse(std::istream& stream,
+                                               FrameHeader const& header);
+    /// parse a document from memory, as with
+    /// `parseXml(const char*, std::size_t)`; @a data is not modified
+    ADM_EXPORT std::shared_ptr<Document> parse(const char* data,
+                                               std::size_t size);
+    /// parse a serial ADM frame from memory
+    ADM_EXPORT std::shared_ptr<Document> parse(const char* data,
+                                               std::size_t size,
+                                               FrameHeader const& header);
+
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+  };
+
   /**
    * @brief Parse an XML representation of a serial ADM frame and return
    * the frameHeader element as an adm::FrameHeader object
@@ -118,3 +395,4 @@ namespace adm {
 }  // namespace adm
 
 ENABLE_ENUM_BITMASK_OPERATORS(adm::xml::ParserOptions);
+ENABLE_ENUM_BITMASK_OPERATORS(adm::xml::ElementKinds);
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+
+namespace adm {
+  namespace detail {
+    /// The contents of resources/common_definitions.xml, as plain tables.
+    ///
+    /// The definitions of these tables are generated from the XML file at
+    /// configuration time by generate_common_definitions(), so that the
+    /// common definitions can be built without parsing XML at runtime.
+    ///
+    /// IDs are stored as their numeric parts, and references between elements
+    /// are stored as indices into the tables of the referenced elements.
+    namespace common_definitions_data {
+
+      /// half-open range of indices into another table
+      struct Range {
+        std::size_t begin;
+        std::size_t end;
+      };
+
+      struct PackFormat {
+        unsigned typeDescriptor;
+        unsigned value;
+        const char* name;
+        /// into packFormatChannelFormatRefs
+        Range channelFormatRefs;
+        /// into packFormatPackFormatRefs
+        Range packFormatRefs;
+      };
+
+      struct ChannelFormat {
+        unsigned typeDescriptor;
+        unsigned value;
+        const char* name;
+        bool hasLowPass;
+        float lowPass;
+        /// into the block table for typeDescriptor
+        Range blocks;
+      };
+
+      struct DirectSpeakersBlock {
+        unsigned counter;
+        const char* speakerLabel;
+        float azimuth;
+        float elevation;
+        float distance;
+        /// horizontal screenEdgeLock of the azimuth, or nullptr
+        const char* azimuthScreenEdgeLock;
+      };
+
+      struct HoaBlock {
+        unsigned counter;
+        int order;
+        int degree;
+        const char* normalization;
+      };
+
+      struct BinauralBlock {
+        unsigned counter;
+      };
+
+      struct StreamFormat {
+        unsigned typeDescriptor;
+        unsigned value;
+        const char* name;
+        unsigned formatDescriptor;
+        /// into streamFormatTrackFormatRefs
+        Range trackFormatRefs;
+        /// into channelFormats
+        std::size_t channelFormatRef;
+      };
+
+      struct TrackFormat {
+        unsigned typeDescriptor;
+        unsigned value;
+        unsigned counter;
+        const char* name;
+        unsigned formatDescriptor;
+        /// into streamFormats
+        std::size_t streamFormatRef;
+      };
+
+      extern const PackFormat packFormats[];
+      extern const std::size_t packFormatCount;
+      extern const std::size_t packFormatChannelFormatRefs[];
+      extern const std::size_t packFormatPackFormatRefs[];
+
+      extern const ChannelFormat channelFormats[];
+      extern const std::size_t channelFormatCount;
+      extern const DirectSpeakersBlock directSpeakersBlocks[];
+      extern const HoaBlock hoaBlocks[];
+      extern const BinauralBlock binauralBlocks[];
+
+      extern const StreamFormat streamFormats[];
+      extern const std::size_t streamFormatCount;
+      extern const std::size_t streamFormatTrackFormatRefs[];
+
+      extern const TrackFormat trackFormats[];
+      extern const std::size_t trackFormatCount;
+
+    }  // namespace common_definitions_data
+  }  // namespace detail
+}  // namespace adm
@@ -1,8 +1,8 @@
 #pragma once
 #include <iosfwd>
-#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include "adm/document.hpp"
 #include "adm/elements.hpp"
@@ -11,7 +11,6 @@
 #include "rapidxml/rapidxml.hpp"
 #include "rapidxml/rapidxml_utils.hpp"
 #include "adm/elements/audio_pack_format_hoa.hpp"
-#include "adm/detail/id_map.hpp"
 #include <adm/serial.hpp>
 
 namespace adm {
@@ -75,6 +74,8 @@ namespace adm {
     NodePtr findAudioFormatExtendedNodeFullRecursive(NodePtr root);
     NodePtr findFrameAudioFormatExtended(NodePtr node);
 
+    class XmlStreamReader;
+
     class DocumentParser {
      public:
       explicit DocumentParser(
@@ -84,9 +85,32 @@ namespace adm {
       explicit DocumentParser(
           std::istream& stream, ParserOptions options = ParserOptions::none,
           std::shared_ptr<Document> destDocument = Document::create());
+      /// parse data in place, without copying it
+      ///
+      /// data must be null-terminated, and is modified by parse(), so must
+      /// not be parsed again
+      DocumentParser(char* data, ParserOptions options,
+                     std::shared_ptr<Document> destDocument);
+      /// construct a parser without input, for use with parseStreaming()
+      DocumentParser(ParserOptions options,
+                     std::shared_ptr<Document> destDocument);
 
       void setHeader(FrameHeader header);
+      void setFilter(ParseFilter filter);
+      /// prepare to parse data (as with the char* constructor) into
+      /// destDocument, forgetting any previous input and frame header
+      ///
+      /// The storage used while parsing is kept, so that a parser which is
+      /// reset for each of a series of documents does not have to allocate
+      /// it again.
+      void reset(char* data, std::shared_ptr<Document> destDocument);
       std::shared_ptr<Document> parse();
+      /// parse using xmlDocument, whose memory pool should have been cleared
+      std::shared_ptr<Document> parse(rapidxml::xml_document<>& xmlDocument);
+      /// parse a document from stream incrementally, passing elements to
+      /// handler as they are parsed; see parseXmlStreaming()
+      std::shared_ptr<Document> parseStreaming(
+          std::istream& stream, StreamingParserHandler& handler);
 
       bool hasUnresolvedReferences();
 
@@ -94,8 +118,32 @@ namespace adm {
       explicit DocumentParser(
           rapidxml::file<> file, ParserOptions options = ParserOptions::none,
           std::shared_ptr<Document> destDocument = Document::create());
+      /// construct a parser for parsing elements on a worker thread, which
+      /// collects references but does not add elements to a document
+      DocumentParser(ParserOptions options,
+                     boost::optional<FrameHeader> frameHeader);
 
       boost::optional<TimeReference> getTimeReference() const;
+      /// is kind excluded by filter_?
+      bool isSkipped(ElementKinds kind) const;
+
+      /// parse a child of audioFormatExtended and add it to the document
+      void parseElement(NodePtr node);
+      /// parse a child of audioFormatExtended, and pass the resulting element
+      /// (if it is one) to f
+      template <typename F>
+      void parseElement(NodePtr node, F&& f);
+      /// parse the children of root like parseElement, using a pool of
+      /// threads
+      void parseElementsParallel(NodePtr root);
+      /// move the references collected by a worker parser into this one
+      void mergeReferences(DocumentParser& worker);
+      void resolveAllReferences();
+
+      void parseStreamingElements(XmlStreamReader& reader,
+                                  rapidxml::xml_document<>& xml);
+      void parseStreamingChannelFormat(XmlStreamReader& reader,
+                                       rapidxml::xml_document<>& xml);
 
       std::shared_ptr<AudioProgramme> parseAudioProgramme(NodePtr node);
       std::shared_ptr<AudioContent> parseAudioContent(NodePtr node);
@@ -105,63 +153,101 @@ namespace adm {
       std::shared_ptr<AudioPackFormat> parseAudioPackFormat(NodePtr node);
       std::shared_ptr<AudioTrackUid> parseAudioTrackUid(NodePtr node);
       std::shared_ptr<AudioChannelFormat> parseAudioChannelFormat(NodePtr node);
+      /// parse an audioBlockFormat and add it to channelFormat, unless it is
+      /// consumed by handler_
+      void parseAudioBlockFormat(
+          const std::shared_ptr<AudioChannelFormat>& channelFormat,
+          NodePtr node);
+      /// make the blocks from first to last (children of the
+      /// audioChannelFormat node) be parsed when they are first accessed
+      /// @returns false if this is not possible, in which case they should
+      /// be parsed now
+      bool deferBlockFormats(
+          const std::shared_ptr<AudioChannelFormat>& channelFormat,
+          NodePtr first, NodePtr last);
+      /// the line of p in xmlData_, counted as by xml::getDocumentLine();
+      /// lines are counted from the previous call, so this is cheap if
+      /// positions are passed in document order
+      int lineAt(const char* p);
+      template <typename Block>
+      void addBlockFormat(
+          const std::shared_ptr<AudioChannelFormat>& channelFormat,
+          Block block);
 
-      rapidxml::file<> xmlFile_;
+      boost::optional<rapidxml::file<>> xmlFile_;
+      /// the data to parse, either in xmlFile_ or owned by the caller
+      char* xmlData_ = nullptr;
+      /// a copy of xmlData_ before it is modified by parsing, if the
+      /// ParserOptions::lazy_block_formats option is set; this is only kept
+      /// while parsing, as each deferred audioChannelFormat takes a copy of
+      /// the text of its own blocks
+      std::shared_ptr<const std::string> xmlSource_;
+      /// the position up to which lines have been counted by lineAt(), and
+      /// the line it is on
+      const char* linePosition_ = nullptr;
+      int line_ = 0;
       ParserOptions options_;
       std::shared_ptr<Document> document_;
       boost::optional<FrameHeader> frameHeader_;
+      ParseFilter filter_;
+      /// receives elements when parsing with parseStreaming()
+      StreamingParserHandler* handler_ = nullptr;
+
+      /// references from elements of type Src to elements with IDs of type
+      /// Id, in document order; these are cleared rather than destroyed by
+      /// reset(), so their storage is reused
+      template <typename Src, typename Id>
+      using References = std::vector<std::pair<std::shared_ptr<Src>, Id>>;
 
       // clang-format off
-      std::map<std::shared_ptr<AudioProgramme>, std::vector<AudioContentId>> programmeContentRefs_;
-      std::map<std::shared_ptr<AudioContent>, std::vector<AudioObjectId>> contentObjectRefs_;
-      std::map<std::shared_ptr<AudioObject>, std::vector<AudioObjectId>> objectObjectRefs_;
-      std::map<std::shared_ptr<AudioObject>, std::vector<AudioObjectId>> objectComplementaryObjectRefs_;
-      std::map<std::shared_ptr<AudioObject>, std::vector<AudioPackFormatId>> objectPackFormatRefs_;
-      std::map<std::shared_ptr<AudioObject>, std::vector<AudioTrackUidId>> objectTrackUidRefs_;
-      std::map<std::shared_ptr<AudioTrackUid>, AudioTrackFormatId> trackUidTrackFormatRef_;
-      std::map<std::shared_ptr<AudioTrackUid>, AudioChannelFormatId> trackUidChannelFormatRef_;
-      std::map<std::shared_ptr<AudioTrackUid>, AudioPackFormatId> trackUidPackFormatRef_;
-      std::map<std::shared_ptr<AudioPackFormat>, std::vector<AudioChannelFormatId>> packFormatChannelFormatRefs_;
-      std::map<std::shared_ptr<AudioPackFormat>, std::vector<AudioPackFormatId>> packFormatPackFormatRefs_;
-      std::map<std::shared_ptr<AudioTrackFormat>, AudioStreamFormatId> trackFormatStreamFormatRef_;
-      std::map<std::shared_ptr<AudioStreamFormat>, AudioChannelFormatId> streamFormatChannelFormatRef_;
-      std::map<std::shared_ptr<AudioStreamFormat>, AudioPackFormatId> streamFormatPackFormatRef_;
-      std::map<std::shared_ptr<AudioStreamFormat>, std::vector<AudioTrackFormatId>> streamFormatTrackFormatRefs_;
+      References<AudioProgramme, AudioContentId> programmeContentRefs_;
+      References<AudioContent, AudioObjectId> contentObjectRefs_;
+      References<AudioObject, AudioObjectId> objectObjectRefs_;
+      References<AudioObject, AudioObjectId> objectComplementaryObjectRefs_;
+      References<AudioObject, AudioPackFormatId> objectPackFormatRefs_;
+      References<AudioObject, AudioTrackUidId> objectTrackUidRefs_;
+      References<AudioTrackUid, AudioTrackFormatId> trackUidTrackFormatRef_;
+      References<AudioTrackUid, AudioChannelFormatId> trackUidChannelFormatRef_;
+      References<AudioTrackUid, AudioPackFormatId> trackUidPackFormatRef_;
+      References<AudioPackFormat, AudioChannelFormatId> packFormatChannelFormatRefs_;
+      References<AudioPackFormat, AudioPackFormatId> packFormatPackFormatRefs_;
+      References<AudioTrackFormat, AudioStreamFormatId> trackFormatStreamFormatRef_;
+      References<AudioStreamFormat, AudioChannelFormatId> streamFormatChannelFormatRef_;
+      References<AudioStreamFormat, AudioPackFormatId> streamFormatPackFormatRef_;
+      References<AudioStreamFormat, AudioTrackFormatId> streamFormatTrackFormatRefs_;
       // clang-format on
 
-      /// used to keep track of element IDs ourselves to avoid having it
-      /// iterate through the whole document for each element and reference
-      ::adm::detail::IDMap idMap_;
-
-      /// add an element to both the document and idMap_
+      /// add an element to the document, and pass it to handler_ if there
+      /// is one
       template <typename Element>
       void add(std::shared_ptr<Element> el);
+      /// is there already an element with this ID? this is always false
+      /// for worker parsers, which have no document
+      template <typename Id>
+      bool contains(const Id& id) const;
+      void clearReferences();
 
       template <typename Src, typename TargetId>
-      void resolveReferences(const std::map<Src, std::vector<TargetId>>& map) {
-        for (const auto& entry : map) {
-          for (const auto& id : entry.second) {
-            if (auto element = idMap_.lookup(id)) {
-              entry.first->addReference(std::move(element));
-            } else {
-              throw error::XmlParsingUnresolvedReference(formatId(id));
-            }
+      void resolveReferences(const References<Src, TargetId>& references) {
+        for (const auto& entry : references) {
+          if (auto element = document_->lookup(entry.second)) {
+            entry.first->addReference(std::move(element));
+          } else {
+            throw error::XmlParsingUnresolvedReference(formatId(entry.second));
           }
         }
       }
 
       void resolveTrackUidReferences(
-          const std::map<std::shared_ptr<AudioObject>,
-                         std::vector<AudioTrackUidId>>& map);
-
-      template <typename Src, typename Target>
-      void resolveReference(const std::map<Src, Target>& map) {
-        for (const auto& entry : map) {
-          const auto& id = entry.second;
-          if (auto element = idMap_.lookup(id)) {
+          const References<AudioObject, AudioTrackUidId>& references);
+
+      template <typename Src, typename TargetId>
+      void resolveReference(const References<Src, TargetId>& references) {
+        for (const auto& entry : references) {
+          if (auto element = document_->lookup(entry.second)) {
             entry.first->setReference(std::move(element));
           } else {
-            throw error::XmlParsingUnresolvedReference(formatId(id));
+            throw error::XmlParsingUnresolvedReference(formatId(entry.second));
           }
         }
       }
@@ -0,0 +1,69 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "adm/elements.hpp"
+#include "adm/private/xml_stream_writer.hpp"
+
+namespace adm {
+  namespace detail {
+
+    /// the content of an audioChannelFormat, with the audioBlockFormats
+    /// kept separately so that added blocks can be told apart from changes
+    struct ChannelFormatContent {
+      /// content of everything except the audioBlockFormats
+      std::string parameters;
+      /// ID and content of each audioBlockFormat, in order
+      std::vector<std::pair<AudioBlockFormatId, std::string>> blocks;
+
+      bool operator==(const ChannelFormatContent& other) const {
+        return parameters == other.parameters && blocks == other.blocks;
+      }
+      bool operator!=(const ChannelFormatContent& other) const {
+        return !(*this == other);
+      }
+    };
+
+    /// gets the content of top-level elements, for telling whether they
+    /// have changed
+    ///
+    /// The content of an element is the XML that the writer would produce
+    /// for it, so two elements have the same content if and only if they
+    /// would be written in the same way. References are included by ID, so
+    /// a change to a referenced element does not change the content of the
+    /// elements which refer to it.
+    ///
+    /// One writer is reused for all elements, so that its storage is only
+    /// allocated once.
+    class ElementContentWriter {
+     public:
+      ElementContentWriter();
+
+      std::string operator()(const std::shared_ptr<const AudioProgramme>&);
+      std::string operator()(const std::shared_ptr<const AudioContent>&);
+      std::string operator()(const std::shared_ptr<const AudioObject>&);
+      std::string operator()(const std::shared_ptr<const AudioPackFormat>&);
+      std::string operator()(
+          const std::shared_ptr<const AudioStreamFormat>&);
+      std::string operator()(const std::shared_ptr<const AudioTrackFormat>&);
+      std::string operator()(const std::shared_ptr<const AudioTrackUid>&);
+      ChannelFormatContent operator()(
+          const std::shared_ptr<const AudioChannelFormat>&);
+
+     private:
+      /// the XML written by format(node, element) to a node called name
+      template <typename Element, typename Format>
+      std::string write(const Element& element, const char* name,
+                        Format format);
+
+      template <typename BlockFormat, typename Format>
+      void writeBlocks(ChannelFormatContent& content,
+                       const AudioChannelFormat& channelFormat,
+                       Format format);
+
+      xml::XmlStreamWriter writer_;
+    };
+
+  }  // namespace detail
+}  // namespace adm
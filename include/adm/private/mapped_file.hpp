@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace adm {
+  namespace xml {
+
+    /// the contents of a file, mapped into memory copy-on-write and followed
+    /// by a null character, so that it can be parsed in place by rapidxml
+    /// without first being read into a buffer
+    ///
+    /// Changes to the data are private to this object and are not written
+    /// back to the file. On platforms without mmap, the file is read into
+    /// memory instead.
+    class MappedFile {
+     public:
+      /// @throws std::runtime_error if the file can't be opened or mapped
+      explicit MappedFile(const std::string& filename);
+      ~MappedFile();
+
+      MappedFile(const MappedFile&) = delete;
+      MappedFile& operator=(const MappedFile&) = delete;
+
+      /// the contents of the file; data()[size()] is '\0'
+      char* data() { return data_; }
+      std::size_t size() const { return size_; }
+
+     private:
+      char* data_ = nullptr;
+      std::size_t size_ = 0;
+      /// size of the mapping at data_, or 0 if the file was read into buffer_
+      std::size_t mappedSize_ = 0;
+      std::vector<char> buffer_;
+    };
+
+  }  // namespace xml
+}  // namespace adm
@@ -0,0 +1,279 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace adm {
+  namespace xml {
+    namespace detail {
+
+      namespace number_parsing {
+        inline bool isSpace(char c) {
+          return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+                 c == '\v' || c == '\f';
+        }
+
+        inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+        inline const char* skipSpace(const char* p, const char* end) {
+          while (p != end && isSpace(*p)) ++p;
+          return p;
+        }
+
+        /// parse an optional sign, returning true if it was '-'
+        inline bool parseSign(const char*& p, const char* end) {
+          if (p != end && (*p == '+' || *p == '-')) return *p++ == '-';
+          return false;
+        }
+
+        /// parse an integer, returning its magnitude, which is at most
+        /// limit; sets negative from the sign
+        inline std::uint64_t parseMagnitude(const char* begin, const char* end,
+                                            std::uint64_t limit,
+                                            bool& negative,
+                                            const char* function) {
+          const char* p = skipSpace(begin, end);
+          negative = parseSign(p, end);
+          if (p == end || !isDigit(*p)) throw std::invalid_argument(function);
+
+          std::uint64_t value = 0;
+          bool overflow = false;
+          for (; p != end && isDigit(*p); ++p) {
+            auto digit = static_cast<std::uint64_t>(*p - '0');
+            if (value > (limit - digit) / 10) {
+              overflow = true;
+            } else {
+              value = value * 10 + digit;
+            }
+          }
+          if (overflow) throw std::out_of_range(function);
+          return value;
+        }
+
+        /// a decimal number in the form mantissa * 10^exponent
+        struct Decimal {
+          bool negative = false;
+          std::uint64_t mantissa = 0;
+          int exponent = 0;
+          /// were non-zero digits dropped from the mantissa?
+          bool truncated = false;
+          /// the end of the text of the number
+          const char* end = nullptr;
+        };
+
+        /// case-insensitive check for a lower-case prefix
+        inline bool startsWith(const char* p, const char* end,
+                               const char* prefix) {
+          for (; *prefix; ++p, ++prefix) {
+            if (p == end || (*p | 0x20) != *prefix) return false;
+          }
+          return true;
+        }
+
+        /// parse the special values accepted by std::stod
+        template <typename Float>
+        bool parseSpecial(const char* p, const char* end, bool negative,
+                          Float& value) {
+          if (startsWith(p, end, "inf")) {
+            value = std::numeric_limits<Float>::infinity();
+          } else if (startsWith(p, end, "nan")) {
+            value = std::numeric_limits<Float>::quiet_NaN();
+          } else {
+            return false;
+          }
+          if (negative) value = -value;
+          return true;
+        }
+
+        /// parse a decimal number with an optional fraction and exponent
+        /// @returns false if there were no digits
+        inline bool parseDecimal(const char* begin, const char* end,
+                                 Decimal& decimal) {
+          const int maxDigits = 19;
+          const char* p = skipSpace(begin, end);
+          decimal.negative = parseSign(p, end);
+
+          int digits = 0;
+          bool anyDigits = false;
+          for (; p != end && isDigit(*p); ++p) {
+            anyDigits = true;
+            if (digits < maxDigits) {
+              decimal.mantissa =
+                  decimal.mantissa * 10 + static_cast<unsigned>(*p - '0');
+              if (decimal.mantissa) ++digits;
+            } else {
+              ++decimal.exponent;
+              if (*p != '0') decimal.truncated = true;
+            }
+          }
+          if (p != end && *p == '.') {
+            ++p;
+            for (; p != end && isDigit(*p); ++p) {
+              anyDigits = true;
+              if (digits < maxDigits) {
+                decimal.mantissa =
+                    decimal.mantissa * 10 + static_cast<unsigned>(*p - '0');
+                --decimal.exponent;
+                if (decimal.mantissa) ++digits;
+              } else if (*p != '0') {
+                decimal.truncated = true;
+              }
+            }
+          }
+          if (!anyDigits) {
+            decimal.end = p;
+            return false;
+          }
+
+          if (p != end && (*p == 'e' || *p == 'E')) {
+            const char* q = p + 1;
+            bool negativeExponent = parseSign(q, end);
+            if (q != end && isDigit(*q)) {
+              int exponent = 0;
+              for (; q != end && isDigit(*q); ++q) {
+                // beyond this the result is zero or infinity anyway
+                if (exponent < 100000) exponent = exponent * 10 + (*q - '0');
+              }
+              decimal.exponent += negativeExponent ? -exponent : exponent;
+              p = q;
+            }
+          }
+          decimal.end = p;
+          return true;
+        }
+
+        /// exact powers of ten which can be represented as doubles
+        inline double exactPowerOfTen(int exponent) {
+          static const double powers[] = {
+              1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+              1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+              1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+          return powers[exponent];
+        }
+
+        /// convert decimal to a double, if this can be done exactly with one
+        /// rounding step (i.e. both the mantissa and the power of ten are
+        /// exactly representable)
+        inline bool fastConvert(const Decimal& decimal, double& value) {
+          const std::uint64_t maxExactMantissa = std::uint64_t(1) << 53;
+          if (decimal.truncated || decimal.mantissa > maxExactMantissa ||
+              decimal.exponent < -22 || decimal.exponent > 22) {
+            return false;
+          }
+          value = static_cast<double>(decimal.mantissa);
+          if (decimal.exponent < 0) {
+            value /= exactPowerOfTen(-decimal.exponent);
+          } else {
+            value *= exactPowerOfTen(decimal.exponent);
+          }
+          if (decimal.negative) value = -value;
+          return true;
+        }
+
+        /// is value exactly half way between two floats? if so, converting
+        /// it to float would round twice
+        inline bool isFloatMidpoint(double value) {
+          std::uint64_t bits;
+          std::memcpy(&bits, &value, sizeof(bits));
+          // the 29 bits of the double mantissa which don't fit in a float
+          const std::uint64_t lowBits = (std::uint64_t(1) << 29) - 1;
+          return (bits & lowBits) == (std::uint64_t(1) << 28);
+        }
+
+        template <typename Float>
+        Float slowConvert(const char* begin, const char* end,
+                          const char* function) {
+          std::istringstream stream(std::string(begin, end));
+          stream.imbue(std::locale::classic());
+          Float value;
+          stream >> value;
+          if (stream.fail()) throw std::out_of_range(function);
+          return value;
+        }
+      }  // namespace number_parsing
+
+      /**
+       * @brief Locale-independent number parsing
+       *
+       * These parse the number at the start of [begin, end) in the same way
+       * as `std::stoi`, `std::stoul`, `std::stof` and `std::stod`: leading
+       * whitespace is skipped, and parsing stops at the first character
+       * which can't be part of the number. Unlike those, they always use '.'
+       * as the decimal separator, and don't allocate in the common cases.
+       *
+       * Floating point results are correctly rounded. Decimal numbers with
+       * at most 19 significant digits and a small exponent are converted
+       * directly; others (which are very rare in ADM documents) are passed
+       * to a stream using the classic locale.
+       *
+       * Hexadecimal floating point numbers are not supported.
+       *
+       * @throws std::invalid_argument if there is no number
+       * @throws std::out_of_range if the number can't be represented in the
+       * result type
+       */
+      inline int parseInt(const char* begin, const char* end) {
+        using namespace number_parsing;
+        const std::uint64_t max = std::numeric_limits<int>::max();
+        bool negative;
+        auto magnitude = parseMagnitude(begin, end, max + 1, negative, "stoi");
+        if (negative) {
+          return static_cast<int>(-static_cast<std::int64_t>(magnitude));
+        }
+        if (magnitude > max) throw std::out_of_range("stoi");
+        return static_cast<int>(magnitude);
+      }
+
+      /// see parseInt()
+      inline unsigned parseUnsigned(const char* begin, const char* end) {
+        using namespace number_parsing;
+        bool negative;
+        auto magnitude =
+            parseMagnitude(begin, end, std::numeric_limits<unsigned>::max(),
+                           negative, "stoul");
+        if (negative && magnitude) throw std::out_of_range("stoul");
+        return static_cast<unsigned>(magnitude);
+      }
+
+      /// see parseInt()
+      inline double parseDouble(const char* begin, const char* end) {
+        using namespace number_parsing;
+        Decimal decimal;
+        double value;
+        if (!parseDecimal(begin, end, decimal)) {
+          if (parseSpecial(decimal.end, end, decimal.negative, value)) {
+            return value;
+          }
+          throw std::invalid_argument("stod");
+        }
+        if (fastConvert(decimal, value)) return value;
+        return slowConvert<double>(begin, decimal.end, "stod");
+      }
+
+      /// see parseInt()
+      inline float parseFloat(const char* begin, const char* end) {
+        using namespace number_parsing;
+        Decimal decimal;
+        float value;
+        if (!parseDecimal(begin, end, decimal)) {
+          if (parseSpecial(decimal.end, end, decimal.negative, value)) {
+            return value;
+          }
+          throw std::invalid_argument("stof");
+        }
+        // values in the range of fastConvert are within the normal float
+        // range, so this can only go wrong if rounding to float is ambiguous
+        double exact;
+        if (fastConvert(decimal, exact) && !isFloatMidpoint(exact)) {
+          return static_cast<float>(exact);
+        }
+        return slowConvert<float>(begin, decimal.end, "stof");
+      }
+
+    }  // namespace detail
+  }  // namespace xml
+}  // namespace adm
@@ -0,0 +1,122 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <boost/optional.hpp>
+
+namespace adm {
+  namespace detail {
+
+    /// the number of threads to use for parallel work by default
+    inline unsigned defaultThreadCount() {
+      return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /**
+     * @brief Produce results for indices [0, count) on a pool of threads,
+     * and consume them in order on the calling thread.
+     *
+     * `produce(i)` is called on the worker threads, and must return a
+     * `Result`; `consume(i, Result&&)` is called on the calling thread in
+     * order of i, as the results become available. At most `window` results
+     * are held at once, so that memory use does not depend on count.
+     *
+     * If `produce` or `consume` throws for some index, the exception from
+     * the lowest such index is rethrown once the workers have stopped, so
+     * errors are the same as when running sequentially. With one thread
+     * (or one item) everything is run on the calling thread.
+     */
+    template <typename Result, typename Produce, typename Consume>
+    void orderedParallelFor(std::size_t count, Produce produce,
+                            Consume consume,
+                            unsigned threads = defaultThreadCount(),
+                            std::size_t window = 0) {
+      threads = static_cast<unsigned>(
+          std::min<std::size_t>(threads, count > 0 ? count : 1));
+      if (threads <= 1) {
+        for (std::size_t i = 0; i < count; ++i) consume(i, produce(i));
+        return;
+      }
+      if (window == 0) window = 4 * threads;
+
+      struct Slot {
+        boost::optional<Result> result;
+        std::exception_ptr error;
+        bool ready = false;
+      };
+      std::vector<Slot> slots(window);
+
+      std::mutex mutex;
+      std::condition_variable produced;
+      std::condition_variable consumed;
+      std::size_t next = 0;  // next index to produce
+      std::size_t done = 0;  // number of results consumed
+      bool stop = false;
+
+      auto worker = [&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+          consumed.wait(lock, [&]() {
+            return stop || next >= count || next < done + window;
+          });
+          if (stop || next >= count) return;
+          auto i = next++;
+          lock.unlock();
+
+          Slot slot;
+          try {
+            slot.result = produce(i);
+          } catch (...) {
+            slot.error = std::current_exception();
+          }
+          slot.ready = true;
+
+          lock.lock();
+          slots[i % window] = std::move(slot);
+          produced.notify_all();
+        }
+      };
+
+      std::vector<std::thread> pool;
+      pool.reserve(threads);
+      auto joinAll = [&]() {
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          stop = true;
+        }
+        consumed.notify_all();
+        for (auto& thread : pool) thread.join();
+      };
+
+      try {
+        for (unsigned t = 0; t < threads; ++t) pool.emplace_back(worker);
+
+        for (std::size_t i = 0; i < count; ++i) {
+          Slot slot;
+          {
+            std::unique_lock<std::mutex> lock(mutex);
+            auto& waiting = slots[i % window];
+            produced.wait(lock, [&]() { return waiting.ready; });
+            slot = std::move(waiting);
+            waiting = Slot();
+            ++done;
+          }
+          consumed.notify_all();
+
+          if (slot.error) std::rethrow_exception(slot.error);
+          consume(i, std::move(*slot.result));
+        }
+      } catch (...) {
+        joinAll();
+        throw;
+      }
+      joinAll();
+    }
+
+  }  // namespace detail
+}  // namespace adm
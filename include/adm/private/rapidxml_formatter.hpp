@@ -45,6 +45,11 @@ namespace adm {
         XmlNode &node,
         const std::shared_ptr<const AudioChannelFormat> channelFormat,
         TimeReference timeReference);
+    /// format the attributes and sub-elements of an audioChannelFormat,
+    /// except for the audioBlockFormats
+    void formatAudioChannelFormatParameters(
+        XmlNode &node,
+        const std::shared_ptr<const AudioChannelFormat> channelFormat);
     void formatAudioStreamFormat(
         XmlNode &node,
         const std::shared_ptr<const AudioStreamFormat> streamFormat);
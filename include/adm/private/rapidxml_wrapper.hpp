@@ -1,46 +1,50 @@
 #pragma once
 #include "adm/document.hpp"
-#include "rapidxml/rapidxml.hpp"
-#include "rapidxml/rapidxml_print.hpp"
-#include "rapidxml/rapidxml_utils.hpp"
 
 #include "adm/elements.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/private/rapidxml_formatter.hpp"
+#include "adm/private/xml_stream_writer.hpp"
 
-#include <iostream>
+#include <iosfwd>
 #include <string>
 
 namespace adm {
   namespace xml {
 
-    using NodePtr = rapidxml::xml_node<> *;
-
     class XmlNode;
 
+    /// an XML document which is written to a stream as nodes are added
+    ///
+    /// Nodes must be added in document order: adding a node to an element
+    /// closes any nodes previously added below it, after which they can't
+    /// be changed. Attributes must be added to an element before any child
+    /// nodes. See XmlStreamWriter.
     class XmlDocument {
      public:
-      XmlDocument() = default;
+      explicit XmlDocument(std::ostream &stream);
       XmlNode addNode(const std::string &name);
 
-      XmlNode addDeclaration();
+      void addDeclaration();
       XmlNode addItuStructure();
       XmlNode addCoreMetadataAudioFormatExtended(XmlNode &parent) const;
       XmlNode addEbuStructure();
 
       void setDiscardDefaults(bool value) { discardDefaultValues_ = value; }
 
-     private:
-      friend std::ostream &operator<<(std::ostream &os, XmlDocument const &doc);
+      /// close all nodes and write any buffered output to the stream
+      void finish();
 
-      rapidxml::xml_document<> doc_;
+     private:
+      XmlStreamWriter writer_;
       bool discardDefaultValues_ = false;
     };
 
     class XmlNode {
      public:
       XmlNode() = default;
-      XmlNode(NodePtr node, bool discardDefaults);
+      XmlNode(XmlStreamWriter &writer, std::size_t depth, std::size_t serial,
+              bool discardDefaults);
 
       // --- GENERAL ---- //
       XmlNode addNode(const std::string &name);
@@ -115,14 +119,36 @@ namespace adm {
           const std::shared_ptr<const AudioStreamFormat> &src,
           const std::string &name);
 
+      /// add nodes written separately to an XmlFragment of this node
+      void addFragment(const std::string &xml);
+
      private:
-      NodePtr node_;
+      friend class XmlFragment;
+
+      XmlStreamWriter *writer_ = nullptr;
+      std::size_t depth_ = 0;
+      std::size_t serial_ = 0;
       bool discardDefaultValues_ = true;
     };
 
-    inline std::ostream &operator<<(std::ostream &os, XmlDocument const &doc) {
-      return os << doc.doc_;
-    }
+    /// nodes written separately from a document, to be added to it later
+    /// with XmlNode::addFragment
+    ///
+    /// This allows parts of a document to be written concurrently.
+    class XmlFragment {
+     public:
+      /// start a fragment containing children of parent
+      explicit XmlFragment(const XmlNode &parent);
+
+      XmlNode addNode(const std::string &name);
+
+      /// close all nodes and return the XML
+      std::string finish();
+
+     private:
+      XmlStreamWriter writer_;
+      bool discardDefaultValues_;
+    };
 
     // ---- Implementation ---- //
 
@@ -5,10 +5,12 @@
 #include <sstream>
 #include <string>
 #include <cstring>
+#include <utility>
 #include <vector>
 #include "adm/document.hpp"
 #include "adm/elements/format_descriptor.hpp"
 #include "adm/elements/type_descriptor.hpp"
+#include "adm/private/number_parsing.hpp"
 #include "adm/private/rapidxml_utils.hpp"
 #include "rapidxml/rapidxml.hpp"
 
@@ -78,7 +80,15 @@ namespace adm {
         std::vector<NodePtr> elements;
 
         size_t nameLen = std::strlen(name);
-        for (NodePtr elementNode = node->first_node(name, nameLen); elementNode;
+        NodePtr first = node->first_node(name, nameLen);
+        // count first, so that the vector is only allocated once
+        std::size_t count = 0;
+        for (NodePtr elementNode = first; elementNode;
+             elementNode = elementNode->next_sibling(name, nameLen)) {
+          count++;
+        }
+        elements.reserve(count);
+        for (NodePtr elementNode = first; elementNode;
              elementNode = elementNode->next_sibling(name, nameLen)) {
           elements.push_back(elementNode);
         }
@@ -88,31 +98,38 @@ namespace adm {
       template <typename T>
       struct TypeTag {};
 
-      inline int parseImpl(const std::string& v, TypeTag<int>) {
-        return std::stoi(v);
+      // numbers are parsed directly from the text in the rapidxml document,
+      // without the locale or allocation of std::stoi etc.
+      inline int parseImpl(const char* v, TypeTag<int>) {
+        return parseInt(v, v + std::strlen(v));
       }
-      inline unsigned int parseImpl(const std::string& v,
-                                    TypeTag<unsigned int>) {
-        return std::stoul(v);
+      inline unsigned int parseImpl(const char* v, TypeTag<unsigned int>) {
+        return parseUnsigned(v, v + std::strlen(v));
       }
-      inline std::string parseImpl(std::string v, TypeTag<std::string>) {
+      inline std::string parseImpl(const char* v, TypeTag<std::string>) {
         return v;
       }
-      inline float parseImpl(const std::string& v, TypeTag<float>) {
-        return std::stof(v);
+      inline float parseImpl(const char* v, TypeTag<float>) {
+        return parseFloat(v, v + std::strlen(v));
       }
-      inline double parseImpl(const std::string& v, TypeTag<double>) {
-        return std::stod(v);
+      inline double parseImpl(const char* v, TypeTag<double>) {
+        return parseDouble(v, v + std::strlen(v));
       }
-      inline bool parseImpl(const std::string& v, TypeTag<bool>) {
-        return std::stoi(v) != 0;
+      inline bool parseImpl(const char* v, TypeTag<bool>) {
+        return parseInt(v, v + std::strlen(v)) != 0;
+      }
+
+      /// parse a timecode from the text in the rapidxml document, without
+      /// copying it into a std::string
+      inline Time parseTimecode(const char* v) {
+        return adm::parseTimecode(v, v + std::strlen(v));
       }
 
       template <typename NT>
-      NT parseDefault(std::string v) {
+      NT parseDefault(const char* v) {
         typedef typename NT::value_type value_type;
         typedef TypeTag<value_type> DispatchTypeTag;
-        return NT(parseImpl(std::move(v), DispatchTypeTag()));
+        return NT(parseImpl(v, DispatchTypeTag()));
       }
     }  // namespace detail
 
@@ -251,7 +268,7 @@ namespace adm {
       auto elements = detail::findElements(node, elementName);
       boost::optional<NT> value;
       if (elements.size() > 0) {
-        value = NT(parser(elements));
+        value = NT(parser(std::move(elements)));
       }
       return value;
     }
@@ -282,12 +299,16 @@ namespace adm {
     }
 
     // ---- references ---- //
+    /// add (src, id) to target for each elementName sub-element of node,
+    /// where target is a sequence of pairs
     template <typename NT, typename Src, typename Target, typename Callable>
     void addOptionalReferences(NodePtr node, const char* elementName,
                                const Src src, Target& target, Callable parser) {
-      auto elements = detail::findElements(node, elementName);
-      for (auto& elementNode : elements) {
-        target[src].push_back(NT(parser(elementNode->value())));
+      std::size_t nameLen = std::strlen(elementName);
+      for (NodePtr elementNode = node->first_node(elementName, nameLen);
+           elementNode;
+           elementNode = elementNode->next_sibling(elementName, nameLen)) {
+        target.emplace_back(src, NT(parser(elementNode->value())));
       }
     }
 
@@ -296,7 +317,7 @@ namespace adm {
                               const Src src, Target& target, Callable parser) {
       auto elementNode = detail::findElement(node, elementName);
       if (elementNode) {
-        target[src] = NT(parser(elementNode->value()));
+        target.emplace_back(src, NT(parser(elementNode->value())));
       }
     }
 
@@ -0,0 +1,69 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace adm {
+  namespace xml {
+
+    /// splits an XML document read from a stream into tokens (tags, text,
+    /// comments etc.), reading the stream in fixed-size chunks rather than
+    /// all at once
+    ///
+    /// This only finds the boundaries of tokens, and does not check that the
+    /// document is well-formed; the text of the tokens which are of interest
+    /// should be passed to a real XML parser.
+    class XmlStreamReader {
+     public:
+      enum class TokenType {
+        startTag,  ///< <name ...>
+        emptyTag,  ///< <name .../>
+        endTag,  ///< </name>
+        text,  ///< character data between tags
+        other  ///< comments, processing instructions, CDATA and DOCTYPE
+      };
+
+      explicit XmlStreamReader(std::istream& stream,
+                               std::size_t bufferSize = 64 * 1024);
+
+      /// read the next token
+      /// @returns false at the end of the stream
+      bool next();
+
+      TokenType type() const { return type_; }
+      /// the complete text of the current token, including any markup
+      const std::string& text() const { return text_; }
+      /// the name of the current tag, for start, empty and end tags
+      const std::string& name() const { return name_; }
+
+     private:
+      bool fill();
+      int get() {
+        if (pos_ == end_ && !fill()) return -1;
+        return static_cast<unsigned char>(buffer_[pos_++]);
+      }
+      int peek() {
+        if (pos_ == end_ && !fill()) return -1;
+        return static_cast<unsigned char>(buffer_[pos_]);
+      }
+      int getOrThrow();
+
+      void readText();
+      void readTag();
+      void readUntil(const char* terminator);
+      void readDoctype();
+      void readName(std::size_t offset);
+
+      std::istream& stream_;
+      std::vector<char> buffer_;
+      std::size_t pos_ = 0;
+      std::size_t end_ = 0;
+
+      TokenType type_ = TokenType::other;
+      std::string text_;
+      std::string name_;
+    };
+
+  }  // namespace xml
+}  // namespace adm
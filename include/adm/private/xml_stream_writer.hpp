@@ -0,0 +1,119 @@
+#pragma once
+#include <cstddef>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+namespace adm {
+  namespace xml {
+
+    /// writes XML elements to a stream as they are added, rather than
+    /// building a tree and printing it at the end
+    ///
+    /// The output is formatted in the same way as rapidxml::print with the
+    /// default flags: each element is on its own line, indented with tabs,
+    /// elements with only a value are written on one line, and empty
+    /// elements use the `<name/>` form.
+    ///
+    /// Elements are identified by their depth and a serial number returned
+    /// by startElement. Only the innermost open element and its ancestors
+    /// can be modified; selecting an ancestor closes all of its
+    /// descendants. Because of this, at most one element (the innermost) has
+    /// output which has not been written yet, so memory use does not depend
+    /// on the size of the document.
+    class XmlStreamWriter {
+     public:
+      /// @param indent number of tabs to add to the indentation of all
+      /// elements, for writing fragments which will be inserted into
+      /// another document with insert()
+      explicit XmlStreamWriter(std::ostream& stream, std::size_t indent = 0,
+                               std::size_t bufferSize = 64 * 1024);
+
+      /// write to a string, which can be retrieved with takeOutput() once
+      /// all elements are closed
+      explicit XmlStreamWriter(std::size_t indent);
+
+      XmlStreamWriter(const XmlStreamWriter&) = delete;
+      XmlStreamWriter& operator=(const XmlStreamWriter&) = delete;
+
+      /// write an XML declaration; this must be called before any elements
+      /// are started
+      void declaration(const std::string& version,
+                       const std::string& encoding);
+
+      /// start a new element at depth, closing any open elements at that
+      /// depth or deeper
+      ///
+      /// For depth > 0, the parent at depth - 1 must be open.
+      /// @returns the serial number of the new element
+      std::size_t startElement(std::size_t depth, const std::string& name);
+
+      /// make an element the innermost open element, closing any of its
+      /// descendants
+      /// @throws std::logic_error if the element has been closed
+      void select(std::size_t depth, std::size_t serial);
+
+      /// add an attribute to an element, which must not have any children
+      void attribute(std::size_t depth, std::size_t serial,
+                     const std::string& name, const std::string& value);
+
+      /// set the value of an element; this is ignored if it has children
+      void value(std::size_t depth, std::size_t serial,
+                 const std::string& value);
+
+      /// insert XML (written by another XmlStreamWriter with indent equal
+      /// to depth) as if it were an element at depth
+      void insert(std::size_t depth, const std::string& xml);
+
+      /// close all open elements
+      void close();
+
+      /// write any buffered output to the stream
+      void flush();
+
+      /// get the output written so far, when writing to a string
+      std::string takeOutput();
+
+      /// close all open elements, end the document and write any buffered
+      /// output to the stream
+      void finish();
+
+     private:
+      struct OpenElement {
+        std::string name;
+        std::size_t serial = 0;
+        /// has the start tag been written?
+        bool started = false;
+      };
+
+      void openChildAt(std::size_t depth);
+      void closeTo(std::size_t depth);
+      void closeInnermost();
+      void writeStartTag(const OpenElement& element, std::size_t depth);
+      void writeIndent(std::size_t depth);
+      /// append text (up to the first null) to out, replacing special
+      /// characters other than noExpand with entity references
+      static void appendEscaped(std::string& out, const char* text,
+                                char noExpand);
+      void flushIfFull();
+
+      /// null when writing to a string
+      std::ostream* stream_;
+      std::size_t indent_;
+      std::size_t bufferSize_;
+      std::string buffer_;
+
+      /// the open elements, outermost first; only the first depth_ are in
+      /// use, so that their storage is reused
+      std::vector<OpenElement> open_;
+      std::size_t depth_ = 0;
+      std::size_t nextSerial_ = 1;
+
+      /// attributes and value of the innermost element, if its start tag
+      /// has not been written
+      std::string attributes_;
+      std::string value_;
+    };
+
+  }  // namespace xml
+}  // namespace adm
@@ -0,0 +1,59 @@
+/// @file changed_ids_differ.hpp
+#pragma once
+#include <memory>
+#include "adm/document.hpp"
+#include "adm/serial/changed_ids.hpp"
+#include "adm/export.h"
+
+namespace adm {
+
+  /**
+   * @brief Works out the changedIDs for a series of serial ADM frames.
+   *
+   * Each call to update() compares a document with the one passed to the
+   * previous call, and returns the changedIDs describing the difference:
+   *
+   * - elements which were not in the previous document are new
+   * - elements which are not in this document are expired
+   * - audioChannelFormats which only differ by having more
+   *   audioBlockFormats after those that were there before, which are
+   *   unchanged, are extended
+   * - other elements which would be written differently are changed
+   *
+   * Elements are compared using their content, as it would be written to
+   * XML; references are compared by ID. The content of the previous
+   * document is kept, so each document is only written once.
+   *
+   * Common definitions elements and silent audioTrackUids are ignored, as
+   * they are not written to frames.
+   *
+   * @ingroup sadm
+   */
+  class ChangedIdsDiffer {
+   public:
+    ADM_EXPORT ChangedIdsDiffer();
+    ADM_EXPORT ~ChangedIdsDiffer();
+    ChangedIdsDiffer(const ChangedIdsDiffer&) = delete;
+    ChangedIdsDiffer& operator=(const ChangedIdsDiffer&) = delete;
+
+    /// compare document with the document passed to the previous call (or
+    /// an empty document, for the first call)
+    ADM_EXPORT ChangedIds
+    update(const std::shared_ptr<const Document>& document);
+
+    /// forget the previous document, so that everything in the next
+    /// document is new
+    ADM_EXPORT void reset();
+
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+  };
+
+  /// the changedIDs for a frame containing current, following a frame
+  /// containing previous; see ChangedIdsDiffer
+  ADM_EXPORT ChangedIds
+  computeChangedIds(const std::shared_ptr<const Document>& previous,
+                    const std::shared_ptr<const Document>& current);
+
+}  // namespace adm
@@ -0,0 +1,75 @@
+/// @file frame_applier.hpp
+#pragma once
+#include <memory>
+#include "adm/document.hpp"
+#include "adm/serial/changed_ids.hpp"
+#include "adm/serial/frame_header.hpp"
+#include "adm/export.h"
+
+namespace adm {
+
+  /**
+   * @brief Keeps the current state of a serial ADM flow in a Document,
+   * applying each frame to it as a set of changes.
+   *
+   * The first frame, and any later frame whose header has no changedIDs,
+   * becomes the document. For other frames, only the elements listed in the
+   * changedIDs of the header are touched:
+   *
+   * - new elements are copied from the frame into the document
+   * - changed elements are updated in place, so that pointers to them (held
+   *   by the user, or by other elements) stay valid
+   * - extended audioChannelFormats have the audioBlockFormats from the frame
+   *   added to them; a block with the same ID as one which is already there
+   *   replaces it. If the blocks in the frame don't follow on from those in
+   *   the document (e.g. because frames were missed), the audioChannelFormat
+   *   is treated as changed. Other extended elements are treated as changed.
+   * - expired elements are removed
+   *
+   * The references of new and changed elements are resolved by ID in the
+   * document; references which are the same as before are left alone.
+   * Elements are found using Document::lookup(), so the cost of applying a
+   * frame depends on the number of changes, not on the number of elements
+   * in the document.
+   *
+   * A change to an element which is not in the document is treated as new,
+   * and the expiry of an element which is not in the document is ignored,
+   * so that a flow can be joined part way through.
+   *
+   * @ingroup sadm
+   */
+  class FrameApplier {
+   public:
+    /// start with no document; the first frame applied becomes the document
+    ADM_EXPORT FrameApplier();
+
+    /// apply frames to an existing document
+    ADM_EXPORT explicit FrameApplier(std::shared_ptr<Document> document);
+
+    /**
+     * @brief Apply a frame to the document.
+     *
+     * @param frame the elements in the frame, as parsed from it; this may
+     *   become the document, so should not be modified afterwards
+     * @param header the header of the frame
+     *
+     * @throws std::runtime_error if a new or changed element is not in the
+     *   frame, or an element refers to one which is not in the document.
+     *   The document may have been partly updated in this case.
+     */
+    ADM_EXPORT void apply(std::shared_ptr<Document> frame,
+                          const FrameHeader& header);
+
+    /// the current state of the flow; null if no frames have been applied
+    ADM_EXPORT std::shared_ptr<Document> getDocument() const;
+
+   private:
+    /// update target in place to match source
+    template <typename Element>
+    static void update(Element& target, const Element& source,
+                       ChangedIdStatus status);
+
+    std::shared_ptr<Document> document_;
+  };
+
+}  // namespace adm
@@ -0,0 +1,71 @@
+/// @file frame_assembler.hpp
+#pragma once
+#include <memory>
+#include "adm/document.hpp"
+#include "adm/serial/frame_header.hpp"
+#include "adm/export.h"
+
+namespace adm {
+
+  /**
+   * @brief Builds one long-form Document from a series of serial ADM frames;
+   * the reverse of FrameGenerator.
+   *
+   * Frames are added one at a time, as they are received:
+   *
+   * - elements which are new in a frame are added to the document, and
+   *   elements which have changed since the previous frame are updated, so
+   *   that e.g. an audioObject added to an audioContent part way through is
+   *   referenced by it. Elements which are no longer in a frame are kept,
+   *   as are the references to them from audioProgrammes, audioContents
+   *   and audioObjects.
+   *   audioChannelFormats are only added; later changes to their
+   *   parameters are ignored.
+   * - the audioBlockFormats of each audioChannelFormat are added to the
+   *   document, with lstart made relative to the start of the programme by
+   *   adding the frame start (for frames with the local time reference).
+   *   Blocks which were split across frames have the same ID in each
+   *   frame; these are merged back into one block, by extending the block
+   *   already in the document. Blocks which are already in the document
+   *   (with an ID which is not after the last block) are not added again.
+   *
+   * Only the document and the element content of the previous frame are
+   * kept between frames (see ChangedIdsDiffer), so the memory used does not
+   * grow with the number of frames, beyond that needed for the document.
+   *
+   * Common definitions referenced by the frames are added to the document
+   * if the first frame contains any.
+   *
+   * @ingroup sadm
+   */
+  class FrameAssembler {
+   public:
+    ADM_EXPORT FrameAssembler();
+    ADM_EXPORT ~FrameAssembler();
+    FrameAssembler(const FrameAssembler&) = delete;
+    FrameAssembler& operator=(const FrameAssembler&) = delete;
+
+    /**
+     * @brief Add the next frame to the document.
+     *
+     * @param frame the elements in the frame, as parsed from it; this is not
+     *   modified
+     * @param header the header of the frame; only the frame start and
+     *   time reference are used
+     *
+     * @throws std::runtime_error if an element in the frame refers to one
+     *   which is not in the frame or document, or a block ID is not valid
+     *   for its audioChannelFormat.
+     */
+    ADM_EXPORT void add(std::shared_ptr<Document> frame,
+                        const FrameHeader& header);
+
+    /// the document assembled from the frames added so far
+    ADM_EXPORT std::shared_ptr<Document> getDocument() const;
+
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+  };
+
+}  // namespace adm
@@ -0,0 +1,86 @@
+/// @file frame_generator.hpp
+#pragma once
+#include <iosfwd>
+#include <memory>
+#include "adm/document.hpp"
+#include "adm/elements/time.hpp"
+#include "adm/serial/frame_header.hpp"
+#include "adm/write.hpp"
+#include "adm/export.h"
+
+namespace adm {
+
+  /// @brief A serial ADM frame made by FrameGenerator
+  /// @ingroup sadm
+  struct GeneratedFrame {
+    FrameHeader header;
+    std::shared_ptr<Document> document;
+  };
+
+  /**
+   * @brief Splits a long-form Document into a series of full serial ADM
+   * frames of a fixed duration.
+   *
+   * Each frame contains all of the elements of the document, but each
+   * audioChannelFormat only has the audioBlockFormats which overlap the
+   * frame. The frames use the local time reference, so the times of these
+   * blocks are made relative to the start of the frame, and blocks which
+   * extend past the start or end of the frame are cut short at its edges.
+   * Blocks with neither rtime nor duration apply for the whole programme,
+   * so are copied to every frame unchanged; blocks with an rtime but no
+   * duration last until the next block, or the end of the programme.
+   *
+   * The rtimes of blocks are treated as times within the programme, i.e.
+   * the audioObjects which use them are assumed to start at zero.
+   *
+   * Each audioChannelFormat has a cursor to the first block which could
+   * overlap the next frame, so generating all of the frames takes time
+   * linear in the number of blocks (plus the size of the rest of the
+   * document for each frame), rather than searching all of the blocks for
+   * each frame.
+   *
+   * Frames are generated until the end of the programme, which is the
+   * latest end of the audioProgrammes or the timed audioBlockFormats in the
+   * document; there is always at least one frame.
+   *
+   * The document must not be modified while frames are being generated.
+   *
+   * @ingroup sadm
+   */
+  class FrameGenerator {
+   public:
+    /**
+     * @param document the long-form document to split into frames
+     * @param frameDuration the duration of each frame
+     * @throws std::invalid_argument if frameDuration is not positive
+     */
+    ADM_EXPORT FrameGenerator(std::shared_ptr<const Document> document,
+                              const Time& frameDuration);
+    ADM_EXPORT ~FrameGenerator();
+    FrameGenerator(const FrameGenerator&) = delete;
+    FrameGenerator& operator=(const FrameGenerator&) = delete;
+
+    /// are there any more frames?
+    ADM_EXPORT bool hasNext() const;
+
+    /**
+     * @brief Make the next frame.
+     *
+     * The header has frame type full and the local time reference. The
+     * returned document belongs to the caller.
+     *
+     * @throws std::runtime_error if there are no more frames
+     */
+    ADM_EXPORT GeneratedFrame next();
+
+    /// make the next frame and write it to stream
+    ADM_EXPORT std::ostream& writeNext(
+        std::ostream& stream,
+        xml::SadmWriterOptions options = xml::SadmWriterOptions::none);
+
+   private:
+    class Impl;
+    std::unique_ptr<Impl> impl_;
+  };
+
+}  // namespace adm
@@ -0,0 +1,176 @@
+/// @file block_timeline.hpp
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <boost/optional.hpp>
+#include "adm/elements/audio_channel_format.hpp"
+#include "adm/elements/time.hpp"
+
+namespace adm {
+
+  /**
+   * @brief Finds the audioBlockFormat of an audioChannelFormat which is
+   * active at a given time
+   * @headerfile block_timeline.hpp <adm/utilities/block_timeline.hpp>
+   *
+   * A block is active from its rtime until the end of its duration or, if
+   * it has no duration, the rtime of the next block; the last block without
+   * a duration stays active. A block without an rtime starts at 0, so a
+   * channel with a single block without rtime or duration has that block
+   * active at all times. Blocks are assumed to be in time order, as they
+   * are in a valid document.
+   *
+   * The times of the blocks are kept alongside the channel format, so
+   * blockAt() is O(log n), and a Cursor moving forward through the blocks
+   * (e.g. for sequential playback) takes amortised O(1) time per call.
+   *
+   * Blocks added to the channel format after the timeline was made are
+   * picked up by the next call. If the blocks already in the channel format
+   * are changed or removed, call reset().
+   *
+   * @code
+     BlockTimeline<AudioBlockFormatObjects> timeline(channelFormat);
+     BlockTimeline<AudioBlockFormatObjects>::Cursor cursor(timeline);
+     for (auto t = 0ms; t < length; t += 10ms) {
+       if (auto block = cursor.seek(t)) render(*block);
+     }
+     @endcode
+   */
+  template <typename AudioBlockFormat>
+  class BlockTimeline {
+   public:
+    explicit BlockTimeline(
+        std::shared_ptr<const AudioChannelFormat> channelFormat)
+        : channelFormat_(std::move(channelFormat)) {}
+
+    /// the index of the block active at time, if there is one
+    boost::optional<std::size_t> indexAt(const Time& time) {
+      update();
+      auto fixed = time.asFixed();
+      auto index = lastStartingBy(fixed, 0);
+      if (index == spans_.size() || !isActive(index, fixed))
+        return boost::none;
+      return index;
+    }
+
+    /// the block active at time, or nullptr if there isn't one; this is
+    /// valid until blocks are added to the channel format
+    const AudioBlockFormat* blockAt(const Time& time) {
+      auto index = indexAt(time);
+      if (!index) return nullptr;
+      return &blocks()[*index];
+    }
+
+    /// forget the times of the blocks, so that they are read again
+    void reset() { spans_.clear(); }
+
+    /// find the active block at increasing times in amortised O(1) time
+    class Cursor {
+     public:
+      explicit Cursor(BlockTimeline& timeline) : timeline_(&timeline) {}
+
+      /// the index of the block active at time, if there is one
+      boost::optional<std::size_t> indexAt(const Time& time) {
+        timeline_->update();
+        const auto& spans = timeline_->spans_;
+        auto fixed = time.asFixed();
+        if (index_ >= spans.size() || fixed < spans[index_].start) {
+          // moved backwards, or the blocks have changed
+          index_ = timeline_->lastStartingBy(fixed, 0);
+        } else {
+          // only look at a few blocks before doing a binary search, so that
+          // large jumps forward are still O(log n)
+          int steps = 0;
+          while (index_ + 1 < spans.size() &&
+                 !(fixed < spans[index_ + 1].start)) {
+            if (++steps > 4) {
+              index_ = timeline_->lastStartingBy(fixed, index_ + 1);
+              break;
+            }
+            ++index_;
+          }
+        }
+        if (index_ == spans.size() || !timeline_->isActive(index_, fixed)) {
+          return boost::none;
+        }
+        return index_;
+      }
+
+      /// the block active at time, or nullptr if there isn't one; this is
+      /// valid until blocks are added to the channel format
+      const AudioBlockFormat* seek(const Time& time) {
+        auto index = indexAt(time);
+        if (!index) return nullptr;
+        return &timeline_->blocks()[*index];
+      }
+
+     private:
+      BlockTimeline* timeline_;
+      std::size_t index_ = 0;
+    };
+
+   private:
+    struct Span {
+      FixedTime start;
+      FixedTime end;
+      /// false if the block has no end, so is active from start onwards
+      bool bounded;
+    };
+
+    BlockFormatsConstRange<AudioBlockFormat> blocks() const {
+      return channelFormat_->getElements<AudioBlockFormat>();
+    }
+
+    /// the index of the last block from first onwards which starts at or
+    /// before time, or the number of blocks if there isn't one
+    std::size_t lastStartingBy(const FixedTime& time,
+                               std::size_t first) const {
+      auto after = std::upper_bound(
+          spans_.begin() + static_cast<std::ptrdiff_t>(first), spans_.end(),
+          time,
+          [](const FixedTime& t, const Span& span) { return t < span.start; });
+      if (after == spans_.begin()) return spans_.size();
+      return static_cast<std::size_t>(after - spans_.begin()) - 1;
+    }
+
+    bool isActive(std::size_t index, const FixedTime& time) const {
+      return !spans_[index].bounded || time < spans_[index].end;
+    }
+
+    /// read the times of blocks added since the last call; blocks without a
+    /// duration end at the start of the next block, so the end of the
+    /// previous last block is found again
+    void update() {
+      auto blockRange = blocks();
+      auto size = static_cast<std::size_t>(blockRange.size());
+      if (size == spans_.size()) return;
+      if (size < spans_.size()) spans_.clear();
+
+      std::size_t first = spans_.size();
+      spans_.reserve(size);
+      for (auto i = first; i < size; ++i) {
+        const auto& block = blockRange[i];
+        Span span{block.template get<Rtime>().get().asFixed(), FixedTime{},
+                  block.template has<Duration>()};
+        if (span.bounded) {
+          auto duration = block.template get<Duration>().get().asFixed();
+          span.end = span.start + duration;
+        }
+        spans_.push_back(span);
+      }
+      for (auto i = first > 0 ? first - 1 : 0; i + 1 < size; ++i) {
+        if (!blockRange[i].template has<Duration>()) {
+          spans_[i].end = spans_[i + 1].start;
+          spans_[i].bounded = true;
+        }
+      }
+    }
+
+    std::shared_ptr<const AudioChannelFormat> channelFormat_;
+    std::vector<Span> spans_;
+  };
+
+}  // namespace adm
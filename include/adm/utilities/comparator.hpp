@@ -30,8 +30,8 @@ namespace adm {
     template <typename AudioBlockFormat>
     bool operator()(const AudioBlockFormat& lhs, const AudioBlockFormat& rhs) {
       if (lhs.template has<Rtime>() && rhs.template has<Rtime>()) {
-        return lhs.template get<Rtime>().get().asNanoseconds() <
-               rhs.template get<Rtime>().get().asNanoseconds();
+        return lhs.template get<Rtime>().get().asFixed() <
+               rhs.template get<Rtime>().get().asFixed();
       }
 
       return false;
@@ -64,15 +64,16 @@ namespace adm {
     template <typename AudioBlockFormat>
     bool operator()(const AudioBlockFormat& lhs, const AudioBlockFormat& rhs) {
       if (lhs.template has<Rtime>() && rhs.template has<Rtime>()) {
-        if (lhs.template get<Rtime>() == rhs.template get<Rtime>()) {
+        if (lhs.template get<Rtime>().get().asFixed() ==
+            rhs.template get<Rtime>().get().asFixed()) {
           if (lhs.template has<Duration>() && rhs.template has<Duration>()) {
-            return lhs.template get<Duration>().get().asNanoseconds() <
-                   rhs.template get<Duration>().get().asNanoseconds();
+            return lhs.template get<Duration>().get().asFixed() <
+                   rhs.template get<Duration>().get().asFixed();
           }
         }
 
-        return lhs.template get<Rtime>().get().asNanoseconds() <
-               rhs.template get<Rtime>().get().asNanoseconds();
+        return lhs.template get<Rtime>().get().asFixed() <
+               rhs.template get<Rtime>().get().asFixed();
       }
 
       return false;
@@ -20,4 +20,17 @@ namespace adm {
   }
 
   inline Time asTime(const RationalTime &t) { return asFractionalTime(t); }
+
+  /// convert to a Time in nanoseconds if this can be done exactly, otherwise
+  /// to a normalised FractionalTime
+  inline Time asNanosecondsOrFractional(const FixedTime &t) {
+    if (t.isNanoseconds()) return t.asTime();
+    FractionalTime normalised = t.asFractional().normalised();
+    if (FixedTime::nanosecondsDenominator % normalised.denominator() == 0) {
+      return std::chrono::nanoseconds(
+          normalised.numerator() *
+          (FixedTime::nanosecondsDenominator / normalised.denominator()));
+    }
+    return normalised;
+  }
 }  // namespace adm
@@ -35,7 +35,15 @@ namespace adm {
      *                      || **options controlling default values**
      * none                 | use `<ebuCoreMain>` envelope (default)
      * write_default_values | use `<ebuCoreMain>` envelope (default)
+     *                      || **options controlling threading**
+     * none                 | write on the calling thread (default)
+     * parallel             | format audioChannelFormats on a thread pool
      *
+     * With `parallel`, each audioChannelFormat is formatted into its own
+     * buffer on a pool of threads, and the buffers are written in document
+     * order, so the output is identical to the single-threaded writer. This
+     * helps for documents with many audioBlockFormats. The document must not
+     * be modified by other threads while it is being written.
      *
      * @ingroup xml
      */
@@ -43,12 +51,14 @@ namespace adm {
       none = 0x0,  ///< default behaviour
       itu_structure = 0x1,  ///< use ITU xml structure
       write_default_values = 0x2,  ///< write default values
+      parallel = 0x4,  ///< format audioChannelFormats on a thread pool
     };
 
     enum class SadmWriterOptions : unsigned {
       none = 0x0,  ///< default behaviour
       core_metadata = 0x1,  ///< audioFormatExtended inside coreMetadata/format/
       write_default_values = 0x2,  ///< write default values
+      parallel = 0x4,  ///< format audioChannelFormats on a thread pool
     };
   }  // namespace xml
 
@@ -1,6 +1,7 @@
 #include "adm/common_definitions.hpp"
-#include "resources.hpp"
-#include "adm/private/document_parser.hpp"
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/private/common_definitions_data.hpp"
 #include "adm/utilities/copy.hpp"
 
 namespace adm {
@@ -153,15 +154,161 @@ namespace adm {
                                    AudioTrackFormatIdCounter(1));
   }
 
+  namespace {
+    namespace data = detail::common_definitions_data;
+
+    AudioBlockFormatId blockId(const data::ChannelFormat& channelFormat,
+                               unsigned counter) {
+      return AudioBlockFormatId(TypeDescriptor(channelFormat.typeDescriptor),
+                                AudioBlockFormatIdValue(channelFormat.value),
+                                AudioBlockFormatIdCounter(counter));
+    }
+
+    void addBlocks(AudioChannelFormat& channelFormat,
+                   const data::ChannelFormat& entry) {
+      TypeDescriptor typeDescriptor(entry.typeDescriptor);
+      for (auto i = entry.blocks.begin; i != entry.blocks.end; ++i) {
+        if (typeDescriptor == TypeDefinition::DIRECT_SPEAKERS) {
+          const auto& block = data::directSpeakersBlocks[i];
+          SphericalSpeakerPosition position{Azimuth(block.azimuth),
+                                            Elevation(block.elevation),
+                                            Distance(block.distance)};
+          ScreenEdgeLock screenEdgeLock;
+          if (block.azimuthScreenEdgeLock)
+            screenEdgeLock.set(HorizontalEdge(block.azimuthScreenEdgeLock));
+          position.set(screenEdgeLock);
+
+          AudioBlockFormatDirectSpeakers blockFormat;
+          blockFormat.set(blockId(entry, block.counter));
+          blockFormat.set(position);
+          blockFormat.add(SpeakerLabel(block.speakerLabel));
+          channelFormat.add(std::move(blockFormat));
+        } else if (typeDescriptor == TypeDefinition::HOA) {
+          const auto& block = data::hoaBlocks[i];
+          AudioBlockFormatHoa blockFormat{Order(block.order),
+                                          Degree(block.degree)};
+          blockFormat.set(blockId(entry, block.counter));
+          blockFormat.set(Normalization(block.normalization));
+          channelFormat.add(std::move(blockFormat));
+        } else if (typeDescriptor == TypeDefinition::BINAURAL) {
+          const auto& block = data::binauralBlocks[i];
+          AudioBlockFormatBinaural blockFormat;
+          blockFormat.set(blockId(entry, block.counter));
+          channelFormat.add(std::move(blockFormat));
+        }
+      }
+    }
+
+    /// build the common definitions from the tables generated from
+    /// common_definitions.xml; the elements are added in the same order as
+    /// the XML parser would add them, and references are resolved afterwards
+    std::shared_ptr<const Document> createCommonDefinitions() {
+      auto document = Document::create();
+
+      std::vector<std::shared_ptr<AudioPackFormat>> packFormats;
+      packFormats.reserve(data::packFormatCount);
+      for (std::size_t i = 0; i < data::packFormatCount; ++i) {
+        const auto& entry = data::packFormats[i];
+        TypeDescriptor typeDescriptor(entry.typeDescriptor);
+        AudioPackFormatId id(typeDescriptor,
+                             AudioPackFormatIdValue(entry.value));
+        if (typeDescriptor == TypeDefinition::HOA) {
+          packFormats.push_back(
+              AudioPackFormatHoa::create(AudioPackFormatName(entry.name), id));
+        } else {
+          packFormats.push_back(AudioPackFormat::create(
+              AudioPackFormatName(entry.name), typeDescriptor, id));
+        }
+        document->add(packFormats.back());
+      }
+
+      std::vector<std::shared_ptr<AudioChannelFormat>> channelFormats;
+      channelFormats.reserve(data::channelFormatCount);
+      for (std::size_t i = 0; i < data::channelFormatCount; ++i) {
+        const auto& entry = data::channelFormats[i];
+        TypeDescriptor typeDescriptor(entry.typeDescriptor);
+        auto channelFormat = AudioChannelFormat::create(
+            AudioChannelFormatName(entry.name), typeDescriptor,
+            AudioChannelFormatId(typeDescriptor,
+                                 AudioChannelFormatIdValue(entry.value)));
+        if (entry.hasLowPass) {
+          Frequency frequency;
+          frequency.set(LowPass(entry.lowPass));
+          channelFormat->set(frequency);
+        }
+        addBlocks(*channelFormat, entry);
+        channelFormats.push_back(channelFormat);
+        document->add(channelFormat);
+      }
+
+      std::vector<std::shared_ptr<AudioStreamFormat>> streamFormats;
+      streamFormats.reserve(data::streamFormatCount);
+      for (std::size_t i = 0; i < data::streamFormatCount; ++i) {
+        const auto& entry = data::streamFormats[i];
+        streamFormats.push_back(AudioStreamFormat::create(
+            AudioStreamFormatName(entry.name),
+            FormatDescriptor(entry.formatDescriptor),
+            AudioStreamFormatId(TypeDescriptor(entry.typeDescriptor),
+                                AudioStreamFormatIdValue(entry.value))));
+        document->add(streamFormats.back());
+      }
+
+      std::vector<std::shared_ptr<AudioTrackFormat>> trackFormats;
+      trackFormats.reserve(data::trackFormatCount);
+      for (std::size_t i = 0; i < data::trackFormatCount; ++i) {
+        const auto& entry = data::trackFormats[i];
+        trackFormats.push_back(AudioTrackFormat::create(
+            AudioTrackFormatName(entry.name),
+            FormatDescriptor(entry.formatDescriptor),
+            AudioTrackFormatId(TypeDescriptor(entry.typeDescriptor),
+                               AudioTrackFormatIdValue(entry.value),
+                               AudioTrackFormatIdCounter(entry.counter))));
+        document->add(trackFormats.back());
+      }
+
+      for (std::size_t i = 0; i < data::packFormatCount; ++i) {
+        const auto& refs = data::packFormats[i].channelFormatRefs;
+        for (auto ref = refs.begin; ref != refs.end; ++ref)
+          packFormats[i]->addReference(
+              channelFormats[data::packFormatChannelFormatRefs[ref]]);
+      }
+      for (std::size_t i = 0; i < data::packFormatCount; ++i) {
+        const auto& refs = data::packFormats[i].packFormatRefs;
+        for (auto ref = refs.begin; ref != refs.end; ++ref)
+          packFormats[i]->addReference(
+              packFormats[data::packFormatPackFormatRefs[ref]]);
+      }
+      for (std::size_t i = 0; i < data::trackFormatCount; ++i) {
+        trackFormats[i]->setReference(
+            streamFormats[data::trackFormats[i].streamFormatRef]);
+      }
+      for (std::size_t i = 0; i < data::streamFormatCount; ++i) {
+        const auto& entry = data::streamFormats[i];
+        streamFormats[i]->setReference(channelFormats[entry.channelFormatRef]);
+        for (auto ref = entry.trackFormatRefs.begin;
+             ref != entry.trackFormatRefs.end; ++ref)
+          streamFormats[i]->addReference(
+              trackFormats[data::streamFormatTrackFormatRefs[ref]]);
+      }
+
+      return document;
+    }
+
+    /// the common definitions are created on first use and never modified
+    /// afterwards, so they can be shared between threads and copied from
+    /// instead of being built again for every document
+    const std::shared_ptr<const Document>& cachedCommonDefinitions() {
+      static const std::shared_ptr<const Document> commonDefinitions =
+          createCommonDefinitions();
+      return commonDefinitions;
+    }
+  }  // namespace
+
   std::shared_ptr<Document> getCommonDefinitions() {
-    std::stringstream commonDefinitions;
-    getEmbeddedFile("common_definitions.xml", commonDefinitions);
-    xml::DocumentParser parser(commonDefinitions,
-                               xml::ParserOptions::recursive_node_search);
-    return parser.parse();
+    return cachedCommonDefinitions()->deepCopy();
   }
 
   void addCommonDefinitionsTo(std::shared_ptr<Document> document) {
-    deepCopyTo(getCommonDefinitions(), document);
+    deepCopyTo(cachedCommonDefinitions(), document);
   }
 }  // namespace adm
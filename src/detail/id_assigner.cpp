@@ -2,63 +2,104 @@
 #include "adm/document.hpp"
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/elements.hpp"
+#include <iterator>
 
 namespace adm {
   namespace detail {
     namespace {
-      struct DefaultFilter {
-        template <typename T>
-        bool operator()(T const&) const {
-          return true;
+      /// CounterSet::nextFree for the set with the given key, which may not
+      /// exist yet
+      template <typename Key>
+      unsigned int nextFree(const std::map<Key, CounterSet>& sets,
+                            const Key& key, unsigned int preferred) {
+        auto it = sets.find(key);
+        if (it == sets.end()) {
+          return preferred;
         }
-      };
-      // original recursive lookup method was O(N^2), this is O(NlogN)
-      // N for filter by type / value
-      // NlogN for sort
-      // logN for lower_bound
-      // N for adjacent_find
-      // if using pre-sorted vectors would be O(N)
-      template <typename ElementT, typename CounterT,
-                typename FilterPredicate = DefaultFilter>
-      CounterT nextCounter(adm::Document const& doc, CounterT preferredCounter,
-                           FilterPredicate predicate = FilterPredicate{}) {
-        auto elements = doc.getElements<ElementT>();
-        // Filter ids by predicate, collect counter values in container
-        std::vector<typename CounterT::value_type> counters;
-        counters.reserve(elements.size());
-        for (auto const& el : elements) {
-          auto id = el->template get<typename ElementT::id_type>();
-          if (predicate(id)) {
-            counters.push_back(id.template get<CounterT>().get());
-          }
+        return it->second.nextFree(preferred);
+      }
+
+      template <typename Key>
+      void erase(std::map<Key, CounterSet>& sets, const Key& key,
+                 unsigned int counter) {
+        auto it = sets.find(key);
+        if (it == sets.end()) {
+          return;
         }
-        // sort counters so we can use fast algorithms
-        std::sort(counters.begin(), counters.end());
-        // find the position where all elements are >= preferred value
-        auto lowerBound = std::lower_bound(counters.begin(), counters.end(),
-                                           preferredCounter.get());
-        // if this is the end of the vector or lower bound is not equal to preferred, preferred is free so use it
-        if (lowerBound == counters.end() ||
-            *lowerBound != preferredCounter.get()) {
-          return preferredCounter;
+        it->second.erase(counter);
+        if (it->second.empty()) {
+          sets.erase(it);
         }
+      }
 
-        // starting from the preferred value, find the next free value by looking for gaps in sequence
-        auto it = std::adjacent_find(
-            lowerBound, counters.end(),
-            [](auto lhs, auto rhs) { return lhs + 1 != rhs; });
-        // if no gaps use next available value
-        if (it == counters.end()) {
-          return CounterT(counters.back() + 1);
-        }
-        // if gap, use that
-        return CounterT((*it) + 1);
+      std::pair<int, unsigned int> trackFormatKey(
+          TypeDescriptor typeDescriptor, AudioTrackFormatIdValue idValue) {
+        return std::make_pair(typeDescriptor.get(), idValue.get());
       }
     }  // namespace
 
-    const Document& IdAssigner::document() const { return *document_; }
+    // runs_ holds maximal runs, so the end of each run is always free, and
+    // runs never touch each other
+
+    void CounterSet::insert(unsigned int counter) {
+      auto next = runs_.upper_bound(counter);
+      auto prev = next == runs_.begin() ? runs_.end() : std::prev(next);
+      if (prev != runs_.end() && counter < prev->second) {
+        ++duplicates_[counter];
+        return;
+      }
+
+      unsigned int end = counter + 1;
+      if (next != runs_.end() && next->first == end) {
+        end = next->second;
+        runs_.erase(next);
+      }
+      if (prev != runs_.end() && prev->second == counter) {
+        prev->second = end;
+      } else {
+        runs_.emplace(counter, end);
+      }
+    }
+
+    void CounterSet::erase(unsigned int counter) {
+      auto duplicate = duplicates_.find(counter);
+      if (duplicate != duplicates_.end()) {
+        if (--duplicate->second == 0) {
+          duplicates_.erase(duplicate);
+        }
+        return;
+      }
+
+      auto next = runs_.upper_bound(counter);
+      if (next == runs_.begin()) {
+        return;
+      }
+      auto run = std::prev(next);
+      if (counter >= run->second) {
+        return;
+      }
+      auto end = run->second;
+      if (run->first == counter) {
+        runs_.erase(run);
+      } else {
+        run->second = counter;
+      }
+      if (counter + 1 != end) {
+        runs_.emplace(counter + 1, end);
+      }
+    }
 
-    void IdAssigner::document(Document* document) { document_ = document; }
+    unsigned int CounterSet::nextFree(unsigned int preferred) const {
+      auto next = runs_.upper_bound(preferred);
+      if (next == runs_.begin()) {
+        return preferred;
+      }
+      auto run = std::prev(next);
+      if (preferred < run->second) {
+        return run->second;
+      }
+      return preferred;
+    }
 
     AudioProgrammeId IdAssigner::assignId(AudioProgramme& programme) {
       if (isCommonDefinitionsId(programme.get<AudioProgrammeId>())) {
@@ -69,7 +110,7 @@ namespace adm {
         idValue =
             programme.get<AudioProgrammeId>().get<AudioProgrammeIdValue>();
       }
-      idValue = nextCounter<AudioProgramme>(document(), idValue);
+      idValue = AudioProgrammeIdValue(programmeValues_.nextFree(idValue.get()));
       auto id = AudioProgrammeId(idValue);
       programme.set(id);
       return id;
@@ -83,7 +124,7 @@ namespace adm {
       if (!isUndefined(content.get<AudioContentId>())) {
         idValue = content.get<AudioContentId>().get<AudioContentIdValue>();
       }
-      idValue = nextCounter<AudioContent>(document(), idValue);
+      idValue = AudioContentIdValue(contentValues_.nextFree(idValue.get()));
       auto id = AudioContentId(idValue);
       content.set(id);
       return id;
@@ -97,7 +138,7 @@ namespace adm {
       if (!isUndefined(object.get<AudioObjectId>())) {
         idValue = object.get<AudioObjectId>().get<AudioObjectIdValue>();
       }
-      idValue = nextCounter<AudioObject>(document(), idValue);
+      idValue = AudioObjectIdValue(objectValues_.nextFree(idValue.get()));
       auto id = AudioObjectId(idValue);
       object.set(id);
       return id;
@@ -113,10 +154,8 @@ namespace adm {
         idValue =
             packFormat.get<AudioPackFormatId>().get<AudioPackFormatIdValue>();
       }
-      idValue = nextCounter<AudioPackFormat>(
-          document(), idValue, [typeDescriptor](AudioPackFormatId const& id) {
-            return id.get<TypeDescriptor>() == typeDescriptor;
-          });
+      idValue = AudioPackFormatIdValue(
+          nextFree(packFormatValues_, typeDescriptor.get(), idValue.get()));
       auto id = AudioPackFormatId(typeDescriptor, idValue);
       packFormat.set(id);
       return id;
@@ -133,11 +172,8 @@ namespace adm {
         idValue = channelFormat.get<AudioChannelFormatId>()
                       .get<AudioChannelFormatIdValue>();
       }
-      idValue = nextCounter<AudioChannelFormat>(
-          document(), idValue,
-          [typeDescriptor](AudioChannelFormatId const& id) {
-            return id.get<TypeDescriptor>() == typeDescriptor;
-          });
+      idValue = AudioChannelFormatIdValue(
+          nextFree(channelFormatValues_, typeDescriptor.get(), idValue.get()));
       auto id = AudioChannelFormatId(typeDescriptor, idValue);
       channelFormat.set(id);
       return id;
@@ -163,10 +199,8 @@ namespace adm {
           typeDescriptor = packFormat->get<TypeDescriptor>();
         }
       }
-      idValue = nextCounter<AudioStreamFormat>(
-          document(), idValue, [typeDescriptor](AudioStreamFormatId const& id) {
-            return id.get<TypeDescriptor>() == typeDescriptor;
-          });
+      idValue = AudioStreamFormatIdValue(
+          nextFree(streamFormatValues_, typeDescriptor.get(), idValue.get()));
       auto id = AudioStreamFormatId(typeDescriptor, idValue);
       streamFormat.set(id);
       return id;
@@ -195,12 +229,9 @@ namespace adm {
           typeDescriptor = streamFormatId.get<TypeDescriptor>();
         }
       }
-      idCounter = nextCounter<AudioTrackFormat>(
-          document(), idCounter,
-          [&typeDescriptor, &idValue](AudioTrackFormatId const& id) {
-            return id.get<TypeDescriptor>() == typeDescriptor &&
-                   id.get<AudioTrackFormatIdValue>() == idValue;
-          });
+      idCounter = AudioTrackFormatIdCounter(
+          nextFree(trackFormatCounters_,
+                   trackFormatKey(typeDescriptor, idValue), idCounter.get()));
       auto id = AudioTrackFormatId(typeDescriptor, idValue, idCounter);
       trackFormat.set(id);
       return id;
@@ -215,11 +246,86 @@ namespace adm {
       if (!isUndefined(trackUid.get<AudioTrackUidId>())) {
         idValue = trackUid.get<AudioTrackUidId>().get<AudioTrackUidIdValue>();
       }
-      idValue = nextCounter<AudioTrackUid>(document(), idValue);
+      idValue = AudioTrackUidIdValue(trackUidValues_.nextFree(idValue.get()));
       auto id = AudioTrackUidId(idValue);
       trackUid.set(id);
       return id;
     }
 
+    void IdAssigner::addId(const AudioProgrammeId& id) {
+      programmeValues_.insert(id.get<AudioProgrammeIdValue>().get());
+    }
+
+    void IdAssigner::addId(const AudioContentId& id) {
+      contentValues_.insert(id.get<AudioContentIdValue>().get());
+    }
+
+    void IdAssigner::addId(const AudioObjectId& id) {
+      objectValues_.insert(id.get<AudioObjectIdValue>().get());
+    }
+
+    void IdAssigner::addId(const AudioPackFormatId& id) {
+      packFormatValues_[id.get<TypeDescriptor>().get()].insert(
+          id.get<AudioPackFormatIdValue>().get());
+    }
+
+    void IdAssigner::addId(const AudioChannelFormatId& id) {
+      channelFormatValues_[id.get<TypeDescriptor>().get()].insert(
+          id.get<AudioChannelFormatIdValue>().get());
+    }
+
+    void IdAssigner::addId(const AudioStreamFormatId& id) {
+      streamFormatValues_[id.get<TypeDescriptor>().get()].insert(
+          id.get<AudioStreamFormatIdValue>().get());
+    }
+
+    void IdAssigner::addId(const AudioTrackFormatId& id) {
+      trackFormatCounters_[trackFormatKey(id.get<TypeDescriptor>(),
+                                          id.get<AudioTrackFormatIdValue>())]
+          .insert(id.get<AudioTrackFormatIdCounter>().get());
+    }
+
+    void IdAssigner::addId(const AudioTrackUidId& id) {
+      trackUidValues_.insert(id.get<AudioTrackUidIdValue>().get());
+    }
+
+    void IdAssigner::removeId(const AudioProgrammeId& id) {
+      programmeValues_.erase(id.get<AudioProgrammeIdValue>().get());
+    }
+
+    void IdAssigner::removeId(const AudioContentId& id) {
+      contentValues_.erase(id.get<AudioContentIdValue>().get());
+    }
+
+    void IdAssigner::removeId(const AudioObjectId& id) {
+      objectValues_.erase(id.get<AudioObjectIdValue>().get());
+    }
+
+    void IdAssigner::removeId(const AudioPackFormatId& id) {
+      erase(packFormatValues_, id.get<TypeDescriptor>().get(),
+            id.get<AudioPackFormatIdValue>().get());
+    }
+
+    void IdAssigner::removeId(const AudioChannelFormatId& id) {
+      erase(channelFormatValues_, id.get<TypeDescriptor>().get(),
+            id.get<AudioChannelFormatIdValue>().get());
+    }
+
+    void IdAssigner::removeId(const AudioStreamFormatId& id) {
+      erase(streamFormatValues_, id.get<TypeDescriptor>().get(),
+            id.get<AudioStreamFormatIdValue>().get());
+    }
+
+    void IdAssigner::removeId(const AudioTrackFormatId& id) {
+      erase(trackFormatCounters_,
+            trackFormatKey(id.get<TypeDescriptor>(),
+                           id.get<AudioTrackFormatIdValue>()),
+            id.get<AudioTrackFormatIdCounter>().get());
+    }
+
+    void IdAssigner::removeId(const AudioTrackUidId& id) {
+      trackUidValues_.erase(id.get<AudioTrackUidIdValue>().get());
+    }
+
   }  // namespace detail
 }  // namespace adm
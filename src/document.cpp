@@ -3,18 +3,18 @@
 #include "adm/elements.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/utilities/copy.hpp"
-#include "adm/utilities/lookup.hpp"
 #include "adm/detail/id_assigner.hpp"
 #include "adm/private/copy.hpp"
 
 #include <algorithm>
+#include <unordered_set>
 
 namespace adm {
   namespace detail {
     template class OptionalParameter<Version>;
   }  // namespace detail
 
-  Document::Document() { idAssigner_.document(this); }
+  Document::Document() {}
 
   std::shared_ptr<Document> Document::create() {
     return std::shared_ptr<Document>(new Document());
@@ -23,13 +23,21 @@ namespace adm {
   std::shared_ptr<Document> Document::deepCopy() const {
     auto copy = Document::create();
     copy->audioProgrammes_.reserve(audioProgrammes_.size());
+    copy->audioProgrammeIndex_.reserve(audioProgrammes_.size());
     copy->audioContents_.reserve(audioContents_.size());
+    copy->audioContentIndex_.reserve(audioContents_.size());
     copy->audioObjects_.reserve(audioObjects_.size());
+    copy->audioObjectIndex_.reserve(audioObjects_.size());
     copy->audioPackFormats_.reserve(audioPackFormats_.size());
+    copy->audioPackFormatIndex_.reserve(audioPackFormats_.size());
     copy->audioChannelFormats_.reserve(audioChannelFormats_.size());
+    copy->audioChannelFormatIndex_.reserve(audioChannelFormats_.size());
     copy->audioStreamFormats_.reserve(audioStreamFormats_.size());
+    copy->audioStreamFormatIndex_.reserve(audioStreamFormats_.size());
     copy->audioTrackFormats_.reserve(audioTrackFormats_.size());
+    copy->audioTrackFormatIndex_.reserve(audioTrackFormats_.size());
     copy->audioTrackUids_.reserve(audioTrackUids_.size());
+    copy->audioTrackUidIndex_.reserve(audioTrackUids_.size());
 
     auto elements = copyAllElements(shared_from_this());
     if (has<Version>()) copy->set(get<Version>());
@@ -37,328 +45,856 @@ namespace adm {
       if (auto v = boost::get<std::shared_ptr<AudioProgramme>>(&e)) {
         AudioProgrammeAttorney::setParent(*v, copy);
         copy->audioProgrammes_.push_back(*v);
+        copy->audioProgrammeIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioProgrammeId>());
+        copy->indexReferences(*v);
       } else if (auto v = boost::get<std::shared_ptr<AudioContent>>(&e)) {
         AudioContentAttorney::setParent(*v, copy);
         copy->audioContents_.push_back(*v);
+        copy->audioContentIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioContentId>());
+        copy->indexReferences(*v);
       } else if (auto v = boost::get<std::shared_ptr<AudioObject>>(&e)) {
         AudioObjectAttorney::setParent(*v, copy);
         copy->audioObjects_.push_back(*v);
+        copy->audioObjectIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioObjectId>());
+        copy->indexReferences(*v);
       } else if (auto v = boost::get<std::shared_ptr<AudioPackFormat>>(&e)) {
         AudioPackFormatAttorney::setParent(*v, copy);
         copy->audioPackFormats_.push_back(*v);
+        copy->audioPackFormatIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioPackFormatId>());
+        copy->indexReferences(*v);
       } else if (auto v = boost::get<std::shared_ptr<AudioChannelFormat>>(&e)) {
         AudioChannelFormatAttorney::setParent(*v, copy);
         copy->audioChannelFormats_.push_back(*v);
+        copy->audioChannelFormatIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioChannelFormatId>());
       } else if (auto v = boost::get<std::shared_ptr<AudioStreamFormat>>(&e)) {
         AudioStreamFormatAttorney::setParent(*v, copy);
         copy->audioStreamFormats_.push_back(*v);
+        copy->audioStreamFormatIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioStreamFormatId>());
+        copy->indexReferences(*v);
       } else if (auto v = boost::get<std::shared_ptr<AudioTrackFormat>>(&e)) {
         AudioTrackFormatAttorney::setParent(*v, copy);
         copy->audioTrackFormats_.push_back(*v);
+        copy->audioTrackFormatIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioTrackFormatId>());
+        copy->indexReferences(*v);
       } else if (auto v = boost::get<std::shared_ptr<AudioTrackUid>>(&e)) {
         AudioTrackUidAttorney::setParent(*v, copy);
         copy->audioTrackUids_.push_back(*v);
+        copy->audioTrackUidIndex_.add(*v);
+        copy->idAssigner_.addId((*v)->get<AudioTrackUidId>());
+        copy->indexReferences(*v);
       }
     }
     return copy;
   }
 
   // ---- add elements ---- //
-  bool Document::add(std::shared_ptr<AudioProgramme> programme) {
-    if (!checkParent(programme, "AudioProgramme")) {
-      idAssigner_.assignId(*programme);
-      AudioProgrammeAttorney::setParent(programme, shared_from_this());
-      audioProgrammes_.push_back(programme);
-      for (auto& reference : programme->getReferences<AudioContent>()) {
-        add(reference);
+  namespace {
+    /// reserve space for n more elements in a vector, keeping the amortised
+    /// growth of push_back
+    template <typename T>
+    void reserveMore(std::vector<T>& vector, std::size_t n) {
+      auto size = vector.size() + n;
+      if (size > vector.capacity()) {
+        vector.reserve(std::max(size, 2 * vector.capacity()));
       }
-      return true;
-    } else {
-      return false;
     }
+  }  // namespace
+
+  void Document::setParent(const std::shared_ptr<AudioProgramme>& programme,
+                           std::weak_ptr<Document> document) {
+    AudioProgrammeAttorney::setParent(programme, std::move(document));
   }
 
-  bool Document::add(std::shared_ptr<AudioContent> content) {
-    if (!checkParent(content, "AudioContent")) {
-      idAssigner_.assignId(*content);
-      AudioContentAttorney::setParent(content, shared_from_this());
-      audioContents_.push_back(content);
-      for (auto& reference : content->getReferences<AudioObject>()) {
-        add(reference);
+  void Document::setParent(const std::shared_ptr<AudioContent>& content,
+                           std::weak_ptr<Document> document) {
+    AudioContentAttorney::setParent(content, std::move(document));
+  }
+
+  void Document::setParent(const std::shared_ptr<AudioObject>& object,
+                           std::weak_ptr<Document> document) {
+    AudioObjectAttorney::setParent(object, std::move(document));
+  }
+
+  void Document::setParent(const std::shared_ptr<AudioPackFormat>& packFormat,
+                           std::weak_ptr<Document> document) {
+    AudioPackFormatAttorney::setParent(packFormat, std::move(document));
+  }
+
+  void Document::setParent(
+      const std::shared_ptr<AudioChannelFormat>& channelFormat,
+      std::weak_ptr<Document> document) {
+    AudioChannelFormatAttorney::setParent(channelFormat, std::move(document));
+  }
+
+  void Document::setParent(
+      const std::shared_ptr<AudioStreamFormat>& streamFormat,
+      std::weak_ptr<Document> document) {
+    AudioStreamFormatAttorney::setParent(streamFormat, std::move(document));
+  }
+
+  void Document::setParent(const std::shared_ptr<AudioTrackFormat>& trackFormat,
+                           std::weak_ptr<Document> document) {
+    AudioTrackFormatAttorney::setParent(trackFormat, std::move(document));
+  }
+
+  void Document::setParent(const std::shared_ptr<AudioTrackUid>& trackUid,
+                           std::weak_ptr<Document> document) {
+    AudioTrackUidAttorney::setParent(trackUid, std::move(document));
+  }
+
+  /// elements to be added to a document, in the order that they were found
+  struct Document::PendingElements {
+    /// returns true if element was not already pending
+    bool insert(const void* element) { return seen.insert(element).second; }
+
+    std::unordered_set<const void*> seen;
+    std::vector<std::shared_ptr<AudioProgramme>> programmes;
+    std::vector<std::shared_ptr<AudioContent>> contents;
+    std::vector<std::shared_ptr<AudioObject>> objects;
+    std::vector<std::shared_ptr<AudioPackFormat>> packFormats;
+    std::vector<std::shared_ptr<AudioChannelFormat>> channelFormats;
+    std::vector<std::shared_ptr<AudioStreamFormat>> streamFormats;
+    std::vector<std::shared_ptr<AudioTrackFormat>> trackFormats;
+    std::vector<std::shared_ptr<AudioTrackUid>> trackUids;
+  };
+
+  // the collect methods find an element and those it references which are
+  // not already in the document, in the order that they should be added;
+  // this checks that they can all be added before the document is changed
+
+  void Document::collect(const std::shared_ptr<AudioProgramme>& programme,
+                         PendingElements& pending) {
+    if (checkParent(programme, "AudioProgramme") ||
+        !pending.insert(programme.get())) {
+      return;
+    }
+    pending.programmes.push_back(programme);
+    for (auto& reference : programme->getReferences<AudioContent>()) {
+      collect(reference, pending);
+    }
+  }
+
+  void Document::collect(const std::shared_ptr<AudioContent>& content,
+                         PendingElements& pending) {
+    if (checkParent(content, "AudioContent") ||
+        !pending.insert(content.get())) {
+      return;
+    }
+    pending.contents.push_back(content);
+    for (auto& reference : content->getReferences<AudioObject>()) {
+      collect(reference, pending);
+    }
+  }
+
+  void Document::collect(const std::shared_ptr<AudioObject>& object,
+                         PendingElements& pending) {
+    if (checkParent(object, "AudioObject") || !pending.insert(object.get())) {
+      return;
+    }
+    pending.objects.push_back(object);
+    for (auto& reference : object->getReferences<AudioObject>()) {
+      collect(reference, pending);
+    }
+    for (auto& reference : object->getReferences<AudioPackFormat>()) {
+      collect(reference, pending);
+    }
+    for (auto& reference : object->getReferences<AudioTrackUid>()) {
+      collect(reference, pending);
+    }
+    for (auto& reference : object->getComplementaryObjects()) {
+      collect(reference, pending);
+    }
+  }
+
+  void Document::collect(const std::shared_ptr<AudioPackFormat>& packFormat,
+                         PendingElements& pending) {
+    if (checkParent(packFormat, "AudioPackFormat") ||
+        !pending.insert(packFormat.get())) {
+      return;
+    }
+    pending.packFormats.push_back(packFormat);
+    for (auto& reference : packFormat->getReferences<AudioPackFormat>()) {
+      collect(reference, pending);
+    }
+    for (auto& reference : packFormat->getReferences<AudioChannelFormat>()) {
+      collect(reference, pending);
+    }
+  }
+
+  void Document::collect(
+      const std::shared_ptr<AudioChannelFormat>& channelFormat,
+      PendingElements& pending) {
+    if (checkParent(channelFormat, "AudioChannelFormat") ||
+        !pending.insert(channelFormat.get())) {
+      return;
+    }
+    pending.channelFormats.push_back(channelFormat);
+  }
+
+  void Document::collect(
+      const std::shared_ptr<AudioStreamFormat>& streamFormat,
+      PendingElements& pending) {
+    if (checkParent(streamFormat, "AudioStreamFormat") ||
+        !pending.insert(streamFormat.get())) {
+      return;
+    }
+    pending.streamFormats.push_back(streamFormat);
+    auto audioChannelFormat = streamFormat->getReference<AudioChannelFormat>();
+    if (audioChannelFormat) {
+      collect(audioChannelFormat, pending);
+    }
+    auto audioPackFormat = streamFormat->getReference<AudioPackFormat>();
+    if (audioPackFormat) {
+      collect(audioPackFormat, pending);
+    }
+    for (auto& weak_reference : streamFormat->getAudioTrackFormatReferences()) {
+      auto reference = weak_reference.lock();
+      if (reference) {
+        collect(reference, pending);
       }
-      return true;
-    } else {
+    }
+  }
+
+  void Document::collect(const std::shared_ptr<AudioTrackFormat>& trackFormat,
+                         PendingElements& pending) {
+    if (checkParent(trackFormat, "AudioTrackFormat")) {
+      return;
+    }
+    // NOTE: That the id assignment works properly the AudioStreamFormats
+    // have to be added before the AudioTrackFormat.
+    auto audioStreamFormat = trackFormat->getReference<AudioStreamFormat>();
+    if (audioStreamFormat) {
+      collect(audioStreamFormat, pending);
+    }
+    // collecting the AudioStreamFormat may have collected this too
+    if (!pending.insert(trackFormat.get())) {
+      return;
+    }
+    pending.trackFormats.push_back(trackFormat);
+  }
+
+  void Document::collect(const std::shared_ptr<AudioTrackUid>& trackUid,
+                         PendingElements& pending) {
+    if (checkParent(trackUid, "AudioTrackUid") ||
+        !pending.insert(trackUid.get())) {
+      return;
+    }
+    pending.trackUids.push_back(trackUid);
+    auto audioTrackFormat = trackUid->getReference<AudioTrackFormat>();
+    if (audioTrackFormat) {
+      collect(audioTrackFormat, pending);
+    }
+    auto audioPackFormat = trackUid->getReference<AudioPackFormat>();
+    if (audioPackFormat) {
+      collect(audioPackFormat, pending);
+    }
+    auto audioChannelFormat = trackUid->getReference<AudioChannelFormat>();
+    if (audioChannelFormat) {
+      collect(audioChannelFormat, pending);
+    }
+  }
+
+  template <typename Element>
+  void Document::commit(
+      const std::vector<std::shared_ptr<Element>>& elements,
+      std::vector<std::shared_ptr<Element>>& documentElements,
+      detail::IdIndex<Element>& index) {
+    using Id = typename Element::id_type;
+    reserveMore(documentElements, elements.size());
+    index.reserveMore(elements.size());
+    std::weak_ptr<Document> self = shared_from_this();
+    for (auto& element : elements) {
+      idAssigner_.assignId(*element);
+      setParent(element, self);
+      documentElements.push_back(element);
+      index.add(element);
+      idAssigner_.addId(element->template get<Id>());
+      indexReferences(element);
+    }
+  }
+
+  void Document::commit(const PendingElements& pending) {
+    // IDs only depend on the IDs of other elements of the same type, except
+    // for AudioTrackFormat IDs which depend on their AudioStreamFormat, so
+    // this assigns the same IDs as adding the elements one at a time
+    commit(pending.programmes, audioProgrammes_, audioProgrammeIndex_);
+    commit(pending.contents, audioContents_, audioContentIndex_);
+    commit(pending.objects, audioObjects_, audioObjectIndex_);
+    commit(pending.packFormats, audioPackFormats_, audioPackFormatIndex_);
+    commit(pending.channelFormats, audioChannelFormats_,
+           audioChannelFormatIndex_);
+    commit(pending.streamFormats, audioStreamFormats_,
+           audioStreamFormatIndex_);
+    commit(pending.trackFormats, audioTrackFormats_, audioTrackFormatIndex_);
+    commit(pending.trackUids, audioTrackUids_, audioTrackUidIndex_);
+  }
+
+  template <typename Element>
+  bool Document::addElement(const std::shared_ptr<Element>& element,
+                            const char* type) {
+    if (checkParent(element, type)) {
       return false;
     }
+    PendingElements pending;
+    collect(element, pending);
+    commit(pending);
+    return true;
+  }
+
+  template <typename Element>
+  void Document::addElements(
+      const std::vector<std::shared_ptr<Element>>& elements) {
+    PendingElements pending;
+    for (auto& element : elements) {
+      collect(element, pending);
+    }
+    commit(pending);
+  }
+
+  bool Document::add(std::shared_ptr<AudioProgramme> programme) {
+    return addElement(programme, "AudioProgramme");
+  }
+
+  bool Document::add(std::shared_ptr<AudioContent> content) {
+    return addElement(content, "AudioContent");
   }
 
   bool Document::add(std::shared_ptr<AudioObject> object) {
-    if (!checkParent(object, "AudioObject")) {
-      idAssigner_.assignId(*object);
-      AudioObjectAttorney::setParent(object, shared_from_this());
-      audioObjects_.push_back(object);
-      for (auto& reference : object->getReferences<AudioObject>()) {
-        add(reference);
+    return addElement(object, "AudioObject");
+  }
+
+  bool Document::add(std::shared_ptr<AudioPackFormat> packFormat) {
+    return addElement(packFormat, "AudioPackFormat");
+  }
+
+  bool Document::add(std::shared_ptr<AudioChannelFormat> channelFormat) {
+    return addElement(channelFormat, "AudioChannelFormat");
+  }
+
+  bool Document::add(std::shared_ptr<AudioStreamFormat> streamFormat) {
+    return addElement(streamFormat, "AudioStreamFormat");
+  }
+
+  bool Document::add(std::shared_ptr<AudioTrackFormat> trackFormat) {
+    return addElement(trackFormat, "AudioTrackFormat");
+  }
+
+  bool Document::add(std::shared_ptr<AudioTrackUid> trackUid) {
+    return addElement(trackUid, "AudioTrackUid");
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioProgramme>>& programmes) {
+    addElements(programmes);
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioContent>>& contents) {
+    addElements(contents);
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioObject>>& objects) {
+    addElements(objects);
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioPackFormat>>& packFormats) {
+    addElements(packFormats);
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioChannelFormat>>& channelFormats) {
+    addElements(channelFormats);
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioStreamFormat>>& streamFormats) {
+    addElements(streamFormats);
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioTrackFormat>>& trackFormats) {
+    addElements(trackFormats);
+  }
+
+  void Document::addAllElements(
+      const std::vector<std::shared_ptr<AudioTrackUid>>& trackUids) {
+    addElements(trackUids);
+  }
+
+  // ---- index references ---- //
+  namespace {
+    /// call f with each element which element refers to
+    template <typename F>
+    void forEachReference(AudioProgramme& programme, F f) {
+      for (auto& content : programme.getReferences<AudioContent>()) {
+        f(content);
       }
-      for (auto& reference : object->getReferences<AudioPackFormat>()) {
-        add(reference);
+    }
+
+    template <typename F>
+    void forEachReference(AudioContent& content, F f) {
+      for (auto& object : content.getReferences<AudioObject>()) {
+        f(object);
+      }
+    }
+
+    template <typename F>
+    void forEachReference(AudioObject& object, F f) {
+      for (auto& reference : object.getReferences<AudioObject>()) {
+        f(reference);
       }
-      for (auto& reference : object->getReferences<AudioTrackUid>()) {
-        add(reference);
+      for (auto& packFormat : object.getReferences<AudioPackFormat>()) {
+        f(packFormat);
       }
-      for (auto& reference : object->getComplementaryObjects()) {
-        add(reference);
+      for (auto& trackUid : object.getReferences<AudioTrackUid>()) {
+        f(trackUid);
       }
-      return true;
-    } else {
-      return false;
     }
-  }
-  bool Document::add(std::shared_ptr<AudioPackFormat> packFormat) {
-    if (!checkParent(packFormat, "AudioPackFormat")) {
-      idAssigner_.assignId(*packFormat);
-      AudioPackFormatAttorney::setParent(packFormat, shared_from_this());
-      audioPackFormats_.push_back(packFormat);
-      for (auto& reference : packFormat->getReferences<AudioPackFormat>()) {
-        add(reference);
+
+    template <typename F>
+    void forEachReference(AudioPackFormat& packFormat, F f) {
+      for (auto& reference : packFormat.getReferences<AudioPackFormat>()) {
+        f(reference);
       }
-      for (auto& reference : packFormat->getReferences<AudioChannelFormat>()) {
-        add(reference);
+      for (auto& channelFormat :
+           packFormat.getReferences<AudioChannelFormat>()) {
+        f(channelFormat);
       }
-      return true;
-    } else {
-      return false;
     }
-  }
 
-  bool Document::add(std::shared_ptr<AudioChannelFormat> channelFormat) {
-    if (!checkParent(channelFormat, "AudioChannelFormat")) {
-      idAssigner_.assignId(*channelFormat);
-      AudioChannelFormatAttorney::setParent(channelFormat, shared_from_this());
-      audioChannelFormats_.push_back(channelFormat);
-      return true;
-    } else {
-      return false;
+    template <typename F>
+    void forEachReference(AudioChannelFormat&, F) {
+      // AudioChannelFormats don't refer to other elements
     }
-  }
 
-  bool Document::add(std::shared_ptr<AudioStreamFormat> streamFormat) {
-    if (!checkParent(streamFormat, "AudioStreamFormat")) {
-      idAssigner_.assignId(*streamFormat);
-      AudioStreamFormatAttorney::setParent(streamFormat, shared_from_this());
-      audioStreamFormats_.push_back(streamFormat);
-      auto audioChannelFormat =
-          streamFormat->getReference<AudioChannelFormat>();
-      if (audioChannelFormat) {
-        add(audioChannelFormat);
+    template <typename F>
+    void forEachReference(AudioStreamFormat& streamFormat, F f) {
+      if (auto channelFormat =
+              streamFormat.getReference<AudioChannelFormat>()) {
+        f(channelFormat);
       }
-      auto audioPackFormat = streamFormat->getReference<AudioPackFormat>();
-      if (audioPackFormat) {
-        add(audioPackFormat);
+      if (auto packFormat = streamFormat.getReference<AudioPackFormat>()) {
+        f(packFormat);
       }
-      for (auto& weak_reference :
-           streamFormat->getAudioTrackFormatReferences()) {
-        auto reference = weak_reference.lock();
-        if (reference) {
-          add(reference);
+      for (auto& weakTrackFormat :
+           streamFormat.getAudioTrackFormatReferences()) {
+        if (auto trackFormat = weakTrackFormat.lock()) {
+          f(trackFormat);
         }
       }
-      return true;
-    } else {
-      return false;
     }
-  }
 
-  bool Document::add(std::shared_ptr<AudioTrackFormat> trackFormat) {
-    if (!checkParent(trackFormat, "AudioTrackFormat")) {
-      // NOTE: That the id assignment works properly the AudioStreamFormats
-      // have to be added before the AudioTrackFormat.
-      auto audioStreamFormat = trackFormat->getReference<AudioStreamFormat>();
-      if (audioStreamFormat) {
-        add(audioStreamFormat);
+    template <typename F>
+    void forEachReference(AudioTrackFormat& trackFormat, F f) {
+      if (auto streamFormat = trackFormat.getReference<AudioStreamFormat>()) {
+        f(streamFormat);
       }
-      auto it = std::find(audioTrackFormats_.begin(), audioTrackFormats_.end(),
-                          trackFormat);
-      if (it != audioTrackFormats_.end()) {
-        return true;
-      }
-      idAssigner_.assignId(*trackFormat);
-      AudioTrackFormatAttorney::setParent(trackFormat, shared_from_this());
-      audioTrackFormats_.push_back(trackFormat);
-      return true;
-    } else {
-      return false;
     }
-  }
 
-  bool Document::add(std::shared_ptr<AudioTrackUid> trackUid) {
-    if (!checkParent(trackUid, "AudioTrackUid")) {
-      idAssigner_.assignId(*trackUid);
-      AudioTrackUidAttorney::setParent(trackUid, shared_from_this());
-      audioTrackUids_.push_back(trackUid);
-
-      auto audioTrackFormat = trackUid->getReference<AudioTrackFormat>();
-      if (audioTrackFormat) {
-        add(audioTrackFormat);
+    template <typename F>
+    void forEachReference(AudioTrackUid& trackUid, F f) {
+      if (auto trackFormat = trackUid.getReference<AudioTrackFormat>()) {
+        f(trackFormat);
       }
-      auto audioPackFormat = trackUid->getReference<AudioPackFormat>();
-      if (audioPackFormat) {
-        add(audioPackFormat);
+      if (auto packFormat = trackUid.getReference<AudioPackFormat>()) {
+        f(packFormat);
       }
-      auto audioChannelFormat = trackUid->getReference<AudioChannelFormat>();
-      if (audioChannelFormat) {
-        add(audioChannelFormat);
+      if (auto channelFormat = trackUid.getReference<AudioChannelFormat>()) {
+        f(channelFormat);
       }
-      return true;
-    } else {
-      return false;
     }
+
+    /// forget the references from element, which is being removed from the
+    /// document, so that they don't stay in the index
+    template <typename Element>
+    void unindexReferences(detail::ReferrerIndex& referrers,
+                           const std::shared_ptr<Element>& element) {
+      forEachReference(*element, [&](const auto& reference) {
+        referrers.remove(element.get(), reference.get());
+      });
+    }
+  }  // namespace
+
+  void Document::indexReferences(
+      const std::shared_ptr<AudioProgramme>& programme) {
+    forEachReference(*programme, [&](const auto& reference) {
+      referrers_.add(programme, reference.get());
+    });
+  }
+
+  void Document::indexReferences(const std::shared_ptr<AudioContent>& content) {
+    forEachReference(*content, [&](const auto& reference) {
+      referrers_.add(content, reference.get());
+    });
+  }
+
+  void Document::indexReferences(const std::shared_ptr<AudioObject>& object) {
+    forEachReference(*object, [&](const auto& reference) {
+      referrers_.add(object, reference.get());
+    });
+  }
+
+  void Document::indexReferences(
+      const std::shared_ptr<AudioPackFormat>& packFormat) {
+    forEachReference(*packFormat, [&](const auto& reference) {
+      referrers_.add(packFormat, reference.get());
+    });
+  }
+
+  void Document::indexReferences(const std::shared_ptr<AudioChannelFormat>&) {
+    // AudioChannelFormats don't refer to other elements
+  }
+
+  void Document::indexReferences(
+      const std::shared_ptr<AudioStreamFormat>& streamFormat) {
+    forEachReference(*streamFormat, [&](const auto& reference) {
+      referrers_.add(streamFormat, reference.get());
+    });
+  }
+
+  void Document::indexReferences(
+      const std::shared_ptr<AudioTrackFormat>& trackFormat) {
+    forEachReference(*trackFormat, [&](const auto& reference) {
+      referrers_.add(trackFormat, reference.get());
+    });
+  }
+
+  void Document::indexReferences(
+      const std::shared_ptr<AudioTrackUid>& trackUid) {
+    forEachReference(*trackUid, [&](const auto& reference) {
+      referrers_.add(trackUid, reference.get());
+    });
   }
 
   // ---- remove elements --- //
-  bool Document::remove(std::shared_ptr<AudioProgramme> programme) {
-    auto it =
-        std::find(audioProgrammes_.begin(), audioProgrammes_.end(), programme);
-    if (it != audioProgrammes_.end()) {
-      audioProgrammes_.erase(it);
-      AudioProgrammeAttorney::setParent(programme, {});
-      return true;
+  namespace {
+    /// remove any references from referrer to target
+    ///
+    /// this is a no-op if referrer doesn't refer to target, or can't
+    template <typename Referrer, typename Target>
+    void dropReference(Referrer&, const std::shared_ptr<Target>&) {}
+
+    void dropReference(AudioProgramme& programme,
+                       const std::shared_ptr<AudioContent>& content) {
+      programme.removeReference(content);
     }
-    return false;
-  }
 
-  bool Document::remove(std::shared_ptr<AudioContent> content) {
-    auto it = std::find(audioContents_.begin(), audioContents_.end(), content);
-    if (it != audioContents_.end()) {
-      audioContents_.erase(it);
-      AudioContentAttorney::setParent(content, {});
-      for (auto& audioProgramme : audioProgrammes_) {
-        audioProgramme->removeReference(content);
+    void dropReference(AudioContent& content,
+                       const std::shared_ptr<AudioObject>& object) {
+      content.removeReference(object);
+    }
+
+    void dropReference(AudioObject& audioObject,
+                       const std::shared_ptr<AudioObject>& object) {
+      audioObject.removeReference(object);
+    }
+
+    void dropReference(AudioObject& object,
+                       const std::shared_ptr<AudioPackFormat>& packFormat) {
+      object.removeReference(packFormat);
+    }
+
+    void dropReference(AudioObject& object,
+                       const std::shared_ptr<AudioTrackUid>& trackUid) {
+      object.removeReference(trackUid);
+    }
+
+    void dropReference(AudioPackFormat& audioPackFormat,
+                       const std::shared_ptr<AudioPackFormat>& packFormat) {
+      audioPackFormat.removeReference(packFormat);
+    }
+
+    void dropReference(
+        AudioPackFormat& packFormat,
+        const std::shared_ptr<AudioChannelFormat>& channelFormat) {
+      packFormat.removeReference(channelFormat);
+    }
+
+    void dropReference(AudioStreamFormat& streamFormat,
+                       const std::shared_ptr<AudioPackFormat>& packFormat) {
+      if (streamFormat.getReference<AudioPackFormat>() == packFormat) {
+        streamFormat.removeReference<AudioPackFormat>();
       }
-      return true;
     }
-    return false;
-  }
 
-  bool Document::remove(std::shared_ptr<AudioObject> object) {
-    auto it = std::find(audioObjects_.begin(), audioObjects_.end(), object);
-    if (it != audioObjects_.end()) {
-      audioObjects_.erase(it);
-      AudioObjectAttorney::setParent(object, {});
-      for (auto& audioObject : audioObjects_) {
-        audioObject->removeReference(object);
+    void dropReference(
+        AudioStreamFormat& streamFormat,
+        const std::shared_ptr<AudioChannelFormat>& channelFormat) {
+      if (streamFormat.getReference<AudioChannelFormat>() == channelFormat) {
+        streamFormat.removeReference<AudioChannelFormat>();
       }
-      for (auto& audioContent : audioContents_) {
-        audioContent->removeReference(object);
+    }
+
+    void dropReference(AudioStreamFormat& streamFormat,
+                       const std::shared_ptr<AudioTrackFormat>& trackFormat) {
+      streamFormat.removeReference(trackFormat);
+    }
+
+    void dropReference(AudioTrackFormat& trackFormat,
+                       const std::shared_ptr<AudioStreamFormat>& streamFormat) {
+      if (trackFormat.getReference<AudioStreamFormat>() == streamFormat) {
+        trackFormat.removeReference<AudioStreamFormat>();
       }
-      return true;
     }
-    return false;
-  }
 
-  bool Document::remove(std::shared_ptr<AudioPackFormat> packFormat) {
-    auto it = std::find(audioPackFormats_.begin(), audioPackFormats_.end(),
-                        packFormat);
-    if (it != audioPackFormats_.end()) {
-      audioPackFormats_.erase(it);
-      AudioPackFormatAttorney::setParent(packFormat, {});
-      for (auto& audioPackFormat : audioPackFormats_) {
-        audioPackFormat->removeReference(packFormat);
+    void dropReference(AudioTrackUid& trackUid,
+                       const std::shared_ptr<AudioPackFormat>& packFormat) {
+      if (trackUid.getReference<AudioPackFormat>() == packFormat) {
+        trackUid.removeReference<AudioPackFormat>();
       }
-      for (auto& audioObject : audioObjects_) {
-        audioObject->removeReference(packFormat);
+    }
+
+    void dropReference(
+        AudioTrackUid& trackUid,
+        const std::shared_ptr<AudioChannelFormat>& channelFormat) {
+      if (trackUid.getReference<AudioChannelFormat>() == channelFormat) {
+        trackUid.removeReference<AudioChannelFormat>();
       }
-      for (auto& audioStreamFormat : audioStreamFormats_) {
-        if (audioStreamFormat->getReference<AudioPackFormat>() == packFormat) {
-          audioStreamFormat->removeReference<AudioPackFormat>();
-        }
+    }
+
+    void dropReference(AudioTrackUid& trackUid,
+                       const std::shared_ptr<AudioTrackFormat>& trackFormat) {
+      if (trackUid.getReference<AudioTrackFormat>() == trackFormat) {
+        trackUid.removeReference<AudioTrackFormat>();
       }
-      for (auto& audioTrackUid : audioTrackUids_) {
-        if (audioTrackUid->getReference<AudioPackFormat>() == packFormat) {
-          audioTrackUid->removeReference<AudioPackFormat>();
+    }
+
+    /// call dropReference for a referrer from a ReferrerIndex, if it is
+    /// still in document
+    template <typename Target>
+    class DropReferenceVisitor : public boost::static_visitor<> {
+     public:
+      DropReferenceVisitor(const Document* document,
+                           const std::shared_ptr<Target>& target)
+          : document_(document), target_(target) {}
+
+      template <typename Referrer>
+      void operator()(const std::weak_ptr<Referrer>& weakReferrer) const {
+        auto referrer = weakReferrer.lock();
+        if (referrer && referrer->getParent().lock().get() == document_) {
+          dropReference(*referrer, target_);
         }
       }
-      return true;
+
+     private:
+      const Document* document_;
+      const std::shared_ptr<Target>& target_;
+    };
+
+    /// remove all references to target from elements in document
+    template <typename Target>
+    void dropReferences(const Document* document,
+                        detail::ReferrerIndex& referrers,
+                        const std::shared_ptr<Target>& target) {
+      DropReferenceVisitor<Target> visitor(document, target);
+      for (auto& referrer : referrers.take(target.get())) {
+        boost::apply_visitor(visitor, referrer);
+      }
+    }
+  }  // namespace
+
+  template <typename Element>
+  bool Document::removeFrom(
+      const std::shared_ptr<Element>& element,
+      std::vector<std::shared_ptr<Element>>& documentElements) {
+    if (!element || element->getParent().lock().get() != this) {
+      return false;
+    }
+    auto it =
+        std::find(documentElements.begin(), documentElements.end(), element);
+    if (it == documentElements.end()) {
+      return false;
     }
-    return false;
+    documentElements.erase(it);
+    unindexReferences(referrers_, element);
+    detach(element);
+    return true;
   }
 
-  bool Document::remove(std::shared_ptr<AudioChannelFormat> channelFormat) {
-    auto it = std::find(audioChannelFormats_.begin(),
-                        audioChannelFormats_.end(), channelFormat);
-    if (it != audioChannelFormats_.end()) {
-      audioChannelFormats_.erase(it);
-      AudioChannelFormatAttorney::setParent(channelFormat, {});
-      for (auto& audioPackFormat : audioPackFormats_) {
-        audioPackFormat->removeReference(channelFormat);
-      }
-      for (auto& audioStreamFormat : audioStreamFormats_) {
-        if (audioStreamFormat->getReference<AudioChannelFormat>() ==
-            channelFormat) {
-          audioStreamFormat->removeReference<AudioChannelFormat>();
-        }
+  template <typename Element>
+  std::size_t Document::removeFrom(
+      const std::vector<std::shared_ptr<Element>>& elements,
+      std::vector<std::shared_ptr<Element>>& documentElements) {
+    std::unordered_set<const Element*> toRemove;
+    for (auto& element : elements) {
+      if (element && element->getParent().lock().get() == this) {
+        toRemove.insert(element.get());
       }
-      for (auto& audioTrackUid : audioTrackUids_) {
-        if (audioTrackUid->getReference<AudioChannelFormat>() ==
-            channelFormat) {
-          audioTrackUid->removeReference<AudioChannelFormat>();
-        }
+    }
+    if (toRemove.empty()) {
+      return 0;
+    }
+
+    auto end = std::remove_if(
+        documentElements.begin(), documentElements.end(),
+        [&toRemove](const std::shared_ptr<Element>& element) {
+          return toRemove.count(element.get()) != 0;
+        });
+    documentElements.erase(end, documentElements.end());
+
+    // detach only after all have been removed from documentElements, so that
+    // the indexes don't see any of them
+    std::size_t removed = 0;
+    for (auto& element : elements) {
+      if (element && toRemove.erase(element.get())) {
+        unindexReferences(referrers_, element);
+        detach(element);
+        ++removed;
       }
-      return true;
     }
-    return false;
+    return removed;
+  }
+
+  void Document::detach(const std::shared_ptr<AudioProgramme>& programme) {
+    audioProgrammeIndex_.remove(programme.get(),
+                                programme->get<AudioProgrammeId>(),
+                                audioProgrammes_);
+    idAssigner_.removeId(programme->get<AudioProgrammeId>());
+    AudioProgrammeAttorney::setParent(programme, {});
+  }
+
+  void Document::detach(const std::shared_ptr<AudioContent>& content) {
+    audioContentIndex_.remove(content.get(), content->get<AudioContentId>(),
+                              audioContents_);
+    idAssigner_.removeId(content->get<AudioContentId>());
+    AudioContentAttorney::setParent(content, {});
+    dropReferences(this, referrers_, content);
+  }
+
+  void Document::detach(const std::shared_ptr<AudioObject>& object) {
+    audioObjectIndex_.remove(object.get(), object->get<AudioObjectId>(),
+                             audioObjects_);
+    idAssigner_.removeId(object->get<AudioObjectId>());
+    AudioObjectAttorney::setParent(object, {});
+    dropReferences(this, referrers_, object);
+  }
+
+  void Document::detach(const std::shared_ptr<AudioPackFormat>& packFormat) {
+    audioPackFormatIndex_.remove(packFormat.get(),
+                                 packFormat->get<AudioPackFormatId>(),
+                                 audioPackFormats_);
+    idAssigner_.removeId(packFormat->get<AudioPackFormatId>());
+    AudioPackFormatAttorney::setParent(packFormat, {});
+    dropReferences(this, referrers_, packFormat);
+  }
+
+  void Document::detach(
+      const std::shared_ptr<AudioChannelFormat>& channelFormat) {
+    audioChannelFormatIndex_.remove(channelFormat.get(),
+                                    channelFormat->get<AudioChannelFormatId>(),
+                                    audioChannelFormats_);
+    idAssigner_.removeId(channelFormat->get<AudioChannelFormatId>());
+    AudioChannelFormatAttorney::setParent(channelFormat, {});
+    dropReferences(this, referrers_, channelFormat);
+  }
+
+  void Document::detach(
+      const std::shared_ptr<AudioStreamFormat>& streamFormat) {
+    audioStreamFormatIndex_.remove(streamFormat.get(),
+                                   streamFormat->get<AudioStreamFormatId>(),
+                                   audioStreamFormats_);
+    idAssigner_.removeId(streamFormat->get<AudioStreamFormatId>());
+    AudioStreamFormatAttorney::setParent(streamFormat, {});
+    dropReferences(this, referrers_, streamFormat);
+  }
+
+  void Document::detach(const std::shared_ptr<AudioTrackFormat>& trackFormat) {
+    audioTrackFormatIndex_.remove(trackFormat.get(),
+                                  trackFormat->get<AudioTrackFormatId>(),
+                                  audioTrackFormats_);
+    idAssigner_.removeId(trackFormat->get<AudioTrackFormatId>());
+    AudioTrackFormatAttorney::setParent(trackFormat, {});
+    dropReferences(this, referrers_, trackFormat);
+  }
+
+  void Document::detach(const std::shared_ptr<AudioTrackUid>& trackUid) {
+    audioTrackUidIndex_.remove(trackUid.get(),
+                               trackUid->get<AudioTrackUidId>(),
+                               audioTrackUids_);
+    idAssigner_.removeId(trackUid->get<AudioTrackUidId>());
+    AudioTrackUidAttorney::setParent(trackUid, {});
+    dropReferences(this, referrers_, trackUid);
+  }
+
+  bool Document::remove(std::shared_ptr<AudioProgramme> programme) {
+    return removeFrom(programme, audioProgrammes_);
+  }
+
+  bool Document::remove(std::shared_ptr<AudioContent> content) {
+    return removeFrom(content, audioContents_);
+  }
+
+  bool Document::remove(std::shared_ptr<AudioObject> object) {
+    return removeFrom(object, audioObjects_);
+  }
+
+  bool Document::remove(std::shared_ptr<AudioPackFormat> packFormat) {
+    return removeFrom(packFormat, audioPackFormats_);
+  }
+
+  bool Document::remove(std::shared_ptr<AudioChannelFormat> channelFormat) {
+    return removeFrom(channelFormat, audioChannelFormats_);
   }
 
   bool Document::remove(std::shared_ptr<AudioStreamFormat> streamFormat) {
-    auto it = std::find(audioStreamFormats_.begin(), audioStreamFormats_.end(),
-                        streamFormat);
-    if (it != audioStreamFormats_.end()) {
-      audioStreamFormats_.erase(it);
-      AudioStreamFormatAttorney::setParent(streamFormat, {});
-
-      for (auto& audioTrackFormat : audioTrackFormats_) {
-        if (audioTrackFormat->getReference<AudioStreamFormat>() ==
-            streamFormat) {
-          audioTrackFormat->removeReference<AudioStreamFormat>();
-        }
-      }
-      return true;
-    }
-    return false;
+    return removeFrom(streamFormat, audioStreamFormats_);
   }
 
   bool Document::remove(std::shared_ptr<AudioTrackFormat> trackFormat) {
-    auto it = std::find(audioTrackFormats_.begin(), audioTrackFormats_.end(),
-                        trackFormat);
-    if (it != audioTrackFormats_.end()) {
-      audioTrackFormats_.erase(it);
-      AudioTrackFormatAttorney::setParent(trackFormat, {});
-
-      for (auto& audioStreamFormat : audioStreamFormats_) {
-        audioStreamFormat->removeReference(trackFormat);
-      }
-      for (auto& audioTrackUid : audioTrackUids_) {
-        if (audioTrackUid->getReference<AudioTrackFormat>() == trackFormat) {
-          audioTrackUid->removeReference<AudioTrackFormat>();
-        }
-      }
-      return true;
-    }
-    return false;
+    return removeFrom(trackFormat, audioTrackFormats_);
   }
 
   bool Document::remove(std::shared_ptr<AudioTrackUid> trackUid) {
-    auto it =
-        std::find(audioTrackUids_.begin(), audioTrackUids_.end(), trackUid);
-    if (it != audioTrackUids_.end()) {
-      audioTrackUids_.erase(it);
-      AudioTrackUidAttorney::setParent(trackUid, {});
-      for (auto& audioObject : audioObjects_) {
-        audioObject->removeReference(trackUid);
-      }
-      return true;
-    }
-    return false;
+    return removeFrom(trackUid, audioTrackUids_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioProgramme>>& programmes) {
+    return removeFrom(programmes, audioProgrammes_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioContent>>& contents) {
+    return removeFrom(contents, audioContents_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioObject>>& objects) {
+    return removeFrom(objects, audioObjects_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioPackFormat>>& packFormats) {
+    return removeFrom(packFormats, audioPackFormats_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioChannelFormat>>& channelFormats) {
+    return removeFrom(channelFormats, audioChannelFormats_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioStreamFormat>>& streamFormats) {
+    return removeFrom(streamFormats, audioStreamFormats_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioTrackFormat>>& trackFormats) {
+    return removeFrom(trackFormats, audioTrackFormats_);
+  }
+
+  std::size_t Document::removeElements(
+      const std::vector<std::shared_ptr<AudioTrackUid>>& trackUids) {
+    return removeFrom(trackUids, audioTrackUids_);
   }
 
   // ---- get elements ---- //
@@ -444,76 +980,124 @@ namespace adm {
 
   // ---- lookup elements ---- //
   std::shared_ptr<AudioProgramme> Document::lookup(const AudioProgrammeId& id) {
-    return lookupById<AudioProgramme>(getElements<AudioProgramme>(), id);
+    return audioProgrammeIndex_.lookup(id);
   }
   std::shared_ptr<const AudioProgramme> Document::lookup(
       const AudioProgrammeId& id) const {
-    return lookupById<const AudioProgramme>(getElements<AudioProgramme>(), id);
+    return audioProgrammeIndex_.lookup(id);
   }
 
   std::shared_ptr<AudioContent> Document::lookup(const AudioContentId& id) {
-    return lookupById<AudioContent>(getElements<AudioContent>(), id);
+    return audioContentIndex_.lookup(id);
   }
   std::shared_ptr<const AudioContent> Document::lookup(
       const AudioContentId& id) const {
-    return lookupById<const AudioContent>(getElements<AudioContent>(), id);
+    return audioContentIndex_.lookup(id);
   }
 
   std::shared_ptr<AudioObject> Document::lookup(const AudioObjectId& id) {
-    return lookupById<AudioObject>(getElements<AudioObject>(), id);
+    return audioObjectIndex_.lookup(id);
   }
   std::shared_ptr<const AudioObject> Document::lookup(
       const AudioObjectId& id) const {
-    return lookupById<const AudioObject>(getElements<AudioObject>(), id);
+    return audioObjectIndex_.lookup(id);
   }
 
   std::shared_ptr<AudioPackFormat> Document::lookup(
       const AudioPackFormatId& id) {
-    return lookupById<AudioPackFormat>(getElements<AudioPackFormat>(), id);
+    return audioPackFormatIndex_.lookup(id);
   }
   std::shared_ptr<const AudioPackFormat> Document::lookup(
       const AudioPackFormatId& id) const {
-    return lookupById<const AudioPackFormat>(getElements<AudioPackFormat>(),
-                                             id);
+    return audioPackFormatIndex_.lookup(id);
   }
 
   std::shared_ptr<AudioChannelFormat> Document::lookup(
       const AudioChannelFormatId& id) {
-    return lookupById<AudioChannelFormat>(getElements<AudioChannelFormat>(),
-                                          id);
+    return audioChannelFormatIndex_.lookup(id);
   }
   std::shared_ptr<const AudioChannelFormat> Document::lookup(
       const AudioChannelFormatId& id) const {
-    return lookupById<const AudioChannelFormat>(
-        getElements<const AudioChannelFormat>(), id);
+    return audioChannelFormatIndex_.lookup(id);
   }
 
   std::shared_ptr<AudioStreamFormat> Document::lookup(
       const AudioStreamFormatId& id) {
-    return lookupById<AudioStreamFormat>(getElements<AudioStreamFormat>(), id);
+    return audioStreamFormatIndex_.lookup(id);
   }
   std::shared_ptr<const AudioStreamFormat> Document::lookup(
       const AudioStreamFormatId& id) const {
-    return lookupById<const AudioStreamFormat>(getElements<AudioStreamFormat>(),
-                                               id);
+    return audioStreamFormatIndex_.lookup(id);
   }
 
   std::shared_ptr<AudioTrackFormat> Document::lookup(
       const AudioTrackFormatId& id) {
-    return lookupById<AudioTrackFormat>(getElements<AudioTrackFormat>(), id);
+    return audioTrackFormatIndex_.lookup(id);
   }
   std::shared_ptr<const AudioTrackFormat> Document::lookup(
       const AudioTrackFormatId& id) const {
-    return lookupById<const AudioTrackFormat>(getElements<AudioTrackFormat>(),
-                                              id);
+    return audioTrackFormatIndex_.lookup(id);
   }
 
   std::shared_ptr<AudioTrackUid> Document::lookup(const AudioTrackUidId& id) {
-    return lookupById<AudioTrackUid>(getElements<AudioTrackUid>(), id);
+    return audioTrackUidIndex_.lookup(id);
   }
   std::shared_ptr<const AudioTrackUid> Document::lookup(
       const AudioTrackUidId& id) const {
-    return lookupById<const AudioTrackUid>(getElements<AudioTrackUid>(), id);
+    return audioTrackUidIndex_.lookup(id);
+  }
+
+  // ---- update index ---- //
+  void Document::idChanged(const std::shared_ptr<AudioProgramme>& programme,
+                           const AudioProgrammeId& oldId) {
+    audioProgrammeIndex_.changeId(programme, oldId, audioProgrammes_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(programme->get<AudioProgrammeId>());
+  }
+  void Document::idChanged(const std::shared_ptr<AudioContent>& content,
+                           const AudioContentId& oldId) {
+    audioContentIndex_.changeId(content, oldId, audioContents_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(content->get<AudioContentId>());
+  }
+  void Document::idChanged(const std::shared_ptr<AudioObject>& object,
+                           const AudioObjectId& oldId) {
+    audioObjectIndex_.changeId(object, oldId, audioObjects_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(object->get<AudioObjectId>());
+  }
+  void Document::idChanged(const std::shared_ptr<AudioPackFormat>& packFormat,
+                           const AudioPackFormatId& oldId) {
+    audioPackFormatIndex_.changeId(packFormat, oldId, audioPackFormats_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(packFormat->get<AudioPackFormatId>());
+  }
+  void Document::idChanged(
+      const std::shared_ptr<AudioChannelFormat>& channelFormat,
+      const AudioChannelFormatId& oldId) {
+    audioChannelFormatIndex_.changeId(channelFormat, oldId,
+                                      audioChannelFormats_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(channelFormat->get<AudioChannelFormatId>());
+  }
+  void Document::idChanged(
+      const std::shared_ptr<AudioStreamFormat>& streamFormat,
+      const AudioStreamFormatId& oldId) {
+    audioStreamFormatIndex_.changeId(streamFormat, oldId, audioStreamFormats_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(streamFormat->get<AudioStreamFormatId>());
+  }
+  void Document::idChanged(const std::shared_ptr<AudioTrackFormat>& trackFormat,
+                           const AudioTrackFormatId& oldId) {
+    audioTrackFormatIndex_.changeId(trackFormat, oldId, audioTrackFormats_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(trackFormat->get<AudioTrackFormatId>());
+  }
+  void Document::idChanged(const std::shared_ptr<AudioTrackUid>& trackUid,
+                           const AudioTrackUidId& oldId) {
+    audioTrackUidIndex_.changeId(trackUid, oldId, audioTrackUids_);
+    idAssigner_.removeId(oldId);
+    idAssigner_.addId(trackUid->get<AudioTrackUidId>());
   }
 
   template <typename Element>
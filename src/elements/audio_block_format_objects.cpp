@@ -33,18 +33,18 @@ namespace adm {
   Position AudioBlockFormatObjects::get(
       detail::ParameterTraits<detail::ParameterTraits<Position>>::tag) const {
     if (has<SphericalPosition>()) {
-      return Position(sphericalPosition_.get());
+      return Position(boost::get<SphericalPosition>(position_));
     } else {
-      return Position(cartesianPosition_.get());
+      return Position(boost::get<CartesianPosition>(position_));
     }
   }
   SphericalPosition AudioBlockFormatObjects::get(
       detail::ParameterTraits<SphericalPosition>::tag) const {
-    return sphericalPosition_.get();
+    return boost::get<SphericalPosition>(position_);
   }
   CartesianPosition AudioBlockFormatObjects::get(
       detail::ParameterTraits<CartesianPosition>::tag) const {
-    return cartesianPosition_.get();
+    return boost::get<CartesianPosition>(position_);
   }
   ScreenEdgeLock AudioBlockFormatObjects::get(
       detail::ParameterTraits<ScreenEdgeLock>::tag) const {
@@ -52,16 +52,16 @@ namespace adm {
   }
   ChannelLock AudioBlockFormatObjects::get(
       detail::ParameterTraits<ChannelLock>::tag) const {
-    return boost::get_optional_value_or(channelLock_, channelLockDefault);
+    return channelLock_ ? channelLock_.get() : channelLockDefault;
   }
   ObjectDivergence AudioBlockFormatObjects::get(
       detail::ParameterTraits<ObjectDivergence>::tag) const {
-    return boost::get_optional_value_or(objectDivergence_,
-                                        objectDivergenceDefault);
+    return objectDivergence_ ? objectDivergence_.get()
+                             : objectDivergenceDefault;
   }
   JumpPosition AudioBlockFormatObjects::get(
       detail::ParameterTraits<JumpPosition>::tag) const {
-    return boost::get_optional_value_or(jumpPosition_, jumpPositionDefault);
+    return jumpPosition_ ? jumpPosition_.get() : jumpPositionDefault;
   }
 
   // ---- Has ---- //
@@ -71,16 +71,15 @@ namespace adm {
   }
   bool AudioBlockFormatObjects::has(
       detail::ParameterTraits<detail::ParameterTraits<Position>>::tag) const {
-    return sphericalPosition_ != boost::none ||
-           cartesianPosition_ != boost::none;
+    return position_.which() != 0;
   }
   bool AudioBlockFormatObjects::has(
       detail::ParameterTraits<SphericalPosition>::tag) const {
-    return sphericalPosition_ != boost::none;
+    return position_.which() == 1;
   }
   bool AudioBlockFormatObjects::has(
       detail::ParameterTraits<CartesianPosition>::tag) const {
-    return cartesianPosition_ != boost::none;
+    return position_.which() == 2;
   }
   bool AudioBlockFormatObjects::has(
       detail::ParameterTraits<ScreenEdgeLock>::tag) const {
@@ -122,11 +121,9 @@ namespace adm {
     cartesian_ = cartesian;
 
     if (cartesian.get()) {
-      sphericalPosition_ = boost::none;
-      if (!cartesianPosition_) cartesianPosition_ = CartesianPosition();
+      if (!has<CartesianPosition>()) position_ = CartesianPosition();
     } else {
-      cartesianPosition_ = boost::none;
-      if (!sphericalPosition_) sphericalPosition_ = SphericalPosition();
+      if (!has<SphericalPosition>()) position_ = SphericalPosition();
     }
   }
   void AudioBlockFormatObjects::set(Position position) {
@@ -137,15 +134,13 @@ namespace adm {
     }
   }
   void AudioBlockFormatObjects::set(SphericalPosition position) {
-    sphericalPosition_ = position;
-    cartesianPosition_ = boost::none;
+    position_ = position;
     if (cartesian_ != boost::none) {
       cartesian_ = Cartesian(false);
     }
   }
   void AudioBlockFormatObjects::set(CartesianPosition position) {
-    cartesianPosition_ = position;
-    sphericalPosition_ = boost::none;
+    position_ = position;
     cartesian_ = Cartesian(true);
   }
   void AudioBlockFormatObjects::set(ScreenEdgeLock screenEdgeLock) {
@@ -170,16 +165,15 @@ namespace adm {
   }
   void AudioBlockFormatObjects::unset(
       detail::ParameterTraits<detail::ParameterTraits<Position>>::tag) {
-    sphericalPosition_ = boost::none;
-    cartesianPosition_ = boost::none;
+    position_ = boost::blank();
   }
   void AudioBlockFormatObjects::unset(
       detail::ParameterTraits<SphericalPosition>::tag) {
-    sphericalPosition_ = boost::none;
+    if (has<SphericalPosition>()) position_ = boost::blank();
   }
   void AudioBlockFormatObjects::unset(
       detail::ParameterTraits<CartesianPosition>::tag) {
-    cartesianPosition_ = boost::none;
+    if (has<CartesianPosition>()) position_ = boost::blank();
   }
   void AudioBlockFormatObjects::unset(
       detail::ParameterTraits<ScreenEdgeLock>::tag) {
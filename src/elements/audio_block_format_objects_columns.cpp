@@ -0,0 +1,185 @@
+#include "adm/elements/audio_block_format_objects_columns.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace adm {
+
+  namespace {
+    /// can time be stored as a FixedTime and converted back with asTime
+    /// without changing its representation?
+    bool isRepresentable(const Time& time) {
+      return time.isNanoseconds() || time.asFractional().denominator() !=
+                                         FixedTime::nanosecondsDenominator;
+    }
+
+    /// does block have any parameters which are not stored in columns?
+    bool needsFullBlock(const AudioBlockFormatObjects& block) {
+      if (!isRepresentable(block.get<Rtime>().get())) return true;
+      if (block.has<Duration>() &&
+          !isRepresentable(block.get<Duration>().get()))
+        return true;
+      if (block.has<SphericalPosition>()) {
+        if (block.get<SphericalPosition>().has<ScreenEdgeLock>()) return true;
+      } else if (block.has<CartesianPosition>()) {
+        if (block.get<CartesianPosition>().has<ScreenEdgeLock>()) return true;
+      } else {
+        return true;
+      }
+      return block.has<InitializeBlock>() ||
+             !block.isDefault<Importance>() ||
+             !block.isDefault<HeadphoneVirtualise>() ||
+             !block.isDefault<HeadLocked>() || !block.isDefault<ScreenRef>() ||
+             block.has<ScreenEdgeLock>() || !block.isDefault<ChannelLock>() ||
+             !block.isDefault<ObjectDivergence>() ||
+             !block.isDefault<JumpPosition>();
+    }
+  }  // namespace
+
+  SphericalPosition AudioBlockFormatObjectsColumns::Row::get(
+      SphericalPosition*) const {
+    if (columns_->cartesian_[index_]) {
+      throw std::runtime_error("optional value for SphericalPosition not set");
+    }
+    SphericalPosition position{Azimuth{columns_->azimuthOrX_[index_]},
+                               Elevation{columns_->elevationOrY_[index_]}};
+    if (columns_->distanceOrZSet_[index_])
+      position.set(Distance{columns_->distanceOrZ_[index_]});
+    return position;
+  }
+
+  CartesianPosition AudioBlockFormatObjectsColumns::Row::get(
+      CartesianPosition*) const {
+    if (!columns_->cartesian_[index_]) {
+      throw std::runtime_error("optional value for CartesianPosition not set");
+    }
+    CartesianPosition position{X{columns_->azimuthOrX_[index_]},
+                               Y{columns_->elevationOrY_[index_]}};
+    if (columns_->distanceOrZSet_[index_])
+      position.set(Z{columns_->distanceOrZ_[index_]});
+    return position;
+  }
+
+  AudioBlockFormatObjectsColumns::AudioBlockFormatObjectsColumns(
+      BlockFormatsConstRange<AudioBlockFormatObjects> blocks) {
+    reserve(static_cast<std::size_t>(blocks.size()));
+    for (const auto& block : blocks) add(block);
+  }
+
+  void AudioBlockFormatObjectsColumns::add(
+      const AudioBlockFormatObjects& block) {
+    ids_.push_back(block.get<AudioBlockFormatId>());
+    rtimes_.push_back(block.get<Rtime>().get().asFixed());
+    rtimeSet_.push_back(!block.isDefault<Rtime>());
+    bool hasDuration = block.has<Duration>();
+    durations_.push_back(hasDuration ? block.get<Duration>().get().asFixed()
+                                     : FixedTime{});
+    hasDuration_.push_back(hasDuration);
+
+    bool cartesian = block.has<CartesianPosition>();
+    cartesian_.push_back(cartesian);
+    cartesianSet_.push_back(!block.isDefault<Cartesian>());
+    if (cartesian) {
+      auto position = block.get<CartesianPosition>();
+      azimuthOrX_.push_back(position.get<X>().get());
+      elevationOrY_.push_back(position.get<Y>().get());
+      distanceOrZ_.push_back(position.get<Z>().get());
+      distanceOrZSet_.push_back(!position.isDefault<Z>());
+    } else if (block.has<SphericalPosition>()) {
+      auto position = block.get<SphericalPosition>();
+      azimuthOrX_.push_back(position.get<Azimuth>().get());
+      elevationOrY_.push_back(position.get<Elevation>().get());
+      distanceOrZ_.push_back(position.get<Distance>().get());
+      distanceOrZSet_.push_back(!position.isDefault<Distance>());
+    } else {
+      azimuthOrX_.push_back(0.0f);
+      elevationOrY_.push_back(0.0f);
+      distanceOrZ_.push_back(0.0f);
+      distanceOrZSet_.push_back(false);
+    }
+
+    widths_.push_back(block.get<Width>().get());
+    widthSet_.push_back(!block.isDefault<Width>());
+    heights_.push_back(block.get<Height>().get());
+    heightSet_.push_back(!block.isDefault<Height>());
+    depths_.push_back(block.get<Depth>().get());
+    depthSet_.push_back(!block.isDefault<Depth>());
+    diffuses_.push_back(block.get<Diffuse>().get());
+    diffuseSet_.push_back(!block.isDefault<Diffuse>());
+    auto gain = block.get<Gain>();
+    gains_.push_back(gain.isDb() ? gain.asDb() : gain.asLinear());
+    gainIsDb_.push_back(gain.isDb());
+    gainSet_.push_back(!block.isDefault<Gain>());
+
+    bool full = needsFullBlock(block);
+    isFull_.push_back(full);
+    if (full) fullBlocks_.emplace_back(ids_.size() - 1, block);
+  }
+
+  void AudioBlockFormatObjectsColumns::reserve(std::size_t size) {
+    ids_.reserve(size);
+    rtimes_.reserve(size);
+    rtimeSet_.reserve(size);
+    durations_.reserve(size);
+    hasDuration_.reserve(size);
+    cartesian_.reserve(size);
+    cartesianSet_.reserve(size);
+    azimuthOrX_.reserve(size);
+    elevationOrY_.reserve(size);
+    distanceOrZ_.reserve(size);
+    distanceOrZSet_.reserve(size);
+    widths_.reserve(size);
+    widthSet_.reserve(size);
+    heights_.reserve(size);
+    heightSet_.reserve(size);
+    depths_.reserve(size);
+    depthSet_.reserve(size);
+    diffuses_.reserve(size);
+    diffuseSet_.reserve(size);
+    gains_.reserve(size);
+    gainIsDb_.reserve(size);
+    gainSet_.reserve(size);
+    isFull_.reserve(size);
+  }
+
+  void AudioBlockFormatObjectsColumns::clear() {
+    *this = AudioBlockFormatObjectsColumns();
+  }
+
+  AudioBlockFormatObjects AudioBlockFormatObjectsColumns::block(
+      std::size_t index) const {
+    if (auto full = fullBlock(index)) return *full;
+
+    Row row{*this, index};
+    AudioBlockFormatObjects block =
+        cartesian_[index]
+            ? AudioBlockFormatObjects{row.get<CartesianPosition>()}
+            : AudioBlockFormatObjects{row.get<SphericalPosition>()};
+    if (cartesianSet_[index] && !cartesian_[index]) block.set(Cartesian{false});
+    block.set(ids_[index]);
+    if (rtimeSet_[index]) block.set(row.get<Rtime>());
+    if (hasDuration_[index]) block.set(row.get<Duration>());
+    if (widthSet_[index]) block.set(row.get<Width>());
+    if (heightSet_[index]) block.set(row.get<Height>());
+    if (depthSet_[index]) block.set(row.get<Depth>());
+    if (diffuseSet_[index]) block.set(row.get<Diffuse>());
+    if (gainSet_[index]) block.set(row.get<Gain>());
+    return block;
+  }
+
+  const AudioBlockFormatObjects* AudioBlockFormatObjectsColumns::fullBlock(
+      std::size_t index) const {
+    if (!isFull_[index]) return nullptr;
+    auto it = std::lower_bound(
+        fullBlocks_.begin(), fullBlocks_.end(), index,
+        [](const std::pair<std::size_t, AudioBlockFormatObjects>& entry,
+           std::size_t i) { return entry.first < i; });
+    return &it->second;
+  }
+
+  const AudioBlockFormatObjects&
+  AudioBlockFormatObjectsColumns::defaultBlock() {
+    static const AudioBlockFormatObjects block{SphericalPosition{}};
+    return block;
+  }
+
+}  // namespace adm
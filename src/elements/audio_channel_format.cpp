@@ -7,6 +7,8 @@
 #include "adm/elements/audio_block_format_hoa.hpp"
 #include "adm/elements/audio_block_format_matrix.hpp"
 #include "adm/elements/audio_block_format_objects.hpp"
+#include "adm/elements/private/block_format_loader.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/utilities/element_io.hpp"
 #include "adm/utilities/id_assignment.hpp"
@@ -38,20 +40,30 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioChannelFormat::set(AudioChannelFormatId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
       throw std::runtime_error("id already in use");
     }
     if (id.get<TypeDescriptor>() == get<TypeDescriptor>()) {
+      // block IDs only change if the value does; this avoids loading blocks
+      // when a channel format is added to a document without changing its ID
+      bool valueChanged = id.get<AudioChannelFormatIdValue>() !=
+                          id_.get<AudioChannelFormatIdValue>();
+      if (valueChanged) loadBlockFormats();
       id_ = id;
-      assignNewIdValue<AudioBlockFormatDirectSpeakers>();
-      assignNewIdValue<AudioBlockFormatMatrix>();
-      assignNewIdValue<AudioBlockFormatObjects>();
-      assignNewIdValue<AudioBlockFormatHoa>();
-      assignNewIdValue<AudioBlockFormatBinaural>();
+      if (valueChanged) {
+        assignNewIdValue<AudioBlockFormatDirectSpeakers>();
+        assignNewIdValue<AudioBlockFormatMatrix>();
+        assignNewIdValue<AudioBlockFormatObjects>();
+        assignNewIdValue<AudioBlockFormatHoa>();
+        assignNewIdValue<AudioBlockFormatBinaural>();
+      }
+      DocumentAttorney::idChanged(*this, oldId);
     } else {
       std::stringstream errorString;
       errorString << "mismatch between TypeDefinition of AudioChannelFormat ("
@@ -90,6 +102,7 @@ namespace adm {
 
   // ---- AudioBlocks ---- //
   void AudioChannelFormat::add(AudioBlockFormatDirectSpeakers blockFormat) {
+    loadBlockFormats();
     if (audioBlockFormatsDirectSpeakers_.empty()) {
       assignId(blockFormat);
     } else {
@@ -98,6 +111,7 @@ namespace adm {
     audioBlockFormatsDirectSpeakers_.push_back(std::move(blockFormat));
   }
   void AudioChannelFormat::add(AudioBlockFormatMatrix blockFormat) {
+    loadBlockFormats();
     if (audioBlockFormatsMatrix_.empty()) {
       assignId(blockFormat);
     } else {
@@ -107,6 +121,7 @@ namespace adm {
   }
 
   void AudioChannelFormat::add(AudioBlockFormatObjects blockFormat) {
+    loadBlockFormats();
     if (audioBlockFormatsObjects_.empty()) {
       assignId(blockFormat);
     } else {
@@ -116,6 +131,7 @@ namespace adm {
   }
 
   void AudioChannelFormat::add(AudioBlockFormatHoa blockFormat) {
+    loadBlockFormats();
     if (audioBlockFormatsHoa_.empty()) {
       assignId(blockFormat);
     } else {
@@ -125,6 +141,7 @@ namespace adm {
   }
 
   void AudioChannelFormat::add(AudioBlockFormatBinaural blockFormat) {
+    loadBlockFormats();
     if (audioBlockFormatsBinaural_.empty()) {
       assignId(blockFormat);
     } else {
@@ -133,60 +150,128 @@ namespace adm {
     audioBlockFormatsBinaural_.push_back(std::move(blockFormat));
   }
 
+  void AudioChannelFormat::addBlocks(
+      std::vector<AudioBlockFormatDirectSpeakers>&& blockFormats) {
+    appendBlockFormats(audioBlockFormatsDirectSpeakers_,
+                       std::move(blockFormats));
+  }
+
+  void AudioChannelFormat::addBlocks(
+      std::vector<AudioBlockFormatMatrix>&& blockFormats) {
+    appendBlockFormats(audioBlockFormatsMatrix_, std::move(blockFormats));
+  }
+
+  void AudioChannelFormat::addBlocks(
+      std::vector<AudioBlockFormatObjects>&& blockFormats) {
+    appendBlockFormats(audioBlockFormatsObjects_, std::move(blockFormats));
+  }
+
+  void AudioChannelFormat::addBlocks(
+      std::vector<AudioBlockFormatHoa>&& blockFormats) {
+    appendBlockFormats(audioBlockFormatsHoa_, std::move(blockFormats));
+  }
+
+  void AudioChannelFormat::addBlocks(
+      std::vector<AudioBlockFormatBinaural>&& blockFormats) {
+    appendBlockFormats(audioBlockFormatsBinaural_, std::move(blockFormats));
+  }
+
+  void AudioChannelFormat::reserve(std::size_t size) {
+    loadBlockFormats();
+    auto typeDescriptor = get<TypeDescriptor>();
+    if (typeDescriptor == TypeDefinition::DIRECT_SPEAKERS)
+      audioBlockFormatsDirectSpeakers_.reserve(size);
+    else if (typeDescriptor == TypeDefinition::MATRIX)
+      audioBlockFormatsMatrix_.reserve(size);
+    else if (typeDescriptor == TypeDefinition::OBJECTS)
+      audioBlockFormatsObjects_.reserve(size);
+    else if (typeDescriptor == TypeDefinition::HOA)
+      audioBlockFormatsHoa_.reserve(size);
+    else if (typeDescriptor == TypeDefinition::BINAURAL)
+      audioBlockFormatsBinaural_.reserve(size);
+  }
+
+  std::size_t AudioChannelFormat::capacity() const {
+    loadBlockFormats();
+    auto typeDescriptor = get<TypeDescriptor>();
+    if (typeDescriptor == TypeDefinition::DIRECT_SPEAKERS)
+      return audioBlockFormatsDirectSpeakers_.capacity();
+    else if (typeDescriptor == TypeDefinition::MATRIX)
+      return audioBlockFormatsMatrix_.capacity();
+    else if (typeDescriptor == TypeDefinition::OBJECTS)
+      return audioBlockFormatsObjects_.capacity();
+    else if (typeDescriptor == TypeDefinition::HOA)
+      return audioBlockFormatsHoa_.capacity();
+    else if (typeDescriptor == TypeDefinition::BINAURAL)
+      return audioBlockFormatsBinaural_.capacity();
+    return 0;
+  }
+
   BlockFormatsConstRange<AudioBlockFormatDirectSpeakers>
   AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatDirectSpeakers>::tag) const {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsDirectSpeakers_.begin(),
                                       audioBlockFormatsDirectSpeakers_.end());
   }
   BlockFormatsConstRange<AudioBlockFormatMatrix> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatMatrix>::tag) const {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsMatrix_.begin(),
                                       audioBlockFormatsMatrix_.end());
   }
   BlockFormatsConstRange<AudioBlockFormatObjects> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatObjects>::tag) const {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsObjects_.begin(),
                                       audioBlockFormatsObjects_.end());
   }
   BlockFormatsConstRange<AudioBlockFormatHoa> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatHoa>::tag) const {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsHoa_.begin(),
                                       audioBlockFormatsHoa_.end());
   }
   BlockFormatsConstRange<AudioBlockFormatBinaural> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatBinaural>::tag) const {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsBinaural_.begin(),
                                       audioBlockFormatsBinaural_.end());
   }
 
   BlockFormatsRange<AudioBlockFormatDirectSpeakers> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatDirectSpeakers>::tag) {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsDirectSpeakers_.begin(),
                                       audioBlockFormatsDirectSpeakers_.end());
   }
   BlockFormatsRange<AudioBlockFormatMatrix> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatMatrix>::tag) {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsMatrix_.begin(),
                                       audioBlockFormatsMatrix_.end());
   }
   BlockFormatsRange<AudioBlockFormatObjects> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatObjects>::tag) {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsObjects_.begin(),
                                       audioBlockFormatsObjects_.end());
   }
   BlockFormatsRange<AudioBlockFormatHoa> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatHoa>::tag) {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsHoa_.begin(),
                                       audioBlockFormatsHoa_.end());
   }
   BlockFormatsRange<AudioBlockFormatBinaural> AudioChannelFormat::get(
       detail::ParameterTraits<AudioBlockFormatBinaural>::tag) {
+    loadBlockFormats();
     return boost::make_iterator_range(audioBlockFormatsBinaural_.begin(),
                                       audioBlockFormatsBinaural_.end());
   }
 
   void AudioChannelFormat::clearAudioBlockFormats() {
+    blockFormatLoader_.reset();
     audioBlockFormatsDirectSpeakers_.clear();
     audioBlockFormatsMatrix_.clear();
     audioBlockFormatsObjects_.clear();
@@ -194,6 +279,22 @@ namespace adm {
     audioBlockFormatsBinaural_.clear();
   }
 
+  void AudioChannelFormat::loadBlockFormats() const {
+    if (!blockFormatLoader_) return;
+    // the blocks are part of the observable state whether or not they have
+    // been loaded, and channel formats are only created non-const by
+    // create(), so this is safe
+    auto& self = const_cast<AudioChannelFormat&>(*this);
+    auto loader = std::move(self.blockFormatLoader_);
+    try {
+      loader->load(self);
+    } catch (...) {
+      self.clearAudioBlockFormats();
+      self.blockFormatLoader_ = std::move(loader);
+      throw;
+    }
+  }
+
   // ---- Common ---- //
   void AudioChannelFormat::print(std::ostream& os) const {
     os << get<AudioChannelFormatId>();
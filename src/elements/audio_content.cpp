@@ -3,6 +3,7 @@
 #include <functional>
 #include "adm/document.hpp"
 #include "adm/elements/loudness_metadata.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/utilities/element_io.hpp"
@@ -82,14 +83,17 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioContent::set(AudioContentId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
       throw std::runtime_error("id already in use");
     }
     id_ = id;
+    DocumentAttorney::idChanged(*this, oldId);
   }
   void AudioContent::set(AudioContentName name) { name_ = std::move(name); }
   void AudioContent::set(AudioContentLanguage language) {
@@ -180,6 +184,7 @@ namespace adm {
     auto it = std::find(audioObjects_.begin(), audioObjects_.end(), object);
     if (it != audioObjects_.end()) {
       audioObjects_.erase(it);
+      DocumentAttorney::referenceRemoved(*this, object);
     }
   }
 
@@ -187,7 +192,9 @@ namespace adm {
 
   void AudioContent::clearReferences(
       detail::ParameterTraits<AudioObject>::tag) {
-    return audioObjects_.clear();
+    for (auto& object : audioObjects_)
+      DocumentAttorney::referenceRemoved(*this, object);
+    audioObjects_.clear();
   }
 
   std::ostream& operator<<(std::ostream& stream,
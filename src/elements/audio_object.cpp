@@ -1,5 +1,6 @@
 #include "adm/elements/audio_object.hpp"
 #include "adm/document.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/utilities/element_io.hpp"
@@ -97,14 +98,17 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioObject::set(AudioObjectId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
       throw std::runtime_error("id already in use");
     }
     id_ = id;
+    DocumentAttorney::idChanged(*this, oldId);
   }
   void AudioObject::set(AudioObjectName name) { name_ = std::move(name); }
   void AudioObject::set(Start start) { start_ = start; }
@@ -222,6 +226,7 @@ namespace adm {
     auto it = std::find(audioObjects_.begin(), audioObjects_.end(), object);
     if (it != audioObjects_.end()) {
       audioObjects_.erase(it);
+      DocumentAttorney::referenceRemoved(*this, object);
     }
   }
 
@@ -231,6 +236,7 @@ namespace adm {
                         packFormat);
     if (it != audioPackFormats_.end()) {
       audioPackFormats_.erase(it);
+      DocumentAttorney::referenceRemoved(*this, packFormat);
     }
   }
 
@@ -239,6 +245,10 @@ namespace adm {
         std::find(audioTrackUids_.begin(), audioTrackUids_.end(), trackUid);
     if (it != audioTrackUids_.end()) {
       audioTrackUids_.erase(it);
+      // silent tracks may be referenced more than once
+      if (std::find(audioTrackUids_.begin(), audioTrackUids_.end(),
+                    trackUid) == audioTrackUids_.end())
+        DocumentAttorney::referenceRemoved(*this, trackUid);
     }
   }
 
@@ -250,17 +260,23 @@ namespace adm {
   }
 
   void AudioObject::clearReferences(detail::ParameterTraits<AudioObject>::tag) {
-    return audioObjects_.clear();
+    for (auto& object : audioObjects_)
+      DocumentAttorney::referenceRemoved(*this, object);
+    audioObjects_.clear();
   }
 
   void AudioObject::clearReferences(
       detail::ParameterTraits<AudioPackFormat>::tag) {
-    return audioPackFormats_.clear();
+    for (auto& packFormat : audioPackFormats_)
+      DocumentAttorney::referenceRemoved(*this, packFormat);
+    audioPackFormats_.clear();
   }
 
   void AudioObject::clearReferences(
       detail::ParameterTraits<AudioTrackUid>::tag) {
-    return audioTrackUids_.clear();
+    for (auto& trackUid : audioTrackUids_)
+      DocumentAttorney::referenceRemoved(*this, trackUid);
+    audioTrackUids_.clear();
   }
 
   // --- ComplementaryObjects ---- //
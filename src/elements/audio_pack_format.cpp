@@ -1,5 +1,7 @@
 #include "adm/elements/audio_pack_format.hpp"
+#include "adm/elements/audio_pack_format_hoa.hpp"
 #include "adm/document.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/utilities/element_io.hpp"
@@ -35,8 +37,10 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioPackFormat::set(AudioPackFormatId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
@@ -44,6 +48,7 @@ namespace adm {
     }
     if (id.get<TypeDescriptor>() == get<TypeDescriptor>()) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
     } else {
       std::stringstream errorString;
       errorString << "mismatch between TypeDefinition of AudioPackFormat ("
@@ -147,6 +152,7 @@ namespace adm {
                         audioChannelFormats_.end(), object);
     if (it != audioChannelFormats_.end()) {
       audioChannelFormats_.erase(it);
+      DocumentAttorney::referenceRemoved(*this, object);
     }
   }
 
@@ -156,6 +162,7 @@ namespace adm {
                         packFormat);
     if (it != audioPackFormats_.end()) {
       audioPackFormats_.erase(it);
+      DocumentAttorney::referenceRemoved(*this, packFormat);
     }
   }
 
@@ -166,11 +173,15 @@ namespace adm {
 
   void AudioPackFormat::clearReferences(
       detail::ParameterTraits<AudioChannelFormat>::tag) {
+    for (auto& channelFormat : audioChannelFormats_)
+      DocumentAttorney::referenceRemoved(*this, channelFormat);
     audioChannelFormats_.clear();
   }
 
   void AudioPackFormat::clearReferences(
       detail::ParameterTraits<AudioPackFormat>::tag) {
+    for (auto& packFormat : audioPackFormats_)
+      DocumentAttorney::referenceRemoved(*this, packFormat);
     audioPackFormats_.clear();
   }
 
@@ -197,8 +208,14 @@ namespace adm {
   const std::weak_ptr<Document> &AudioPackFormat::getParent() const { return parent_; }
 
   std::shared_ptr<AudioPackFormat> AudioPackFormat::copy() const {
-    auto audioPackFormatCopy =
-        std::shared_ptr<AudioPackFormat>(new AudioPackFormat(*this));
+    std::shared_ptr<AudioPackFormat> audioPackFormatCopy;
+    if (auto hoaPackFormat = dynamic_cast<const AudioPackFormatHoa *>(this)) {
+      audioPackFormatCopy = std::shared_ptr<AudioPackFormat>(
+          new AudioPackFormatHoa(*hoaPackFormat));
+    } else {
+      audioPackFormatCopy =
+          std::shared_ptr<AudioPackFormat>(new AudioPackFormat(*this));
+    }
     audioPackFormatCopy->setParent(std::weak_ptr<Document>());
     audioPackFormatCopy->disconnectReferences();
     return audioPackFormatCopy;
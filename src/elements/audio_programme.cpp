@@ -3,6 +3,7 @@
 #include "adm/elements/time.hpp"
 #include "adm/elements/audio_content.hpp"
 #include "adm/elements/loudness_metadata.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/elements/private/auto_parent.hpp"
@@ -81,14 +82,17 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioProgramme::set(AudioProgrammeId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
       throw std::runtime_error("id already in use");
     }
     id_ = id;
+    DocumentAttorney::idChanged(*this, oldId);
   }
 
   void AudioProgramme::set(AudioProgrammeName name) { name_ = std::move(name); }
@@ -141,6 +145,7 @@ namespace adm {
     auto it = std::find(audioContents_.begin(), audioContents_.end(), content);
     if (it != audioContents_.end()) {
       audioContents_.erase(it);
+      DocumentAttorney::referenceRemoved(*this, content);
     }
   }
 
@@ -150,6 +155,8 @@ namespace adm {
 
   void AudioProgramme::clearReferences(
       detail::ParameterTraits<AudioContent>::tag) {
+    for (auto& content : audioContents_)
+      DocumentAttorney::referenceRemoved(*this, content);
     audioContents_.clear();
   }
 
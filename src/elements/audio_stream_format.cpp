@@ -1,5 +1,6 @@
 #include "adm/elements/audio_stream_format.hpp"
 #include "adm/document.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/utilities/element_io.hpp"
@@ -25,14 +26,17 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioStreamFormat::set(AudioStreamFormatId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
       throw std::runtime_error("id already in use");
     }
     id_ = id;
+    DocumentAttorney::idChanged(*this, oldId);
   }
   void AudioStreamFormat::set(AudioStreamFormatName name) {
     name_ = std::move(name);
@@ -60,6 +64,8 @@ namespace adm {
           "AudioStreamFormat cannot refer to an AudioChannelFormat in a "
           "different document");
     }
+    if (audioChannelFormat_ != channelFormat)
+      DocumentAttorney::referenceRemoved(*this, audioChannelFormat_);
     audioChannelFormat_ = std::move(channelFormat);
   }
 
@@ -70,6 +76,8 @@ namespace adm {
           "AudioStreamFormat cannot refer to an AudioPackFormat in a "
           "different document");
     }
+    if (audioPackFormat_ != packFormat)
+      DocumentAttorney::referenceRemoved(*this, audioPackFormat_);
     audioPackFormat_ = std::move(packFormat);
   }
 
@@ -141,11 +149,13 @@ namespace adm {
 
   void AudioStreamFormat::removeReference(
       detail::ParameterTraits<AudioChannelFormat>::tag) {
+    DocumentAttorney::referenceRemoved(*this, audioChannelFormat_);
     audioChannelFormat_ = nullptr;
   }
 
   void AudioStreamFormat::removeReference(
       detail::ParameterTraits<AudioPackFormat>::tag) {
+    DocumentAttorney::referenceRemoved(*this, audioPackFormat_);
     audioPackFormat_ = nullptr;
   }
 
@@ -164,12 +174,15 @@ namespace adm {
 
     if (it != audioTrackFormats_.end()) {
       audioTrackFormats_.erase(it);
+      DocumentAttorney::referenceRemoved(*this, trackFormat);
       trackFormat->removeReference<AudioStreamFormat>();
     }
   }
 
   void AudioStreamFormat::clearReferences(
       detail::ParameterTraits<AudioTrackFormat>::tag) {
+    for (auto& weakTrackFormat : audioTrackFormats_)
+      DocumentAttorney::referenceRemoved(*this, weakTrackFormat.lock());
     audioTrackFormats_.clear();
   }
 
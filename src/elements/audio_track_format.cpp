@@ -1,6 +1,7 @@
 #include "adm/elements/audio_track_format.hpp"
 #include "adm/document.hpp"
 #include "adm/elements/audio_stream_format.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/utilities/element_io.hpp"
@@ -24,14 +25,17 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioTrackFormat::set(AudioTrackFormatId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
       throw std::runtime_error("id already in use");
     }
     id_ = id;
+    DocumentAttorney::idChanged(*this, oldId);
   }
   void AudioTrackFormat::set(AudioTrackFormatName name) {
     name_ = std::move(name);
@@ -99,6 +103,7 @@ namespace adm {
       // remove from this first, to avoid  cyclic reference removement calls
       auto tmp = audioStreamFormat_;
       audioStreamFormat_.reset();
+      DocumentAttorney::referenceRemoved(*this, tmp);
       if (tmp) {
         tmp->removeReference(shared_from_this());
       }
@@ -1,5 +1,6 @@
 #include "adm/document.hpp"
 #include "adm/elements/audio_track_format.hpp"
+#include "adm/elements/private/document_attorney.hpp"
 #include "adm/elements/private/parent_attorneys.hpp"
 #include "adm/elements/private/auto_parent.hpp"
 #include "adm/utilities/element_io.hpp"
@@ -43,8 +44,10 @@ namespace adm {
 
   // ---- Setter ---- //
   void AudioTrackUid::set(AudioTrackUidId id) {
+    auto oldId = id_;
     if (isUndefined(id)) {
       id_ = id;
+      DocumentAttorney::idChanged(*this, oldId);
       return;
     }
     if (getParent().lock() != nullptr && getParent().lock()->lookup(id)) {
@@ -57,6 +60,7 @@ namespace adm {
       throw error::AdmGenericRuntimeError(
           "audioTrackUid with ID zero has no references or parameters");
     id_ = id;
+    DocumentAttorney::idChanged(*this, oldId);
   }
   void AudioTrackUid::set(SampleRate sampleRate) {
     if (isSilent())
@@ -109,6 +113,8 @@ namespace adm {
           trackFormat->get<AudioTrackFormatId>());
     }
 
+    if (audioTrackFormat_ != trackFormat)
+      DocumentAttorney::referenceRemoved(*this, audioTrackFormat_);
     audioTrackFormat_ = std::move(trackFormat);
   }
 
@@ -122,6 +128,8 @@ namespace adm {
           "AudioTrackUid cannot refer to an AudioPackFormat in a different "
           "document");
     }
+    if (audioPackFormat_ != packFormat)
+      DocumentAttorney::referenceRemoved(*this, audioPackFormat_);
     audioPackFormat_ = std::move(packFormat);
   }
 
@@ -142,6 +150,8 @@ namespace adm {
           audioTrackFormat_->get<AudioTrackFormatId>());
     }
 
+    if (audioChannelFormat_ != channelFormat)
+      DocumentAttorney::referenceRemoved(*this, audioChannelFormat_);
     audioChannelFormat_ = std::move(channelFormat);
   }
 
@@ -183,16 +193,19 @@ namespace adm {
 
   void AudioTrackUid::removeReference(
       detail::ParameterTraits<AudioTrackFormat>::tag) {
+    DocumentAttorney::referenceRemoved(*this, audioTrackFormat_);
     audioTrackFormat_ = nullptr;
   }
 
   void AudioTrackUid::removeReference(
       detail::ParameterTraits<AudioChannelFormat>::tag) {
+    DocumentAttorney::referenceRemoved(*this, audioChannelFormat_);
     audioChannelFormat_ = nullptr;
   }
 
   void AudioTrackUid::removeReference(
       detail::ParameterTraits<AudioPackFormat>::tag) {
+    DocumentAttorney::referenceRemoved(*this, audioPackFormat_);
     audioPackFormat_ = nullptr;
   }
 
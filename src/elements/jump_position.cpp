@@ -1,4 +1,5 @@
 #include "adm/elements/jump_position.hpp"
+#include "adm/private/number_parsing.hpp"
 
 #include <iomanip>
 
@@ -68,7 +69,8 @@ namespace adm {
     return jumpPosition.set(JumpPositionFlag(false));
   }
   InterpolationLength parseInterpolationLength(const std::string &length) {
-    auto floatTime = std::chrono::duration<float>(stof(length));
+    auto floatTime = std::chrono::duration<float>(xml::detail::parseFloat(
+        length.data(), length.data() + length.size()));
     return InterpolationLength(
         std::chrono::duration_cast<std::chrono::nanoseconds>(floatTime));
   }
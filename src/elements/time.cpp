@@ -1,8 +1,7 @@
 #include "adm/elements/time.hpp"
 #include <boost/integer/common_factor.hpp>
-#include <iomanip>
-#include <regex>
-#include <sstream>
+#include <boost/rational.hpp>
+#include <limits>
 
 namespace adm {
   namespace detail {
@@ -18,19 +17,54 @@ namespace adm {
     return {numerator() / gcd, denominator() / gcd};
   }
 
-  struct AsNanosecondsVisitor
-      : public boost::static_visitor<std::chrono::nanoseconds> {
-    std::chrono::nanoseconds operator()(
-        const std::chrono::nanoseconds& time) const {
-      return time;
+  constexpr int64_t FixedTime::nanosecondsDenominator;
+
+  std::chrono::nanoseconds FixedTime::asNanoseconds() const {
+    if (isNanoseconds()) return std::chrono::nanoseconds{numerator()};
+#ifdef __SIZEOF_INT128__
+    // the same result as below, without finding the gcd
+    return std::chrono::nanoseconds{static_cast<int64_t>(
+        static_cast<__int128>(numerator()) * nanosecondsDenominator /
+        denominator())};
+#else
+    FractionalTime normalised = asFractional().normalised();
+    return std::chrono::nanoseconds{
+        (nanosecondsDenominator * normalised.numerator()) /
+        normalised.denominator()};
+#endif
+  }
+
+  namespace detail {
+    int compareSlow(const FixedTime& a, const FixedTime& b) {
+#ifdef __SIZEOF_INT128__
+      auto lhs = static_cast<__int128>(a.numerator()) * b.denominator();
+      auto rhs = static_cast<__int128>(b.numerator()) * a.denominator();
+#else
+      // boost::rational compares without overflowing
+      boost::rational<int64_t> lhs(a.numerator(), a.denominator());
+      boost::rational<int64_t> rhs(b.numerator(), b.denominator());
+#endif
+      return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
     }
 
-    std::chrono::nanoseconds operator()(const FractionalTime& time) const {
-      FractionalTime normalised = time.normalised();
-      return std::chrono::nanoseconds{(1000000000 * normalised.numerator()) /
-                                      normalised.denominator()};
+    FixedTime addSlow(const FixedTime& a, const FixedTime& b, bool subtract) {
+      int64_t gcd = boost::integer::gcd(a.denominator(), b.denominator());
+      int64_t aScale = b.denominator() / gcd;
+      int64_t bScale = a.denominator() / gcd;
+      if (aScale > std::numeric_limits<int64_t>::max() / a.denominator()) {
+        // the common denominator doesn't fit, so use the smallest
+        // denominator of the result instead
+        boost::rational<int64_t> lhs(a.numerator(), a.denominator());
+        boost::rational<int64_t> rhs(b.numerator(), b.denominator());
+        auto result = subtract ? lhs - rhs : lhs + rhs;
+        return {result.numerator(), result.denominator()};
+      }
+      int64_t bNumerator = b.numerator() * bScale;
+      return {a.numerator() * aScale +
+                  (subtract ? -bNumerator : bNumerator),
+              a.denominator() * aScale};
     }
-  };
+  }  // namespace detail
 
   struct AsFractionalVisitor : public boost::static_visitor<FractionalTime> {
     FractionalTime operator()(const std::chrono::nanoseconds& time) const {
@@ -41,103 +75,174 @@ namespace adm {
   };
 
   std::chrono::nanoseconds Time::asNanoseconds() const {
-    return boost::apply_visitor(AsNanosecondsVisitor(), time);
+    return asFixed().asNanoseconds();
   }
 
   FractionalTime Time::asFractional() const {
     return boost::apply_visitor(AsFractionalVisitor(), time);
   }
 
+  namespace {
+    bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+    const char* skipDigits(const char* p, const char* end) {
+      while (p != end && isDigit(*p)) ++p;
+      return p;
+    }
+
+    int parseTwoDigits(const char* p) {
+      return (p[0] - '0') * 10 + (p[1] - '0');
+    }
+
+    /// parse a string of digits, which must fit in an int, as with std::stoi
+    int64_t parseIntDigits(const char* begin, const char* end) {
+      int64_t value = 0;
+      for (; begin != end; ++begin) {
+        value = value * 10 + (*begin - '0');
+        if (value > std::numeric_limits<int>::max()) {
+          throw std::out_of_range("stoi");
+        }
+      }
+      return value;
+    }
+
+    [[noreturn]] void throwInvalidTimecode(const char* begin, const char* end,
+                                           const char* reason = "") {
+      throw std::runtime_error("invalid timecode: " + std::string(begin, end) +
+                               reason);
+    }
+  }  // namespace
+
   Time parseTimecode(const std::string& timecode) {
-    const static std::regex commonFormat("(\\d{2}):(\\d{2}):(\\d{2}).(\\d+)");
-    const static std::regex fractionalFormat(
-        "(\\d{2}):(\\d{2}):(\\d{2}).(\\d+)S(\\d+)");
+    return parseTimecode(timecode.data(), timecode.data() + timecode.size());
+  }
+
+  Time parseTimecode(const char* begin, const char* end) {
+    // hh:mm:ss, any separator (the '.' in the regular expressions which this
+    // used to use was unescaped), then either a decimal fraction, or a
+    // fraction in the form numeratorSdenominator
+    auto length = end - begin;
+    if (length < 10 || !isDigit(begin[0]) || !isDigit(begin[1]) ||
+        begin[2] != ':' || !isDigit(begin[3]) || !isDigit(begin[4]) ||
+        begin[5] != ':' || !isDigit(begin[6]) || !isDigit(begin[7]) ||
+        begin[8] == '\n' || begin[8] == '\r') {
+      throwInvalidTimecode(begin, end);
+    }
+    int64_t seconds = 3600 * parseTwoDigits(begin) +
+                      60 * parseTwoDigits(begin + 3) +
+                      parseTwoDigits(begin + 6);
 
-    std::smatch timecodeMatch;
-    if (std::regex_match(timecode, timecodeMatch, commonFormat)) {
-      const std::string& ns_str = timecodeMatch[4];
+    const char* fractionBegin = begin + 9;
+    const char* fractionEnd = skipDigits(fractionBegin, end);
+    if (fractionEnd == fractionBegin) throwInvalidTimecode(begin, end);
 
+    if (fractionEnd == end) {
       // parse number of nanoseconds as if it always had 9 digits
       int64_t ns = 0;
-      int64_t place_value = 1;
-      for (size_t i = 8; i != (size_t)-1; i--) {
-        if (i < ns_str.size()) ns += place_value * (ns_str[i] - '0');
-        place_value *= 10;
+      const char* digit = fractionBegin;
+      for (int i = 0; i < 9; i++) {
+        ns = ns * 10 + (digit != fractionEnd ? *digit++ - '0' : 0);
       }
+      return std::chrono::seconds(seconds) + std::chrono::nanoseconds(ns);
+    }
 
-      return std::chrono::hours(stoi(timecodeMatch[1])) +
-             std::chrono::minutes(stoi(timecodeMatch[2])) +
-             std::chrono::seconds(stoi(timecodeMatch[3])) +
-             std::chrono::nanoseconds(ns);
-    } else if (std::regex_match(timecode, timecodeMatch, fractionalFormat)) {
-      int64_t seconds = 3600 * stoi(timecodeMatch[1]) +
-                        60 * stoi(timecodeMatch[2]) +
-                        1 * stoi(timecodeMatch[3]);
-
-      int64_t numerator = stoi(timecodeMatch[4]);
-      int64_t denominator = stoi(timecodeMatch[5]);
-
-      if (denominator == 0) {
-        std::stringstream errorString;
-        errorString << "invalid timecode: " << timecode
-                    << " has a zero denominator";
-        throw std::runtime_error(errorString.str());
-      }
+    const char* denominatorBegin = fractionEnd + 1;
+    const char* denominatorEnd = skipDigits(denominatorBegin, end);
+    if (*fractionEnd != 'S' || denominatorBegin == denominatorEnd ||
+        denominatorEnd != end) {
+      throwInvalidTimecode(begin, end);
+    }
+
+    int64_t numerator = parseIntDigits(fractionBegin, fractionEnd);
+    int64_t denominator = parseIntDigits(denominatorBegin, denominatorEnd);
 
-      return FractionalTime{seconds * denominator + numerator, denominator};
-    } else {
-      std::stringstream errorString;
-      errorString << "invalid timecode: " << timecode;
-      throw std::runtime_error(errorString.str());
+    if (denominator == 0) {
+      throwInvalidTimecode(begin, end, " has a zero denominator");
     }
+
+    return FractionalTime{seconds * denominator + numerator, denominator};
   }
 
-  struct FormatTimeVisitor : public boost::static_visitor<std::string> {
-    std::string operator()(const std::chrono::nanoseconds& time) const {
-      std::stringstream ss;
-      ss << std::setw(2) << std::setfill('0')
-         << std::chrono::duration_cast<std::chrono::hours>(time).count();
-      ss << ":";
-      ss << std::setw(2) << std::setfill('0')
-         << std::chrono::duration_cast<std::chrono::minutes>(time).count() % 60;
-      ss << ":";
-      ss << std::setw(2) << std::setfill('0')
-         << std::chrono::duration_cast<std::chrono::seconds>(time).count() % 60;
-      ss << ".";
-
-      {
-        auto ns = time.count() % 1000000000;
-        // drop trailing zero digits, while keeping at least 5 to satisfy BS.2076-2
-        int precision = 9;
-        while (ns % 10 == 0 && precision > 5) {
-          ns /= 10;
-          precision--;
-        }
-        ss << std::setw(precision) << std::setfill('0') << ns;
+  namespace {
+    /// write value to out in decimal, padded on the left with '0' to width
+    /// characters in the same way as std::setw and std::setfill('0')
+    char* writeDecimal(char* out, int64_t value, int width = 0) {
+      char digits[20];
+      int count = 0;
+      uint64_t magnitude =
+          value < 0 ? 0 - static_cast<uint64_t>(value) : value;
+      do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+      } while (magnitude);
+
+      for (int length = count + (value < 0); length < width; length++) {
+        *out++ = '0';
       }
+      if (value < 0) *out++ = '-';
+      while (count) *out++ = digits[--count];
+      return out;
+    }
 
-      return ss.str();
+    /// write hh:mm:ss. for a whole number of seconds
+    char* writeHoursMinutesSeconds(char* out, int64_t hours, int64_t minutes,
+                                   int64_t seconds) {
+      out = writeDecimal(out, hours, 2);
+      *out++ = ':';
+      out = writeDecimal(out, minutes, 2);
+      *out++ = ':';
+      out = writeDecimal(out, seconds, 2);
+      *out++ = '.';
+      return out;
+    }
+  }  // namespace
+
+  struct FormatTimeVisitor : public boost::static_visitor<char*> {
+    explicit FormatTimeVisitor(char* out) : out(out) {}
+
+    char* operator()(const std::chrono::nanoseconds& time) const {
+      int64_t count = time.count();
+      char* p = writeHoursMinutesSeconds(out, count / 3600000000000,
+                                         (count / 60000000000) % 60,
+                                         (count / 1000000000) % 60);
+
+      auto ns = count % 1000000000;
+      // drop trailing zero digits, while keeping at least 5 to satisfy BS.2076-2
+      int precision = 9;
+      while (ns % 10 == 0 && precision > 5) {
+        ns /= 10;
+        precision--;
+      }
+      return writeDecimal(p, ns, precision);
     }
 
-    std::string operator()(const FractionalTime& time) const {
+    char* operator()(const FractionalTime& time) const {
       int64_t whole_seconds = time.numerator() / time.denominator();
       int64_t frac_numerator =
           time.numerator() - whole_seconds * time.denominator();
 
-      std::stringstream ss;
-      ss << std::setw(2) << std::setfill('0') << whole_seconds / 3600;
-      ss << ":";
-      ss << std::setw(2) << std::setfill('0') << (whole_seconds / 60) % 60;
-      ss << ":";
-      ss << std::setw(2) << std::setfill('0') << whole_seconds % 60;
-      ss << ".";
-      ss << frac_numerator << "S" << time.denominator();
-      return ss.str();
+      char* p = writeHoursMinutesSeconds(out, whole_seconds / 3600,
+                                         (whole_seconds / 60) % 60,
+                                         whole_seconds % 60);
+      p = writeDecimal(p, frac_numerator);
+      *p++ = 'S';
+      return writeDecimal(p, time.denominator());
     }
+
+    char* out;
   };
 
   std::string formatTimecode(const Time& time) {
-    return boost::apply_visitor(FormatTimeVisitor(), time.asVariant());
+    char buffer[timecodeBufferSize];
+    auto length = formatTimecode(time, buffer);
+    return std::string(buffer, length);
+  }
+
+  std::size_t formatTimecode(const Time& time, char* buffer) {
+    char* end =
+        boost::apply_visitor(FormatTimeVisitor(buffer), time.asVariant());
+    *end = '\0';
+    return static_cast<std::size_t>(end - buffer);
   }
 
 }  // namespace adm
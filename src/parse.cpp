@@ -1,42 +1,286 @@
 #include "adm/parse.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <istream>
 #include <memory>
+#include <new>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include "adm/common_definitions.hpp"
 #include "adm/private/document_parser.hpp"
+#include "adm/private/mapped_file.hpp"
 #include "adm/serial/frame_header_parser.hpp"
 
 namespace adm {
   class FrameHeader;
   std::shared_ptr<Document> parseXml(const std::string& filename,
                                      xml::ParserOptions options) {
+    return parseXml(filename, options, xml::ParseFilter());
+  }
+
+  std::shared_ptr<Document> parseXml(std::istream& stream,
+                                     xml::ParserOptions options) {
+    return parseXml(stream, options, xml::ParseFilter());
+  }
+
+  std::shared_ptr<Document> parseXml(const std::string& filename,
+                                     const FrameHeader& header,
+                                     xml::ParserOptions options) {
+    return parseXml(filename, header, options, xml::ParseFilter());
+  }
+
+  std::shared_ptr<Document> parseXml(std::istream& stream,
+                                     const FrameHeader& header,
+                                     xml::ParserOptions options) {
+    return parseXml(stream, header, options, xml::ParseFilter());
+  }
+
+  std::shared_ptr<Document> parseXml(const std::string& filename,
+                                     xml::ParserOptions options,
+                                     const xml::ParseFilter& filter) {
     auto commonDefinitions = getCommonDefinitions();
     xml::DocumentParser parser(filename, options, commonDefinitions);
+    parser.setFilter(filter);
     return parser.parse();
   }
 
   std::shared_ptr<Document> parseXml(std::istream& stream,
-                                     xml::ParserOptions options) {
+                                     xml::ParserOptions options,
+                                     const xml::ParseFilter& filter) {
     auto commonDefinitions = getCommonDefinitions();
     xml::DocumentParser parser(stream, options, commonDefinitions);
+    parser.setFilter(filter);
     return parser.parse();
   }
   std::shared_ptr<Document> parseXml(const std::string& filename,
                                      const FrameHeader& header,
-                                     xml::ParserOptions options) {
+                                     xml::ParserOptions options,
+                                     const xml::ParseFilter& filter) {
     auto commonDefinitions = getCommonDefinitions();
     xml::DocumentParser parser(filename, options, commonDefinitions);
+    parser.setFilter(filter);
     parser.setHeader(header);
     return parser.parse();
   }
   std::shared_ptr<Document> parseXml(std::istream& stream,
                                      const FrameHeader& header,
-                                     xml::ParserOptions options) {
+                                     xml::ParserOptions options,
+                                     const xml::ParseFilter& filter) {
     auto commonDefinitions = getCommonDefinitions();
     xml::DocumentParser parser(stream, options, commonDefinitions);
+    parser.setFilter(filter);
     parser.setHeader(header);
     return parser.parse();
   }
 
+  std::shared_ptr<Document> parseXml(const char* data, std::size_t size,
+                                     xml::ParserOptions options,
+                                     const xml::ParseFilter& filter) {
+    std::vector<char> buffer;
+    buffer.reserve(size + 1);
+    buffer.assign(data, data + size);
+    buffer.push_back('\0');
+    return parseXmlInSitu(buffer.data(), size, options, filter);
+  }
+
+  std::shared_ptr<Document> parseXmlInSitu(char* data, std::size_t size,
+                                           xml::ParserOptions options,
+                                           const xml::ParseFilter& filter) {
+    if (data[size] != '\0') {
+      throw std::invalid_argument(
+          "data passed to parseXmlInSitu must be null-terminated");
+    }
+    auto commonDefinitions = getCommonDefinitions();
+    xml::DocumentParser parser(data, options, commonDefinitions);
+    parser.setFilter(filter);
+    return parser.parse();
+  }
+
+  std::shared_ptr<Document> parseXmlMapped(const std::string& filename,
+                                           xml::ParserOptions options,
+                                           const xml::ParseFilter& filter) {
+    xml::MappedFile file(filename);
+    return parseXmlInSitu(file.data(), file.size(), options, filter);
+  }
+
+  std::shared_ptr<Document> parseXmlStreaming(
+      std::istream& stream, xml::StreamingParserHandler& handler,
+      xml::ParserOptions options, const xml::ParseFilter& filter) {
+    auto commonDefinitions = getCommonDefinitions();
+    xml::DocumentParser parser(options, commonDefinitions);
+    parser.setFilter(filter);
+    return parser.parseStreaming(stream, handler);
+  }
+
+  namespace {
+    /// dynamic memory blocks for the rapidxml memory pool of a
+    /// ReusableParser, which are kept when the pool is cleared so that they
+    /// can be used again by the next document
+    ///
+    /// rapidxml only accepts plain allocation functions, so these use the
+    /// cache of the ReusableParser which is active on the current thread,
+    /// if there is one.
+    class PoolBlockCache {
+     public:
+      PoolBlockCache() = default;
+      PoolBlockCache(const PoolBlockCache&) = delete;
+      PoolBlockCache& operator=(const PoolBlockCache&) = delete;
+      ~PoolBlockCache() {
+        for (auto block : blocks_) ::operator delete(block);
+      }
+
+      static void* allocate(std::size_t size) {
+        if (auto cache = current()) {
+          auto& blocks = cache->blocks_;
+          auto it = std::find_if(blocks.begin(), blocks.end(),
+                                 [size](void* block) {
+                                   return blockSize(block) >= size;
+                                 });
+          if (it != blocks.end()) {
+            void* block = *it;
+            blocks.erase(it);
+            return data(block);
+          }
+          // make room to keep all blocks, so that free() can not throw
+          blocks.reserve(++cache->allocated_);
+        }
+        void* block = ::operator new(headerSize + size);
+        *static_cast<std::size_t*>(block) = size;
+        return data(block);
+      }
+
+      static void free(void* memory) {
+        void* block = static_cast<char*>(memory) - headerSize;
+        auto cache = current();
+        if (cache && cache->blocks_.size() < cache->blocks_.capacity()) {
+          cache->blocks_.push_back(block);
+        } else {
+          ::operator delete(block);
+        }
+      }
+
+      /// makes a cache the one used by allocate() and free() on this thread
+      class Scope {
+       public:
+        explicit Scope(PoolBlockCache& cache) : previous_(current()) {
+          current() = &cache;
+        }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope() { current() = previous_; }
+
+       private:
+        PoolBlockCache* previous_;
+      };
+
+     private:
+      /// each block starts with its size, padded to keep the data aligned
+      static constexpr std::size_t headerSize = alignof(std::max_align_t);
+
+      static PoolBlockCache*& current() {
+        static thread_local PoolBlockCache* cache = nullptr;
+        return cache;
+      }
+      static std::size_t blockSize(void* block) {
+        return *static_cast<std::size_t*>(block);
+      }
+      static void* data(void* block) {
+        return static_cast<char*>(block) + headerSize;
+      }
+
+      /// blocks which are not in use
+      std::vector<void*> blocks_;
+      /// the number of blocks allocated while this cache was active
+      std::size_t allocated_ = 0;
+    };
+  }  // namespace
+
+  class ReusableParser::Impl {
+   public:
+    Impl(xml::ParserOptions options, const xml::ParseFilter& filter)
+        : parser_(options, nullptr) {
+      parser_.setFilter(filter);
+      xml_.set_allocator(&PoolBlockCache::allocate, &PoolBlockCache::free);
+    }
+
+    ~Impl() {
+      PoolBlockCache::Scope scope(blockCache_);
+      xml_.clear();
+    }
+
+    void read(std::istream& stream) {
+      if (!stream || !stream.rdbuf()) {
+        throw std::runtime_error("error reading stream");
+      }
+      std::size_t size = 0;
+      while (true) {
+        if (buffer_.size() == size) {
+          // use all of the storage left by previous documents before growing
+          buffer_.resize(buffer_.capacity() > size
+                             ? buffer_.capacity()
+                             : std::max<std::size_t>(2 * size, 64 * 1024));
+        }
+        auto available = buffer_.size() - size;
+        auto read = stream.rdbuf()->sgetn(
+            &buffer_[size], static_cast<std::streamsize>(available));
+        if (read <= 0) break;
+        size += static_cast<std::size_t>(read);
+      }
+      buffer_.resize(size);
+      buffer_.push_back('\0');
+    }
+
+    void copy(const char* data, std::size_t size) {
+      buffer_.assign(data, data + size);
+      buffer_.push_back('\0');
+    }
+
+    std::shared_ptr<Document> parse(const FrameHeader* header) {
+      PoolBlockCache::Scope scope(blockCache_);
+      xml_.clear();
+      parser_.reset(buffer_.data(), getCommonDefinitions());
+      if (header) parser_.setHeader(*header);
+      return parser_.parse(xml_);
+    }
+
+   private:
+    std::vector<char> buffer_;
+    PoolBlockCache blockCache_;
+    rapidxml::xml_document<> xml_;
+    xml::DocumentParser parser_;
+  };
+
+  ReusableParser::ReusableParser(xml::ParserOptions options,
+                                 const xml::ParseFilter& filter)
+      : impl_(new Impl(options, filter)) {}
+
+  ReusableParser::~ReusableParser() = default;
+
+  std::shared_ptr<Document> ReusableParser::parse(std::istream& stream) {
+    impl_->read(stream);
+    return impl_->parse(nullptr);
+  }
+
+  std::shared_ptr<Document> ReusableParser::parse(std::istream& stream,
+                                                  const FrameHeader& header) {
+    impl_->read(stream);
+    return impl_->parse(&header);
+  }
+
+  std::shared_ptr<Document> ReusableParser::parse(const char* data,
+                                                  std::size_t size) {
+    impl_->copy(data, size);
+    return impl_->parse(nullptr);
+  }
+
+  std::shared_ptr<Document> ReusableParser::parse(const char* data,
+                                                  std::size_t size,
+                                                  const FrameHeader& header) {
+    impl_->copy(data, size);
+    return impl_->parse(&header);
+  }
+
   FrameHeader parseFrameHeader(std::istream& stream,
                                xml::ParserOptions options) {
     xml::FrameHeaderParser parser(stream, options);
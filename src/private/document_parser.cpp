@@ -1,8 +1,20 @@
 #include "adm/private/document_parser.hpp"
 #include "adm/common_definitions.hpp"
 #include "adm/private/xml_parser_helper.hpp"
+#include "adm/private/xml_stream_reader.hpp"
 #include "adm/detail/named_type_validators.hpp"
 #include "adm/errors.hpp"
+#include "adm/element_variant.hpp"
+#include "adm/elements/private/block_format_loader.hpp"
+#include "adm/elements/private/parent_attorneys.hpp"
+#include "adm/private/parallel.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
 namespace adm {
   namespace xml {
 
@@ -20,9 +32,15 @@ namespace adm {
     DocumentParser::DocumentParser(rapidxml::file<> file, ParserOptions options,
                                    std::shared_ptr<Document> destDocument)
         : xmlFile_(std::move(file)),
+          xmlData_(xmlFile_->data()),
           options_(options),
-          document_(destDocument),
-          idMap_(*destDocument) {}
+          document_(destDocument) {}
+
+    DocumentParser::DocumentParser(char* data, ParserOptions options,
+                                   std::shared_ptr<Document> destDocument)
+        : xmlData_(data),
+          options_(options),
+          document_(destDocument) {}
 
     DocumentParser::DocumentParser(const std::string& filename,
                                    ParserOptions options,
@@ -35,18 +53,70 @@ namespace adm {
         : DocumentParser(rapidxml::file<>{stream}, options,
                          std::move(destDocument)) {}
 
+    DocumentParser::DocumentParser(ParserOptions options,
+                                   std::shared_ptr<Document> destDocument)
+        : options_(options),
+          document_(destDocument) {}
+
+    DocumentParser::DocumentParser(ParserOptions options,
+                                   boost::optional<FrameHeader> frameHeader)
+        : options_(options), frameHeader_(std::move(frameHeader)) {}
+
     template <typename Element>
     void DocumentParser::add(std::shared_ptr<Element> el) {
       document_->add(el);
-      idMap_.add(std::move(el));
+      if (handler_) handler_->element(el);
+    }
+
+    template <typename Id>
+    bool DocumentParser::contains(const Id& id) const {
+      return document_ && document_->lookup(id);
+    }
+
+    void DocumentParser::reset(char* data,
+                               std::shared_ptr<Document> destDocument) {
+      xmlFile_ = boost::none;
+      xmlData_ = data;
+      xmlSource_.reset();
+      document_ = std::move(destDocument);
+      frameHeader_ = boost::none;
+      clearReferences();
+    }
+
+    void DocumentParser::clearReferences() {
+      programmeContentRefs_.clear();
+      contentObjectRefs_.clear();
+      objectObjectRefs_.clear();
+      objectComplementaryObjectRefs_.clear();
+      objectPackFormatRefs_.clear();
+      objectTrackUidRefs_.clear();
+      trackUidTrackFormatRef_.clear();
+      trackUidChannelFormatRef_.clear();
+      trackUidPackFormatRef_.clear();
+      packFormatChannelFormatRefs_.clear();
+      packFormatPackFormatRefs_.clear();
+      trackFormatStreamFormatRef_.clear();
+      streamFormatChannelFormatRef_.clear();
+      streamFormatPackFormatRef_.clear();
+      streamFormatTrackFormatRefs_.clear();
     }
 
     std::shared_ptr<Document> DocumentParser::parse() {
       rapidxml::xml_document<> xmlDocument;
-      xmlDocument.parse<0>(xmlFile_.data());
+      return parse(xmlDocument);
+    }
+
+    std::shared_ptr<Document> DocumentParser::parse(
+        rapidxml::xml_document<>& xmlDocument) {
+      if (isSet(options_, ParserOptions::lazy_block_formats)) {
+        xmlSource_ = std::make_shared<const std::string>(xmlData_);
+      }
+      xmlDocument.parse<0>(xmlData_);
 
       if (!xmlDocument.first_node())
         throw error::XmlParsingError("xml document is empty");
+      linePosition_ = xmlDocument.first_node()->name();
+      line_ = 0;
 
       NodePtr root = nullptr;
 
@@ -64,57 +134,447 @@ namespace adm {
       if (root) {
         setOptionalAttribute<Version>(root, "version", document_);
         // add ADM elements to ADM document
+        if (isSet(options_, ParserOptions::parallel)) {
+          parseElementsParallel(root);
+        } else {
+          for (NodePtr node = root->first_node(); node;
+               node = node->next_sibling()) {
+            parseElement(node);
+          }
+        }
+        resolveAllReferences();
+      } else {
+        throw error::XmlParsingError("audioFormatExtended node not found");
+      }
+      // the deferred audioChannelFormats have copies of their own blocks
+      xmlSource_.reset();
+      return document_;
+    }
+
+    namespace {
+      /// the kind of a child of audioFormatExtended with the given name, or
+      /// none if it is not an ADM element
+      ElementKinds elementKind(const char* name, std::size_t size) {
+        auto is = [name, size](const char* kindName) {
+          return std::strlen(kindName) == size &&
+                 std::memcmp(name, kindName, size) == 0;
+        };
+        if (is("audioProgramme")) return ElementKinds::audioProgramme;
+        if (is("audioContent")) return ElementKinds::audioContent;
+        if (is("audioObject")) return ElementKinds::audioObject;
+        if (is("audioTrackUID")) return ElementKinds::audioTrackUid;
+        if (is("audioPackFormat")) return ElementKinds::audioPackFormat;
+        if (is("audioChannelFormat")) return ElementKinds::audioChannelFormat;
+        if (is("audioStreamFormat")) return ElementKinds::audioStreamFormat;
+        if (is("audioTrackFormat")) return ElementKinds::audioTrackFormat;
+        return ElementKinds::none;
+      }
+
+      ElementKinds elementKind(const std::string& name) {
+        return elementKind(name.data(), name.size());
+      }
+    }  // namespace
+
+    template <typename F>
+    void DocumentParser::parseElement(NodePtr node, F&& f) {
+      auto kind = elementKind(node->name(), node->name_size());
+      if (isSkipped(kind)) return;
+
+      switch (kind) {
+        case ElementKinds::audioProgramme:
+          f(parseAudioProgramme(node));
+          break;
+        case ElementKinds::audioContent:
+          f(parseAudioContent(node));
+          break;
+        case ElementKinds::audioObject:
+          f(parseAudioObject(node));
+          break;
+        case ElementKinds::audioTrackUid:
+          f(parseAudioTrackUid(node));
+          break;
+        case ElementKinds::audioPackFormat:
+          f(parseAudioPackFormat(node));
+          break;
+        case ElementKinds::audioChannelFormat:
+          f(parseAudioChannelFormat(node));
+          break;
+        case ElementKinds::audioStreamFormat:
+          f(parseAudioStreamFormat(node));
+          break;
+        case ElementKinds::audioTrackFormat:
+          f(parseAudioTrackFormat(node));
+          break;
+        default:
+          break;
+      }
+    }
+
+    void DocumentParser::parseElement(NodePtr node) {
+      parseElement(node, [this](auto element) { add(std::move(element)); });
+    }
+
+    namespace {
+      /// the number of child nodes to aim for in each run of elements parsed
+      /// by one worker; this keeps the overhead per run small for documents
+      /// with many small elements
+      const std::size_t parallelChunkNodes = 256;
+
+      /// a run of consecutive children of audioFormatExtended
+      struct NodeRange {
+        NodePtr begin;
+        NodePtr end;
+      };
+
+      std::vector<NodeRange> splitElements(NodePtr root) {
+        std::vector<NodeRange> ranges;
+        std::size_t nodes = 0;
         for (NodePtr node = root->first_node(); node;
              node = node->next_sibling()) {
-          std::string nodeName(node->name(), node->name_size());
-
-          if (nodeName == "audioProgramme") {
-            add(parseAudioProgramme(node));
-          } else if (nodeName == "audioContent") {
-            add(parseAudioContent(node));
-          } else if (nodeName == "audioObject") {
-            add(parseAudioObject(node));
-          } else if (nodeName == "audioTrackUID") {
-            add(parseAudioTrackUid(node));
-          } else if (nodeName == "audioPackFormat") {
-            add(parseAudioPackFormat(node));
-          } else if (nodeName == "audioChannelFormat") {
-            add(parseAudioChannelFormat(node));
-          } else if (nodeName == "audioStreamFormat") {
-            add(parseAudioStreamFormat(node));
-          } else if (nodeName == "audioTrackFormat") {
-            add(parseAudioTrackFormat(node));
+          if (nodes == 0) ranges.push_back({node, nullptr});
+          nodes++;
+          for (NodePtr child = node->first_node(); child;
+               child = child->next_sibling()) {
+            nodes++;
+          }
+          if (nodes >= parallelChunkNodes) {
+            ranges.back().end = node->next_sibling();
+            nodes = 0;
+          }
+        }
+        return ranges;
+      }
+
+      template <typename Map>
+      void moveEntries(Map& to, Map& from) {
+        to.insert(to.end(), std::make_move_iterator(from.begin()),
+                  std::make_move_iterator(from.end()));
+        from.clear();
+      }
+
+      /// calls f with the element in an ElementVariant
+      template <typename F>
+      struct ElementVisitor : public boost::static_visitor<void> {
+        explicit ElementVisitor(F& f) : f(f) {}
+        template <typename Element>
+        void operator()(std::shared_ptr<Element>& element) const {
+          f(element);
+        }
+        F& f;
+      };
+    }  // namespace
+
+    void DocumentParser::parseElementsParallel(NodePtr root) {
+      // Each range of nodes is parsed by a worker parser, which collects
+      // the elements and their references without adding them to a
+      // document. These are added in document order on this thread, so
+      // that duplicate IDs are detected in the same way as when parsing
+      // sequentially. If anything goes wrong on a worker, the range is
+      // parsed again here, so that the same error is reported.
+      struct ParsedRange {
+        std::vector<std::pair<NodePtr, ElementVariant>> elements;
+        /// null if parsing failed
+        std::unique_ptr<DocumentParser> parser;
+      };
+
+      auto ranges = splitElements(root);
+
+      // the line of the start of each range, so that workers do not all
+      // count lines from the start of the document
+      std::vector<int> lines;
+      if (xmlSource_) {
+        lines.reserve(ranges.size());
+        for (auto& range : ranges) lines.push_back(lineAt(range.begin->name()));
+      }
+
+      auto produce = [&](std::size_t i) {
+        ParsedRange parsed;
+        std::unique_ptr<DocumentParser> parser(
+            new DocumentParser(options_, frameHeader_));
+        parser->xmlData_ = xmlData_;
+        parser->xmlSource_ = xmlSource_;
+        if (xmlSource_) {
+          parser->linePosition_ = ranges[i].begin->name();
+          parser->line_ = lines[i];
+        }
+        parser->filter_ = filter_;
+        try {
+          for (NodePtr node = ranges[i].begin; node != ranges[i].end;
+               node = node->next_sibling()) {
+            parser->parseElement(node, [&](auto element) {
+              parsed.elements.emplace_back(node, std::move(element));
+            });
+          }
+          parsed.parser = std::move(parser);
+        } catch (...) {
+          parsed.elements.clear();
+        }
+        return parsed;
+      };
+
+      auto consume = [&](std::size_t i, ParsedRange parsed) {
+        if (!parsed.parser) {
+          for (NodePtr node = ranges[i].begin; node != ranges[i].end;
+               node = node->next_sibling()) {
+            parseElement(node);
           }
+          return;
+        }
+        bool duplicate = false;
+        auto addUnlessDuplicate = [&](auto& element) {
+          using Element =
+              typename std::decay_t<decltype(element)>::element_type;
+          using Id = typename Element::id_type;
+          duplicate = contains(element->template get<Id>());
+          if (!duplicate) add(element);
+        };
+        ElementVisitor<decltype(addUnlessDuplicate)> visitor(
+            addUnlessDuplicate);
+        for (auto& entry : parsed.elements) {
+          boost::apply_visitor(visitor, entry.second);
+          // report the duplicate ID in the same way as parseElement
+          if (duplicate) parseElement(entry.first);
         }
-        resolveReferences(programmeContentRefs_);
-        resolveReferences(contentObjectRefs_);
-        resolveReferences(objectObjectRefs_);
-        // resolve complementary object references
+        mergeReferences(*parsed.parser);
+      };
+
+      ::adm::detail::orderedParallelFor<ParsedRange>(ranges.size(), produce,
+                                                     consume);
+    }
+
+    void DocumentParser::mergeReferences(DocumentParser& worker) {
+      moveEntries(programmeContentRefs_, worker.programmeContentRefs_);
+      moveEntries(contentObjectRefs_, worker.contentObjectRefs_);
+      moveEntries(objectObjectRefs_, worker.objectObjectRefs_);
+      moveEntries(objectComplementaryObjectRefs_,
+                  worker.objectComplementaryObjectRefs_);
+      moveEntries(objectPackFormatRefs_, worker.objectPackFormatRefs_);
+      moveEntries(objectTrackUidRefs_, worker.objectTrackUidRefs_);
+      moveEntries(trackUidTrackFormatRef_, worker.trackUidTrackFormatRef_);
+      moveEntries(trackUidChannelFormatRef_, worker.trackUidChannelFormatRef_);
+      moveEntries(trackUidPackFormatRef_, worker.trackUidPackFormatRef_);
+      moveEntries(packFormatChannelFormatRefs_,
+                  worker.packFormatChannelFormatRefs_);
+      moveEntries(packFormatPackFormatRefs_, worker.packFormatPackFormatRefs_);
+      moveEntries(trackFormatStreamFormatRef_,
+                  worker.trackFormatStreamFormatRef_);
+      moveEntries(streamFormatChannelFormatRef_,
+                  worker.streamFormatChannelFormatRef_);
+      moveEntries(streamFormatPackFormatRef_,
+                  worker.streamFormatPackFormatRef_);
+      moveEntries(streamFormatTrackFormatRefs_,
+                  worker.streamFormatTrackFormatRefs_);
+    }
+
+    void DocumentParser::resolveAllReferences() {
+      // references to kinds of element which were skipped are ignored
+      auto resolving = [this](ElementKinds target) {
+        return !isSkipped(target);
+      };
+      const auto content = ElementKinds::audioContent;
+      const auto object = ElementKinds::audioObject;
+      const auto packFormat = ElementKinds::audioPackFormat;
+      const auto channelFormat = ElementKinds::audioChannelFormat;
+      const auto streamFormat = ElementKinds::audioStreamFormat;
+      const auto trackFormat = ElementKinds::audioTrackFormat;
+      const auto trackUid = ElementKinds::audioTrackUid;
+
+      if (resolving(content)) resolveReferences(programmeContentRefs_);
+      if (resolving(object)) resolveReferences(contentObjectRefs_);
+      if (resolving(object)) resolveReferences(objectObjectRefs_);
+      // resolve complementary object references
+      if (resolving(object)) {
         for (auto& entry : objectComplementaryObjectRefs_) {
-          for (const auto& id : entry.second) {
-            if (auto element = document_->lookup(id)) {
-              entry.first->addComplementary(element);
-            } else {
-              throw error::XmlParsingUnresolvedReference(formatId(id));
-            }
+          if (auto element = document_->lookup(entry.second)) {
+            entry.first->addComplementary(element);
+          } else {
+            throw error::XmlParsingUnresolvedReference(formatId(entry.second));
           }
         }
-        resolveReferences(objectPackFormatRefs_);
-        resolveTrackUidReferences(objectTrackUidRefs_);
-        resolveReference(trackUidTrackFormatRef_);
+      }
+      if (resolving(packFormat)) resolveReferences(objectPackFormatRefs_);
+      if (resolving(trackUid)) resolveTrackUidReferences(objectTrackUidRefs_);
+      if (resolving(trackFormat)) resolveReference(trackUidTrackFormatRef_);
+      if (resolving(channelFormat))
         resolveReference(trackUidChannelFormatRef_);
-        resolveReference(trackUidPackFormatRef_);
+      if (resolving(packFormat)) resolveReference(trackUidPackFormatRef_);
+      if (resolving(channelFormat))
         resolveReferences(packFormatChannelFormatRefs_);
-        resolveReferences(packFormatPackFormatRefs_);
+      if (resolving(packFormat)) resolveReferences(packFormatPackFormatRefs_);
+      if (resolving(streamFormat))
         resolveReference(trackFormatStreamFormatRef_);
+      if (resolving(channelFormat))
         resolveReference(streamFormatChannelFormatRef_);
-        resolveReference(streamFormatPackFormatRef_);
+      if (resolving(packFormat)) resolveReference(streamFormatPackFormatRef_);
+      if (resolving(trackFormat))
         resolveReferences(streamFormatTrackFormatRefs_);
+    }
 
-      } else {
-        throw error::XmlParsingError("audioFormatExtended node not found");
+    namespace {
+      /// is path (the names of an element and its ancestors) the location of
+      /// the audioFormatExtended element to parse?
+      ///
+      /// This accepts the same locations as the searches in
+      /// DocumentParser::parse()
+      bool isAudioFormatExtendedPath(const std::vector<std::string>& path,
+                                     ParserOptions options) {
+        if (path.back() != "audioFormatExtended") return false;
+        if (isSet(options, ParserOptions::recursive_node_search)) return true;
+
+        auto matches = [&path](std::initializer_list<const char*> names) {
+          return std::equal(path.begin(), path.end(), names.begin(),
+                            names.end());
+        };
+        return matches({"frame", "audioFormatExtended"}) ||
+               matches({"frame", "coreMetadata", "format",
+                        "audioFormatExtended"}) ||
+               matches({"ebuCoreMain", "coreMetadata", "format",
+                        "audioFormatExtended"});
       }
-      return document_;
+
+      /// read the tokens of the element whose start tag is the current token
+      /// of reader, up to and including its end tag, passing each to f
+      template <typename F>
+      void forEachElementToken(XmlStreamReader& reader, F f) {
+        std::size_t depth = 1;
+        while (depth && reader.next()) {
+          f(reader);
+          if (reader.type() == XmlStreamReader::TokenType::startTag) {
+            ++depth;
+          } else if (reader.type() == XmlStreamReader::TokenType::endTag) {
+            --depth;
+          }
+        }
+        if (depth) {
+          throw error::XmlParsingError("unexpected end of xml document");
+        }
+      }
+
+      /// append the tokens of the element whose start tag is the current
+      /// token of reader to text, up to and including its end tag
+      void readElement(XmlStreamReader& reader, std::string& text) {
+        forEachElementToken(
+            reader, [&text](XmlStreamReader& r) { text += r.text(); });
+      }
+
+      /// skip the element whose start tag is the current token of reader
+      void skipElement(XmlStreamReader& reader) {
+        forEachElementToken(reader, [](XmlStreamReader&) {});
+      }
+
+      /// parse the XML fragment in text, returning its root element
+      ///
+      /// text is modified, and must outlive the returned node
+      NodePtr parseFragment(rapidxml::xml_document<>& xml, std::string& text) {
+        text.push_back('\0');
+        // clear() also releases the memory used for the previous fragment
+        xml.clear();
+        xml.parse<0>(&text[0]);
+        return xml.first_node();
+      }
+    }  // namespace
+
+    std::shared_ptr<Document> DocumentParser::parseStreaming(
+        std::istream& stream, StreamingParserHandler& handler) {
+      using TokenType = XmlStreamReader::TokenType;
+      handler_ = &handler;
+      XmlStreamReader reader(stream);
+      rapidxml::xml_document<> xml;
+      // names of the elements containing the current token
+      std::vector<std::string> path;
+      bool empty = true;
+
+      while (reader.next()) {
+        auto type = reader.type();
+        if (type == TokenType::startTag || type == TokenType::emptyTag) {
+          empty = false;
+          path.push_back(reader.name());
+          if (isAudioFormatExtendedPath(path, options_)) {
+            std::string text = reader.text();
+            if (type == TokenType::startTag) text += "</audioFormatExtended>";
+            setOptionalAttribute<Version>(parseFragment(xml, text), "version",
+                                          document_);
+            if (type == TokenType::startTag) {
+              parseStreamingElements(reader, xml);
+            }
+            resolveAllReferences();
+            return document_;
+          }
+          if (type == TokenType::emptyTag) path.pop_back();
+        } else if (type == TokenType::endTag && !path.empty()) {
+          path.pop_back();
+        }
+      }
+
+      if (empty) throw error::XmlParsingError("xml document is empty");
+      throw error::XmlParsingError("audioFormatExtended node not found");
+    }
+
+    void DocumentParser::parseStreamingElements(
+        XmlStreamReader& reader, rapidxml::xml_document<>& xml) {
+      using TokenType = XmlStreamReader::TokenType;
+      std::string text;
+      while (reader.next()) {
+        if (reader.type() == TokenType::endTag) {
+          return;
+        } else if (reader.type() == TokenType::startTag) {
+          if (isSkipped(elementKind(reader.name()))) {
+            skipElement(reader);
+          } else if (reader.name() == "audioChannelFormat") {
+            parseStreamingChannelFormat(reader, xml);
+          } else {
+            text = reader.text();
+            readElement(reader, text);
+            parseElement(parseFragment(xml, text));
+          }
+        } else if (reader.type() == TokenType::emptyTag) {
+          text = reader.text();
+          parseElement(parseFragment(xml, text));
+        }
+      }
+      throw error::XmlParsingError("unexpected end of xml document");
+    }
+
+    void DocumentParser::parseStreamingChannelFormat(
+        XmlStreamReader& reader, rapidxml::xml_document<>& xml) {
+      using TokenType = XmlStreamReader::TokenType;
+      // the audioChannelFormat is created from its start tag, and blocks are
+      // parsed and added as they are read, so that they never have to be
+      // held as text; other sub-elements are collected and parsed at the end
+      std::string startTag = reader.text();
+      std::string text = startTag + "</audioChannelFormat>";
+      auto audioChannelFormat =
+          parseAudioChannelFormat(parseFragment(xml, text));
+
+      std::string subElements = startTag;
+      std::string block;
+      while (reader.next()) {
+        auto type = reader.type();
+        if (type == TokenType::endTag) {
+          subElements += reader.text();
+          // clang-format off
+          setOptionalMultiElement<Frequency>(parseFragment(xml, subElements), "frequency", audioChannelFormat, &parseFrequency);
+          // clang-format on
+          add(std::move(audioChannelFormat));
+          return;
+        } else if (type == TokenType::startTag ||
+                   type == TokenType::emptyTag) {
+          bool isBlock = reader.name() == "audioBlockFormat";
+          if (isBlock && isSkipped(ElementKinds::audioBlockFormat)) {
+            if (type == TokenType::startTag) skipElement(reader);
+            continue;
+          }
+          auto& dest = isBlock ? block : subElements;
+          if (isBlock) block.clear();
+          dest += reader.text();
+          if (type == TokenType::startTag) readElement(reader, dest);
+          if (isBlock) {
+            parseAudioBlockFormat(audioChannelFormat,
+                                  parseFragment(xml, block));
+          }
+        }
+      }
+      throw error::XmlParsingError("unexpected end of xml document");
     }
 
     boost::optional<TimeReference> DocumentParser::getTimeReference() const {
@@ -210,14 +670,14 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioProgrammeName>(node, "audioProgrammeName");
       AudioProgrammeId id = parseAttribute<AudioProgrammeId>(node, "audioProgrammeID", &parseAudioProgrammeId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
       auto audioProgramme = AudioProgramme::create(std::move(name), id);
 
       setOptionalAttribute<AudioProgrammeLanguage>(node, "audioProgrammeLanguage", audioProgramme);
-      setOptionalAttribute<Start>(node, "start", audioProgramme, &parseTimecode);
-      setOptionalAttribute<End>(node, "end", audioProgramme, &parseTimecode);
+      setOptionalAttribute<Start>(node, "start", audioProgramme, &detail::parseTimecode);
+      setOptionalAttribute<End>(node, "end", audioProgramme, &detail::parseTimecode);
       setOptionalAttribute<MaxDuckingDepth>(node, "maxDuckingDepth", audioProgramme);
 
       setOptionalMultiElement<LoudnessMetadatas>(node, "loudnessMetadata", audioProgramme, &parseLoudnessMetadatas);
@@ -235,7 +695,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioContentName>(node, "audioContentName");
       auto id = parseAttribute<AudioContentId>(node, "audioContentID", &parseAudioContentId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
       auto audioContent = AudioContent::create(std::move(name), id);
@@ -257,13 +717,13 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioObjectName>(node, "audioObjectName");
       auto id = parseAttribute<AudioObjectId>(node, "audioObjectID", &parseAudioObjectId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
       auto audioObject = AudioObject::create(std::move(name), id);
 
-      setOptionalAttribute<Start>(node, "start", audioObject, &parseTimecode);
-      setOptionalAttribute<Duration>(node, "duration", audioObject, &parseTimecode);
+      setOptionalAttribute<Start>(node, "start", audioObject, &detail::parseTimecode);
+      setOptionalAttribute<Duration>(node, "duration", audioObject, &detail::parseTimecode);
       setOptionalAttribute<DialogueId>(node, "dialogue", audioObject);
       setOptionalAttribute<Importance>(node, "importance", audioObject);
       setOptionalAttribute<Interact>(node, "interact", audioObject);
@@ -361,7 +821,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioPackFormatName>(node, "audioPackFormatName");
       auto id = parseAttribute<AudioPackFormatId>(node, "audioPackFormatID", &parseAudioPackFormatId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
       auto typeDescriptor = id.get<TypeDescriptor>();
@@ -386,17 +846,15 @@ namespace adm {
     }
 
     void DocumentParser::resolveTrackUidReferences(
-        const std::map<std::shared_ptr<AudioObject>,
-                       std::vector<AudioTrackUidId>>& map) {
-      for (const auto& entry : map) {
-        for (const auto& id : entry.second) {
-          if (*id.get<AudioTrackUidIdValue>() == 0)
-            entry.first->addReference(AudioTrackUid::getSilent(document_));
-          else if (const auto& element = document_->lookup(id))
-            entry.first->addReference(element);
-          else
-            throw error::XmlParsingUnresolvedReference(formatId(id));
-        }
+        const References<AudioObject, AudioTrackUidId>& references) {
+      for (const auto& entry : references) {
+        const auto& id = entry.second;
+        if (*id.get<AudioTrackUidIdValue>() == 0)
+          entry.first->addReference(AudioTrackUid::getSilent(document_));
+        else if (const auto& element = document_->lookup(id))
+          entry.first->addReference(element);
+        else
+          throw error::XmlParsingUnresolvedReference(formatId(id));
       }
     }
 
@@ -410,12 +868,21 @@ namespace adm {
       // clang-format on
     }
 
+    namespace {
+      /// does filter skip audioBlockFormats outside a time window? if so,
+      /// the number of audioBlockFormat nodes is not the number kept, so
+      /// shouldn't be used to reserve space for them
+      bool hasBlockWindow(const ParseFilter& filter) {
+        return filter.blockStart || filter.blockEnd;
+      }
+    }  // namespace
+
     std::shared_ptr<AudioChannelFormat> DocumentParser::parseAudioChannelFormat(
         NodePtr node) {
       // clang-format off
       auto name = parseAttribute<AudioChannelFormatName>(node, "audioChannelFormatName");
       auto id = parseAttribute<AudioChannelFormatId>(node, "audioChannelFormatID", &parseAudioChannelFormatId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
       auto audioChannelFormat = AudioChannelFormat::create(std::move(name), id.get<TypeDescriptor>(), id);
@@ -427,39 +894,187 @@ namespace adm {
       setOptionalMultiElement<Frequency>(node, "frequency", audioChannelFormat, &parseFrequency);
       // clang-format on
 
-      auto elements = detail::findElements(node, "audioBlockFormat");
+      if (isSkipped(ElementKinds::audioBlockFormat)) return audioChannelFormat;
+      auto blocks = detail::findElements(node, "audioBlockFormat");
+      if (blocks.empty() ||
+          !deferBlockFormats(audioChannelFormat, blocks.front(),
+                             blocks.back())) {
+        // blocks passed to a handler are not stored
+        if (!handler_ && !hasBlockWindow(filter_))
+          audioChannelFormat->reserve(blocks.size());
+        for (auto& element : blocks) {
+          parseAudioBlockFormat(audioChannelFormat, element);
+        }
+      }
+      return audioChannelFormat;
+    }
 
-      if (audioChannelFormat->get<TypeDescriptor>() ==
-          TypeDefinition::DIRECT_SPEAKERS) {
-        for (auto& element : elements) {
-          audioChannelFormat->add(
-              parseAudioBlockFormatDirectSpeakers(element, getTimeReference()));
+    namespace {
+      /// is the audioBlockFormat node within the time window of filter?
+      bool inBlockWindow(NodePtr node, const ParseFilter& filter) {
+        if (!hasBlockWindow(filter)) return true;
+        auto attribute = node->first_attribute("rtime");
+        if (!attribute) attribute = node->first_attribute("lstart");
+        if (!attribute) return true;
+        auto time = detail::parseTimecode(attribute->value()).asNanoseconds();
+        if (filter.blockStart && time < filter.blockStart->asNanoseconds())
+          return false;
+        if (filter.blockEnd && !(time < filter.blockEnd->asNanoseconds()))
+          return false;
+        return true;
+      }
+
+      /// parse an audioBlockFormat in a channel of type typeDescriptor, and
+      /// pass it to f, unless it is outside the time window of filter
+      template <typename F>
+      void parseBlockFormatOfType(TypeDescriptor typeDescriptor, NodePtr node,
+                                  boost::optional<TimeReference> timeReference,
+                                  const ParseFilter& filter, F&& f) {
+        if (!inBlockWindow(node, filter)) return;
+        if (typeDescriptor == TypeDefinition::DIRECT_SPEAKERS) {
+          f(parseAudioBlockFormatDirectSpeakers(node, timeReference));
+        } else if (typeDescriptor == TypeDefinition::MATRIX) {
+          // f(parseAudioBlockFormatMatrix(node));
+        } else if (typeDescriptor == TypeDefinition::OBJECTS) {
+          f(parseAudioBlockFormatObjects(node, timeReference));
+        } else if (typeDescriptor == TypeDefinition::HOA) {
+          f(parseAudioBlockFormatHoa(node, timeReference));
+        } else if (typeDescriptor == TypeDefinition::BINAURAL) {
+          f(parseAudioBlockFormatBinaural(node, timeReference));
         }
-      } else if (audioChannelFormat->get<TypeDescriptor>() ==
-                 TypeDefinition::MATRIX) {
-        // for (auto& element : elements) {
-        //    audioChannelFormat->add(parseAudioBlockFormatMatrix(element));
-        // }
-      } else if (audioChannelFormat->get<TypeDescriptor>() ==
-                 TypeDefinition::OBJECTS) {
-        for (auto& element : elements) {
-          audioChannelFormat->add(
-              parseAudioBlockFormatObjects(element, getTimeReference()));
+      }
+
+      bool startsWith(const char* text, const char* prefix) {
+        return std::strncmp(text, prefix, std::strlen(prefix)) == 0;
+      }
+
+      /// the start of the first end tag for an element called name in text,
+      /// skipping comments, CDATA sections and processing instructions
+      /// @returns nullptr if there is none
+      const char* findEndTag(const char* text, const char* name) {
+        auto nameSize = std::strlen(name);
+        auto skipPast = [&text](const char* start, const char* terminator) {
+          text = std::strstr(text + std::strlen(start), terminator);
+          if (text) text += std::strlen(terminator);
+        };
+        while ((text = std::strchr(text, '<'))) {
+          if (startsWith(text, "<!--")) {
+            skipPast("<!--", "-->");
+          } else if (startsWith(text, "<![CDATA[")) {
+            skipPast("<![CDATA[", "]]>");
+          } else if (startsWith(text, "<?")) {
+            skipPast("<?", "?>");
+          } else if (startsWith(text, "</") &&
+                     std::strncmp(text + 2, name, nameSize) == 0 &&
+                     (text[2 + nameSize] == '>' ||
+                      std::isspace(
+                          static_cast<unsigned char>(text[2 + nameSize])))) {
+            return text;
+          } else {
+            ++text;
+          }
+          if (!text) return nullptr;
         }
-      } else if (audioChannelFormat->get<TypeDescriptor>() ==
-                 TypeDefinition::HOA) {
-        for (auto& element : elements) {
-          audioChannelFormat->add(
-              parseAudioBlockFormatHoa(element, getTimeReference()));
+        return nullptr;
+      }
+
+      /// parses audioBlockFormats from a copy of their XML text
+      class XmlBlockFormatLoader : public ::adm::detail::BlockFormatLoader {
+       public:
+        /// @param text the original text of the blocks, from the start of
+        /// the first to the end of the last
+        /// @param line the line of the start of text in the document
+        XmlBlockFormatLoader(std::string text, int line,
+                             boost::optional<TimeReference> timeReference,
+                             ParseFilter filter)
+            : text_(std::move(text)),
+              line_(line),
+              timeReference_(timeReference),
+              filter_(std::move(filter)) {}
+
+        void load(AudioChannelFormat& channelFormat) const override {
+          try {
+            load(channelFormat, 0);
+          } catch (...) {
+            // parse again with blank lines before the blocks, so that the
+            // error has the same line number as when parsing the whole
+            // document; this is only done for errors, as the blank lines
+            // would be expensive for blocks late in large documents
+            channelFormat.clearAudioBlockFormats();
+            load(channelFormat, line_);
+          }
         }
-      } else if (audioChannelFormat->get<TypeDescriptor>() ==
-                 TypeDefinition::BINAURAL) {
-        for (auto& element : elements) {
-          audioChannelFormat->add(
-              parseAudioBlockFormatBinaural(element, getTimeReference()));
+
+       private:
+        void load(AudioChannelFormat& channelFormat, int lines) const {
+          std::string xml = "<audioBlockFormats>";
+          xml.append(static_cast<std::size_t>(lines), '\n');
+          xml += text_;
+          xml += "</audioBlockFormats>";
+
+          rapidxml::xml_document<> xmlDocument;
+          xmlDocument.parse<0>(&xml[0]);
+          auto typeDescriptor = channelFormat.get<TypeDescriptor>();
+          auto nodes = detail::findElements(xmlDocument.first_node(),
+                                            "audioBlockFormat");
+          if (!hasBlockWindow(filter_)) channelFormat.reserve(nodes.size());
+          for (auto& node : nodes) {
+            parseBlockFormatOfType(
+                typeDescriptor, node, timeReference_, filter_,
+                [&](auto block) { channelFormat.add(std::move(block)); });
+          }
         }
-      }
-      return audioChannelFormat;
+
+        std::string text_;
+        int line_;
+        boost::optional<TimeReference> timeReference_;
+        ParseFilter filter_;
+      };
+    }  // namespace
+
+    bool DocumentParser::deferBlockFormats(
+        const std::shared_ptr<AudioChannelFormat>& channelFormat,
+        NodePtr first, NodePtr last) {
+      if (!xmlSource_) return false;
+      // the blocks end before the end tag of the audioChannelFormat;
+      // parsing has modified xmlData_, so this is found in xmlSource_
+      const char* source = xmlSource_->c_str();
+      const char* begin = source + (first->name() - 1 - xmlData_);
+      const char* end = findEndTag(source + (last->name() - xmlData_),
+                                   "audioChannelFormat");
+      if (!end) return false;
+
+      AudioChannelFormatAttorney::setBlockFormatLoader(
+          channelFormat, std::make_shared<XmlBlockFormatLoader>(
+                             std::string(begin, end), lineAt(first->name()),
+                             getTimeReference(), filter_));
+      return true;
+    }
+
+    int DocumentParser::lineAt(const char* p) {
+      if (p < linePosition_)
+        line_ -= countLines(p, linePosition_);
+      else
+        line_ += countLines(linePosition_, p);
+      linePosition_ = p;
+      return line_;
+    }
+
+    void DocumentParser::parseAudioBlockFormat(
+        const std::shared_ptr<AudioChannelFormat>& channelFormat,
+        NodePtr node) {
+      parseBlockFormatOfType(
+          channelFormat->get<TypeDescriptor>(), node, getTimeReference(),
+          filter_,
+          [&](auto block) { addBlockFormat(channelFormat, std::move(block)); });
+    }
+
+    template <typename Block>
+    void DocumentParser::addBlockFormat(
+        const std::shared_ptr<AudioChannelFormat>& channelFormat,
+        Block block) {
+      if (handler_ && handler_->blockFormat(channelFormat, block)) return;
+      channelFormat->add(std::move(block));
     }
 
     std::shared_ptr<AudioStreamFormat> DocumentParser::parseAudioStreamFormat(
@@ -467,7 +1082,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioStreamFormatName>(node, "audioStreamFormatName");
       auto id = parseAttribute<AudioStreamFormatId>(node, "audioStreamFormatID", &parseAudioStreamFormatId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
 
@@ -488,7 +1103,7 @@ namespace adm {
       // clang-format off
       auto name = parseAttribute<AudioTrackFormatName>(node, "audioTrackFormatName");
       auto id = parseAttribute<AudioTrackFormatId>(node, "audioTrackFormatID", &parseAudioTrackFormatId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
 
@@ -507,7 +1122,7 @@ namespace adm {
         NodePtr node) {
       // clang-format off
       auto id = parseAttribute<AudioTrackUidId>(node, "UID", &parseAudioTrackUidId);
-      if(idMap_.contains(id)) {
+      if(contains(id)) {
         throw error::XmlParsingDuplicateId(formatId(id), getDocumentLine(node));
       }
       auto audioTrackUid = AudioTrackUid::create(id);
@@ -525,6 +1140,14 @@ namespace adm {
       frameHeader_ = std::move(header);
     }
 
+    void DocumentParser::setFilter(ParseFilter filter) {
+      filter_ = std::move(filter);
+    }
+
+    bool DocumentParser::isSkipped(ElementKinds kind) const {
+      return static_cast<bool>(filter_.skip & kind);
+    }
+
     Profile parseProfile(NodePtr node) {
       auto value = parseValue<ProfileValue>(node);
       auto name = parseAttribute<ProfileName>(node, "profileName");
@@ -547,47 +1170,47 @@ namespace adm {
           boost::optional<TimeReference> timeReference) {
         setOptionalAttribute<Rtime>(
             node, "rtime", audioBlockFormat,
-            [timeReference](const std::string& timeCode) {
+            [timeReference](const char* timeCode) {
               if (timeReference && *timeReference == TimeReference::LOCAL) {
                 throw std::runtime_error(
                     "'rtime' used in audioBlockFormat, when FrameHeader "
                     "timeReference is 'local'. Either the timeReference should "
                     "be 'total' or 'lstart' should be used.");
               }
-              return parseTimecode(timeCode);
+              return detail::parseTimecode(timeCode);
             });
         setOptionalAttribute<Duration>(
             node, "duration", audioBlockFormat,
-            [timeReference](const std::string& timeCode) {
+            [timeReference](const char* timeCode) {
               if (timeReference && *timeReference == TimeReference::LOCAL) {
                 throw std::runtime_error(
                     "'duration' used in audioBlockFormat, when FrameHeader "
                     "timeReference is 'local'. Either the timeReference should "
                     "be 'total' or 'lduration' should be used.");
               }
-              return parseTimecode(timeCode);
+              return detail::parseTimecode(timeCode);
             });
         setOptionalAttribute<Rtime>(
             node, "lstart", audioBlockFormat,
-            [timeReference](const std::string& timeCode) {
+            [timeReference](const char* timeCode) {
               if (timeReference && *timeReference == TimeReference::TOTAL) {
                 throw std::runtime_error(
                     "'lstart' used in audioBlockFormat, when FrameHeader "
                     "timeReference is 'total'. Either the timeReference should "
                     "be 'local' or 'rtime' should be used.");
               }
-              return parseTimecode(timeCode);
+              return detail::parseTimecode(timeCode);
             });
         setOptionalAttribute<Duration>(
             node, "lduration", audioBlockFormat,
-            [timeReference](const std::string& timeCode) {
+            [timeReference](const char* timeCode) {
               if (timeReference && *timeReference == TimeReference::TOTAL) {
                 throw std::runtime_error(
                     "'lduration' used in audioBlockFormat when FrameHeader "
                     "timeReference is 'total'. Either the timeReference should "
                     "be 'local' or 'duration' should be used.");
               }
-              return parseTimecode(timeCode);
+              return detail::parseTimecode(timeCode);
             });
       }
     }  // namespace
@@ -798,7 +1421,8 @@ namespace adm {
 
     Gain parseGain(NodePtr node) {
       auto unitAttr = node->first_attribute("gainUnit");
-      double value = std::stod(node->value());
+      double value = detail::parseDouble(
+          node->value(), node->value() + node->value_size());
       if (unitAttr) {
         std::string unitAttrStr{unitAttr->value()};
         if (unitAttrStr == "linear")
@@ -974,7 +1598,8 @@ namespace adm {
     }
 
     DialogueId parseDialogueId(NodePtr node) {
-      return DialogueId(std::stoi(node->value()));
+      return DialogueId(detail::parseInt(
+          node->value(), node->value() + node->value_size()));
     }
 
     ContentKind parseContentKind(NodePtr node) {
@@ -0,0 +1,102 @@
+#include "adm/private/element_content.hpp"
+#include "adm/private/rapidxml_formatter.hpp"
+#include "adm/private/rapidxml_wrapper.hpp"
+
+namespace adm {
+  namespace detail {
+
+    ElementContentWriter::ElementContentWriter() : writer_(0) {}
+
+    template <typename Element, typename Format>
+    std::string ElementContentWriter::write(const Element& element,
+                                            const char* name, Format format) {
+      // default values are discarded, as when writing a document
+      auto serial = writer_.startElement(0, name);
+      xml::XmlNode node(writer_, 0, serial, true);
+      format(node, element);
+      writer_.close();
+      return writer_.takeOutput();
+    }
+
+    template <typename BlockFormat, typename Format>
+    void ElementContentWriter::writeBlocks(
+        ChannelFormatContent& content, const AudioChannelFormat& channelFormat,
+        Format format) {
+      auto blocks = channelFormat.getElements<BlockFormat>();
+      content.blocks.reserve(blocks.size());
+      for (const auto& block : blocks) {
+        content.blocks.emplace_back(
+            block.template get<AudioBlockFormatId>(),
+            write(block, "audioBlockFormat",
+                  [&format](xml::XmlNode& node, const BlockFormat& b) {
+                    format(node, b, TimeReference::TOTAL);
+                  }));
+      }
+    }
+
+    std::string ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioProgramme>& programme) {
+      return write(programme, "audioProgramme", &xml::formatAudioProgramme);
+    }
+
+    std::string ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioContent>& content) {
+      return write(content, "audioContent", &xml::formatAudioContent);
+    }
+
+    std::string ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioObject>& object) {
+      return write(object, "audioObject", &xml::formatAudioObject);
+    }
+
+    std::string ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioPackFormat>& packFormat) {
+      return write(packFormat, "audioPackFormat", &xml::formatAudioPackFormat);
+    }
+
+    std::string ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioStreamFormat>& streamFormat) {
+      return write(streamFormat, "audioStreamFormat",
+                   &xml::formatAudioStreamFormat);
+    }
+
+    std::string ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioTrackFormat>& trackFormat) {
+      return write(trackFormat, "audioTrackFormat",
+                   &xml::formatAudioTrackFormat);
+    }
+
+    std::string ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioTrackUid>& trackUid) {
+      return write(trackUid, "audioTrackUID", &xml::formatAudioTrackUid);
+    }
+
+    ChannelFormatContent ElementContentWriter::operator()(
+        const std::shared_ptr<const AudioChannelFormat>& channelFormat) {
+      ChannelFormatContent content;
+      content.parameters = write(channelFormat, "audioChannelFormat",
+                                 &xml::formatAudioChannelFormatParameters);
+
+      // only the blocks of the channel type are written
+      auto channelType = channelFormat->get<TypeDescriptor>();
+      if (channelType == TypeDefinition::DIRECT_SPEAKERS) {
+        writeBlocks<AudioBlockFormatDirectSpeakers>(
+            content, *channelFormat, &xml::formatBlockFormatDirectSpeakers);
+      } else if (channelType == TypeDefinition::MATRIX) {
+        writeBlocks<AudioBlockFormatMatrix>(content, *channelFormat,
+                                            &xml::formatBlockFormatMatrix);
+      } else if (channelType == TypeDefinition::OBJECTS) {
+        writeBlocks<AudioBlockFormatObjects>(content, *channelFormat,
+                                             &xml::formatBlockFormatObjects);
+      } else if (channelType == TypeDefinition::HOA) {
+        writeBlocks<AudioBlockFormatHoa>(content, *channelFormat,
+                                         &xml::formatBlockFormatHoa);
+      } else if (channelType == TypeDefinition::BINAURAL) {
+        writeBlocks<AudioBlockFormatBinaural>(
+            content, *channelFormat, &xml::formatBlockFormatBinaural);
+      }
+      return content;
+    }
+
+  }  // namespace detail
+}  // namespace adm
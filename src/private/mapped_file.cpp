@@ -0,0 +1,70 @@
+#include "adm/private/mapped_file.hpp"
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ADM_HAVE_MMAP
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+namespace adm {
+  namespace xml {
+
+#ifdef ADM_HAVE_MMAP
+    MappedFile::MappedFile(const std::string& filename) {
+      int fd = open(filename.c_str(), O_RDONLY);
+      if (fd == -1) throw std::runtime_error("cannot open file " + filename);
+
+      struct stat fileStat;
+      if (fstat(fd, &fileStat) == -1) {
+        close(fd);
+        throw std::runtime_error("cannot stat file " + filename);
+      }
+      size_ = static_cast<std::size_t>(fileStat.st_size);
+
+      // reserve zero-filled space for the file and the terminating null
+      // character, then map the file over the start of it; the rest of the
+      // last page of the file is zero-filled too
+      auto pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+      mappedSize_ = (size_ / pageSize + 1) * pageSize;
+      void* base = mmap(nullptr, mappedSize_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANON, -1, 0);
+      if (base == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("cannot map file " + filename);
+      }
+      if (size_ && mmap(base, size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, mappedSize_);
+        close(fd);
+        throw std::runtime_error("cannot map file " + filename);
+      }
+      // the mapping stays valid after the file is closed
+      close(fd);
+      data_ = static_cast<char*>(base);
+    }
+
+    MappedFile::~MappedFile() {
+      if (mappedSize_) munmap(data_, mappedSize_);
+    }
+#else
+    MappedFile::MappedFile(const std::string& filename) {
+      std::ifstream stream(filename, std::ios::binary);
+      if (!stream) throw std::runtime_error("cannot open file " + filename);
+      buffer_.assign(std::istreambuf_iterator<char>(stream),
+                     std::istreambuf_iterator<char>());
+      size_ = buffer_.size();
+      buffer_.push_back('\0');
+      data_ = buffer_.data();
+    }
+
+    MappedFile::~MappedFile() = default;
+#endif
+
+  }  // namespace xml
+}  // namespace adm
@@ -310,16 +310,24 @@ namespace adm {
       // clang-format on
     }
 
-    void formatAudioChannelFormat(
-        XmlNode &node, std::shared_ptr<const AudioChannelFormat> channelFormat,
-        TimeReference timeReference) {
+    void formatAudioChannelFormatParameters(
+        XmlNode &node,
+        const std::shared_ptr<const AudioChannelFormat> channelFormat) {
       // clang-format off
       node.addAttribute<AudioChannelFormatId>(channelFormat, "audioChannelFormatID");
       node.addOptionalAttribute<AudioChannelFormatName>(channelFormat, "audioChannelFormatName");
       node.addOptionalAttribute<TypeDescriptor>(channelFormat, "typeLabel", &formatTypeLabel);
       node.addOptionalAttribute<TypeDescriptor>(channelFormat, "typeDefinition", &formatTypeDefinition);
       node.addOptionalMultiElement<Frequency>(channelFormat, "frequency", &formatFrequency);
+      // clang-format on
+    }
 
+    void formatAudioChannelFormat(
+        XmlNode &node, std::shared_ptr<const AudioChannelFormat> channelFormat,
+        TimeReference timeReference) {
+      formatAudioChannelFormatParameters(node, channelFormat);
+
+      // clang-format off
       auto channelType = channelFormat->get<TypeDescriptor>();
       if (channelType == TypeDefinition::DIRECT_SPEAKERS) {
         node.addElements<AudioBlockFormatDirectSpeakers>(channelFormat, "audioBlockFormat", detail::wrapWithTimeRef(formatBlockFormatDirectSpeakers, timeReference));
@@ -5,21 +5,14 @@ namespace adm {
 
     // ---- XML DOCUMENT WRAPPER ---- //
 
+    XmlDocument::XmlDocument(std::ostream &stream) : writer_(stream) {}
+
     XmlNode XmlDocument::addNode(const std::string &name) {
-      auto nameString = doc_.allocate_string(name.c_str());
-      auto childNode = doc_.allocate_node(rapidxml::node_element, nameString);
-      doc_.append_node(childNode);
-      return XmlNode(childNode, discardDefaultValues_);
+      auto serial = writer_.startElement(0, name);
+      return XmlNode(writer_, 0, serial, discardDefaultValues_);
     }
 
-    XmlNode XmlDocument::addDeclaration() {
-      auto declaration = doc_.allocate_node(rapidxml::node_declaration);
-      declaration->append_attribute(doc_.allocate_attribute("version", "1.0"));
-      declaration->append_attribute(
-          doc_.allocate_attribute("encoding", "utf-8"));
-      doc_.append_node(declaration);
-      return XmlNode(declaration, discardDefaultValues_);
-    }
+    void XmlDocument::addDeclaration() { writer_.declaration("1.0", "utf-8"); }
 
     XmlNode XmlDocument::addItuStructure() {
       auto ituAdmNode = addNode("ituADM");
@@ -48,31 +41,35 @@ namespace adm {
       return addCoreMetadataAudioFormatExtended(ebuCoreMainNode);
     }
 
+    void XmlDocument::finish() { writer_.finish(); }
+
     // ---- XML NODE WRAPPER ---- //
 
-    XmlNode::XmlNode(NodePtr node, bool discardDefaults)
-        : node_(node), discardDefaultValues_(discardDefaults){};
+    XmlNode::XmlNode(XmlStreamWriter &writer, std::size_t depth,
+                     std::size_t serial, bool discardDefaults)
+        : writer_(&writer),
+          depth_(depth),
+          serial_(serial),
+          discardDefaultValues_(discardDefaults) {}
 
     void XmlNode::setValue(const std::string &value) {
-      auto valueString = node_->document()->allocate_string(value.c_str());
-      node_->value(valueString);
+      writer_->value(depth_, serial_, value);
     }
 
     XmlNode XmlNode::addNode(const std::string &name) {
-      auto nameString = node_->document()->allocate_string(name.c_str());
-      auto childNode =
-          node_->document()->allocate_node(rapidxml::node_element, nameString);
-      node_->append_node(childNode);
-      return XmlNode(childNode, discardDefaultValues_);
+      writer_->select(depth_, serial_);
+      auto serial = writer_->startElement(depth_ + 1, name);
+      return XmlNode(*writer_, depth_ + 1, serial, discardDefaultValues_);
     }
 
     void XmlNode::addAttribute(const std::string &name,
                                const std::string &value) {
-      auto nameString = node_->document()->allocate_string(name.c_str());
-      auto valueString = node_->document()->allocate_string(value.c_str());
-      auto attribute =
-          node_->document()->allocate_attribute(nameString, valueString);
-      node_->append_attribute(attribute);
+      writer_->attribute(depth_, serial_, name, value);
+    }
+
+    void XmlNode::addFragment(const std::string &xml) {
+      writer_->select(depth_, serial_);
+      writer_->insert(depth_ + 1, xml);
     }
 
     void XmlNode::addElement(const std::string &name,
@@ -81,5 +78,21 @@ namespace adm {
       elementNode.setValue(value);
     }
 
+    // ---- XML FRAGMENT ---- //
+
+    XmlFragment::XmlFragment(const XmlNode &parent)
+        : writer_(parent.depth_ + 1),
+          discardDefaultValues_(parent.discardDefaultValues_) {}
+
+    XmlNode XmlFragment::addNode(const std::string &name) {
+      auto serial = writer_.startElement(0, name);
+      return XmlNode(writer_, 0, serial, discardDefaultValues_);
+    }
+
+    std::string XmlFragment::finish() {
+      writer_.close();
+      return writer_.takeOutput();
+    }
+
   }  // namespace xml
 }  // namespace adm
@@ -0,0 +1,132 @@
+#include "adm/private/xml_stream_reader.hpp"
+#include <cstring>
+#include <istream>
+#include "adm/errors.hpp"
+
+namespace adm {
+  namespace xml {
+
+    XmlStreamReader::XmlStreamReader(std::istream& stream,
+                                     std::size_t bufferSize)
+        : stream_(stream), buffer_(bufferSize) {}
+
+    bool XmlStreamReader::fill() {
+      stream_.read(buffer_.data(),
+                   static_cast<std::streamsize>(buffer_.size()));
+      pos_ = 0;
+      end_ = static_cast<std::size_t>(stream_.gcount());
+      return end_ != 0;
+    }
+
+    int XmlStreamReader::getOrThrow() {
+      int c = get();
+      if (c == -1) {
+        throw error::XmlParsingError("unexpected end of xml document");
+      }
+      return c;
+    }
+
+    bool XmlStreamReader::next() {
+      text_.clear();
+      name_.clear();
+      int c = peek();
+      if (c == -1) return false;
+      if (c == '<') {
+        readTag();
+      } else {
+        readText();
+      }
+      return true;
+    }
+
+    void XmlStreamReader::readText() {
+      type_ = TokenType::text;
+      while (peek() != -1) {
+        const char* begin = buffer_.data() + pos_;
+        auto found = static_cast<const char*>(
+            std::memchr(begin, '<', end_ - pos_));
+        const char* stop = found ? found : buffer_.data() + end_;
+        text_.append(begin, stop);
+        pos_ += static_cast<std::size_t>(stop - begin);
+        if (found) return;
+      }
+    }
+
+    void XmlStreamReader::readTag() {
+      text_.push_back(static_cast<char>(get()));
+      int c = getOrThrow();
+      text_.push_back(static_cast<char>(c));
+      if (c == '/') {
+        type_ = TokenType::endTag;
+        readUntil(">");
+        readName(2);
+      } else if (c == '?') {
+        type_ = TokenType::other;
+        readUntil("?>");
+      } else if (c == '!') {
+        type_ = TokenType::other;
+        c = getOrThrow();
+        text_.push_back(static_cast<char>(c));
+        if (c == '-') {
+          readUntil("-->");
+        } else if (c == '[') {
+          readUntil("]]>");
+        } else {
+          readDoctype();
+        }
+      } else {
+        // attribute values may contain '>'
+        char quote = 0;
+        while (c != '>' || quote) {
+          c = getOrThrow();
+          text_.push_back(static_cast<char>(c));
+          if (quote) {
+            if (c == quote) quote = 0;
+          } else if (c == '"' || c == '\'') {
+            quote = static_cast<char>(c);
+          }
+        }
+        type_ = text_[text_.size() - 2] == '/' ? TokenType::emptyTag
+                                                : TokenType::startTag;
+        readName(1);
+      }
+    }
+
+    void XmlStreamReader::readUntil(const char* terminator) {
+      auto length = std::strlen(terminator);
+      // the terminator may not overlap with the start of the token
+      auto start = text_.size();
+      while (text_.size() < start + length ||
+             text_.compare(text_.size() - length, length, terminator) != 0) {
+        text_.push_back(static_cast<char>(getOrThrow()));
+      }
+    }
+
+    void XmlStreamReader::readDoctype() {
+      // the internal subset may contain '>', but brackets and quotes are
+      // balanced
+      int depth = 0;
+      char quote = 0;
+      char c = text_.back();
+      while (c != '>' || depth || quote) {
+        if (quote) {
+          if (c == quote) quote = 0;
+        } else if (c == '"' || c == '\'') {
+          quote = c;
+        } else if (c == '[') {
+          ++depth;
+        } else if (c == ']') {
+          --depth;
+        }
+        c = static_cast<char>(getOrThrow());
+        text_.push_back(c);
+      }
+    }
+
+    void XmlStreamReader::readName(std::size_t offset) {
+      auto end = text_.find_first_of(" \t\r\n/>", offset);
+      name_.assign(text_, offset, end - offset);
+    }
+
+  }  // namespace xml
+}  // namespace adm
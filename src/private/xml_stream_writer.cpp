@@ -0,0 +1,193 @@
+#include "adm/private/xml_stream_writer.hpp"
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+
+namespace adm {
+  namespace xml {
+
+    XmlStreamWriter::XmlStreamWriter(std::ostream& stream,
+                                     std::size_t indent,
+                                     std::size_t bufferSize)
+        : stream_(&stream), indent_(indent), bufferSize_(bufferSize) {
+      buffer_.reserve(bufferSize_);
+    }
+
+    XmlStreamWriter::XmlStreamWriter(std::size_t indent)
+        : stream_(nullptr), indent_(indent), bufferSize_(0) {}
+
+    void XmlStreamWriter::declaration(const std::string& version,
+                                      const std::string& encoding) {
+      buffer_ += "<?xml version=\"";
+      appendEscaped(buffer_, version.c_str(), '\'');
+      buffer_ += "\" encoding=\"";
+      appendEscaped(buffer_, encoding.c_str(), '\'');
+      buffer_ += "\"?>\n";
+    }
+
+    std::size_t XmlStreamWriter::startElement(std::size_t depth,
+                                              const std::string& name) {
+      openChildAt(depth);
+      if (open_.size() == depth_) open_.emplace_back();
+      auto& element = open_[depth_++];
+      element.name.assign(name.c_str());
+      element.serial = nextSerial_++;
+      element.started = false;
+      attributes_.clear();
+      value_.clear();
+      return element.serial;
+    }
+
+    void XmlStreamWriter::attribute(std::size_t depth, std::size_t serial,
+                                    const std::string& name,
+                                    const std::string& value) {
+      select(depth, serial);
+      if (open_[depth].started) {
+        throw std::logic_error(
+            "attribute added to XML element after its children");
+      }
+      attributes_ += ' ';
+      attributes_ += name.c_str();
+      attributes_ += '=';
+      // quote in the same way as rapidxml
+      if (std::strchr(value.c_str(), '"')) {
+        attributes_ += '\'';
+        appendEscaped(attributes_, value.c_str(), '"');
+        attributes_ += '\'';
+      } else {
+        attributes_ += '"';
+        appendEscaped(attributes_, value.c_str(), '\'');
+        attributes_ += '"';
+      }
+    }
+
+    void XmlStreamWriter::value(std::size_t depth, std::size_t serial,
+                                const std::string& value) {
+      select(depth, serial);
+      if (!open_[depth].started) value_.assign(value.c_str());
+    }
+
+    void XmlStreamWriter::insert(std::size_t depth, const std::string& xml) {
+      openChildAt(depth);
+      buffer_ += xml;
+      flushIfFull();
+    }
+
+    void XmlStreamWriter::close() { closeTo(0); }
+
+    void XmlStreamWriter::flush() {
+      if (!stream_) return;
+      stream_->write(buffer_.data(),
+                     static_cast<std::streamsize>(buffer_.size()));
+      buffer_.clear();
+    }
+
+    std::string XmlStreamWriter::takeOutput() {
+      std::string output;
+      std::swap(output, buffer_);
+      return output;
+    }
+
+    void XmlStreamWriter::finish() {
+      close();
+      // rapidxml ends the document node with a newline too
+      buffer_ += '\n';
+      flush();
+    }
+
+    void XmlStreamWriter::select(std::size_t depth, std::size_t serial) {
+      if (depth >= depth_ || open_[depth].serial != serial) {
+        throw std::logic_error("XML element modified after it was closed");
+      }
+      closeTo(depth + 1);
+    }
+
+    void XmlStreamWriter::openChildAt(std::size_t depth) {
+      if (depth > depth_) {
+        throw std::logic_error("parent of new XML element is not open");
+      }
+      closeTo(depth);
+      if (depth > 0 && !open_[depth - 1].started) {
+        // the value of an element with children is not written
+        writeStartTag(open_[depth - 1], depth - 1);
+        buffer_ += ">\n";
+        open_[depth - 1].started = true;
+      }
+      flushIfFull();
+    }
+
+    void XmlStreamWriter::closeTo(std::size_t depth) {
+      while (depth_ > depth) closeInnermost();
+    }
+
+    void XmlStreamWriter::closeInnermost() {
+      auto depth = depth_ - 1;
+      auto& element = open_[depth];
+      if (element.started) {
+        writeIndent(depth);
+        buffer_ += "</";
+        buffer_ += element.name;
+        buffer_ += ">\n";
+      } else {
+        writeStartTag(element, depth);
+        if (value_.empty()) {
+          buffer_ += "/>\n";
+        } else {
+          buffer_ += '>';
+          appendEscaped(buffer_, value_.c_str(), '\0');
+          buffer_ += "</";
+          buffer_ += element.name;
+          buffer_ += ">\n";
+        }
+      }
+      depth_ = depth;
+      flushIfFull();
+    }
+
+    void XmlStreamWriter::writeStartTag(const OpenElement& element,
+                                        std::size_t depth) {
+      writeIndent(depth);
+      buffer_ += '<';
+      buffer_ += element.name;
+      buffer_ += attributes_;
+    }
+
+    void XmlStreamWriter::writeIndent(std::size_t depth) {
+      buffer_.append(indent_ + depth, '\t');
+    }
+
+    void XmlStreamWriter::appendEscaped(std::string& out, const char* text,
+                                        char noExpand) {
+      for (const char* p = text; *p; ++p) {
+        if (*p == noExpand) {
+          out += *p;
+          continue;
+        }
+        switch (*p) {
+          case '<':
+            out += "&lt;";
+            break;
+          case '>':
+            out += "&gt;";
+            break;
+          case '\'':
+            out += "&apos;";
+            break;
+          case '"':
+            out += "&quot;";
+            break;
+          case '&':
+            out += "&amp;";
+            break;
+          default:
+            out += *p;
+        }
+      }
+    }
+
+    void XmlStreamWriter::flushIfFull() {
+      if (stream_ && buffer_.size() >= bufferSize_) flush();
+    }
+
+  }  // namespace xml
+}  // namespace adm
@@ -2,10 +2,9 @@
 #include "adm/elements.hpp"
 #include "adm/document.hpp"
 #include "adm/private/rapidxml_formatter.hpp"
-#include "rapidxml/rapidxml.hpp"
-#include "rapidxml/rapidxml_print.hpp"
-#include "rapidxml/rapidxml_utils.hpp"
 #include "adm/private/rapidxml_wrapper.hpp"
+#include "adm/private/parallel.hpp"
+#include <vector>
 
 namespace adm {
   namespace xml {
@@ -24,19 +23,48 @@ namespace adm {
         return static_cast<bool>(options & flag);
       }
 
+      /// format the audioChannelFormats in document into separate
+      /// fragments on a pool of threads, and add them to node in order
+      void add_channel_formats_parallel(
+          XmlNode& node, const std::shared_ptr<Document const>& document,
+          TimeReference timeReference) {
+        std::vector<std::shared_ptr<const AudioChannelFormat>> channelFormats;
+        for (auto& element : document->getElements<AudioChannelFormat>()) {
+          if (!isCommonDefinitionsId(element->get<AudioChannelFormatId>())) {
+            channelFormats.push_back(element);
+          }
+        }
+
+        adm::detail::orderedParallelFor<std::string>(
+            channelFormats.size(),
+            [&](std::size_t i) {
+              XmlFragment fragment(node);
+              auto channelNode = fragment.addNode("audioChannelFormat");
+              formatAudioChannelFormat(channelNode, channelFormats[i],
+                                       timeReference);
+              return fragment.finish();
+            },
+            [&](std::size_t, std::string&& xml) { node.addFragment(xml); });
+      }
+
       void add_document_to_node(
           XmlNode& audioFormatExtended,
           std::shared_ptr<Document const> document,
-          TimeReference timeReference = TimeReference::TOTAL) {
+          TimeReference timeReference = TimeReference::TOTAL,
+          bool parallel = false) {
         // clang-format off
         audioFormatExtended.addOptionalAttribute<Version>(document, "version");
         audioFormatExtended.addBaseElements<AudioProgramme, AudioProgrammeId>(document, "audioProgramme", &formatAudioProgramme);
         audioFormatExtended.addBaseElements<AudioContent, AudioContentId>(document, "audioContent", &formatAudioContent);
         audioFormatExtended.addBaseElements<AudioObject, AudioObjectId>(document, "audioObject", &formatAudioObject);
         audioFormatExtended.addBaseElements<AudioPackFormat, AudioPackFormatId>(document, "audioPackFormat", &formatAudioPackFormat);
-        audioFormatExtended.addBaseElements<AudioChannelFormat, AudioChannelFormatId>(document, "audioChannelFormat",
-                                                                                      [timeReference](XmlNode& node, std::shared_ptr<const AudioChannelFormat> channelFormat){formatAudioChannelFormat(
-                                                                                          node, std::move(channelFormat), timeReference);});
+        if (parallel) {
+          add_channel_formats_parallel(audioFormatExtended, document, timeReference);
+        } else {
+          audioFormatExtended.addBaseElements<AudioChannelFormat, AudioChannelFormatId>(document, "audioChannelFormat",
+                                                                                        [timeReference](XmlNode& node, std::shared_ptr<const AudioChannelFormat> channelFormat){formatAudioChannelFormat(
+                                                                                            node, std::move(channelFormat), timeReference);});
+        }
         audioFormatExtended.addBaseElements<AudioStreamFormat, AudioStreamFormatId>(document, "audioStreamFormat", &formatAudioStreamFormat);
         audioFormatExtended.addBaseElements<AudioTrackFormat, AudioTrackFormatId>(document, "audioTrackFormat", &formatAudioTrackFormat);
 
@@ -50,13 +78,11 @@ namespace adm {
       }
     }  // namespace
 
-    using NodePtr = rapidxml::xml_node<>*;
-
     XmlWriter::XmlWriter(WriterOptions options) : options_(options) {}
 
     std::ostream& XmlWriter::write(std::shared_ptr<const Document> document,
                                    std::ostream& stream) {
-      XmlDocument xmlDocument;
+      XmlDocument xmlDocument(stream);
       xmlDocument.setDiscardDefaults(
           !isSet(options_, WriterOptions::write_default_values));
       xmlDocument.addDeclaration();
@@ -66,8 +92,10 @@ namespace adm {
       } else {
         root = xmlDocument.addEbuStructure();
       }
-      add_document_to_node(root, document);
-      return stream << xmlDocument;
+      add_document_to_node(root, document, TimeReference::TOTAL,
+                           isSet(options_, WriterOptions::parallel));
+      xmlDocument.finish();
+      return stream;
     }
 
     SadmXmlWriter::SadmXmlWriter(SadmWriterOptions options)
@@ -75,7 +103,7 @@ namespace adm {
     std::ostream& SadmXmlWriter::write(std::shared_ptr<const Document> document,
                                        const FrameHeader& frameHeader,
                                        std::ostream& stream) {
-      XmlDocument xmlDocument;
+      XmlDocument xmlDocument(stream);
       xmlDocument.setDiscardDefaults(
           !isSet(options_, SadmWriterOptions::write_default_values));
       xmlDocument.addDeclaration();
@@ -89,8 +117,10 @@ namespace adm {
         formatExtended = root.addNode("audioFormatExtended");
       }
       add_document_to_node(formatExtended, document,
-                           frameHeader.get<FrameFormat>().get<TimeReference>());
-      return stream << xmlDocument;
+                           frameHeader.get<FrameFormat>().get<TimeReference>(),
+                           isSet(options_, SadmWriterOptions::parallel));
+      xmlDocument.finish();
+      return stream;
     }
   }  // namespace xml
 }  // namespace adm
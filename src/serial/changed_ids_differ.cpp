@@ -0,0 +1,158 @@
+#include "adm/serial/changed_ids_differ.hpp"
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "adm/detail/id_index.hpp"
+#include "adm/private/element_content.hpp"
+#include "adm/utilities/id_assignment.hpp"
+
+namespace adm {
+
+  namespace {
+
+    template <typename Element>
+    bool isWritten(const Element& element) {
+      return !isCommonDefinitionsId(
+          element.template get<typename Element::id_type>());
+    }
+
+    bool isWritten(const AudioTrackUid& trackUid) {
+      return !isCommonDefinitionsId(trackUid.get<AudioTrackUidId>()) &&
+             !trackUid.isSilent();
+    }
+
+    /// the status of an element which is in both documents, if it changed
+    bool compare(const std::string& previous, const std::string& current,
+                 ChangedIdStatus& status) {
+      status = ChangedIdStatus::CHANGED;
+      return previous != current;
+    }
+
+    bool compare(const detail::ChannelFormatContent& previous,
+                 const detail::ChannelFormatContent& current,
+                 ChangedIdStatus& status) {
+      if (previous == current) return false;
+      // extended if blocks were only added at the end; any change to the
+      // blocks that were there before is a change
+      bool extended = previous.parameters == current.parameters &&
+                      current.blocks.size() > previous.blocks.size();
+      for (std::size_t i = 0; extended && i < previous.blocks.size(); ++i) {
+        extended = previous.blocks[i] == current.blocks[i];
+      }
+      status = extended ? ChangedIdStatus::EXTENDED : ChangedIdStatus::CHANGED;
+      return true;
+    }
+
+    /// the content of the elements of one type in a document
+    template <typename Element>
+    struct ElementContents {
+      using Id = typename Element::id_type;
+      using Content = decltype(std::declval<detail::ElementContentWriter&>()(
+          std::shared_ptr<const Element>()));
+
+      /// IDs in document order
+      std::vector<Id> ids;
+      std::unordered_map<Id, Content, detail::IdHash> contents;
+
+      void clear() {
+        ids.clear();
+        contents.clear();
+      }
+    };
+
+    /// write the elements of one type in document into current, and add
+    /// the differences from previous to changedIds
+    template <typename Element>
+    void diff(const Document& document,
+              const ElementContents<Element>& previous,
+              ElementContents<Element>& current,
+              detail::ElementContentWriter& writer, ChangedIds& changedIds) {
+      using Id = typename Element::id_type;
+      current.clear();
+      for (const auto& element : document.getElements<Element>()) {
+        if (!isWritten(*element)) continue;
+        auto id = element->template get<Id>();
+        auto content = writer(element);
+        auto previousContent = previous.contents.find(id);
+        ChangedIdStatus status = ChangedIdStatus::NEW;
+        if (previousContent == previous.contents.end() ||
+            compare(previousContent->second, content, status)) {
+          changedIds.add(ChangedId<Element>(id, status));
+        }
+        if (current.contents.emplace(id, std::move(content)).second) {
+          current.ids.push_back(id);
+        }
+      }
+      for (const auto& id : previous.ids) {
+        if (current.contents.find(id) == current.contents.end()) {
+          changedIds.add(ChangedId<Element>(id, ChangedIdStatus::EXPIRED));
+        }
+      }
+    }
+
+  }  // namespace
+
+  class ChangedIdsDiffer::Impl {
+   public:
+    ChangedIds update(const Document& document) {
+      ChangedIds changedIds;
+      diff(document, previous_.programmes, current_.programmes, writer_,
+           changedIds);
+      diff(document, previous_.contents, current_.contents, writer_,
+           changedIds);
+      diff(document, previous_.objects, current_.objects, writer_,
+           changedIds);
+      diff(document, previous_.packFormats, current_.packFormats, writer_,
+           changedIds);
+      diff(document, previous_.channelFormats, current_.channelFormats,
+           writer_, changedIds);
+      diff(document, previous_.streamFormats, current_.streamFormats,
+           writer_, changedIds);
+      diff(document, previous_.trackFormats, current_.trackFormats, writer_,
+           changedIds);
+      diff(document, previous_.trackUids, current_.trackUids, writer_,
+           changedIds);
+      // keep both, so that their storage is reused
+      std::swap(previous_, current_);
+      return changedIds;
+    }
+
+    void reset() { previous_ = DocumentContents(); }
+
+   private:
+    struct DocumentContents {
+      ElementContents<AudioProgramme> programmes;
+      ElementContents<AudioContent> contents;
+      ElementContents<AudioObject> objects;
+      ElementContents<AudioPackFormat> packFormats;
+      ElementContents<AudioChannelFormat> channelFormats;
+      ElementContents<AudioStreamFormat> streamFormats;
+      ElementContents<AudioTrackFormat> trackFormats;
+      ElementContents<AudioTrackUid> trackUids;
+    };
+
+    DocumentContents previous_;
+    DocumentContents current_;
+    detail::ElementContentWriter writer_;
+  };
+
+  ChangedIdsDiffer::ChangedIdsDiffer() : impl_(new Impl) {}
+
+  ChangedIdsDiffer::~ChangedIdsDiffer() = default;
+
+  ChangedIds ChangedIdsDiffer::update(
+      const std::shared_ptr<const Document>& document) {
+    return impl_->update(*document);
+  }
+
+  void ChangedIdsDiffer::reset() { impl_->reset(); }
+
+  ChangedIds computeChangedIds(const std::shared_ptr<const Document>& previous,
+                               const std::shared_ptr<const Document>& current) {
+    ChangedIdsDiffer differ;
+    differ.update(previous);
+    return differ.update(current);
+  }
+
+}  // namespace adm
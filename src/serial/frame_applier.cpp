@@ -0,0 +1,406 @@
+#include "adm/serial/frame_applier.hpp"
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "adm/elements/private/parent_attorneys.hpp"
+
+namespace adm {
+
+  namespace {
+
+    /// the attorney which gives access to the private parts of Element
+    template <typename Element>
+    struct AttorneyFor;
+    template <>
+    struct AttorneyFor<AudioProgramme> {
+      using type = AudioProgrammeAttorney;
+    };
+    template <>
+    struct AttorneyFor<AudioContent> {
+      using type = AudioContentAttorney;
+    };
+    template <>
+    struct AttorneyFor<AudioObject> {
+      using type = AudioObjectAttorney;
+    };
+    template <>
+    struct AttorneyFor<AudioPackFormat> {
+      using type = AudioPackFormatAttorney;
+    };
+    template <>
+    struct AttorneyFor<AudioChannelFormat> {
+      using type = AudioChannelFormatAttorney;
+    };
+    template <>
+    struct AttorneyFor<AudioStreamFormat> {
+      using type = AudioStreamFormatAttorney;
+    };
+    template <>
+    struct AttorneyFor<AudioTrackFormat> {
+      using type = AudioTrackFormatAttorney;
+    };
+    template <>
+    struct AttorneyFor<AudioTrackUid> {
+      using type = AudioTrackUidAttorney;
+    };
+
+    template <typename Element>
+    typename Element::id_type idOf(const Element& element) {
+      return element.template get<typename Element::id_type>();
+    }
+
+    /// a new, changed or extended element
+    template <typename Element>
+    struct Update {
+      /// the element in the document; null for new elements
+      std::shared_ptr<Element> target;
+      /// the element in the frame
+      std::shared_ptr<const Element> source;
+      ChangedIdStatus status;
+    };
+
+    /// the changes to apply to elements of one type
+    template <typename Element>
+    struct ElementChanges {
+      std::vector<Update<Element>> updates;
+      std::vector<std::shared_ptr<Element>> expired;
+    };
+
+    struct FrameChanges {
+      ElementChanges<AudioProgramme> programmes;
+      ElementChanges<AudioContent> contents;
+      ElementChanges<AudioObject> objects;
+      ElementChanges<AudioPackFormat> packFormats;
+      ElementChanges<AudioChannelFormat> channelFormats;
+      ElementChanges<AudioStreamFormat> streamFormats;
+      ElementChanges<AudioTrackFormat> trackFormats;
+      ElementChanges<AudioTrackUid> trackUids;
+    };
+
+    /// call f with the changes for each element type
+    template <typename F>
+    void forEachType(FrameChanges& changes, F f) {
+      f(changes.programmes);
+      f(changes.contents);
+      f(changes.objects);
+      f(changes.packFormats);
+      f(changes.channelFormats);
+      f(changes.streamFormats);
+      f(changes.trackFormats);
+      f(changes.trackUids);
+    }
+
+    /// find the elements in the document and frame for each changed ID,
+    /// without modifying anything
+    template <typename Element>
+    void collect(ElementChanges<Element>& changes, Document& document,
+                 const Document& frame,
+                 const std::vector<ChangedId<Element>>& changedIds) {
+      using Id = typename Element::id_type;
+      for (const auto& changedId : changedIds) {
+        auto id = changedId.template get<Id>();
+        auto status = changedId.template get<ChangedIdStatus>();
+        auto target = document.lookup(id);
+        if (status == ChangedIdStatus::EXPIRED) {
+          if (target) changes.expired.push_back(std::move(target));
+          continue;
+        }
+        auto source = frame.lookup(id);
+        if (!source) {
+          throw std::runtime_error("element " + formatId(id) +
+                                   " is marked as " + formatValue(status) +
+                                   " but is not in the frame");
+        }
+        changes.updates.push_back({std::move(target), std::move(source),
+                                   status});
+      }
+    }
+
+    /// the element in document with the same ID as reference
+    template <typename Element>
+    std::shared_ptr<Element> resolve(std::shared_ptr<Document>& document,
+                                     const Element& reference) {
+      auto id = idOf(reference);
+      if (auto element = document->lookup(id)) return element;
+      throw std::runtime_error("referenced element " + formatId(id) +
+                               " is not in the document");
+    }
+
+    std::shared_ptr<AudioTrackUid> resolve(std::shared_ptr<Document>& document,
+                                           const AudioTrackUid& reference) {
+      if (reference.isSilent()) return AudioTrackUid::getSilent(document);
+      return resolve<AudioTrackUid>(document, reference);
+    }
+
+    /// do two ranges of element pointers refer to elements with the same IDs
+    /// in the same order?
+    template <typename Range, typename OtherRange>
+    bool sameIds(const Range& range, const OtherRange& otherRange) {
+      auto it = std::begin(range);
+      auto otherIt = std::begin(otherRange);
+      for (; it != std::end(range) && otherIt != std::end(otherRange);
+           ++it, ++otherIt) {
+        if (idOf(**it) != idOf(**otherIt)) return false;
+      }
+      return it == std::end(range) && otherIt == std::end(otherRange);
+    }
+
+    /// make the Referenced references of target refer to the elements in
+    /// document with the same IDs as those of source
+    template <typename Referenced, typename Element>
+    void updateReferences(std::shared_ptr<Document>& document, Element& target,
+                          const Element& source) {
+      auto wanted = source.template getReferences<Referenced>();
+      if (sameIds(target.template getReferences<Referenced>(), wanted)) return;
+      target.template clearReferences<Referenced>();
+      for (const auto& reference : wanted) {
+        target.addReference(resolve(document, *reference));
+      }
+    }
+
+    /// make the Referenced reference of target refer to the element in
+    /// document with the same ID as that of source
+    template <typename Referenced, typename Element>
+    void updateReference(std::shared_ptr<Document>& document, Element& target,
+                         const Element& source) {
+      auto wanted = source.template getReference<Referenced>();
+      auto current = target.template getReference<Referenced>();
+      if (!wanted) {
+        if (current) target.template removeReference<Referenced>();
+      } else if (!current || idOf(*current) != idOf(*wanted)) {
+        target.setReference(resolve(document, *wanted));
+      }
+    }
+
+    void updateComplementaries(std::shared_ptr<Document>& document,
+                               AudioObject& target,
+                               const AudioObject& source) {
+      const auto& wanted = source.getComplementaryObjects();
+      if (sameIds(target.getComplementaryObjects(), wanted)) return;
+      target.clearComplementaryObjects();
+      for (const auto& reference : wanted) {
+        target.addComplementary(resolve(document, *reference));
+      }
+    }
+
+    /// the track formats of a stream format are updated individually, as
+    /// removing one also removes its reference to the stream format
+    void updateTrackFormatReferences(std::shared_ptr<Document>& document,
+                                     AudioStreamFormat& target,
+                                     const AudioStreamFormat& source) {
+      std::vector<std::shared_ptr<AudioTrackFormat>> wanted;
+      for (const auto& weakReference : source.getAudioTrackFormatReferences()) {
+        if (auto reference = weakReference.lock()) {
+          wanted.push_back(resolve(document, *reference));
+        }
+      }
+      std::vector<std::shared_ptr<AudioTrackFormat>> unwanted;
+      for (const auto& weakReference : target.getAudioTrackFormatReferences()) {
+        auto reference = weakReference.lock();
+        if (reference && std::find(wanted.begin(), wanted.end(),
+                                   reference) == wanted.end()) {
+          unwanted.push_back(std::move(reference));
+        }
+      }
+      for (auto& reference : unwanted) target.removeReference(reference);
+      for (auto& reference : wanted) target.addReference(reference);
+    }
+
+    void updateAllReferences(std::shared_ptr<Document>& document,
+                             AudioProgramme& target,
+                             const AudioProgramme& source) {
+      updateReferences<AudioContent>(document, target, source);
+    }
+
+    void updateAllReferences(std::shared_ptr<Document>& document,
+                             AudioContent& target, const AudioContent& source) {
+      updateReferences<AudioObject>(document, target, source);
+    }
+
+    void updateAllReferences(std::shared_ptr<Document>& document,
+                             AudioObject& target, const AudioObject& source) {
+      updateReferences<AudioObject>(document, target, source);
+      updateReferences<AudioPackFormat>(document, target, source);
+      updateReferences<AudioTrackUid>(document, target, source);
+      updateComplementaries(document, target, source);
+    }
+
+    void updateAllReferences(std::shared_ptr<Document>& document,
+                             AudioPackFormat& target,
+                             const AudioPackFormat& source) {
+      updateReferences<AudioPackFormat>(document, target, source);
+      updateReferences<AudioChannelFormat>(document, target, source);
+    }
+
+    void updateAllReferences(std::shared_ptr<Document>&, AudioChannelFormat&,
+                             const AudioChannelFormat&) {}
+
+    void updateAllReferences(std::shared_ptr<Document>& document,
+                             AudioStreamFormat& target,
+                             const AudioStreamFormat& source) {
+      updateReference<AudioPackFormat>(document, target, source);
+      updateReference<AudioChannelFormat>(document, target, source);
+      updateTrackFormatReferences(document, target, source);
+    }
+
+    void updateAllReferences(std::shared_ptr<Document>& document,
+                             AudioTrackFormat& target,
+                             const AudioTrackFormat& source) {
+      updateReference<AudioStreamFormat>(document, target, source);
+    }
+
+    void updateAllReferences(std::shared_ptr<Document>& document,
+                             AudioTrackUid& target,
+                             const AudioTrackUid& source) {
+      if (target.isSilent()) return;
+      updateReference<AudioTrackFormat>(document, target, source);
+      updateReference<AudioPackFormat>(document, target, source);
+      updateReference<AudioChannelFormat>(document, target, source);
+    }
+
+    /// add the blocks of source to target, replacing those with the same ID
+    ///
+    /// The blocks in a frame normally follow those already in the document,
+    /// so the search for existing blocks starts from the end.
+    template <typename BlockFormat>
+    void extendBlocks(AudioChannelFormat& target,
+                      const AudioChannelFormat& source) {
+      for (const auto& block : source.getElements<BlockFormat>()) {
+        auto id = block.template get<AudioBlockFormatId>();
+        auto counter = id.template get<AudioBlockFormatIdCounter>().get();
+        auto blocks = target.getElements<BlockFormat>();
+        auto it = blocks.end();
+        while (it != blocks.begin()) {
+          auto existingId = std::prev(it)->template get<AudioBlockFormatId>();
+          auto existingCounter =
+              existingId.template get<AudioBlockFormatIdCounter>().get();
+          if (existingCounter < counter) break;
+          --it;
+          if (existingId == id) break;
+        }
+        if (it != blocks.end() &&
+            it->template get<AudioBlockFormatId>() == id) {
+          *it = block;
+        } else {
+          target.add(block);
+        }
+      }
+    }
+
+    /// can the blocks of source be applied to target by extendBlocks? This
+    /// is the case if they replace blocks in target or follow straight on
+    /// from them, as block counters must be consecutive
+    template <typename BlockFormat>
+    bool canExtendBlocks(const AudioChannelFormat& target,
+                         const AudioChannelFormat& source) {
+      auto blocks = target.getElements<BlockFormat>();
+      auto newBlocks = source.getElements<BlockFormat>();
+      if (blocks.empty() || newBlocks.empty()) return true;
+      auto counterOf = [](const BlockFormat& block) {
+        return block.template get<AudioBlockFormatId>()
+            .template get<AudioBlockFormatIdCounter>()
+            .get();
+      };
+      auto first = counterOf(newBlocks.front());
+      return first >= counterOf(blocks.front()) &&
+             first <= counterOf(blocks.back()) + 1u;
+    }
+
+    /// apply an extension of target; returns false if this is not an
+    /// extension, so target should be updated in the same way as a change
+    template <typename Element>
+    bool extend(Element&, const Element&, ChangedIdStatus) {
+      return false;
+    }
+
+    bool extend(AudioChannelFormat& target, const AudioChannelFormat& source,
+                ChangedIdStatus status) {
+      if (status != ChangedIdStatus::EXTENDED) return false;
+      // if frames were missed, the blocks in the frame replace those in the
+      // document, as when joining a flow part way through
+      if (!canExtendBlocks<AudioBlockFormatDirectSpeakers>(target, source) ||
+          !canExtendBlocks<AudioBlockFormatMatrix>(target, source) ||
+          !canExtendBlocks<AudioBlockFormatObjects>(target, source) ||
+          !canExtendBlocks<AudioBlockFormatHoa>(target, source) ||
+          !canExtendBlocks<AudioBlockFormatBinaural>(target, source))
+        return false;
+      extendBlocks<AudioBlockFormatDirectSpeakers>(target, source);
+      extendBlocks<AudioBlockFormatMatrix>(target, source);
+      extendBlocks<AudioBlockFormatObjects>(target, source);
+      extendBlocks<AudioBlockFormatHoa>(target, source);
+      extendBlocks<AudioBlockFormatBinaural>(target, source);
+      return true;
+    }
+
+  }  // namespace
+
+  template <typename Element>
+  void FrameApplier::update(Element& target, const Element& source,
+                            ChangedIdStatus status) {
+    if (!extend(target, source, status)) {
+      AttorneyFor<Element>::type::assignParameters(target, source);
+    }
+  }
+
+  FrameApplier::FrameApplier() = default;
+
+  FrameApplier::FrameApplier(std::shared_ptr<Document> document)
+      : document_(std::move(document)) {}
+
+  void FrameApplier::apply(std::shared_ptr<Document> frame,
+                           const FrameHeader& header) {
+    auto frameFormat = header.get<FrameFormat>();
+    if (!document_ || !frameFormat.has<ChangedIds>()) {
+      document_ = std::move(frame);
+      return;
+    }
+    auto changedIds = frameFormat.get<ChangedIds>();
+
+    FrameChanges changes;
+    collect(changes.programmes, *document_, *frame,
+            changedIds.get<ChangedAudioProgrammeIds>());
+    collect(changes.contents, *document_, *frame,
+            changedIds.get<ChangedAudioContentIds>());
+    collect(changes.objects, *document_, *frame,
+            changedIds.get<ChangedAudioObjectIds>());
+    collect(changes.packFormats, *document_, *frame,
+            changedIds.get<ChangedAudioPackFormatIds>());
+    collect(changes.channelFormats, *document_, *frame,
+            changedIds.get<ChangedAudioChannelFormatIds>());
+    collect(changes.streamFormats, *document_, *frame,
+            changedIds.get<ChangedAudioStreamFormatIds>());
+    collect(changes.trackFormats, *document_, *frame,
+            changedIds.get<ChangedAudioTrackFormatIds>());
+    collect(changes.trackUids, *document_, *frame,
+            changedIds.get<ChangedAudioTrackUidIds>());
+
+    // add and update all elements first, so that references between them
+    // can be resolved
+    auto& document = document_;
+    forEachType(changes, [&document](auto& elementChanges) {
+      for (auto& change : elementChanges.updates) {
+        if (change.target) {
+          update(*change.target, *change.source, change.status);
+        } else {
+          change.target = change.source->copy();
+          document->add(change.target);
+        }
+      }
+    });
+    forEachType(changes, [&document](auto& elementChanges) {
+      for (auto& change : elementChanges.updates) {
+        updateAllReferences(document, *change.target, *change.source);
+      }
+    });
+    forEachType(changes, [&document](auto& elementChanges) {
+      document->removeAll(elementChanges.expired);
+    });
+  }
+
+  std::shared_ptr<Document> FrameApplier::getDocument() const {
+    return document_;
+  }
+
+}  // namespace adm
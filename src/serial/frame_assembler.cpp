@@ -0,0 +1,260 @@
+#include "adm/serial/frame_assembler.hpp"
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "adm/common_definitions.hpp"
+#include "adm/serial/changed_ids_differ.hpp"
+#include "adm/serial/frame_applier.hpp"
+#include "adm/utilities/id_assignment.hpp"
+#include "adm/utilities/time_conversion.hpp"
+
+namespace adm {
+
+  namespace {
+
+    /// the changes to elements other than audioChannelFormats; elements
+    /// are never removed
+    template <typename Element>
+    void keepChanges(const ChangedIds& changedIds, ChangedIds& kept) {
+      for (const auto& changedId :
+           changedIds.get<std::vector<ChangedId<Element>>>()) {
+        if (changedId.template get<ChangedIdStatus>() !=
+            ChangedIdStatus::EXPIRED) {
+          kept.add(changedId);
+        }
+      }
+    }
+
+    /// audioChannelFormats which are not in document are added to it, but
+    /// their blocks are merged separately
+    void keepNewChannelFormats(const ChangedIds& changedIds,
+                               const Document& document, ChangedIds& kept,
+                               std::vector<AudioChannelFormatId>& added) {
+      for (const auto& changedId :
+           changedIds.get<ChangedAudioChannelFormatIds>()) {
+        if (changedId.get<ChangedIdStatus>() == ChangedIdStatus::NEW &&
+            !document.lookup(changedId.get<AudioChannelFormatId>())) {
+          kept.add(changedId);
+          added.push_back(changedId.get<AudioChannelFormatId>());
+        }
+      }
+    }
+
+    template <typename Element, typename Referenced>
+    using References = std::vector<
+        std::pair<std::shared_ptr<Element>, std::shared_ptr<Referenced>>>;
+
+    /// find the references from elements which have changed to elements
+    /// which are not in frame, so that they can be restored after the
+    /// change is applied
+    template <typename Element, typename Referenced>
+    void findReferencesToKeep(Document& document, const Document& frame,
+                              const ChangedIds& changedIds,
+                              References<Element, Referenced>& references) {
+      using Id = typename Element::id_type;
+      using ReferencedId = typename Referenced::id_type;
+      references.clear();
+      for (const auto& changedId :
+           changedIds.get<std::vector<ChangedId<Element>>>()) {
+        if (changedId.template get<ChangedIdStatus>() !=
+            ChangedIdStatus::CHANGED)
+          continue;
+        auto element = document.lookup(changedId.template get<Id>());
+        if (!element) continue;
+        for (const auto& reference :
+             element->template getReferences<Referenced>()) {
+          if (!frame.lookup(reference->template get<ReferencedId>())) {
+            references.emplace_back(element, reference);
+          }
+        }
+      }
+    }
+
+    template <typename Element, typename Referenced>
+    void restoreReferences(const References<Element, Referenced>& references) {
+      for (const auto& reference : references) {
+        reference.first->addReference(reference.second);
+      }
+    }
+
+    template <typename Block>
+    bool isTimed(const Block& block) {
+      return !block.template isDefault<Rtime>() ||
+             block.template has<Duration>();
+    }
+
+    template <typename Block>
+    FixedTime rtimeOf(const Block& block) {
+      return block.template get<Rtime>().get().asFixed();
+    }
+
+    template <typename Block>
+    FixedTime durationOf(const Block& block) {
+      return block.template get<Duration>().get().asFixed();
+    }
+
+    AudioBlockFormatIdCounter counterOf(const AudioBlockFormatId& id) {
+      return id.get<AudioBlockFormatIdCounter>();
+    }
+
+    /// the start of a frame, which is added to the times of its blocks
+    struct Offset {
+      FixedTime time;
+      bool fractional;
+
+      /// convert time back to a Time, keeping fractional times fractional
+      Time toTime(const FixedTime& t, const Time& original) const {
+        return fractional || original.isFractional()
+                   ? Time{t.asFractional().normalised()}
+                   : asNanosecondsOrFractional(t);
+      }
+    };
+
+    /// add the blocks of source to target, with their times offset
+    template <typename Block>
+    void mergeBlocks(const AudioChannelFormat& source,
+                     AudioChannelFormat& target, const Offset& offset) {
+      for (const auto& block : source.getElements<Block>()) {
+        auto blocks = target.getElements<Block>();
+        if (!blocks.empty()) {
+          auto& last = blocks.back();
+          auto id = block.template get<AudioBlockFormatId>();
+          auto lastId = last.template get<AudioBlockFormatId>();
+          if (counterOf(id) < counterOf(lastId)) continue;
+          if (id == lastId) {
+            // the rest of a block which was split between frames
+            if (block.template has<Duration>()) {
+              auto lastStart = rtimeOf(last);
+              auto end = offset.time + rtimeOf(block) + durationOf(block);
+              if (last.template has<Duration>()) {
+                end = std::max(end, lastStart + durationOf(last));
+              }
+              last.set(Duration{offset.toTime(
+                  end - lastStart, block.template get<Duration>().get())});
+            }
+            continue;
+          }
+        }
+
+        if (!isTimed(block) || offset.time == FixedTime{}) {
+          target.add(block);
+        } else {
+          Block rebased = block;
+          rebased.set(Rtime{offset.toTime(offset.time + rtimeOf(block),
+                                          block.template get<Rtime>().get())});
+          target.add(std::move(rebased));
+        }
+      }
+    }
+
+    void mergeBlocks(const AudioChannelFormat& source,
+                     AudioChannelFormat& target, const Offset& offset) {
+      auto channelType = source.get<TypeDescriptor>();
+      if (channelType == TypeDefinition::DIRECT_SPEAKERS) {
+        mergeBlocks<AudioBlockFormatDirectSpeakers>(source, target, offset);
+      } else if (channelType == TypeDefinition::MATRIX) {
+        mergeBlocks<AudioBlockFormatMatrix>(source, target, offset);
+      } else if (channelType == TypeDefinition::OBJECTS) {
+        mergeBlocks<AudioBlockFormatObjects>(source, target, offset);
+      } else if (channelType == TypeDefinition::HOA) {
+        mergeBlocks<AudioBlockFormatHoa>(source, target, offset);
+      } else if (channelType == TypeDefinition::BINAURAL) {
+        mergeBlocks<AudioBlockFormatBinaural>(source, target, offset);
+      }
+    }
+
+    bool hasCommonDefinitions(const Document& document) {
+      for (const auto& packFormat : document.getElements<AudioPackFormat>()) {
+        if (isCommonDefinitionsId(packFormat->get<AudioPackFormatId>()))
+          return true;
+      }
+      return false;
+    }
+
+  }  // namespace
+
+  class FrameAssembler::Impl {
+   public:
+    Impl() : document_(Document::create()), applier_(document_) {}
+
+    void add(const std::shared_ptr<Document>& frame,
+             const FrameHeader& header) {
+      if (first_ && hasCommonDefinitions(*frame)) {
+        addCommonDefinitionsTo(document_);
+      }
+      first_ = false;
+
+      // add and update the elements, using the changes since the last frame
+      auto changedIds = differ_.update(frame);
+      ChangedIds kept;
+      keepChanges<AudioProgramme>(changedIds, kept);
+      keepChanges<AudioContent>(changedIds, kept);
+      keepChanges<AudioObject>(changedIds, kept);
+      keepChanges<AudioPackFormat>(changedIds, kept);
+      keepChanges<AudioStreamFormat>(changedIds, kept);
+      keepChanges<AudioTrackFormat>(changedIds, kept);
+      keepChanges<AudioTrackUid>(changedIds, kept);
+      addedChannelFormats_.clear();
+      keepNewChannelFormats(changedIds, *document_, kept,
+                            addedChannelFormats_);
+
+      // elements are never removed from the document, so references to
+      // them from the changed elements are kept
+      findReferencesToKeep(*document_, *frame, kept, contentReferences_);
+      findReferencesToKeep(*document_, *frame, kept, objectReferences_);
+      findReferencesToKeep(*document_, *frame, kept, nestedObjectReferences_);
+
+      auto frameFormat = header.get<FrameFormat>();
+      Offset offset{FixedTime{}, false};
+      if (frameFormat.get<TimeReference>() == TimeReference::LOCAL) {
+        auto start = frameFormat.get<Start>().get();
+        offset = Offset{start.asFixed(), start.isFractional()};
+      }
+      frameFormat.set(kept);
+      FrameHeader changes = header;
+      changes.set(frameFormat);
+      applier_.apply(frame, changes);
+      restoreReferences(contentReferences_);
+      restoreReferences(objectReferences_);
+      restoreReferences(nestedObjectReferences_);
+
+      for (const auto& id : addedChannelFormats_) {
+        document_->lookup(id)->clearAudioBlockFormats();
+      }
+
+      // then the blocks
+      for (const auto& channelFormat :
+           frame->getElements<AudioChannelFormat>()) {
+        auto id = channelFormat->get<AudioChannelFormatId>();
+        if (isCommonDefinitionsId(id)) continue;
+        mergeBlocks(*channelFormat, *document_->lookup(id), offset);
+      }
+    }
+
+    std::shared_ptr<Document> getDocument() const { return document_; }
+
+   private:
+    std::shared_ptr<Document> document_;
+    FrameApplier applier_;
+    ChangedIdsDiffer differ_;
+    bool first_ = true;
+    std::vector<AudioChannelFormatId> addedChannelFormats_;
+    References<AudioProgramme, AudioContent> contentReferences_;
+    References<AudioContent, AudioObject> objectReferences_;
+    References<AudioObject, AudioObject> nestedObjectReferences_;
+  };
+
+  FrameAssembler::FrameAssembler() : impl_(new Impl) {}
+
+  FrameAssembler::~FrameAssembler() = default;
+
+  void FrameAssembler::add(std::shared_ptr<Document> frame,
+                           const FrameHeader& header) {
+    impl_->add(frame, header);
+  }
+
+  std::shared_ptr<Document> FrameAssembler::getDocument() const {
+    return impl_->getDocument();
+  }
+
+}  // namespace adm
@@ -0,0 +1,234 @@
+#include "adm/serial/frame_generator.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+#include "adm/utilities/id_assignment.hpp"
+#include "adm/utilities/time_conversion.hpp"
+
+namespace adm {
+
+  namespace {
+
+    /// convert time back to a Time, as nanoseconds unless the input times
+    /// were fractional or time can't be represented in nanoseconds
+    Time toTime(const FixedTime& time, bool fractional) {
+      return fractional ? Time{time.asFractional().normalised()}
+                        : asNanosecondsOrFractional(time);
+    }
+
+    struct FrameTimes {
+      FixedTime start;
+      FixedTime end;
+      bool fractional;
+    };
+
+    /// a block with neither rtime nor duration lasts for the whole programme,
+    /// if it is not among timed blocks
+    template <typename Block>
+    bool isTimed(const Block& block) {
+      return !block.template isDefault<Rtime>() ||
+             block.template has<Duration>();
+    }
+
+    template <typename Block>
+    FixedTime startOf(const Block& block) {
+      return block.template get<Rtime>().get().asFixed();
+    }
+
+    /// the end of blocks[i], if it has one: either from its duration, or
+    /// the start of the next block
+    template <typename Blocks>
+    bool endOf(const Blocks& blocks, std::size_t i, FixedTime& end) {
+      const auto& block = blocks[i];
+      if (block.template has<Duration>()) {
+        end = startOf(block) + block.template get<Duration>().get().asFixed();
+        return true;
+      }
+      if (i + 1 < static_cast<std::size_t>(blocks.size())) {
+        end = startOf(blocks[i + 1]);
+        return true;
+      }
+      return false;
+    }
+
+    /// copy the blocks of source starting at cursor which overlap frame to
+    /// target, and return the new cursor: the first block which could
+    /// overlap the following frame
+    ///
+    /// Blocks without times among timed blocks start at zero and end at the
+    /// start of the next block, like any other block without a duration.
+    template <typename Block>
+    std::size_t copyBlocks(const AudioChannelFormat& source,
+                           std::size_t cursor, AudioChannelFormat& target,
+                           const FrameTimes& frame) {
+      auto blocks = source.getElements<Block>();
+      auto size = static_cast<std::size_t>(blocks.size());
+      std::size_t next = cursor;
+      for (auto i = cursor; i < size; ++i) {
+        const auto& block = blocks[i];
+        auto start = startOf(block);
+        if (start >= frame.end) break;
+
+        FixedTime end;
+        bool bounded = endOf(blocks, i, end);
+        // blocks which end before the next frame are not needed again
+        if (next == i && bounded && end <= frame.end) ++next;
+        if (bounded && end <= frame.start && start < frame.start) continue;
+
+        auto localStart = std::max(start, frame.start);
+        auto localEnd = bounded ? std::min(end, frame.end) : frame.end;
+        bool fractional = frame.fractional ||
+                          block.template get<Rtime>().get().isFractional();
+        Block localBlock = block;
+        localBlock.set(Rtime{toTime(localStart - frame.start, fractional)});
+        localBlock.set(Duration{toTime(localEnd - localStart, fractional)});
+        target.add(std::move(localBlock));
+      }
+      return next;
+    }
+
+    /// the latest end (or start, for blocks without an end) of the timed
+    /// blocks in channelFormat
+    template <typename Block>
+    void updateEnd(const AudioChannelFormat& channelFormat, FixedTime& end) {
+      auto blocks = channelFormat.getElements<Block>();
+      for (auto i = blocks.size(); i-- > 0;) {
+        if (!isTimed(blocks[i])) continue;
+        FixedTime blockEnd = startOf(blocks[i]);
+        endOf(blocks, static_cast<std::size_t>(i), blockEnd);
+        end = std::max(end, blockEnd);
+        return;
+      }
+    }
+
+    using CopyBlocks = std::size_t (*)(const AudioChannelFormat&, std::size_t,
+                                       AudioChannelFormat&, const FrameTimes&);
+
+    struct ChannelCursor {
+      std::shared_ptr<const AudioChannelFormat> source;
+      std::size_t next;
+      CopyBlocks copyBlocks;
+    };
+
+    /// add a cursor for the blocks of channelFormat, unless none of them are
+    /// timed; these are in every frame, so are copied to target, the copy
+    /// which each frame is made from
+    template <typename Block>
+    void addCursor(std::vector<ChannelCursor>& cursors,
+                   std::shared_ptr<const AudioChannelFormat> channelFormat,
+                   AudioChannelFormat& target, FixedTime& end) {
+      updateEnd<Block>(*channelFormat, end);
+      auto blocks = channelFormat->getElements<Block>();
+      if (std::none_of(blocks.begin(), blocks.end(),
+                       [](const Block& block) { return isTimed(block); })) {
+        for (const auto& block : blocks) target.add(block);
+        return;
+      }
+      cursors.push_back({std::move(channelFormat), 0, &copyBlocks<Block>});
+    }
+
+  }  // namespace
+
+  class FrameGenerator::Impl {
+   public:
+    Impl(std::shared_ptr<const Document> document, const Time& frameDuration)
+        : document_(std::move(document)),
+          structure_(document_->deepCopy()),
+          frameDuration_(frameDuration.asFixed()),
+          fractional_(frameDuration.isFractional()) {
+      if (frameDuration_ <= FixedTime{}) {
+        throw std::invalid_argument("frame duration must be positive");
+      }
+
+      for (const auto& programme : document_->getElements<AudioProgramme>()) {
+        if (programme->has<End>()) {
+          end_ = std::max(end_, programme->get<End>().get().asFixed());
+        }
+      }
+
+      // only the blocks of channels without timed blocks are kept in the
+      // copy; the blocks that overlap each frame are added to the copy made
+      // for it
+      for (const auto& channelFormat :
+           document_->getElements<AudioChannelFormat>()) {
+        auto id = channelFormat->get<AudioChannelFormatId>();
+        if (isCommonDefinitionsId(id)) continue;
+        auto& target = *structure_->lookup(id);
+        target.clearAudioBlockFormats();
+
+        auto channelType = channelFormat->get<TypeDescriptor>();
+        if (channelType == TypeDefinition::DIRECT_SPEAKERS) {
+          addCursor<AudioBlockFormatDirectSpeakers>(cursors_, channelFormat,
+                                                    target, end_);
+        } else if (channelType == TypeDefinition::MATRIX) {
+          addCursor<AudioBlockFormatMatrix>(cursors_, channelFormat, target,
+                                            end_);
+        } else if (channelType == TypeDefinition::OBJECTS) {
+          addCursor<AudioBlockFormatObjects>(cursors_, channelFormat, target,
+                                             end_);
+        } else if (channelType == TypeDefinition::HOA) {
+          addCursor<AudioBlockFormatHoa>(cursors_, channelFormat, target,
+                                         end_);
+        } else if (channelType == TypeDefinition::BINAURAL) {
+          addCursor<AudioBlockFormatBinaural>(cursors_, channelFormat, target,
+                                              end_);
+        }
+      }
+    }
+
+    bool hasNext() const { return index_ == 0 || start_ < end_; }
+
+    GeneratedFrame next() {
+      if (!hasNext()) {
+        throw std::runtime_error("no more frames to generate");
+      }
+      FrameTimes frame{start_, start_ + frameDuration_, fractional_};
+
+      auto document = structure_->deepCopy();
+      for (auto& cursor : cursors_) {
+        auto target =
+            document->lookup(cursor.source->get<AudioChannelFormatId>());
+        cursor.next =
+            cursor.copyBlocks(*cursor.source, cursor.next, *target, frame);
+      }
+
+      ++index_;
+      FrameHeader header{
+          FrameFormat{FrameFormatId{FrameIndex{index_}},
+                      Start{toTime(frame.start, fractional_)},
+                      Duration{toTime(frameDuration_, fractional_)},
+                      FrameType::FULL, TimeReference::LOCAL}};
+      start_ = frame.end;
+      return GeneratedFrame{std::move(header), std::move(document)};
+    }
+
+   private:
+    std::shared_ptr<const Document> document_;
+    /// a copy of document_ without the blocks of its audioChannelFormats
+    std::shared_ptr<Document> structure_;
+    FixedTime frameDuration_;
+    bool fractional_;
+    std::vector<ChannelCursor> cursors_;
+
+    unsigned index_ = 0;
+    FixedTime start_;
+    FixedTime end_;
+  };
+
+  FrameGenerator::FrameGenerator(std::shared_ptr<const Document> document,
+                                 const Time& frameDuration)
+      : impl_(new Impl(std::move(document), frameDuration)) {}
+
+  FrameGenerator::~FrameGenerator() = default;
+
+  bool FrameGenerator::hasNext() const { return impl_->hasNext(); }
+
+  GeneratedFrame FrameGenerator::next() { return impl_->next(); }
+
+  std::ostream& FrameGenerator::writeNext(std::ostream& stream,
+                                          xml::SadmWriterOptions options) {
+    auto frame = next();
+    return writeXml(stream, frame.document, frame.header, options);
+  }
+
+}  // namespace adm
@@ -136,10 +136,10 @@ namespace adm {
       FrameFormat createFrameFormat(NodePtr frameFormatNode) {
         FrameFormatId id = parseAttribute<FrameFormatId>(
             frameFormatNode, "frameFormatID", &parseFrameFormatId);
-        Start start =
-            parseAttribute<Start>(frameFormatNode, "start", &parseTimecode);
+        Start start = parseAttribute<Start>(frameFormatNode, "start",
+                                            &detail::parseTimecode);
         Duration duration = parseAttribute<Duration>(
-            frameFormatNode, "duration", &parseTimecode);
+            frameFormatNode, "duration", &detail::parseTimecode);
         FrameType type =
             parseAttribute<FrameType>(frameFormatNode, "type", &parseFrameType);
         return {id, start, duration, type};
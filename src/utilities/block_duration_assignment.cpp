@@ -6,32 +6,28 @@
 #include <memory>
 #include <map>
 #include <stdexcept>
-#include <adm/utilities/time_conversion.hpp>
 
 namespace adm {
 
   Time subtractTimes(const Time& firstTime, const Time& secondTime) {
+    FixedTime difference = firstTime.asFixed() - secondTime.asFixed();
+
     // both nanoseconds -> return nanoseconds
     if (firstTime.isNanoseconds() && secondTime.isNanoseconds())
-      return firstTime.asNanoseconds() - secondTime.asNanoseconds();
+      return difference.asTime();
 
     // both fractional with same denominator -> keep denominator
-    if (firstTime.isFractional() && secondTime.isFractional()) {
-      FractionalTime firstFrac = firstTime.asFractional();
-      FractionalTime secondFrac = secondTime.asFractional();
-
-      if (firstFrac.denominator() == secondFrac.denominator())
-        return FractionalTime{firstFrac.numerator() - secondFrac.numerator(),
-                              firstFrac.denominator()};
-    }
+    if (firstTime.isFractional() && secondTime.isFractional() &&
+        firstTime.asFixed().denominator() ==
+            secondTime.asFixed().denominator())
+      return difference.asFractional();
 
     // mixed, or different denominators
-    return asTime(asRational(firstTime) - asRational(secondTime));
+    return difference.asFractional().normalised();
   }
 
   bool timesEqual(const Time& firstTime, const Time& secondTime) {
-    return firstTime.asFractional().normalised() ==
-           secondTime.asFractional().normalised();
+    return firstTime.asFixed() == secondTime.asFixed();
   }
 
   Time durationOfProgramme(const AudioProgramme* programme,
@@ -13,8 +13,9 @@ namespace adm {
    * be ignored.
    * 
    * @note This class differs from IdAssigner in that it is more
-   * efficient for this purpose. IdAssigner uses lookups to find
-   * an available ID, which has exponential complexity. 
+   * efficient for this purpose. IdAssigner has to find an available
+   * ID among those already in the document, which has logarithmic
+   * complexity per ID.
    * IdReassigner uses the IdIssuer class to track ID's through
    * simple incrementation and so has linear complexity.
    * 
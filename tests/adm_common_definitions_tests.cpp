@@ -1,5 +1,9 @@
 #include <catch2/catch.hpp>
+#include <fstream>
+#include <sstream>
 #include "adm/common_definitions.hpp"
+#include "adm/document.hpp"
+#include "adm/private/document_parser.hpp"
 
 TEST_CASE("basic_document") {
   using namespace adm;
@@ -52,3 +56,115 @@ TEST_CASE("HOA Track Lookup") {
     auto label_FuMa = formatId(audioTrackFormatId_FuMa);
     REQUIRE(label_FuMa == "AT_0004020c_01");
 }
+
+namespace {
+  using namespace adm;
+
+  template <typename Element>
+  std::string describeRefs(ElementRange<const Element> elements) {
+    std::stringstream ss;
+    for (const auto& element : elements)
+      ss << " " << formatId(element->template get<typename Element::id_type>());
+    return ss.str();
+  }
+
+  std::string describe(const AudioBlockFormatDirectSpeakers& block) {
+    std::stringstream ss;
+    ss << formatId(block.get<AudioBlockFormatId>());
+    for (const auto& label : block.get<SpeakerLabels>()) ss << " " << label;
+    auto position = block.get<SphericalSpeakerPosition>();
+    ss << " " << position.get<Azimuth>() << " " << position.get<Elevation>()
+       << " " << position.get<Distance>();
+    auto screenEdgeLock = position.get<ScreenEdgeLock>();
+    if (screenEdgeLock.has<HorizontalEdge>())
+      ss << " " << screenEdgeLock.get<HorizontalEdge>();
+    return ss.str();
+  }
+
+  std::string describe(const AudioBlockFormatHoa& block) {
+    std::stringstream ss;
+    ss << formatId(block.get<AudioBlockFormatId>()) << " "
+       << block.get<Order>() << " " << block.get<Degree>() << " "
+       << block.get<Normalization>();
+    return ss.str();
+  }
+
+  std::string describe(const AudioBlockFormatBinaural& block) {
+    return formatId(block.get<AudioBlockFormatId>());
+  }
+
+  /// describe the parts of a document that are used by the common
+  /// definitions, one line per element
+  std::vector<std::string> describe(std::shared_ptr<const Document> document) {
+    std::vector<std::string> lines;
+    for (const auto& packFormat : document->getElements<AudioPackFormat>()) {
+      std::stringstream ss;
+      ss << formatId(packFormat->get<AudioPackFormatId>()) << " "
+         << packFormat->get<AudioPackFormatName>() << " "
+         << packFormat->get<TypeDescriptor>() << " "
+         << static_cast<bool>(
+                std::dynamic_pointer_cast<const AudioPackFormatHoa>(
+                    packFormat))
+         << describeRefs<AudioChannelFormat>(
+                packFormat->getReferences<AudioChannelFormat>())
+         << describeRefs<AudioPackFormat>(
+                packFormat->getReferences<AudioPackFormat>());
+      lines.push_back(ss.str());
+    }
+    for (const auto& channelFormat :
+         document->getElements<AudioChannelFormat>()) {
+      std::stringstream ss;
+      ss << formatId(channelFormat->get<AudioChannelFormatId>()) << " "
+         << channelFormat->get<AudioChannelFormatName>() << " "
+         << channelFormat->get<TypeDescriptor>();
+      if (channelFormat->has<Frequency>())
+        channelFormat->get<Frequency>().print(ss);
+      for (const auto& block :
+           channelFormat->getElements<AudioBlockFormatDirectSpeakers>())
+        ss << ", " << describe(block);
+      for (const auto& block :
+           channelFormat->getElements<AudioBlockFormatHoa>())
+        ss << ", " << describe(block);
+      for (const auto& block :
+           channelFormat->getElements<AudioBlockFormatBinaural>())
+        ss << ", " << describe(block);
+      lines.push_back(ss.str());
+    }
+    for (const auto& streamFormat :
+         document->getElements<AudioStreamFormat>()) {
+      std::stringstream ss;
+      ss << formatId(streamFormat->get<AudioStreamFormatId>()) << " "
+         << streamFormat->get<AudioStreamFormatName>() << " "
+         << streamFormat->get<FormatDescriptor>() << " "
+         << formatId(streamFormat->getReference<AudioChannelFormat>()
+                         ->get<AudioChannelFormatId>());
+      for (const auto& trackFormat :
+           streamFormat->getAudioTrackFormatReferences())
+        ss << " " << formatId(trackFormat.lock()->get<AudioTrackFormatId>());
+      lines.push_back(ss.str());
+    }
+    for (const auto& trackFormat : document->getElements<AudioTrackFormat>()) {
+      std::stringstream ss;
+      ss << formatId(trackFormat->get<AudioTrackFormatId>()) << " "
+         << trackFormat->get<AudioTrackFormatName>() << " "
+         << trackFormat->get<FormatDescriptor>() << " "
+         << formatId(trackFormat->getReference<AudioStreamFormat>()
+                         ->get<AudioStreamFormatId>());
+      lines.push_back(ss.str());
+    }
+    return lines;
+  }
+}  // namespace
+
+TEST_CASE("common definitions match the XML file") {
+  std::ifstream xmlFile(ADM_COMMON_DEFINITIONS_XML);
+  REQUIRE(xmlFile.good());
+  xml::DocumentParser parser(xmlFile,
+                             xml::ParserOptions::recursive_node_search);
+  auto parsed = describe(parser.parse());
+  auto generated = describe(getCommonDefinitions());
+
+  REQUIRE(generated.size() == parsed.size());
+  for (std::size_t i = 0; i < parsed.size(); ++i)
+    CHECK(generated[i] == parsed[i]);
+}
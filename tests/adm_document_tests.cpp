@@ -1,7 +1,9 @@
 #include <catch2/catch.hpp>
 #include "adm/document.hpp"
+#include "adm/detail/referrer_index.hpp"
 #include "adm/elements.hpp"
 #include "adm/utilities/id_assignment.hpp"
+#include "adm/common_definitions.hpp"
 #include "adm/utilities/copy.hpp"
 #include "adm/utilities/object_creation.hpp"
 #include "adm/parse.hpp"
@@ -642,3 +644,250 @@ TEST_CASE("Copy the kitchen sink") {
   writeXml(xmlCopy, documentCopy);
   REQUIRE(xml.str() == xmlCopy.str());
 }
+
+TEST_CASE("lookup_index") {
+  using namespace adm;
+  auto document = Document::create();
+  auto channelFormat = AudioChannelFormat::create(
+      AudioChannelFormatName("MyChannelFormat"), TypeDefinition::OBJECTS);
+  document->add(channelFormat);
+  auto id = channelFormat->get<AudioChannelFormatId>();
+  REQUIRE(document->lookup(id) == channelFormat);
+
+  SECTION("change ID") {
+    auto newId = AudioChannelFormatId(TypeDefinition::OBJECTS,
+                                      AudioChannelFormatIdValue(0x1234));
+    channelFormat->set(newId);
+    REQUIRE(document->lookup(id) == nullptr);
+    REQUIRE(document->lookup(newId) == channelFormat);
+
+    channelFormat->set(AudioChannelFormatId());
+    REQUIRE(document->lookup(newId) == nullptr);
+  }
+
+  SECTION("remove") {
+    REQUIRE(document->remove(channelFormat));
+    REQUIRE(document->lookup(id) == nullptr);
+
+    // changes after removal don't affect the document
+    channelFormat->set(AudioChannelFormatId(TypeDefinition::OBJECTS,
+                                            AudioChannelFormatIdValue(0x1234)));
+    REQUIRE(document->lookup(channelFormat->get<AudioChannelFormatId>()) ==
+            nullptr);
+  }
+
+  SECTION("copy") {
+    auto copy = document->deepCopy();
+    auto copied = copy->lookup(id);
+    REQUIRE(copied != nullptr);
+    REQUIRE(copied != channelFormat);
+    REQUIRE(copied->get<AudioChannelFormatName>() ==
+            channelFormat->get<AudioChannelFormatName>());
+  }
+}
+
+TEST_CASE("lookup_duplicate_common_definitions_id") {
+  using namespace adm;
+  auto document = getCommonDefinitions();
+  auto id = AudioChannelFormatId(TypeDefinition::DIRECT_SPEAKERS,
+                                 AudioChannelFormatIdValue(0x0001));
+  auto original = document->lookup(id);
+  REQUIRE(original != nullptr);
+
+  // common definitions IDs are not reassigned, so this is a duplicate
+  auto duplicate = AudioChannelFormat::create(
+      AudioChannelFormatName("duplicate"), TypeDefinition::DIRECT_SPEAKERS);
+  duplicate->set(id);
+  document->add(duplicate);
+  REQUIRE(document->lookup(id) == original);
+
+  // the first remaining element with that ID is found after removal
+  REQUIRE(document->remove(original));
+  REQUIRE(document->lookup(id) == duplicate);
+  REQUIRE(document->remove(duplicate));
+  REQUIRE(document->lookup(id) == nullptr);
+}
+
+TEST_CASE("id_assignment_tracks_document_changes") {
+  using namespace adm;
+  auto document = Document::create();
+  auto addObject = [&document]() {
+    auto object = AudioObject::create(AudioObjectName("object"));
+    document->add(object);
+    return object;
+  };
+  auto objectValue = [](const std::shared_ptr<AudioObject>& object) {
+    return object->get<AudioObjectId>().get<AudioObjectIdValue>().get();
+  };
+
+  auto object1 = addObject();
+  auto object2 = addObject();
+  auto object3 = addObject();
+  REQUIRE(objectValue(object1) == 0x1001u);
+  REQUIRE(objectValue(object2) == 0x1002u);
+  REQUIRE(objectValue(object3) == 0x1003u);
+
+  // removed IDs are reused
+  REQUIRE(document->remove(object2));
+  REQUIRE(objectValue(addObject()) == 0x1002u);
+
+  // IDs changed in the document are freed and taken
+  object3->set(AudioObjectId(AudioObjectIdValue(0x1005u)));
+  REQUIRE(objectValue(addObject()) == 0x1003u);
+  REQUIRE(objectValue(addObject()) == 0x1004u);
+  REQUIRE(objectValue(addObject()) == 0x1006u);
+
+  // preferred IDs are kept if they are free
+  auto object = AudioObject::create(AudioObjectName("object"));
+  object->set(AudioObjectId(AudioObjectIdValue(0x2000u)));
+  document->add(object);
+  REQUIRE(objectValue(object) == 0x2000u);
+}
+
+TEST_CASE("remove_all") {
+  using namespace adm;
+  auto document = Document::create();
+  auto content = AudioContent::create(AudioContentName("content"));
+  document->add(content);
+  std::vector<SimpleObjectHolder> holders;
+  for (int i = 0; i < 4; i++) {
+    holders.push_back(addSimpleObjectTo(document, std::to_string(i)));
+    // reference made after the object was added to the document
+    content->addReference(holders.back().audioObject);
+  }
+
+  SECTION("some") {
+    std::vector<std::shared_ptr<AudioObject>> toRemove{
+        holders[1].audioObject, holders[3].audioObject};
+    REQUIRE(document->removeAll(toRemove) == 2);
+    REQUIRE(document->getElements<AudioObject>().size() == 2);
+    REQUIRE(document->getElements<AudioObject>()[0] == holders[0].audioObject);
+    REQUIRE(document->getElements<AudioObject>()[1] == holders[2].audioObject);
+    REQUIRE(content->getReferences<AudioObject>().size() == 2);
+    REQUIRE(holders[1].audioObject->getParent().lock() == nullptr);
+    REQUIRE(document->lookup(holders[1].audioObject->get<AudioObjectId>()) ==
+            nullptr);
+
+    // already removed
+    REQUIRE(document->removeAll(toRemove) == 0);
+  }
+
+  SECTION("all from the document") {
+    REQUIRE(document->removeAll(document->getElements<AudioPackFormat>()) ==
+            4);
+    REQUIRE(document->getElements<AudioPackFormat>().size() == 0);
+    for (auto& holder : holders) {
+      REQUIRE(holder.audioObject->getReferences<AudioPackFormat>().size() ==
+              0);
+      REQUIRE(holder.audioTrackUid->getReference<AudioPackFormat>() ==
+              nullptr);
+    }
+  }
+
+  SECTION("references from removed elements are kept") {
+    REQUIRE(document->remove(content));
+    REQUIRE(document->remove(holders[0].audioObject));
+    REQUIRE(content->getReferences<AudioObject>().size() == 4);
+  }
+}
+
+TEST_CASE("referrer_index_size") {
+  using namespace adm;
+  detail::ReferrerIndex index;
+  auto content = AudioContent::create(AudioContentName("content"));
+  std::vector<std::shared_ptr<AudioObject>> objects;
+  for (int i = 0; i < 4; i++) {
+    objects.push_back(AudioObject::create(AudioObjectName("object")));
+  }
+
+  SECTION("repeated add/remove cycles") {
+    for (int cycle = 0; cycle < 100; cycle++) {
+      for (auto& object : objects) {
+        index.add(content, object.get());
+        index.add(content, object.get());
+      }
+      REQUIRE(index.size() == objects.size());
+      for (auto& object : objects) index.remove(content.get(), object.get());
+      REQUIRE(index.size() == 0);
+    }
+  }
+
+  SECTION("expired referrers are compacted") {
+    for (int i = 0; i < 100; i++) {
+      auto referrer = AudioContent::create(AudioContentName("content"));
+      index.add(referrer, objects[0].get());
+    }
+    REQUIRE(index.size() < 16);
+  }
+
+  SECTION("take") {
+    for (auto& object : objects) index.add(content, object.get());
+    REQUIRE(index.take(objects[0].get()).size() == 1);
+    REQUIRE(index.take(objects[0].get()).size() == 0);
+    REQUIRE(index.size() == objects.size() - 1);
+  }
+}
+
+TEST_CASE("remove_after_clear_add_cycles") {
+  using namespace adm;
+  auto document = Document::create();
+  auto content = AudioContent::create(AudioContentName("content"));
+  document->add(content);
+  std::vector<SimpleObjectHolder> holders;
+  for (int i = 0; i < 4; i++) {
+    holders.push_back(addSimpleObjectTo(document, std::to_string(i)));
+  }
+
+  for (int cycle = 0; cycle < 100; cycle++) {
+    content->clearReferences<AudioObject>();
+    for (auto& holder : holders) content->addReference(holder.audioObject);
+  }
+  content->removeReference(holders[0].audioObject);
+
+  REQUIRE(document->remove(holders[1].audioObject));
+  REQUIRE(content->getReferences<AudioObject>().size() == 2);
+  // no longer referenced, so nothing to drop
+  REQUIRE(document->remove(holders[0].audioObject));
+  REQUIRE(content->getReferences<AudioObject>().size() == 2);
+  REQUIRE(holders[0].audioObject->getReferences<AudioPackFormat>().size() ==
+          1);
+}
+
+TEST_CASE("add_all") {
+  using namespace adm;
+  auto makeObjects = []() {
+    std::vector<std::shared_ptr<AudioObject>> objects;
+    for (int i = 0; i < 3; i++) {
+      objects.push_back(createSimpleObject(std::to_string(i)).audioObject);
+    }
+    objects.push_back(objects[1]);
+    return objects;
+  };
+
+  SECTION("same as add") {
+    auto batchDocument = Document::create();
+    batchDocument->addAll(makeObjects());
+    REQUIRE(batchDocument->getElements<AudioObject>().size() == 3);
+    REQUIRE(batchDocument->getElements<AudioTrackUid>().size() == 3);
+
+    auto document = Document::create();
+    for (auto& object : makeObjects()) document->add(object);
+
+    std::stringstream batchXml, xml;
+    writeXml(batchXml, batchDocument);
+    writeXml(xml, document);
+    REQUIRE(batchXml.str() == xml.str());
+  }
+
+  SECTION("nothing is added on error") {
+    auto otherDocument = Document::create();
+    auto objects = makeObjects();
+    otherDocument->add(objects[2]);
+
+    auto document = Document::create();
+    REQUIRE_THROWS_AS(document->addAll(objects), std::runtime_error);
+    REQUIRE(document->getElements<AudioObject>().size() == 0);
+    REQUIRE(document->getElements<AudioPackFormat>().size() == 0);
+    REQUIRE(objects[0]->getParent().lock() == nullptr);
+  }
+}
@@ -3,6 +3,14 @@
 #include "adm/elements/time.hpp"
 #include "adm/utilities/time_conversion.hpp"
 #include "helper/ostream_operators.hpp"
+#include <cstdio>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <vector>
 
 using namespace adm;
 
@@ -114,3 +122,276 @@ TEST_CASE("rational conversion") {
 
   REQUIRE(asTime(RationalTime{1, 2}) == FractionalTime{1, 2});
 }
+
+TEST_CASE("fixed time") {
+  using namespace std::chrono_literals;
+
+  SECTION("comparison") {
+    REQUIRE(FixedTime{1, 2} == FixedTime{2, 4});
+    REQUIRE(FixedTime{1, 2} == FixedTime{500ms});
+    REQUIRE(FixedTime{1, 3} != FixedTime{333333333ns});
+    REQUIRE(FixedTime{333333333ns} < FixedTime{1, 3});
+    REQUIRE(FixedTime{1, 3} < FixedTime{333333334ns});
+    REQUIRE(FixedTime{-1, 3} < FixedTime{0, 1});
+    REQUIRE(FixedTime{2, 4} <= FixedTime{1, 2});
+    REQUIRE(FixedTime{3, 4} > FixedTime{2, 3});
+    REQUIRE(FixedTime{} == FixedTime{0, 25});
+  }
+
+  SECTION("arithmetic") {
+    // the denominator is kept if it is the same
+    auto sum = FixedTime{3, 25} + FixedTime{4, 25};
+    REQUIRE(sum.numerator() == 7);
+    REQUIRE(sum.denominator() == 25);
+    auto difference = FixedTime{3, 4} - FixedTime{5, 6};
+    REQUIRE(difference.numerator() == -1);
+    REQUIRE(difference.denominator() == 12);
+    REQUIRE(FixedTime{1, 3} + FixedTime{1s} == FixedTime{4, 3});
+    REQUIRE(FixedTime{1, 48000} - FixedTime{1, 96000} == FixedTime{1, 96000});
+
+    // the common denominator doesn't fit in 64 bits
+    int64_t a = 1000000007, b = 1000000009, c = 1000000021;
+    auto large = FixedTime{a, a * b} + FixedTime{c, b * c};
+    REQUIRE(large.numerator() == 2);
+    REQUIRE(large.denominator() == b);
+  }
+
+  SECTION("conversion") {
+    REQUIRE(Time{FractionalTime{1, 2}}.asFixed() == FixedTime{1, 2});
+    REQUIRE(Time{1500ms}.asFixed().isNanoseconds());
+    REQUIRE(FixedTime{1, 2}.asTime() == Time{FractionalTime{1, 2}});
+    REQUIRE(FixedTime{1500ms}.asTime() == Time{1500ms});
+    REQUIRE(FixedTime{1, 2}.asFractional() == FractionalTime{1, 2});
+
+    // the same results as converting the normalised fraction
+    for (int64_t numerator : {-7, -1, 0, 1, 6, 7, 1000001}) {
+      for (int64_t denominator : {1, 3, 4, 7, 48000, 1000000000}) {
+        FractionalTime fraction{numerator, denominator};
+        auto normalised = fraction.normalised();
+        auto expected = std::chrono::nanoseconds{
+            (1000000000 * normalised.numerator()) / normalised.denominator()};
+        REQUIRE(FixedTime{fraction}.asNanoseconds() == expected);
+        REQUIRE(Time{fraction}.asNanoseconds() == expected);
+      }
+    }
+
+    REQUIRE(asNanosecondsOrFractional(FixedTime{2, 4}) == Time{500ms});
+    REQUIRE(asNanosecondsOrFractional(FixedTime{2, 6}) ==
+            Time{FractionalTime{1, 3}});
+  }
+
+  REQUIRE_THROWS_WITH(FixedTime(0, 0),
+                      Catch::Contains("denominator must be positive"));
+}
+
+namespace reference {
+  // the regular-expression and stream based implementations which
+  // parseTimecode and formatTimecode replaced
+
+  Time parseTimecode(const std::string& timecode) {
+    const static std::regex commonFormat("(\\d{2}):(\\d{2}):(\\d{2}).(\\d+)");
+    const static std::regex fractionalFormat(
+        "(\\d{2}):(\\d{2}):(\\d{2}).(\\d+)S(\\d+)");
+
+    std::smatch timecodeMatch;
+    if (std::regex_match(timecode, timecodeMatch, commonFormat)) {
+      const std::string& ns_str = timecodeMatch[4];
+
+      int64_t ns = 0;
+      int64_t place_value = 1;
+      for (size_t i = 8; i != (size_t)-1; i--) {
+        if (i < ns_str.size()) ns += place_value * (ns_str[i] - '0');
+        place_value *= 10;
+      }
+
+      return std::chrono::hours(stoi(timecodeMatch[1])) +
+             std::chrono::minutes(stoi(timecodeMatch[2])) +
+             std::chrono::seconds(stoi(timecodeMatch[3])) +
+             std::chrono::nanoseconds(ns);
+    } else if (std::regex_match(timecode, timecodeMatch, fractionalFormat)) {
+      int64_t seconds = 3600 * stoi(timecodeMatch[1]) +
+                        60 * stoi(timecodeMatch[2]) +
+                        1 * stoi(timecodeMatch[3]);
+
+      int64_t numerator = stoi(timecodeMatch[4]);
+      int64_t denominator = stoi(timecodeMatch[5]);
+
+      if (denominator == 0) {
+        std::stringstream errorString;
+        errorString << "invalid timecode: " << timecode
+                    << " has a zero denominator";
+        throw std::runtime_error(errorString.str());
+      }
+
+      return FractionalTime{seconds * denominator + numerator, denominator};
+    } else {
+      std::stringstream errorString;
+      errorString << "invalid timecode: " << timecode;
+      throw std::runtime_error(errorString.str());
+    }
+  }
+
+  struct FormatTimeVisitor : public boost::static_visitor<std::string> {
+    std::string operator()(const std::chrono::nanoseconds& time) const {
+      std::stringstream ss;
+      ss << std::setw(2) << std::setfill('0')
+         << std::chrono::duration_cast<std::chrono::hours>(time).count();
+      ss << ":";
+      ss << std::setw(2) << std::setfill('0')
+         << std::chrono::duration_cast<std::chrono::minutes>(time).count() % 60;
+      ss << ":";
+      ss << std::setw(2) << std::setfill('0')
+         << std::chrono::duration_cast<std::chrono::seconds>(time).count() % 60;
+      ss << ".";
+
+      {
+        auto ns = time.count() % 1000000000;
+        int precision = 9;
+        while (ns % 10 == 0 && precision > 5) {
+          ns /= 10;
+          precision--;
+        }
+        ss << std::setw(precision) << std::setfill('0') << ns;
+      }
+
+      return ss.str();
+    }
+
+    std::string operator()(const FractionalTime& time) const {
+      int64_t whole_seconds = time.numerator() / time.denominator();
+      int64_t frac_numerator =
+          time.numerator() - whole_seconds * time.denominator();
+
+      std::stringstream ss;
+      ss << std::setw(2) << std::setfill('0') << whole_seconds / 3600;
+      ss << ":";
+      ss << std::setw(2) << std::setfill('0') << (whole_seconds / 60) % 60;
+      ss << ":";
+      ss << std::setw(2) << std::setfill('0') << whole_seconds % 60;
+      ss << ".";
+      ss << frac_numerator << "S" << time.denominator();
+      return ss.str();
+    }
+  };
+
+  std::string formatTimecode(const Time& time) {
+    return boost::apply_visitor(FormatTimeVisitor(), time.asVariant());
+  }
+}  // namespace reference
+
+namespace {
+  /// the result of parsing s with parse, or the exception message
+  template <typename Parse>
+  std::string parseResult(Parse parse, const std::string& s) {
+    try {
+      std::stringstream result;
+      Time time = parse(s);
+      if (time.isFractional()) {
+        result << time.asFractional().numerator() << "/"
+               << time.asFractional().denominator();
+      } else {
+        result << time.asNanoseconds().count() << "ns";
+      }
+      return result.str();
+    } catch (std::exception& e) {
+      return std::string("error: ") + e.what();
+    }
+  }
+}  // namespace
+
+TEST_CASE("timecode_differential") {
+  std::mt19937 rng(42);
+  auto randomInt = [&rng](int64_t min, int64_t max) {
+    return std::uniform_int_distribution<int64_t>(min, max)(rng);
+  };
+
+  SECTION("parse") {
+    std::vector<std::string> timecodes = {
+        "00:00:00.0",         "00:00:00.00000",     "99:59:59.999999999",
+        "00:00:0012345",      "00:00:00S5",         "00:00:00S5S10",
+        "00:00:00.5S",        "00:00:00.S5",        "00:00:00.",
+        "00:00:00\n5",        "00:00:00\r5",        "0:00:00.0",
+        "00:00:00.0 ",        " 00:00:00.0",        "00-00:00.0",
+        "00:00:00.1S0",       "00:00:00.1S00",      "00:00:00.0S1",
+        "00:00:00.2147483647S2147483647",
+        "00:00:00.2147483648S1",
+        "00:00:00.1S2147483648",
+        "00:00:00.99999999999999999999S1",
+        "12:34:56.1234567891234",
+        "",
+        "foo"};
+    const std::string alphabet = "0123456789:.S\n -";
+    for (int i = 0; i < 20000; i++) {
+      std::string s;
+      if (randomInt(0, 1)) {
+        // mutate a valid timecode
+        s = randomInt(0, 1) ? "01:23:45.678901234" : "01:23:45.678S1000";
+        auto mutations = randomInt(1, 3);
+        for (int m = 0; m < mutations; m++) {
+          auto pos = static_cast<size_t>(randomInt(0, s.size() - 1));
+          auto c = alphabet[static_cast<size_t>(
+              randomInt(0, alphabet.size() - 1))];
+          switch (randomInt(0, 2)) {
+            case 0: s[pos] = c; break;
+            case 1: s.insert(pos, 1, c); break;
+            default: s.erase(pos, 1); break;
+          }
+        }
+      } else {
+        // random digits in the right shape
+        char buf[64];
+        std::snprintf(buf, sizeof(buf), "%02d:%02d:%02d.%lld",
+                      static_cast<int>(randomInt(0, 99)),
+                      static_cast<int>(randomInt(0, 99)),
+                      static_cast<int>(randomInt(0, 99)),
+                      static_cast<long long>(randomInt(0, 1LL << 40)));
+        s = buf;
+        if (randomInt(0, 1)) {
+          s += "S" + std::to_string(randomInt(0, 100000));
+        }
+      }
+      timecodes.push_back(s);
+    }
+
+    for (auto& s : timecodes) {
+      INFO(s);
+      auto parse = [](const std::string& t) { return parseTimecode(t); };
+      REQUIRE(parseResult(parse, s) ==
+              parseResult(reference::parseTimecode, s));
+    }
+  }
+
+  SECTION("format") {
+    std::vector<Time> times = {
+        std::chrono::nanoseconds(0),
+        std::chrono::nanoseconds(-1),
+        std::chrono::nanoseconds(-1500000000),
+        std::chrono::nanoseconds(std::numeric_limits<int64_t>::max()),
+        std::chrono::nanoseconds(std::numeric_limits<int64_t>::min()),
+        FractionalTime{0, 1},
+        FractionalTime{-7, 3},
+        FractionalTime{std::numeric_limits<int64_t>::max(), 1},
+        FractionalTime{std::numeric_limits<int64_t>::min(), 1},
+        FractionalTime{std::numeric_limits<int64_t>::min(),
+                       std::numeric_limits<int64_t>::max()},
+    };
+    for (int i = 0; i < 20000; i++) {
+      times.push_back(
+          std::chrono::nanoseconds(randomInt(-(1LL << 50), 1LL << 50)));
+      times.push_back(FractionalTime{randomInt(-(1LL << 40), 1LL << 40),
+                                     randomInt(1, 1000000)});
+    }
+
+    for (auto& time : times) {
+      auto expected = reference::formatTimecode(time);
+      INFO(expected);
+      REQUIRE(formatTimecode(time) == expected);
+
+      char buffer[timecodeBufferSize];
+      auto length = formatTimecode(time, buffer);
+      REQUIRE(length == expected.size());
+      REQUIRE(buffer[length] == '\0');
+      REQUIRE(std::string(buffer) == expected);
+    }
+  }
+}
@@ -0,0 +1,102 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include "adm/document.hpp"
+#include "adm/elements/audio_block_format_objects_columns.hpp"
+#include "helper/document_fixtures.hpp"
+
+using namespace adm;
+using namespace adm_test;
+
+namespace {
+  using namespace std::chrono_literals;
+
+  /// a channel with blocks using the parameters which are in columns, and
+  /// some which are not
+  std::shared_ptr<AudioChannelFormat> makeExampleChannel() {
+    auto channel = makeChannel();
+    channel->add(AudioBlockFormatObjects(SphericalPosition{Azimuth{30.0f}},
+                                         Rtime{0s}, Duration{1s}));
+    channel->add(AudioBlockFormatObjects(
+        SphericalPosition{Azimuth{-30.0f}, Elevation{10.0f}, Distance{0.5f}},
+        Rtime{FractionalTime{1, 1}}, Duration{FractionalTime{3, 2}},
+        Width{10.0f}, Gain::fromDb(-6.0)));
+    AudioBlockFormatObjects cartesian(CartesianPosition{X{0.5f}, Y{-1.0f}},
+                                      Rtime{2500ms}, Height{5.0f},
+                                      Depth{0.1f}, Diffuse{0.5f});
+    channel->add(cartesian);
+    // parameters which are not stored in columns
+    AudioBlockFormatObjects jump(SphericalPosition{}, Rtime{3s},
+                                 Gain::fromLinear(0.5));
+    jump.set(JumpPosition{JumpPositionFlag{true}});
+    jump.set(Cartesian{false});
+    channel->add(jump);
+    return channel;
+  }
+}  // namespace
+
+TEST_CASE("audio_block_format_objects_columns/columns") {
+  auto channel = makeExampleChannel();
+  AudioBlockFormatObjectsColumns columns(
+      channel->getElements<AudioBlockFormatObjects>());
+  REQUIRE(columns.size() == 4);
+
+  REQUIRE(columns.rtimes()[1] == FixedTime{1, 1});
+  REQUIRE(columns.durations()[1] == FixedTime{3, 2});
+  REQUIRE_FALSE(columns.hasDuration()[2]);
+  REQUIRE(columns.cartesian()[2]);
+  REQUIRE(columns.azimuthOrX()[1] == -30.0f);
+  REQUIRE(columns.elevationOrY()[2] == -1.0f);
+  REQUIRE(columns.distanceOrZ()[0] == 1.0f);
+  REQUIRE(columns.distanceOrZ()[1] == 0.5f);
+  REQUIRE(columns.widths()[1] == 10.0f);
+  REQUIRE(columns.heights()[2] == 5.0f);
+  REQUIRE(columns.gains()[0] == 1.0);
+  REQUIRE(columns.gains()[1] == -6.0);
+  REQUIRE(columns.gainIsDb()[1]);
+  // blocks with other parameters still have their columns filled in
+  REQUIRE(columns.gains()[3] == 0.5);
+}
+
+TEST_CASE("audio_block_format_objects_columns/rows") {
+  auto channel = makeExampleChannel();
+  auto blocks = channel->getElements<AudioBlockFormatObjects>();
+  AudioBlockFormatObjectsColumns columns(blocks);
+
+  auto row = columns[1];
+  REQUIRE(row.get<AudioBlockFormatId>() ==
+          blocks[1].get<AudioBlockFormatId>());
+  REQUIRE(row.get<Rtime>().get() == Time{FractionalTime{1, 1}});
+  REQUIRE(row.get<SphericalPosition>().get<Distance>() == 0.5f);
+  REQUIRE_FALSE(row.has<CartesianPosition>());
+  REQUIRE_THROWS(row.get<CartesianPosition>());
+  REQUIRE(row.get<Gain>().isDb());
+  REQUIRE(row.get<Gain>().asDb() == -6.0);
+  REQUIRE_FALSE(row.isDefault<Width>());
+  REQUIRE(row.isDefault<Height>());
+  REQUIRE(row.isDefault<Cartesian>());
+  REQUIRE(row.isDefault<JumpPosition>());
+  REQUIRE_FALSE(row.has<InitializeBlock>());
+
+  REQUIRE(columns[0].isDefault<Rtime>() == blocks[0].isDefault<Rtime>());
+  REQUIRE_FALSE(columns[2].has<Duration>());
+  REQUIRE_THROWS(columns[2].get<Duration>());
+  REQUIRE(columns[2].get<Cartesian>() == true);
+  REQUIRE(columns[2].get<CartesianPosition>().get<Y>() == -1.0f);
+
+  REQUIRE(columns[3].get<JumpPosition>().get<JumpPositionFlag>() == true);
+  REQUIRE_FALSE(columns[3].isDefault<Cartesian>());
+}
+
+TEST_CASE("audio_block_format_objects_columns/round_trip") {
+  auto channel = makeExampleChannel();
+  AudioBlockFormatObjectsColumns columns(
+      channel->getElements<AudioBlockFormatObjects>());
+
+  auto copy = AudioChannelFormat::create(AudioChannelFormatName("channel"),
+                                         TypeDefinition::OBJECTS);
+  for (std::size_t i = 0; i < columns.size(); ++i) copy->add(columns.block(i));
+  REQUIRE(toXml(copy) == toXml(channel));
+
+  columns.clear();
+  REQUIRE(columns.empty());
+}
@@ -202,3 +202,44 @@ TEST_CASE("audio_block_format_objects cartesian") {
     REQUIRE(block_format.isDefault<Cartesian>() == false);
   }
 }
+
+TEST_CASE("audio_block_format_objects copies") {
+  // some parameters are stored out of line, so check that copies don't share
+  // them
+  AudioBlockFormatObjects block{
+      SphericalPosition{Azimuth{10.0f}, Elevation{0.0f},
+                        ScreenEdgeLock{HorizontalEdge{"left"}}},
+      ScreenEdgeLock{VerticalEdge{"top"}}, JumpPosition{JumpPositionFlag{true}},
+      Width{20.0f}, Importance{5}};
+
+  AudioBlockFormatObjects copy = block;
+  copy.set(ScreenEdgeLock{VerticalEdge{"bottom"}});
+  copy.unset<JumpPosition>();
+  copy.set(ObjectDivergence{Divergence{0.5f}});
+  copy.unset<Width>();
+  copy.set(Height{10.0f});
+
+  REQUIRE(block.get<ScreenEdgeLock>().get<VerticalEdge>() == "top");
+  REQUIRE(block.get<JumpPosition>().get<JumpPositionFlag>() == true);
+  REQUIRE(block.isDefault<ObjectDivergence>());
+  REQUIRE(block.get<Width>() == 20.0f);
+  REQUIRE(block.isDefault<Height>());
+  REQUIRE(block.get<Importance>() == 5);
+
+  REQUIRE(copy.get<ScreenEdgeLock>().get<VerticalEdge>() == "bottom");
+  REQUIRE(copy.isDefault<JumpPosition>());
+  REQUIRE(copy.get<ObjectDivergence>().get<Divergence>() == 0.5f);
+  REQUIRE(copy.isDefault<Width>());
+  REQUIRE(copy.get<Width>() == 0.0f);
+  REQUIRE(copy.get<Height>() == 10.0f);
+  REQUIRE(copy.get<Importance>() == 5);
+  REQUIRE(copy.get<SphericalPosition>()
+              .get<ScreenEdgeLock>()
+              .get<HorizontalEdge>() == "left");
+
+  copy = AudioBlockFormatObjects{CartesianPosition{}};
+  REQUIRE(block.has<ScreenEdgeLock>());
+  REQUIRE_FALSE(copy.has<ScreenEdgeLock>());
+  REQUIRE(copy.has<CartesianPosition>());
+  REQUIRE_FALSE(copy.has<SphericalPosition>());
+}
@@ -93,3 +93,65 @@ TEST_CASE("audio_channel_format") {
   }
   */
 }
+
+TEST_CASE("audio_channel_format add blocks in bulk") {
+  using namespace adm;
+  using std::chrono::seconds;
+  auto channelFormat = AudioChannelFormat::create(
+      AudioChannelFormatName("MyChannelFormat"), TypeDefinition::OBJECTS);
+  channelFormat->set(AudioChannelFormatId(TypeDefinition::OBJECTS,
+                                          AudioChannelFormatIdValue(0x1001)));
+  channelFormat->reserve(10);
+  REQUIRE(channelFormat->capacity() >= 10);
+
+  auto counters = [&]() {
+    std::vector<unsigned> result;
+    for (auto &block : channelFormat->getElements<AudioBlockFormatObjects>())
+      result.push_back(block.get<AudioBlockFormatId>()
+                           .get<AudioBlockFormatIdCounter>()
+                           .get());
+    return result;
+  };
+
+  // taken over by an empty channel format
+  std::vector<AudioBlockFormatObjects> blocks;
+  for (int i = 0; i < 3; i++)
+    blocks.emplace_back(SphericalPosition{}, Rtime{seconds{i}});
+  channelFormat->addBlocks(std::move(blocks));
+  REQUIRE(counters() == std::vector<unsigned>{1, 2, 3});
+
+  // appended, with IDs following on from the existing blocks
+  std::vector<AudioBlockFormatObjects> more{
+      AudioBlockFormatObjects{SphericalPosition{}, Rtime{seconds{3}}},
+      AudioBlockFormatObjects{SphericalPosition{}, Rtime{seconds{4}}}};
+  channelFormat->add(more.begin(), more.end());
+  REQUIRE(counters() == std::vector<unsigned>{1, 2, 3, 4, 5});
+  REQUIRE(channelFormat->getElements<AudioBlockFormatObjects>()[4]
+              .get<Rtime>()
+              .get() == seconds{4});
+  // the blocks were copied
+  REQUIRE(more.size() == 2);
+
+  // existing IDs are checked, and nothing is added if one is wrong
+  std::vector<AudioBlockFormatObjects> wrong{
+      AudioBlockFormatObjects{SphericalPosition{}},
+      AudioBlockFormatObjects{
+          SphericalPosition{},
+          AudioBlockFormatId(TypeDefinition::OBJECTS,
+                             AudioBlockFormatIdValue(0x1001),
+                             AudioBlockFormatIdCounter(10))}};
+  REQUIRE_THROWS_AS(channelFormat->addBlocks(std::move(wrong)),
+                    std::runtime_error);
+  REQUIRE(counters() == std::vector<unsigned>{1, 2, 3, 4, 5});
+
+  std::vector<AudioBlockFormatObjects> right{
+      AudioBlockFormatObjects{
+          SphericalPosition{},
+          AudioBlockFormatId(TypeDefinition::OBJECTS,
+                             AudioBlockFormatIdValue(0x1001),
+                             AudioBlockFormatIdCounter(6))},
+      AudioBlockFormatObjects{SphericalPosition{}}};
+  channelFormat->add(std::make_move_iterator(right.begin()),
+                     std::make_move_iterator(right.end()));
+  REQUIRE(counters() == std::vector<unsigned>{1, 2, 3, 4, 5, 6, 7});
+}
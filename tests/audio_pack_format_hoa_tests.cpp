@@ -57,3 +57,18 @@ TEST_CASE("audio_pack_format_hoa_with_extra_param_in_constructor") {
   REQUIRE(packFormatHoa->get<ScreenRef>() == true);
   REQUIRE(packFormatHoa->get<NfcRefDist>() == 2);
 }
+
+TEST_CASE("audio_pack_format_hoa_copy") {
+  using namespace adm;
+
+  auto packFormatHoa = AudioPackFormatHoa::create(
+      AudioPackFormatName("MyPackFormatHoa"), Normalization("FuMa"));
+
+  std::shared_ptr<AudioPackFormat> packFormat = packFormatHoa;
+  auto packFormatCopy =
+      std::dynamic_pointer_cast<AudioPackFormatHoa>(packFormat->copy());
+  REQUIRE(packFormatCopy);
+  REQUIRE(packFormatCopy != packFormatHoa);
+  REQUIRE(packFormatCopy->get<AudioPackFormatName>() == "MyPackFormatHoa");
+  REQUIRE(packFormatCopy->get<Normalization>() == "FuMa");
+}
@@ -19,6 +19,12 @@ namespace adm {
   struct DefaultTag {};
   using Default = detail::NamedType<int, DefaultTag>;
 
+  struct PackedFloatTag {};
+  using PackedFloat = detail::NamedType<float, PackedFloatTag>;
+
+  struct PackedBoolTag {};
+  using PackedBool = detail::NamedType<bool, PackedBoolTag>;
+
   struct VectorTag {};
   using Vector = detail::NamedType<int, VectorTag>;
 
@@ -32,6 +38,11 @@ namespace adm {
       return Default{42};
     }
 
+    template <>
+    PackedFloat getDefault<PackedFloat>() {
+      return PackedFloat{1.5f};
+    }
+
     template class RequiredParameter<Required>;
     template class OptionalParameter<Optional>;
     template class DefaultParameter<Default>;
@@ -39,7 +50,8 @@ namespace adm {
 
     using Base =
         HasParameters<RequiredParameter<Required>, OptionalParameter<Optional>,
-                      DefaultParameter<Default>, VectorParameter<Vectors>>;
+                      DefaultParameter<Default>, VectorParameter<Vectors>,
+                      PackedDefaultParameters<PackedFloat, PackedBool>>;
   };  // namespace detail
 
   // standard wrapper around Base providing templated methods. not really
@@ -140,6 +152,30 @@ TEST_CASE("default") {
   REQUIRE(e.isDefault<Default>());
 }
 
+TEST_CASE("packed default") {
+  TestElement e{PackedBool{true}};
+  REQUIRE(e.has<PackedFloat>());
+  REQUIRE(e.get<PackedFloat>() == 1.5f);
+  REQUIRE(e.isDefault<PackedFloat>());
+  REQUIRE(e.get<PackedBool>() == true);
+  REQUIRE(!e.isDefault<PackedBool>());
+
+  e.set(PackedFloat{5.0f});
+  REQUIRE(e.has<PackedFloat>());
+  REQUIRE(e.get<PackedFloat>() == 5.0f);
+  REQUIRE(!e.isDefault<PackedFloat>());
+
+  e.unset<PackedBool>();
+  REQUIRE(e.get<PackedBool>() == false);
+  REQUIRE(e.isDefault<PackedBool>());
+  REQUIRE(!e.isDefault<PackedFloat>());
+
+  e.unset<PackedFloat>();
+  REQUIRE(e.has<PackedFloat>());
+  REQUIRE(e.get<PackedFloat>() == 1.5f);
+  REQUIRE(e.isDefault<PackedFloat>());
+}
+
 TEST_CASE("vector") {
   TestElement e;
   REQUIRE(!e.has<Vectors>());
@@ -1,23 +1,79 @@
 #include <catch2/catch.hpp>
 #include "adm/common_definitions.hpp"
+#include "adm/elements/audio_block_format_objects_columns.hpp"
+#include "adm/utilities/block_duration_assignment.hpp"
+#include "adm/utilities/block_timeline.hpp"
+#include "adm/utilities/comparator.hpp"
 #include "adm/utilities/copy.hpp"
 #include "adm/utilities/object_creation.hpp"
 #include "adm/parse.hpp"
 #include "adm/write.hpp"
+#include "adm/serial/changed_ids_differ.hpp"
+#include "adm/serial/frame_applier.hpp"
+#include "adm/serial/frame_assembler.hpp"
+#include "adm/serial/frame_generator.hpp"
+#include "adm/private/document_parser.hpp"
+#include "adm/private/number_parsing.hpp"
+#include <algorithm>
+#include <fstream>
 #include <sstream>
+#include <vector>
+#ifdef __linux__
+#include <unistd.h>
+#endif
 
 using namespace adm;
 
 TEST_CASE("common_definitions") {
-  BENCHMARK("parse") { return getCommonDefinitions(); };
+  BENCHMARK("get") { return getCommonDefinitions(); };
+
+  BENCHMARK("parse from XML") {
+    std::ifstream stream(ADM_COMMON_DEFINITIONS_XML);
+    xml::DocumentParser parser(stream,
+                               xml::ParserOptions::recursive_node_search);
+    return parser.parse();
+  };
 
   auto common_defs = adm::getCommonDefinitions();
   BENCHMARK("copy") { return adm::deepCopy(common_defs); };
 }
 
+TEST_CASE("parsing short frames") {
+  auto frame = Document::create();
+  auto holder = addSimpleObjectTo(frame, "object");
+  for (int i = 0; i < 4; i++)
+    holder.audioChannelFormat->add(AudioBlockFormatObjects{
+        SphericalPosition{Azimuth{i * 10.0f}}, Rtime{std::chrono::seconds(i)},
+        Duration{std::chrono::seconds(1)}});
+
+  std::stringstream stream;
+  writeXml(stream, frame);
+
+  // what parseXml did before the common definitions were cached
+  BENCHMARK("parse frame with common definitions from XML") {
+    std::ifstream commonDefinitionsStream(ADM_COMMON_DEFINITIONS_XML);
+    xml::DocumentParser commonDefinitionsParser(
+        commonDefinitionsStream, xml::ParserOptions::recursive_node_search);
+    stream.seekg(0);
+    xml::DocumentParser parser(stream, xml::ParserOptions::none,
+                               commonDefinitionsParser.parse());
+    return parser.parse();
+  };
+
+  BENCHMARK("parse frame with cached common definitions") {
+    stream.seekg(0);
+    return parseXml(stream);
+  };
+
+  ReusableParser reusableParser;
+  BENCHMARK("parse frame with a reusable parser") {
+    stream.seekg(0);
+    return reusableParser.parse(stream);
+  };
+}
+
 TEST_CASE("adding lots of objects to document") {
-  auto const n = 200;
-  auto add_to_document = [n]() {
+  auto add_to_document = [](int n) {
     std::vector<SimpleObjectHolder> holders;
     holders.reserve(n);
     for (auto i = 0; i != n; ++i) {
@@ -29,7 +85,83 @@ TEST_CASE("adding lots of objects to document") {
     }
   };
 
-  BENCHMARK("add to document") { return add_to_document(); };
+  BENCHMARK("add to document") { return add_to_document(200); };
+  BENCHMARK("add 10k to document") { return add_to_document(10000); };
+  BENCHMARK("add 100k to document") { return add_to_document(100000); };
+
+  BENCHMARK("addAll 10k to document") {
+    std::vector<std::shared_ptr<AudioObject>> objects;
+    objects.reserve(10000);
+    for (auto i = 0; i != 10000; ++i) {
+      objects.push_back(createSimpleObject(std::to_string(i)).audioObject);
+    }
+    auto doc = Document::create();
+    doc->addAll(objects);
+    return doc;
+  };
+}
+
+TEST_CASE("looking up lots of channel formats") {
+  auto const n = 10000;
+  auto doc = Document::create();
+  std::vector<AudioChannelFormatId> ids;
+  ids.reserve(n);
+  for (auto i = 0; i != n; ++i) {
+    auto channelFormat = AudioChannelFormat::create(
+        AudioChannelFormatName(std::to_string(i)), TypeDefinition::OBJECTS);
+    doc->add(channelFormat);
+    ids.push_back(channelFormat->get<AudioChannelFormatId>());
+  }
+
+  BENCHMARK("lookup all") {
+    std::size_t found = 0;
+    for (auto const& id : ids) {
+      if (doc->lookup(id)) ++found;
+    }
+    return found;
+  };
+
+  BENCHMARK("change ID") {
+    auto channelFormat = doc->lookup(ids.back());
+    channelFormat->set(AudioChannelFormatId(
+        TypeDefinition::OBJECTS, AudioChannelFormatIdValue(0xffff)));
+    channelFormat->set(ids.back());
+    return channelFormat;
+  };
+}
+
+TEST_CASE("removing lots of objects from document") {
+  auto const n = 10000;
+  struct Setup {
+    std::shared_ptr<Document> doc;
+    std::vector<std::shared_ptr<AudioPackFormat>> packFormats;
+  };
+  auto setup = [n]() {
+    Setup result{Document::create(), {}};
+    for (auto i = 0; i != n; ++i) {
+      auto holder = addSimpleObjectTo(result.doc, std::to_string(i));
+      if (i % 2) result.packFormats.push_back(holder.audioPackFormat);
+    }
+    return result;
+  };
+
+  BENCHMARK_ADVANCED("remove half one at a time")
+  (Catch::Benchmark::Chronometer meter) {
+    std::vector<Setup> setups;
+    for (int i = 0; i < meter.runs(); i++) setups.push_back(setup());
+    meter.measure([&setups](int i) {
+      for (auto& packFormat : setups[i].packFormats)
+        setups[i].doc->remove(packFormat);
+    });
+  };
+
+  BENCHMARK_ADVANCED("removeAll half")(Catch::Benchmark::Chronometer meter) {
+    std::vector<Setup> setups;
+    for (int i = 0; i < meter.runs(); i++) setups.push_back(setup());
+    meter.measure([&setups](int i) {
+      return setups[i].doc->removeAll(setups[i].packFormats);
+    });
+  };
 }
 
 TEST_CASE("copying document with lots of objects and common defs") {
@@ -47,6 +179,115 @@ TEST_CASE("copying document with lots of objects and common defs") {
   BENCHMARK("deepCopy()") { return doc->deepCopy(); };
 }
 
+TEST_CASE("applying frames to a large scene") {
+  using namespace std::chrono_literals;
+  auto const n = 1000;
+  auto scene = Document::create();
+  for (auto i = 0; i != n; ++i) {
+    auto holder = addSimpleObjectTo(scene, std::to_string(i));
+    for (auto b = 0; b != 10; ++b) {
+      holder.audioChannelFormat->add(AudioBlockFormatObjects(
+          SphericalPosition{Azimuth{static_cast<float>(b)}}, Rtime{b * 1s},
+          Duration{1s}));
+    }
+  }
+  FrameApplier applier(scene);
+
+  // a frame with the first object, which has been renamed, and the next
+  // block of its channel
+  auto frame = Document::create();
+  auto holder = addSimpleObjectTo(frame, "renamed");
+  holder.audioChannelFormat->add(AudioBlockFormatObjects(
+      SphericalPosition{}, Rtime{10s}, Duration{1s},
+      AudioBlockFormatId(TypeDefinition::OBJECTS,
+                         AudioBlockFormatIdValue(0x1001),
+                         AudioBlockFormatIdCounter(11))));
+  ChangedIds changedIds;
+  changedIds.add(holder.audioObject, ChangedIdStatus::CHANGED);
+  changedIds.add(holder.audioChannelFormat, ChangedIdStatus::EXTENDED);
+  FrameFormat frameFormat{FrameFormatId{FrameIndex{2}}, Start{0s},
+                          Duration{1s}, FrameType::INTERMEDIATE};
+  frameFormat.set(changedIds);
+  FrameHeader header{frameFormat};
+
+  BENCHMARK("apply a frame with two changes") {
+    applier.apply(frame, header);
+  };
+}
+
+TEST_CASE("computing changedIDs") {
+  using namespace std::chrono_literals;
+  // frames with 128 objects, each with one block per frame
+  auto const n = 128;
+  auto makeFrame = [n](int index) {
+    auto frame = Document::create();
+    for (auto i = 0; i != n; ++i) {
+      auto holder = addSimpleObjectTo(frame, std::to_string(i));
+      holder.audioChannelFormat->add(AudioBlockFormatObjects(
+          SphericalPosition{Azimuth{static_cast<float>(index + i)}},
+          Rtime{index * 1s}, Duration{1s}));
+    }
+    return frame;
+  };
+  auto first = makeFrame(0);
+  auto second = makeFrame(1);
+
+  ChangedIdsDiffer differ;
+  differ.update(first);
+  BENCHMARK("compare with the previous frame") {
+    return differ.update(second);
+  };
+}
+
+TEST_CASE("generating frames from a long programme") {
+  using namespace std::chrono_literals;
+  // 16 objects with 10 minutes of 100ms blocks, split into 1s frames
+  auto document = Document::create();
+  for (auto i = 0; i != 16; ++i) {
+    auto holder = addSimpleObjectTo(document, std::to_string(i));
+    for (auto b = 0; b != 6000; ++b) {
+      holder.audioChannelFormat->add(AudioBlockFormatObjects(
+          SphericalPosition{Azimuth{static_cast<float>(b % 180)}},
+          Rtime{b * 100ms}, Duration{100ms}));
+    }
+  }
+
+  BENCHMARK("generate all frames") {
+    FrameGenerator generator(document, 1s);
+    std::size_t frames = 0;
+    while (generator.hasNext()) {
+      generator.next();
+      ++frames;
+    }
+    return frames;
+  };
+}
+
+TEST_CASE("assembling frames into a long programme") {
+  using namespace std::chrono_literals;
+  // 16 objects with a minute of 100ms blocks, in 1s frames
+  auto document = Document::create();
+  for (auto i = 0; i != 16; ++i) {
+    auto holder = addSimpleObjectTo(document, std::to_string(i));
+    for (auto b = 0; b != 600; ++b) {
+      holder.audioChannelFormat->add(AudioBlockFormatObjects(
+          SphericalPosition{Azimuth{static_cast<float>(b % 180)}},
+          Rtime{b * 100ms}, Duration{100ms}));
+    }
+  }
+  std::vector<GeneratedFrame> frames;
+  FrameGenerator generator(document, 1s);
+  while (generator.hasNext()) frames.push_back(generator.next());
+
+  BENCHMARK("assemble all frames") {
+    FrameAssembler assembler;
+    for (const auto& frame : frames) {
+      assembler.add(frame.document, frame.header);
+    }
+    return assembler.getDocument();
+  };
+}
+
 TEST_CASE("lots of blocks") {
   auto generate = []() {
     auto doc = Document::create();
@@ -64,6 +305,34 @@ TEST_CASE("lots of blocks") {
 
   BENCHMARK("generate") { return generate(); };
 
+  BENCHMARK("generate with reserve") {
+    auto doc = Document::create();
+    auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                              TypeDefinition::OBJECTS);
+    doc->add(channel);
+
+    const size_t n = 3600 * 20;
+    channel->reserve(n);
+    for (size_t i = 0; i < n; i++)
+      channel->add(AudioBlockFormatObjects{SphericalPosition{}});
+
+    return doc;
+  };
+
+  BENCHMARK("generate with addBlocks") {
+    auto doc = Document::create();
+    auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                              TypeDefinition::OBJECTS);
+    doc->add(channel);
+
+    const size_t n = 3600 * 20;
+    std::vector<AudioBlockFormatObjects> blocks(
+        n, AudioBlockFormatObjects{SphericalPosition{}});
+    channel->addBlocks(std::move(blocks));
+
+    return doc;
+  };
+
   auto document = generate();
 
   BENCHMARK("copy") { return adm::deepCopy(document); };
@@ -81,6 +350,360 @@ TEST_CASE("lots of blocks") {
     stream.seekg(0);
     return parseXml(stream);
   };
+
+  std::string xml = stream.str();
+
+  BENCHMARK("parse from memory") {
+    return parseXml(xml.data(), xml.size());
+  };
+
+  BENCHMARK_ADVANCED("parse in situ")(Catch::Benchmark::Chronometer meter) {
+    std::vector<char> buffer(xml.c_str(), xml.c_str() + xml.size() + 1);
+    std::vector<std::vector<char>> buffers(meter.runs(), buffer);
+    meter.measure([&](int i) {
+      return parseXmlInSitu(buffers[i].data(), xml.size());
+    });
+  };
+}
+
+TEST_CASE("lots of blocks in lots of channels") {
+  auto document = Document::create();
+  for (size_t c = 0; c < 64; c++) {
+    auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                              TypeDefinition::OBJECTS);
+    document->add(channel);
+    for (size_t i = 0; i < 1125; i++) {
+      channel->add(AudioBlockFormatObjects{
+          SphericalPosition{}, Rtime{std::chrono::milliseconds(100 * i)},
+          Duration{std::chrono::milliseconds(100)}});
+    }
+  }
+
+  BENCHMARK("write") {
+    std::ostringstream stream;
+    writeXml(stream, document);
+    return stream;
+  };
+
+  BENCHMARK("write parallel") {
+    std::ostringstream stream;
+    writeXml(stream, document, xml::WriterOptions::parallel);
+    return stream;
+  };
+
+  std::stringstream stream;
+  writeXml(stream, document);
+  std::string xml = stream.str();
+
+  BENCHMARK("parse") { return parseXml(xml.data(), xml.size()); };
+
+  BENCHMARK("parse parallel") {
+    return parseXml(xml.data(), xml.size(), xml::ParserOptions::parallel);
+  };
+
+  BENCHMARK("parse with lazy blocks") {
+    return parseXml(xml.data(), xml.size(),
+                    xml::ParserOptions::lazy_block_formats);
+  };
+
+  xml::ParseFilter window;
+  window.blockStart = Time{std::chrono::seconds(10)};
+  window.blockEnd = Time{std::chrono::seconds(20)};
+  BENCHMARK("parse 10s window") {
+    return parseXml(xml.data(), xml.size(), xml::ParserOptions::none, window);
+  };
+
+  BENCHMARK("parse with lazy blocks, then load them") {
+    auto parsed = parseXml(xml.data(), xml.size(),
+                           xml::ParserOptions::lazy_block_formats);
+    std::size_t blocks = 0;
+    for (auto& channel : parsed->getElements<AudioChannelFormat>())
+      blocks += channel->getElements<AudioBlockFormatObjects>().size();
+    return blocks;
+  };
+}
+
+TEST_CASE("parsing numbers in blocks") {
+  // blocks with most of their parameters set, so that parsing is dominated
+  // by numeric attributes and elements
+  auto doc = Document::create();
+  auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                            TypeDefinition::OBJECTS);
+  doc->add(channel);
+  for (size_t i = 0; i < 3600 * 5; i++) {
+    AudioBlockFormatObjects block{
+        SphericalPosition{Azimuth(-30.0f + 0.001f * i), Elevation(12.5f),
+                          Distance(0.75f)},
+        Width(10.0f), Height(5.0f), Depth(0.25f), Gain::fromLinear(0.5),
+        Diffuse(0.125f), Importance(7)};
+    block.set(ObjectDivergence(Divergence(0.5f), AzimuthRange(30.0f)));
+    channel->add(block);
+  }
+  std::stringstream stream;
+  writeXml(stream, doc);
+  std::string xml = stream.str();
+
+  BENCHMARK("parse document") { return parseXml(xml.data(), xml.size()); };
+
+  std::vector<std::string> values;
+  for (size_t i = 0; i < 10000; i++) {
+    values.push_back(std::to_string(-30.0f + 0.001f * i));
+  }
+
+  BENCHMARK("std::stof") {
+    float sum = 0.0f;
+    for (auto& value : values) sum += std::stof(value);
+    return sum;
+  };
+
+  BENCHMARK("parseFloat") {
+    float sum = 0.0f;
+    for (auto& value : values) {
+      sum += xml::detail::parseFloat(value.data(),
+                                     value.data() + value.size());
+    }
+    return sum;
+  };
+}
+
+TEST_CASE("timecodes") {
+  std::vector<std::string> timecodes;
+  std::vector<Time> times;
+  for (int64_t i = 0; i < 10000; i++) {
+    times.push_back(std::chrono::nanoseconds(i * 1234567891));
+    times.push_back(FractionalTime{i * 7, 48000});
+  }
+  for (auto& time : times) timecodes.push_back(formatTimecode(time));
+
+  BENCHMARK("parse string") {
+    int64_t sum = 0;
+    for (auto& timecode : timecodes) {
+      sum += parseTimecode(timecode).asNanoseconds().count();
+    }
+    return sum;
+  };
+
+  BENCHMARK("parse range") {
+    int64_t sum = 0;
+    for (auto& timecode : timecodes) {
+      sum += parseTimecode(timecode.data(), timecode.data() + timecode.size())
+                 .asNanoseconds()
+                 .count();
+    }
+    return sum;
+  };
+
+  BENCHMARK("format string") {
+    std::size_t sum = 0;
+    for (auto& time : times) sum += formatTimecode(time).size();
+    return sum;
+  };
+
+  BENCHMARK("format buffer") {
+    std::size_t sum = 0;
+    char buffer[timecodeBufferSize];
+    for (auto& time : times) sum += formatTimecode(time, buffer);
+    return sum;
+  };
+}
+
+TEST_CASE("time arithmetic") {
+  std::vector<Time> times;
+  for (int64_t i = 0; i < 10000; i++) {
+    times.push_back(std::chrono::nanoseconds(i * 1234567891));
+    times.push_back(FractionalTime{i * 7, 48000});
+  }
+
+  BENCHMARK("as nanoseconds") {
+    int64_t sum = 0;
+    for (auto& time : times) sum += time.asNanoseconds().count();
+    return sum;
+  };
+
+  BENCHMARK("compare") {
+    std::size_t count = 0;
+    for (std::size_t i = 1; i < times.size(); i++)
+      count += times[i].asFixed() < times[i - 1].asFixed();
+    return count;
+  };
+
+  std::vector<AudioBlockFormatObjects> blocks;
+  for (int64_t i = 0; i < 10000; i++) {
+    blocks.push_back(AudioBlockFormatObjects{
+        SphericalPosition{}, Rtime{FractionalTime{(i * 7919) % 10000, 25}}});
+  }
+
+  BENCHMARK("sort blocks") {
+    auto sorted = blocks;
+    std::sort(sorted.begin(), sorted.end(), CompareRtimeLess());
+    return sorted;
+  };
+
+  auto document = Document::create();
+  auto programme = AudioProgramme::create(AudioProgrammeName{"programme"},
+                                          End{FractionalTime{10000, 25}});
+  auto content = AudioContent::create(AudioContentName{"content"});
+  programme->addReference(content);
+  document->add(programme);
+  auto holder = addSimpleObjectTo(document, "object");
+  content->addReference(holder.audioObject);
+  for (int64_t i = 0; i < 10000; i++) {
+    holder.audioChannelFormat->add(AudioBlockFormatObjects{
+        SphericalPosition{}, Rtime{FractionalTime{i, 25}}});
+  }
+
+  BENCHMARK("assign block durations") {
+    updateBlockFormatDurations(document);
+    return document;
+  };
+}
+
+TEST_CASE("finding active blocks") {
+  using namespace std::chrono_literals;
+  auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                            TypeDefinition::OBJECTS);
+  const int64_t n = 3600 * 20;
+  for (int64_t i = 0; i < n; i++) {
+    channel->add(AudioBlockFormatObjects{SphericalPosition{},
+                                         Rtime{i * 50ms}, Duration{50ms}});
+  }
+  // evenly spaced times, as for playback in large steps
+  std::vector<Time> times;
+  for (int64_t i = 0; i < 200; i++) times.push_back(i * (n * 50ms / 200));
+
+  BENCHMARK("linear scan") {
+    std::size_t found = 0;
+    auto blocks = channel->getElements<AudioBlockFormatObjects>();
+    for (auto& time : times) {
+      auto t = time.asNanoseconds();
+      found += std::find_if(blocks.begin(), blocks.end(),
+                            [&t](const AudioBlockFormatObjects& block) {
+                              auto start =
+                                  block.get<Rtime>().get().asNanoseconds();
+                              return start <= t &&
+                                     t < start + block.get<Duration>()
+                                                     .get()
+                                                     .asNanoseconds();
+                            }) != blocks.end();
+    }
+    return found;
+  };
+
+  BlockTimeline<AudioBlockFormatObjects> timeline(channel);
+
+  BENCHMARK("timeline") {
+    std::size_t found = 0;
+    for (auto& time : times) found += timeline.blockAt(time) != nullptr;
+    return found;
+  };
+
+  BENCHMARK("cursor, every 10ms") {
+    BlockTimeline<AudioBlockFormatObjects>::Cursor cursor(timeline);
+    std::size_t found = 0;
+    for (auto t = 0ms; t < n * 50ms; t += 10ms)
+      found += cursor.seek(t) != nullptr;
+    return found;
+  };
+}
+
+TEST_CASE("scanning object blocks") {
+  using namespace std::chrono_literals;
+  auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                            TypeDefinition::OBJECTS);
+  const int64_t n = 3600 * 20;
+  for (int64_t i = 0; i < n; i++) {
+    channel->add(AudioBlockFormatObjects{
+        SphericalPosition{Azimuth{static_cast<float>(i % 180)}},
+        Rtime{i * 50ms}, Duration{50ms}, Gain::fromLinear(0.5)});
+  }
+  auto blocks = channel->getElements<AudioBlockFormatObjects>();
+
+  BENCHMARK("build columns") {
+    return AudioBlockFormatObjectsColumns{blocks};
+  };
+
+  AudioBlockFormatObjectsColumns columns{blocks};
+
+  BENCHMARK("azimuths from blocks") {
+    float sum = 0.0f;
+    for (auto& block : blocks)
+      sum += block.get<SphericalPosition>().get<Azimuth>().get();
+    return sum;
+  };
+
+  BENCHMARK("azimuths from rows") {
+    float sum = 0.0f;
+    for (std::size_t i = 0; i < columns.size(); i++)
+      sum += columns[i].get<SphericalPosition>().get<Azimuth>().get();
+    return sum;
+  };
+
+  BENCHMARK("azimuths from columns") {
+    float sum = 0.0f;
+    for (float azimuth : columns.azimuthOrX()) sum += azimuth;
+    return sum;
+  };
+
+  BENCHMARK("gains from blocks") {
+    double sum = 0.0;
+    for (auto& block : blocks) sum += block.get<Gain>().asLinear();
+    return sum;
+  };
+
+  BENCHMARK("gains from columns") {
+    double sum = 0.0;
+    for (double gain : columns.gains()) sum += gain;
+    return sum;
+  };
+}
+
+namespace {
+  /// the resident set size of this process in bytes, or 0 if unknown
+  std::size_t residentBytes() {
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    std::size_t size = 0, resident = 0;
+    if (statm >> size >> resident)
+      return resident * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    return 0;
+  }
+}  // namespace
+
+TEST_CASE("block format memory") {
+  WARN("sizeof(AudioBlockFormatObjects): "
+       << sizeof(AudioBlockFormatObjects) << "\n"
+       << "sizeof(AudioBlockFormatDirectSpeakers): "
+       << sizeof(AudioBlockFormatDirectSpeakers) << "\n"
+       << "sizeof(AudioBlockFormatHoa): " << sizeof(AudioBlockFormatHoa)
+       << "\n"
+       << "sizeof(AudioBlockFormatMatrix): " << sizeof(AudioBlockFormatMatrix)
+       << "\n"
+       << "sizeof(AudioBlockFormatBinaural): "
+       << sizeof(AudioBlockFormatBinaural));
+
+  // memory freed by earlier test cases may be reused, so run this test case
+  // on its own to get a meaningful resident set size
+  const std::size_t n = 3600 * 20;
+  auto before = residentBytes();
+  auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                            TypeDefinition::OBJECTS);
+  for (std::size_t i = 0; i < n; i++)
+    channel->add(AudioBlockFormatObjects{
+        SphericalPosition{Azimuth{static_cast<float>(i % 360) - 180.0f}},
+        Width{10.0f}, Gain::fromDb(-3.0)});
+  auto after = residentBytes();
+  if (after > before)
+    WARN("resident set size increase for " << n << " object blocks: "
+                                            << (after - before) / 1024
+                                            << " KiB");
+
+  BENCHMARK("copy object blocks") {
+    std::vector<AudioBlockFormatObjects> blocks;
+    for (auto& block : channel->getElements<AudioBlockFormatObjects>())
+      blocks.push_back(block);
+    return blocks;
+  };
 }
 
 TEST_CASE("IDs") {
@@ -0,0 +1,79 @@
+#include <catch2/catch.hpp>
+#include <boost/optional/optional_io.hpp>
+#include "adm/elements/audio_channel_format.hpp"
+#include "adm/utilities/block_timeline.hpp"
+#include "helper/document_fixtures.hpp"
+
+using namespace adm;
+using namespace adm_test;
+
+namespace {
+  using namespace std::chrono_literals;
+
+  boost::optional<std::size_t> index(std::size_t i) { return i; }
+
+  float azimuthOf(const AudioBlockFormatObjects* block) {
+    return block->get<SphericalPosition>().get<Azimuth>().get();
+  }
+}  // namespace
+
+TEST_CASE("block_timeline/lookup") {
+  auto channel = makeChannel();
+  // a gap between 1s and 2s, and a last block without a duration
+  channel->add(AudioBlockFormatObjects(SphericalPosition{Azimuth{0.0f}},
+                                       Rtime{0s}, Duration{1s}));
+  channel->add(AudioBlockFormatObjects(SphericalPosition{Azimuth{1.0f}},
+                                       Rtime{2s}));
+  channel->add(AudioBlockFormatObjects(SphericalPosition{Azimuth{2.0f}},
+                                       Rtime{FractionalTime{5, 2}}));
+
+  BlockTimeline<AudioBlockFormatObjects> timeline(channel);
+  REQUIRE(timeline.indexAt(0s) == index(0));
+  REQUIRE(timeline.indexAt(999ms) == index(0));
+  REQUIRE_FALSE(timeline.indexAt(1s));
+  REQUIRE(timeline.blockAt(1500ms) == nullptr);
+  REQUIRE(azimuthOf(timeline.blockAt(2s)) == 1.0f);
+  REQUIRE(azimuthOf(timeline.blockAt(FractionalTime{12, 5})) == 1.0f);
+  REQUIRE(azimuthOf(timeline.blockAt(2500ms)) == 2.0f);
+  REQUIRE(azimuthOf(timeline.blockAt(1h)) == 2.0f);
+  REQUIRE_FALSE(timeline.indexAt(-1ms));
+
+  // blocks added later are found, and end the previous block
+  channel->add(AudioBlockFormatObjects(SphericalPosition{Azimuth{3.0f}},
+                                       Rtime{3s}, Duration{1s}));
+  REQUIRE(timeline.indexAt(2999ms) == index(2));
+  REQUIRE(timeline.indexAt(3s) == index(3));
+  REQUIRE_FALSE(timeline.indexAt(4s));
+
+  // and so are changes, after a reset
+  channel->clearAudioBlockFormats();
+  channel->add(AudioBlockFormatObjects(SphericalPosition{}));
+  timeline.reset();
+  REQUIRE(timeline.indexAt(1h) == index(0));
+}
+
+TEST_CASE("block_timeline/cursor") {
+  auto channel = makeChannel();
+  for (int i = 0; i != 100; ++i) {
+    channel->add(AudioBlockFormatObjects(
+        SphericalPosition{Azimuth{static_cast<float>(i)}}, Rtime{i * 10ms},
+        Duration{i % 10 == 9 ? 5ms : 10ms}));
+  }
+
+  BlockTimeline<AudioBlockFormatObjects> timeline(channel);
+  BlockTimeline<AudioBlockFormatObjects>::Cursor cursor(timeline);
+  // forwards in small and large steps, then backwards, always agreeing
+  // with a binary search
+  for (auto t : {0ms, 1ms, 10ms, 11ms, 96ms, 100ms, 500ms, 993ms, 1000ms, 2000ms,
+                 50ms, 0ms, 250ms}) {
+    REQUIRE(cursor.indexAt(t) == timeline.indexAt(t));
+    REQUIRE(cursor.seek(t) == timeline.blockAt(t));
+  }
+  for (auto t = 0ms; t < 1100ms; t += 1ms) {
+    auto found = cursor.indexAt(t);
+    REQUIRE(found == timeline.indexAt(t));
+    if (t < 1s && t % 100ms < 95ms) {
+      REQUIRE(found == index(static_cast<std::size_t>(t / 10ms)));
+    }
+  }
+}
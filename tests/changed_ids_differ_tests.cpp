@@ -0,0 +1,167 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include "adm/common_definitions.hpp"
+#include "adm/document.hpp"
+#include "adm/serial/changed_ids_differ.hpp"
+#include "adm/serial/frame_applier.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "helper/document_fixtures.hpp"
+
+using namespace adm;
+using namespace adm_test;
+
+namespace {
+  using namespace std::chrono_literals;
+
+  template <typename Element>
+  ChangedIdStatus statusOf(const ChangedIds& changedIds,
+                           const std::shared_ptr<Element>& element) {
+    using Id = typename Element::id_type;
+    auto id = element->template get<Id>();
+    for (const auto& changedId :
+         changedIds.get<std::vector<ChangedId<Element>>>()) {
+      if (changedId.template get<Id>() == id)
+        return changedId.template get<ChangedIdStatus>();
+    }
+    FAIL("no changedID for " << formatId(id));
+    return ChangedIdStatus::NEW;
+  }
+
+  std::size_t countChanges(const ChangedIds& changedIds) {
+    return changedIds.get<ChangedAudioProgrammeIds>().size() +
+           changedIds.get<ChangedAudioContentIds>().size() +
+           changedIds.get<ChangedAudioObjectIds>().size() +
+           changedIds.get<ChangedAudioPackFormatIds>().size() +
+           changedIds.get<ChangedAudioChannelFormatIds>().size() +
+           changedIds.get<ChangedAudioStreamFormatIds>().size() +
+           changedIds.get<ChangedAudioTrackFormatIds>().size() +
+           changedIds.get<ChangedAudioTrackUidIds>().size();
+  }
+}  // namespace
+
+TEST_CASE("changed_ids_differ/statuses") {
+  auto first = Document::create();
+  addCommonDefinitionsTo(first);
+  auto kept = addSimpleObjectTo(first, "kept");
+  auto expired = addSimpleObjectTo(first, "expired");
+  kept.audioChannelFormat->add(makeBlock(0.0f, 0));
+
+  ChangedIdsDiffer differ;
+  auto initial = differ.update(first);
+  // everything is new, except the common definitions
+  REQUIRE(countChanges(initial) == 12);
+  REQUIRE(statusOf(initial, kept.audioObject) == ChangedIdStatus::NEW);
+
+  // the same content in a different document has no changes
+  auto second = first->deepCopy();
+  REQUIRE(countChanges(differ.update(second)) == 0);
+
+  auto third = second->deepCopy();
+  auto object = third->lookup(kept.audioObject->get<AudioObjectId>());
+  object->set(AudioObjectName("renamed"));
+  auto channelFormat =
+      third->lookup(kept.audioChannelFormat->get<AudioChannelFormatId>());
+  channelFormat->add(makeBlock(10.0f, 1));
+  auto trackUid = third->lookup(kept.audioTrackUid->get<AudioTrackUidId>());
+  trackUid->set(SampleRate(96000));
+  auto added = addSimpleObjectTo(third, "added");
+  third->remove(third->lookup(expired.audioObject->get<AudioObjectId>()));
+
+  auto changedIds = differ.update(third);
+  REQUIRE(statusOf(changedIds, object) == ChangedIdStatus::CHANGED);
+  REQUIRE(statusOf(changedIds, channelFormat) == ChangedIdStatus::EXTENDED);
+  REQUIRE(statusOf(changedIds, trackUid) == ChangedIdStatus::CHANGED);
+  REQUIRE(statusOf(changedIds, added.audioObject) == ChangedIdStatus::NEW);
+  REQUIRE(statusOf(changedIds, added.audioTrackUid) == ChangedIdStatus::NEW);
+  REQUIRE(statusOf(changedIds, expired.audioObject) ==
+          ChangedIdStatus::EXPIRED);
+  // 3 changes, 6 new elements and 1 expired object
+  REQUIRE(countChanges(changedIds) == 10);
+
+  // after reset, everything is new again
+  differ.reset();
+  REQUIRE(countChanges(differ.update(third)) == 17);
+}
+
+TEST_CASE("changed_ids_differ/channel_formats") {
+  auto document = Document::create();
+  auto holder = addSimpleObjectTo(document, "object");
+  holder.audioChannelFormat->add(makeBlock(0.0f, 0));
+  holder.audioChannelFormat->add(makeBlock(1.0f, 1));
+
+  SECTION("new block only") {
+    auto frame = document->deepCopy();
+    auto channelFormat =
+        frame->lookup(holder.audioChannelFormat->get<AudioChannelFormatId>());
+    channelFormat->add(makeBlock(3.0f, 2));
+    REQUIRE(statusOf(computeChangedIds(document, frame), channelFormat) ==
+            ChangedIdStatus::EXTENDED);
+  }
+
+  SECTION("changed block and new block") {
+    // the existing block has the same ID, but a different hash
+    auto frame = document->deepCopy();
+    auto channelFormat =
+        frame->lookup(holder.audioChannelFormat->get<AudioChannelFormatId>());
+    auto blocks = channelFormat->getElements<AudioBlockFormatObjects>();
+    blocks[1].set(SphericalPosition{Azimuth{2.0f}});
+    channelFormat->add(makeBlock(3.0f, 2));
+    REQUIRE(statusOf(computeChangedIds(document, frame), channelFormat) ==
+            ChangedIdStatus::CHANGED);
+  }
+
+  SECTION("changed block only") {
+    auto frame = document->deepCopy();
+    auto channelFormat =
+        frame->lookup(holder.audioChannelFormat->get<AudioChannelFormatId>());
+    channelFormat->getElements<AudioBlockFormatObjects>()[1].set(
+        SphericalPosition{Azimuth{2.0f}});
+    REQUIRE(statusOf(computeChangedIds(document, frame), channelFormat) ==
+            ChangedIdStatus::CHANGED);
+  }
+
+  SECTION("removed block") {
+    auto frame = document->deepCopy();
+    auto channelFormat =
+        frame->lookup(holder.audioChannelFormat->get<AudioChannelFormatId>());
+    auto lastBlock = channelFormat->getElements<AudioBlockFormatObjects>()[1];
+    channelFormat->clearAudioBlockFormats();
+    channelFormat->add(lastBlock);
+    channelFormat->add(makeBlock(3.0f, 2));
+    REQUIRE(statusOf(computeChangedIds(document, frame), channelFormat) ==
+            ChangedIdStatus::CHANGED);
+  }
+
+  SECTION("changed parameters") {
+    auto frame = document->deepCopy();
+    auto channelFormat =
+        frame->lookup(holder.audioChannelFormat->get<AudioChannelFormatId>());
+    channelFormat->set(AudioChannelFormatName("renamed"));
+    channelFormat->add(makeBlock(3.0f, 2));
+    REQUIRE(statusOf(computeChangedIds(document, frame), channelFormat) ==
+            ChangedIdStatus::CHANGED);
+  }
+}
+
+TEST_CASE("changed_ids_differ/frame_applier") {
+  // changedIDs from the differ can be used to apply full frames
+  auto first = Document::create();
+  auto kept = addSimpleObjectTo(first, "kept");
+  auto removed = addSimpleObjectTo(first, "removed");
+
+  auto second = first->deepCopy();
+  second->lookup(kept.audioObject->get<AudioObjectId>())
+      ->set(AudioObjectName("renamed"));
+  second->remove(second->lookup(removed.audioObject->get<AudioObjectId>()));
+  addSimpleObjectTo(second, "added");
+
+  FrameHeader header{FrameFormat{FrameFormatId{FrameIndex{2}}, Start{1s},
+                                 Duration{1s}, FrameType::INTERMEDIATE}};
+  auto frameFormat = header.get<FrameFormat>();
+  frameFormat.set(computeChangedIds(first, second));
+  header.set(frameFormat);
+
+  FrameApplier applier(first->deepCopy());
+  applier.apply(second, header);
+  REQUIRE(toXml(applier.getDocument()) == toXml(second));
+}
@@ -0,0 +1,220 @@
+#include <catch2/catch.hpp>
+#include <string>
+#include "adm/document.hpp"
+#include "adm/serial/frame_applier.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "helper/document_fixtures.hpp"
+
+using namespace adm;
+using namespace adm_test;
+
+namespace {
+  using namespace std::chrono_literals;
+
+  /// the IDs of everything in holder, with status
+  void addChanges(ChangedIds& changedIds, const SimpleObjectHolder& holder,
+                  ChangedIdStatus status) {
+    changedIds.add(holder.audioObject, status);
+    changedIds.add(holder.audioPackFormat, status);
+    changedIds.add(holder.audioChannelFormat, status);
+    changedIds.add(holder.audioStreamFormat, status);
+    changedIds.add(holder.audioTrackFormat, status);
+    changedIds.add(holder.audioTrackUid, status);
+  }
+}  // namespace
+
+TEST_CASE("frame_applier/changes") {
+  auto firstFrame = Document::create();
+  auto first = addSimpleObjectTo(firstFrame, "first");
+  auto second = addSimpleObjectTo(firstFrame, "second");
+  first.audioChannelFormat->add(makeBlock(0.0f, 0));
+
+  FrameApplier applier;
+  REQUIRE(applier.getDocument() == nullptr);
+  applier.apply(firstFrame, makeHeader(1));
+  auto document = applier.getDocument();
+  REQUIRE(document == firstFrame);
+
+  // the next frame has the whole scene, with some changes
+  auto frame = firstFrame->deepCopy();
+  ChangedIds changedIds;
+
+  auto object = frame->lookup(first.audioObject->get<AudioObjectId>());
+  object->set(AudioObjectName("first, renamed"));
+  changedIds.add(object, ChangedIdStatus::CHANGED);
+
+  auto channelFormat =
+      frame->lookup(first.audioChannelFormat->get<AudioChannelFormatId>());
+  channelFormat->add(makeBlock(10.0f, 1));
+  changedIds.add(channelFormat, ChangedIdStatus::EXTENDED);
+
+  auto third = addSimpleObjectTo(frame, "third");
+  addChanges(changedIds, third, ChangedIdStatus::NEW);
+
+  frame->remove(frame->lookup(second.audioObject->get<AudioObjectId>()));
+  changedIds.add(second.audioObject, ChangedIdStatus::EXPIRED);
+
+  applier.apply(frame, makeHeader(2, changedIds));
+
+  // the result is the same as the frame...
+  REQUIRE(applier.getDocument() == document);
+  REQUIRE(toXml(document) == toXml(frame));
+
+  // ...but the existing elements are updated in place
+  REQUIRE(document->lookup(first.audioObject->get<AudioObjectId>()) ==
+          first.audioObject);
+  REQUIRE(first.audioObject->get<AudioObjectName>() == "first, renamed");
+  REQUIRE(first.audioObject->getReferences<AudioPackFormat>()[0] ==
+          first.audioPackFormat);
+  REQUIRE(first.audioChannelFormat->getElements<AudioBlockFormatObjects>()
+              .size() == 2);
+
+  // new elements refer to elements in the document
+  auto thirdObject = document->lookup(third.audioObject->get<AudioObjectId>());
+  REQUIRE(thirdObject != third.audioObject);
+  REQUIRE(thirdObject->getReferences<AudioPackFormat>()[0] ==
+          document->lookup(third.audioPackFormat->get<AudioPackFormatId>()));
+  REQUIRE(thirdObject->getReferences<AudioTrackUid>()[0]
+              ->getReference<AudioTrackFormat>()
+              ->getParent()
+              .lock() == document);
+
+  // expired elements are removed
+  REQUIRE(document->lookup(second.audioObject->get<AudioObjectId>()) ==
+          nullptr);
+  REQUIRE(second.audioObject->getParent().lock() == nullptr);
+}
+
+TEST_CASE("frame_applier/references") {
+  auto document = Document::create();
+  auto first = addSimpleObjectTo(document, "first");
+  auto second = addSimpleObjectTo(document, "second");
+  FrameApplier applier(document);
+
+  // a changed object with different references
+  auto frame = document->deepCopy();
+  auto object = frame->lookup(first.audioObject->get<AudioObjectId>());
+  object->clearReferences<AudioPackFormat>();
+  object->addReference(
+      frame->lookup(second.audioPackFormat->get<AudioPackFormatId>()));
+  object->addReference(
+      frame->lookup(second.audioObject->get<AudioObjectId>()));
+  ChangedIds changedIds;
+  changedIds.add(object, ChangedIdStatus::CHANGED);
+  applier.apply(frame, makeHeader(2, changedIds));
+
+  REQUIRE(toXml(document) == toXml(frame));
+  REQUIRE(first.audioObject->getReferences<AudioPackFormat>().size() == 1);
+  REQUIRE(first.audioObject->getReferences<AudioPackFormat>()[0] ==
+          second.audioPackFormat);
+  REQUIRE(first.audioObject->getReferences<AudioObject>()[0] ==
+          second.audioObject);
+
+  // removing a referenced element removes the reference
+  ChangedIds expired;
+  expired.add(second.audioObject, ChangedIdStatus::EXPIRED);
+  applier.apply(Document::create(), makeHeader(3, expired));
+  REQUIRE(first.audioObject->getReferences<AudioObject>().size() == 0);
+}
+
+TEST_CASE("frame_applier/extended_blocks") {
+  auto document = Document::create();
+  auto holder = addSimpleObjectTo(document, "object");
+  holder.audioChannelFormat->add(makeBlock(0.0f, 0));
+  holder.audioChannelFormat->add(makeBlock(1.0f, 1));
+  FrameApplier applier(document);
+
+  // the frame only has the last block (which has been changed) and a new
+  // block
+  auto frame = document->deepCopy();
+  auto channelFormat =
+      frame->lookup(holder.audioChannelFormat->get<AudioChannelFormatId>());
+  auto blocks = channelFormat->getElements<AudioBlockFormatObjects>();
+  auto lastBlock = blocks[1];
+  channelFormat->clearAudioBlockFormats();
+  lastBlock.set(SphericalPosition{Azimuth{2.0f}});
+  channelFormat->add(lastBlock);
+  channelFormat->add(makeBlock(3.0f, 2));
+
+  ChangedIds changedIds;
+  changedIds.add(channelFormat, ChangedIdStatus::EXTENDED);
+  applier.apply(frame, makeHeader(2, changedIds));
+
+  auto result =
+      holder.audioChannelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(result.size() == 3);
+  REQUIRE(result[0].get<SphericalPosition>().get<Azimuth>() == 0.0f);
+  REQUIRE(result[1].get<SphericalPosition>().get<Azimuth>() == 2.0f);
+  REQUIRE(result[2].get<SphericalPosition>().get<Azimuth>() == 3.0f);
+  REQUIRE(result[2].get<AudioBlockFormatId>() ==
+          channelFormat->getElements<AudioBlockFormatObjects>()[1]
+              .get<AudioBlockFormatId>());
+}
+
+TEST_CASE("frame_applier/extended_blocks_with_gap") {
+  auto document = Document::create();
+  auto holder = addSimpleObjectTo(document, "object");
+  holder.audioChannelFormat->add(makeBlock(0.0f, 0));
+  holder.audioChannelFormat->add(makeBlock(1.0f, 1));
+  FrameApplier applier(document);
+
+  // the frame has blocks 5 and 6, so blocks 3 and 4 were missed
+  auto frame = document->deepCopy();
+  auto channelFormatId = holder.audioChannelFormat->get<AudioChannelFormatId>();
+  auto channelFormat = frame->lookup(channelFormatId);
+  channelFormat->clearAudioBlockFormats();
+  for (unsigned counter = 5; counter != 7; ++counter) {
+    auto block = makeBlock(static_cast<float>(counter), counter - 1);
+    block.set(AudioBlockFormatId(
+        TypeDefinition::OBJECTS,
+        AudioBlockFormatIdValue(
+            channelFormatId.get<AudioChannelFormatIdValue>().get()),
+        AudioBlockFormatIdCounter(counter)));
+    channelFormat->add(block);
+  }
+  auto object = frame->lookup(holder.audioObject->get<AudioObjectId>());
+  object->set(AudioObjectName("renamed"));
+
+  ChangedIds changedIds;
+  changedIds.add(object, ChangedIdStatus::CHANGED);
+  changedIds.add(channelFormat, ChangedIdStatus::EXTENDED);
+  applier.apply(frame, makeHeader(2, changedIds));
+
+  // the blocks in the frame replace those in the document
+  auto result =
+      holder.audioChannelFormat->getElements<AudioBlockFormatObjects>();
+  REQUIRE(result.size() == 2);
+  REQUIRE(result[0]
+              .get<AudioBlockFormatId>()
+              .get<AudioBlockFormatIdCounter>()
+              .get() == 5u);
+  REQUIRE(result[1].get<SphericalPosition>().get<Azimuth>() == 6.0f);
+  REQUIRE(holder.audioObject->get<AudioObjectName>() == "renamed");
+}
+
+TEST_CASE("frame_applier/full_frames_and_errors") {
+  auto document = Document::create();
+  auto holder = addSimpleObjectTo(document, "object");
+  FrameApplier applier(document);
+
+  // a changed element must be in the frame
+  ChangedIds changedIds;
+  changedIds.add(holder.audioObject, ChangedIdStatus::CHANGED);
+  REQUIRE_THROWS_AS(
+      applier.apply(Document::create(), makeHeader(2, changedIds)),
+      std::runtime_error);
+
+  // references must be to elements in the document or frame
+  auto frame = Document::create();
+  addSimpleObjectTo(frame, "object");
+  auto other = addSimpleObjectTo(frame, "other");
+  ChangedIds newObject;
+  newObject.add(other.audioObject, ChangedIdStatus::NEW);
+  REQUIRE_THROWS_AS(applier.apply(frame, makeHeader(2, newObject)),
+                    std::runtime_error);
+
+  // a frame without changedIDs replaces the document
+  auto fullFrame = Document::create();
+  applier.apply(fullFrame, makeHeader(3));
+  REQUIRE(applier.getDocument() == fullFrame);
+}
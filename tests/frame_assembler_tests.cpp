@@ -0,0 +1,119 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include "adm/document.hpp"
+#include "adm/parse.hpp"
+#include "adm/serial/frame_assembler.hpp"
+#include "adm/serial/frame_generator.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/document_fixtures.hpp"
+
+using namespace adm;
+using namespace adm_test;
+
+namespace {
+  using namespace std::chrono_literals;
+
+  std::shared_ptr<Document> makeProgramme() {
+    auto document = Document::create();
+    auto programme = AudioProgramme::create(AudioProgrammeName("programme"));
+    auto content = AudioContent::create(AudioContentName("content"));
+    programme->addReference(content);
+    document->add(programme);
+    for (auto name : {"first", "second"}) {
+      auto holder = addSimpleObjectTo(document, name);
+      content->addReference(holder.audioObject);
+      for (int i = 0; i != 5; ++i) {
+        holder.audioChannelFormat->add(AudioBlockFormatObjects(
+            SphericalPosition{Azimuth{static_cast<float>(i)}},
+            Rtime{i * 400ms}, Duration{400ms}));
+      }
+    }
+    return document;
+  }
+}  // namespace
+
+TEST_CASE("frame_assembler/round_trip") {
+  auto document = makeProgramme();
+
+  FrameAssembler assembler;
+  FrameGenerator generator(document, 1s);
+  while (generator.hasNext()) {
+    auto frame = generator.next();
+    assembler.add(frame.document, frame.header);
+  }
+
+  // split blocks are merged, so the result is the same as the original
+  REQUIRE(toXml(assembler.getDocument()) == toXml(document));
+}
+
+TEST_CASE("frame_assembler/round_trip_xml") {
+  auto document = makeProgramme();
+
+  FrameAssembler assembler;
+  FrameGenerator generator(document, 600ms);
+  while (generator.hasNext()) {
+    std::stringstream xml;
+    generator.writeNext(xml);
+    auto header = parseFrameHeader(xml);
+    xml.seekg(0);
+    assembler.add(parseXml(xml, header), header);
+  }
+
+  REQUIRE(toXml(assembler.getDocument()) == toXml(document));
+}
+
+TEST_CASE("frame_assembler/structure_changes") {
+  auto firstFrame = Document::create();
+  auto content = AudioContent::create(AudioContentName("content"));
+  firstFrame->add(content);
+  auto first = addSimpleObjectTo(firstFrame, "first");
+  content->addReference(first.audioObject);
+  first.audioChannelFormat->add(AudioBlockFormatObjects(
+      SphericalPosition{}, Rtime{0s}, Duration{1s}));
+
+  FrameAssembler assembler;
+  assembler.add(firstFrame, makeHeader(1));
+
+  // the second frame has another object, and no blocks for the first
+  auto secondFrame = firstFrame->deepCopy();
+  secondFrame->lookup(first.audioChannelFormat->get<AudioChannelFormatId>())
+      ->clearAudioBlockFormats();
+  auto second = addSimpleObjectTo(secondFrame, "second");
+  secondFrame->lookup(content->get<AudioContentId>())
+      ->addReference(second.audioObject);
+  second.audioChannelFormat->add(AudioBlockFormatObjects(
+      SphericalPosition{}, Rtime{500ms}, Duration{500ms}));
+  assembler.add(secondFrame, makeHeader(2));
+
+  // the third frame only has the second object, whose block continues
+  auto thirdFrame = secondFrame->deepCopy();
+  thirdFrame->remove(
+      thirdFrame->lookup(first.audioObject->get<AudioObjectId>()));
+  auto thirdChannel = thirdFrame->lookup(
+      second.audioChannelFormat->get<AudioChannelFormatId>());
+  auto block = thirdChannel->getElements<AudioBlockFormatObjects>()[0];
+  block.set(Rtime{0s});
+  thirdChannel->clearAudioBlockFormats();
+  thirdChannel->add(block);
+  assembler.add(thirdFrame, makeHeader(3));
+
+  auto result = assembler.getDocument();
+  auto resultContent = result->lookup(content->get<AudioContentId>());
+  REQUIRE(resultContent->getReferences<AudioObject>().size() == 2);
+  REQUIRE(result->lookup(first.audioObject->get<AudioObjectId>()));
+
+  auto firstBlocks =
+      result->lookup(first.audioChannelFormat->get<AudioChannelFormatId>())
+          ->getElements<AudioBlockFormatObjects>();
+  REQUIRE(firstBlocks.size() == 1);
+
+  // the block was split between the second and third frames
+  auto secondBlocks =
+      result->lookup(second.audioChannelFormat->get<AudioChannelFormatId>())
+          ->getElements<AudioBlockFormatObjects>();
+  REQUIRE(secondBlocks.size() == 1);
+  REQUIRE(secondBlocks[0].get<Rtime>().get().asNanoseconds() == 1500ms);
+  REQUIRE(secondBlocks[0].get<Duration>().get().asNanoseconds() == 1s);
+}
@@ -0,0 +1,148 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <string>
+#include "adm/document.hpp"
+#include "adm/serial/frame_generator.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "helper/document_fixtures.hpp"
+
+using namespace adm;
+using namespace adm_test;
+
+namespace {
+  using namespace std::chrono_literals;
+
+  std::shared_ptr<AudioChannelFormat> channelOf(
+      const GeneratedFrame& frame, const SimpleObjectHolder& holder) {
+    return frame.document->lookup(
+        holder.audioChannelFormat->get<AudioChannelFormatId>());
+  }
+}  // namespace
+
+TEST_CASE("frame_generator/blocks") {
+  auto document = Document::create();
+  auto holder = addSimpleObjectTo(document, "object");
+  for (int i = 0; i != 5; ++i) {
+    holder.audioChannelFormat->add(
+        makeBlock(static_cast<float>(i), i * 400ms, 400ms));
+  }
+  auto blocks =
+      holder.audioChannelFormat->getElements<AudioBlockFormatObjects>();
+
+  FrameGenerator generator(document, 1s);
+  REQUIRE(generator.hasNext());
+  auto first = generator.next();
+  REQUIRE(generator.hasNext());
+  auto second = generator.next();
+  REQUIRE_FALSE(generator.hasNext());
+  REQUIRE_THROWS_AS(generator.next(), std::runtime_error);
+
+  auto firstFormat = first.header.get<FrameFormat>();
+  REQUIRE(firstFormat.get<FrameFormatId>().get<FrameIndex>() == 1u);
+  REQUIRE(firstFormat.get<Start>().get().asNanoseconds() == 0s);
+  REQUIRE(firstFormat.get<Duration>().get().asNanoseconds() == 1s);
+  REQUIRE(firstFormat.get<FrameType>() == FrameType::FULL);
+  REQUIRE(firstFormat.get<TimeReference>() == TimeReference::LOCAL);
+  auto secondFormat = second.header.get<FrameFormat>();
+  REQUIRE(secondFormat.get<FrameFormatId>().get<FrameIndex>() == 2u);
+  REQUIRE(secondFormat.get<Start>().get().asNanoseconds() == 1s);
+
+  // the third block is split between the frames
+  auto firstBlocks =
+      channelOf(first, holder)->getElements<AudioBlockFormatObjects>();
+  REQUIRE(firstBlocks.size() == 3);
+  REQUIRE(firstBlocks[2].get<AudioBlockFormatId>() ==
+          blocks[2].get<AudioBlockFormatId>());
+  REQUIRE(firstBlocks[2].get<Rtime>().get().asNanoseconds() == 800ms);
+  REQUIRE(firstBlocks[2].get<Duration>().get().asNanoseconds() == 200ms);
+
+  auto secondBlocks =
+      channelOf(second, holder)->getElements<AudioBlockFormatObjects>();
+  REQUIRE(secondBlocks.size() == 3);
+  REQUIRE(secondBlocks[0].get<AudioBlockFormatId>() ==
+          blocks[2].get<AudioBlockFormatId>());
+  REQUIRE(secondBlocks[0].get<Rtime>().get().asNanoseconds() == 0ms);
+  REQUIRE(secondBlocks[0].get<Duration>().get().asNanoseconds() == 200ms);
+  REQUIRE(secondBlocks[1].get<Rtime>().get().asNanoseconds() == 200ms);
+  REQUIRE(secondBlocks[2].get<Rtime>().get().asNanoseconds() == 600ms);
+  REQUIRE(secondBlocks[2].get<Duration>().get().asNanoseconds() == 400ms);
+  REQUIRE(secondBlocks[2].get<SphericalPosition>().get<Azimuth>() == 4.0f);
+
+  // the rest of the document is in each frame, and the source is unchanged
+  REQUIRE(first.document->lookup(holder.audioObject->get<AudioObjectId>()));
+  REQUIRE(
+      second.document->lookup(holder.audioTrackUid->get<AudioTrackUidId>()));
+  REQUIRE(blocks.size() == 5);
+}
+
+TEST_CASE("frame_generator/programme_length") {
+  auto document = Document::create();
+  auto programme = AudioProgramme::create(AudioProgrammeName("programme"),
+                                          End{3s});
+  document->add(programme);
+  auto timed = addSimpleObjectTo(document, "timed");
+  timed.audioChannelFormat->add(makeBlock(0.0f, 0s, 1s));
+  auto untimed = addSimpleObjectTo(document, "untimed");
+  untimed.audioChannelFormat->add(
+      AudioBlockFormatObjects(SphericalPosition{}));
+
+  FrameGenerator generator(document, FractionalTime{1, 2});
+  std::size_t frames = 0;
+  while (generator.hasNext()) {
+    auto frame = generator.next();
+    auto start = frame.header.get<FrameFormat>().get<Start>().get();
+    REQUIRE(start.isFractional());
+    REQUIRE(start.asNanoseconds() == static_cast<int>(frames) * 500ms);
+    // blocks without times are in every frame
+    REQUIRE(channelOf(frame, untimed)
+                ->getElements<AudioBlockFormatObjects>()
+                .size() == 1);
+    auto timedBlocks =
+        channelOf(frame, timed)->getElements<AudioBlockFormatObjects>();
+    REQUIRE(timedBlocks.size() == (frames < 2 ? 1u : 0u));
+    ++frames;
+  }
+  REQUIRE(frames == 6);
+}
+
+TEST_CASE("frame_generator/untimed_then_timed") {
+  auto document = Document::create();
+  auto holder = addSimpleObjectTo(document, "object");
+  holder.audioChannelFormat->add(AudioBlockFormatObjects(SphericalPosition{}));
+  for (int i = 0; i != 100; ++i) {
+    holder.audioChannelFormat->add(
+        makeBlock(static_cast<float>(i), i * 100ms, 100ms));
+  }
+
+  FrameGenerator generator(document, 1s);
+  std::size_t frames = 0;
+  while (generator.hasNext()) {
+    auto frame = generator.next();
+    auto blocks =
+        channelOf(frame, holder)->getElements<AudioBlockFormatObjects>();
+    // the untimed block ends where the first timed block starts, so only
+    // the timed blocks in each frame are included after the first
+    REQUIRE(blocks.size() == (frames == 0 ? 11u : 10u));
+    auto& first = blocks[frames == 0 ? 1 : 0];
+    REQUIRE(first.get<SphericalPosition>().get<Azimuth>() ==
+            static_cast<float>(frames * 10));
+    REQUIRE(first.get<Rtime>().get().asNanoseconds() == 0s);
+    ++frames;
+  }
+  REQUIRE(frames == 10);
+}
+
+TEST_CASE("frame_generator/write") {
+  auto document = Document::create();
+  auto holder = addSimpleObjectTo(document, "object");
+  holder.audioChannelFormat->add(makeBlock(0.0f, 0s, 2s));
+
+  FrameGenerator generator(document, 1s);
+  std::stringstream xml;
+  generator.writeNext(xml);
+  REQUIRE(xml.str().find("timeReference=\"local\"") != std::string::npos);
+  REQUIRE(xml.str().find("lstart=") != std::string::npos);
+  REQUIRE(xml.str().find("lduration=") != std::string::npos);
+
+  REQUIRE_THROWS_AS(FrameGenerator(document, 0s), std::invalid_argument);
+}
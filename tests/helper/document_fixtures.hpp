@@ -0,0 +1,69 @@
+#pragma once
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <adm/document.hpp>
+#include <adm/serial/changed_ids.hpp>
+#include <adm/serial/frame_header.hpp>
+#include <adm/write.hpp>
+
+namespace adm_test {
+
+  /// document written as XML, for comparing documents
+  inline std::string toXml(
+      const std::shared_ptr<const adm::Document>& document) {
+    std::stringstream xml;
+    adm::writeXml(xml, document);
+    return xml.str();
+  }
+
+  /// channel written as XML, in an otherwise empty document
+  inline std::string toXml(
+      const std::shared_ptr<adm::AudioChannelFormat>& channel) {
+    auto document = adm::Document::create();
+    document->add(channel);
+    return toXml(document);
+  }
+
+  /// an objects audioChannelFormat without any blocks
+  inline std::shared_ptr<adm::AudioChannelFormat> makeChannel() {
+    return adm::AudioChannelFormat::create(
+        adm::AudioChannelFormatName("channel"), adm::TypeDefinition::OBJECTS);
+  }
+
+  inline adm::AudioBlockFormatObjects makeBlock(
+      float azimuth, std::chrono::nanoseconds rtime,
+      std::chrono::nanoseconds duration) {
+    return adm::AudioBlockFormatObjects(
+        adm::SphericalPosition{adm::Azimuth{azimuth}}, adm::Rtime{rtime},
+        adm::Duration{duration});
+  }
+
+  /// the block at position index in a sequence of 500ms blocks
+  inline adm::AudioBlockFormatObjects makeBlock(float azimuth, int index) {
+    using namespace std::chrono_literals;
+    return makeBlock(azimuth, index * 500ms, 500ms);
+  }
+
+  /// the header of frame number index (from 1) of a flow of 1s frames
+  inline adm::FrameHeader makeHeader(
+      unsigned index, adm::FrameType frameType = adm::FrameType::FULL) {
+    using namespace std::chrono_literals;
+    return adm::FrameHeader{adm::FrameFormat{
+        adm::FrameFormatId{adm::FrameIndex{index}},
+        adm::Start{(index - 1) * 1s}, adm::Duration{1s}, frameType,
+        adm::TimeReference::LOCAL}};
+  }
+
+  /// the header of an intermediate frame with changedIds
+  inline adm::FrameHeader makeHeader(unsigned index,
+                                     adm::ChangedIds changedIds) {
+    auto header = makeHeader(index, adm::FrameType::INTERMEDIATE);
+    auto frameFormat = header.get<adm::FrameFormat>();
+    frameFormat.set(std::move(changedIds));
+    header.set(frameFormat);
+    return header;
+  }
+
+}  // namespace adm_test
@@ -0,0 +1,69 @@
+#include <catch2/catch.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "adm/private/parallel.hpp"
+
+using adm::detail::orderedParallelFor;
+
+TEST_CASE("ordered_parallel_for/order") {
+  for (unsigned threads : {1u, 2u, 4u, 16u}) {
+    for (std::size_t count : {0u, 1u, 2u, 1000u}) {
+      std::vector<std::size_t> consumed;
+      orderedParallelFor<std::string>(
+          count, [](std::size_t i) { return std::to_string(i * i); },
+          [&](std::size_t i, std::string&& result) {
+            REQUIRE(result == std::to_string(i * i));
+            consumed.push_back(i);
+          },
+          threads);
+      REQUIRE(consumed.size() == count);
+      for (std::size_t i = 0; i < consumed.size(); i++) {
+        REQUIRE(consumed[i] == i);
+      }
+    }
+  }
+}
+
+TEST_CASE("ordered_parallel_for/window") {
+  // results are not produced more than window ahead of consumption
+  std::atomic<std::size_t> consumedCount{0};
+  std::atomic<bool> tooFarAhead{false};
+  const std::size_t window = 3;
+  orderedParallelFor<std::size_t>(
+      200,
+      [&](std::size_t i) {
+        if (i > consumedCount + window) tooFarAhead = true;
+        return i;
+      },
+      [&](std::size_t, std::size_t&&) { ++consumedCount; }, 4, window);
+  REQUIRE(consumedCount == 200);
+  REQUIRE(!tooFarAhead);
+}
+
+TEST_CASE("ordered_parallel_for/errors") {
+  // the error from the lowest index is thrown, as it would be sequentially
+  for (unsigned threads : {1u, 4u}) {
+    std::size_t consumed = 0;
+    REQUIRE_THROWS_WITH(
+        orderedParallelFor<int>(
+            100,
+            [](std::size_t i) -> int {
+              if (i >= 10) throw std::runtime_error(std::to_string(i));
+              return 0;
+            },
+            [&](std::size_t, int&&) { ++consumed; }, threads),
+        "10");
+    REQUIRE(consumed == 10);
+
+    REQUIRE_THROWS_WITH(
+        orderedParallelFor<int>(
+            100, [](std::size_t) { return 0; },
+            [](std::size_t i, int&&) {
+              if (i == 5) throw std::runtime_error("consume");
+            },
+            threads),
+        "consume");
+  }
+}
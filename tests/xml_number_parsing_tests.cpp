@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+#include <clocale>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "adm/private/number_parsing.hpp"
+
+using namespace adm::xml::detail;
+
+namespace {
+  template <typename F>
+  auto parse(F f, const std::string& s) -> decltype(f(nullptr, nullptr)) {
+    return f(s.data(), s.data() + s.size());
+  }
+
+  /// check that f gives exactly the same result as strtof or strtod (in
+  /// the C locale), for numbers which are in range
+  template <typename F, typename Strtod>
+  void checkAgainst(F f, Strtod strtod, const std::string& s) {
+    INFO(s);
+    errno = 0;
+    auto expected = strtod(s.c_str(), nullptr);
+    if (errno == ERANGE) return;
+    auto parsed = parse(f, s);
+    if (std::isnan(expected)) {
+      REQUIRE(std::isnan(parsed));
+    } else {
+      REQUIRE(parsed == expected);
+      REQUIRE(std::signbit(parsed) == std::signbit(expected));
+    }
+  }
+
+  void checkAgainstStrtod(const std::string& s) {
+    checkAgainst(parseDouble, std::strtod, s);
+    checkAgainst(parseFloat, std::strtof, s);
+  }
+}  // namespace
+
+TEST_CASE("number_parsing/integers") {
+  REQUIRE(parse(parseInt, "0") == 0);
+  REQUIRE(parse(parseInt, "42") == 42);
+  REQUIRE(parse(parseInt, " \n-17") == -17);
+  REQUIRE(parse(parseInt, "+5") == 5);
+  REQUIRE(parse(parseInt, "12abc") == 12);
+  REQUIRE(parse(parseInt, "3.7") == 3);
+  REQUIRE(parse(parseInt, "2147483647") == 2147483647);
+  REQUIRE(parse(parseInt, "-2147483648") == -2147483647 - 1);
+  REQUIRE_THROWS_AS(parse(parseInt, "2147483648"), std::out_of_range);
+  REQUIRE_THROWS_AS(parse(parseInt, "-2147483649"), std::out_of_range);
+  REQUIRE_THROWS_AS(parse(parseInt, "99999999999999999999999"),
+                    std::out_of_range);
+  REQUIRE_THROWS_AS(parse(parseInt, ""), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse(parseInt, "-"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse(parseInt, "x1"), std::invalid_argument);
+
+  REQUIRE(parse(parseUnsigned, "4294967295") == 4294967295u);
+  REQUIRE_THROWS_AS(parse(parseUnsigned, "4294967296"), std::out_of_range);
+  REQUIRE_THROWS_AS(parse(parseUnsigned, "-1"), std::out_of_range);
+
+  // the range end is respected
+  std::string s = "123";
+  REQUIRE(parseInt(s.data(), s.data() + 2) == 12);
+}
+
+TEST_CASE("number_parsing/floating_point") {
+  for (auto s :
+       {"0", "-0", "0.0", "1", "-1", "0.5", "30.0", "-22.5", "1.", ".5",
+        "  0.25", "1e3", "1E-3", "1e+2", "2.5e", "1e-", "7.5abc", "0.1",
+        "0.2", "0.3", "3.14159265358979323846", "1e22", "1e23", "1e-22",
+        "1e-23", "9007199254740993", "123456789012345678901234567890",
+        "0.000000000000000000000000000001", "1e308", "4.9e-324", "inf",
+        "-Infinity", "nan", "340282346638528859811704183484516925440",
+        "1.00000005960464477539062500", "1.000000059604644775390625001",
+        "0.30000001192092895507812500"}) {
+    checkAgainstStrtod(s);
+  }
+
+  REQUIRE_THROWS_AS(parse(parseDouble, ""), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse(parseDouble, "."), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse(parseDouble, "-e5"), std::invalid_argument);
+  REQUIRE_THROWS_AS(parse(parseDouble, "1e400"), std::out_of_range);
+  REQUIRE_THROWS_AS(parse(parseFloat, "1e40"), std::out_of_range);
+}
+
+TEST_CASE("number_parsing/random") {
+  std::mt19937 rng(1234);
+  std::uniform_int_distribution<int> digitsDist(1, 20);
+  std::uniform_int_distribution<int> digitDist(0, 9);
+  std::uniform_int_distribution<int> exponentDist(-40, 40);
+  for (int i = 0; i < 100000; i++) {
+    std::string s;
+    if (digitDist(rng) < 5) s += '-';
+    int digits = digitsDist(rng);
+    int point = std::uniform_int_distribution<int>(0, digits)(rng);
+    for (int d = 0; d < digits; d++) {
+      if (d == point) s += '.';
+      s += static_cast<char>('0' + digitDist(rng));
+    }
+    if (digitDist(rng) < 3) s += "e" + std::to_string(exponentDist(rng));
+    checkAgainstStrtod(s);
+  }
+}
+
+TEST_CASE("number_parsing/locale_independent") {
+  // std::stod would stop at the '.' in locales which use ','
+  bool changed = false;
+  for (auto name : {"de_DE.UTF-8", "de_DE.utf8", "fr_FR.UTF-8", "de_DE"}) {
+    if (std::setlocale(LC_ALL, name)) {
+      changed = true;
+      break;
+    }
+  }
+  if (!changed) WARN("no locale with ',' decimal separator available");
+  REQUIRE(parse(parseDouble, "1.5") == 1.5);
+  REQUIRE(parse(parseFloat, "-0.25") == -0.25f);
+  REQUIRE(parse(parseDouble, "1.2345678901234567890123") ==
+          1.2345678901234567);
+  std::setlocale(LC_ALL, "C");
+}
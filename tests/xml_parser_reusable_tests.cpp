@@ -0,0 +1,166 @@
+#include <catch2/catch.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+#include "adm/common_definitions.hpp"
+#include "adm/document.hpp"
+#include "adm/errors.hpp"
+#include "adm/parse.hpp"
+#include "adm/serial.hpp"
+#include "adm/utilities/object_creation.hpp"
+#include "adm/write.hpp"
+#include "helper/document_fixtures.hpp"
+
+// count the allocations made by the code under test by replacing the global
+// allocation functions for this executable
+namespace {
+  struct AllocationStats {
+    std::size_t count = 0;
+    std::size_t bytes = 0;
+    std::size_t largest = 0;
+  };
+
+  bool counting = false;
+  AllocationStats stats;
+
+  /// the allocations made while calling f
+  template <typename F>
+  AllocationStats countAllocations(F f) {
+    stats = AllocationStats();
+    counting = true;
+    f();
+    counting = false;
+    return stats;
+  }
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (counting) {
+    stats.count++;
+    stats.bytes += size;
+    stats.largest = std::max(stats.largest, size);
+  }
+  if (void* memory = std::malloc(size ? size : 1)) return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept { std::free(memory); }
+void operator delete(void* memory, std::size_t) noexcept {
+  std::free(memory);
+}
+
+using namespace adm;
+using namespace adm_test;
+
+namespace {
+  using namespace std::chrono_literals;
+
+  FrameHeader makeHeader() {
+    return FrameHeader{FrameFormat{FrameFormatId{FrameIndex{1}}, Start{0s},
+                                   Duration{1s}, FrameType::FULL}};
+  }
+
+  /// a serial ADM frame with some objects, each with some blocks
+  std::string makeFrame(int objects, int blocks) {
+    auto document = Document::create();
+    for (int i = 0; i < objects; i++) {
+      auto holder =
+          addSimpleObjectTo(document, "object " + std::to_string(i));
+      for (int b = 0; b < blocks; b++) {
+        holder.audioChannelFormat->add(AudioBlockFormatObjects(
+            SphericalPosition{Azimuth{static_cast<float>(i + b)}},
+            Rtime{b * 1s / blocks}, Duration{1s / blocks}));
+      }
+    }
+    std::stringstream xml;
+    writeXml(xml, document, makeHeader());
+    return xml.str();
+  }
+}  // namespace
+
+TEST_CASE("reusable_parser/same_result") {
+  ReusableParser parser;
+  auto header = makeHeader();
+  // documents of different sizes in turn, and an error part way through
+  for (auto frame : {makeFrame(4, 2), makeFrame(32, 8), makeFrame(1, 1),
+                     std::string("<frame>"), makeFrame(16, 4)}) {
+    std::shared_ptr<Document> expected;
+    try {
+      expected = parseXml(frame.data(), frame.size());
+    } catch (const std::exception&) {
+      REQUIRE_THROWS(parser.parse(frame.data(), frame.size()));
+      continue;
+    }
+    REQUIRE(toXml(parser.parse(frame.data(), frame.size())) ==
+            toXml(expected));
+
+    std::istringstream stream(frame);
+    REQUIRE(toXml(parser.parse(stream, header)) == toXml(expected));
+  }
+
+  // the unresolved reference errors are the same as parseXml
+  std::istringstream unresolved(
+      "<frame><audioFormatExtended><audioObject audioObjectID=\"AO_1001\" "
+      "audioObjectName=\"x\"><audioPackFormatIDRef>AP_00031002"
+      "</audioPackFormatIDRef></audioObject></audioFormatExtended></frame>");
+  REQUIRE_THROWS_AS(parser.parse(unresolved),
+                    error::XmlParsingUnresolvedReference);
+
+  // the returned documents do not depend on the parser
+  auto frame = makeFrame(2, 2);
+  auto document = parser.parse(frame.data(), frame.size());
+  auto expected = toXml(document);
+  parser.parse(frame.data(), frame.size());
+  REQUIRE(toXml(document) == expected);
+}
+
+TEST_CASE("reusable_parser/allocations") {
+  // large enough that the rapidxml node pool needs dynamic blocks
+  auto frame = makeFrame(32, 8);
+  auto header = makeHeader();
+
+  // the streams are made outside of countAllocations, as they copy frame
+  std::istringstream parseXmlStream(frame);
+  auto parseXmlStats =
+      countAllocations([&]() { parseXml(parseXmlStream, header); });
+  if (parseXmlStats.count == 0) {
+    WARN("allocations can not be counted on this platform");
+    return;
+  }
+
+  ReusableParser parser;
+  auto parse = [&]() {
+    std::istringstream stream(frame);
+    return countAllocations([&]() { parser.parse(stream, header); });
+  };
+  // the first parses grow the buffers, pool and tables
+  parse();
+  parse();
+  auto reusableStats = parse();
+
+  // once warmed up, each parse allocates the same (just the document)
+  REQUIRE(parse().count == reusableStats.count);
+  REQUIRE(reusableStats.count < parseXmlStats.count);
+
+  // parseXml allocates a buffer at least the size of the input, and pool
+  // blocks for the XML nodes; the reusable parser allocates neither, so
+  // there are no large allocations and less memory is allocated in total
+  REQUIRE(parseXmlStats.largest >= frame.size());
+  REQUIRE(reusableStats.largest < 64 * 1024);
+  REQUIRE(reusableStats.bytes + frame.size() < parseXmlStats.bytes);
+
+  // parsing a smaller document does not need any new storage either
+  auto small = makeFrame(4, 2);
+  auto smallStats = countAllocations([&]() {
+    parser.parse(small.data(), small.size(), header);
+  });
+  auto expectedSmallStats = countAllocations([&]() {
+    ReusableParser other;
+    other.parse(small.data(), small.size(), header);
+  });
+  REQUIRE(smallStats.largest < 64 * 1024);
+  REQUIRE(smallStats.count < expectedSmallStats.count);
+}
@@ -0,0 +1,247 @@
+#include <catch2/catch.hpp>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include "adm/common_definitions.hpp"
+#include "adm/document.hpp"
+#include "adm/elements.hpp"
+#include "adm/errors.hpp"
+#include "adm/parse.hpp"
+#include "adm/write.hpp"
+#include "helper/document_fixtures.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define ADM_TEST_HAVE_GETRUSAGE
+#endif
+
+namespace {
+  struct CountingHandler : adm::xml::StreamingParserHandler {
+    using adm::xml::StreamingParserHandler::element;
+    using adm::xml::StreamingParserHandler::blockFormat;
+
+    void element(const std::shared_ptr<adm::AudioObject>&) override {
+      ++objects;
+    }
+    void element(const std::shared_ptr<adm::AudioChannelFormat>&
+                     channelFormat) override {
+      ++channelFormats;
+      lastChannelFormat = channelFormat;
+    }
+    bool blockFormat(const std::shared_ptr<adm::AudioChannelFormat>&,
+                     adm::AudioBlockFormatObjects&) override {
+      ++blocks;
+      return consumeBlocks;
+    }
+
+    bool consumeBlocks = false;
+    std::size_t objects = 0;
+    std::size_t channelFormats = 0;
+    std::size_t blocks = 0;
+    std::shared_ptr<adm::AudioChannelFormat> lastChannelFormat;
+  };
+
+  /// generates a document with one audioChannelFormat containing at least
+  /// size bytes of audioBlockFormats, without storing it
+  class SyntheticDocumentBuf : public std::streambuf {
+   public:
+    explicit SyntheticDocumentBuf(std::size_t size) : size_(size) {
+      chunk_ =
+          "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+          "<ebuCoreMain><coreMetadata><format><audioFormatExtended>\n"
+          "<audioChannelFormat audioChannelFormatID=\"AC_00031001\" "
+          "audioChannelFormatName=\"big\">\n";
+      setg(&chunk_[0], &chunk_[0], &chunk_[0] + chunk_.size());
+    }
+
+    std::size_t blocks() const { return blocks_; }
+
+   protected:
+    int_type underflow() override {
+      if (done_) return traits_type::eof();
+      chunk_.clear();
+      while (chunk_.size() < 64 * 1024 && generated_ < size_) {
+        char block[256];
+        int length = std::snprintf(
+            block, sizeof(block),
+            "<audioBlockFormat audioBlockFormatID=\"AB_00031001_%08x\">"
+            "<position coordinate=\"azimuth\">30.0</position>"
+            "<position coordinate=\"elevation\">0.0</position>"
+            "<gain>0.5</gain></audioBlockFormat>\n",
+            static_cast<unsigned>(++blocks_));
+        chunk_.append(block, static_cast<std::size_t>(length));
+        generated_ += static_cast<std::size_t>(length);
+      }
+      if (generated_ >= size_) {
+        chunk_ +=
+            "<frequency typeDefinition=\"lowPass\">120</frequency>\n"
+            "</audioChannelFormat>\n"
+            "</audioFormatExtended></format></coreMetadata></ebuCoreMain>\n";
+        done_ = true;
+      }
+      setg(&chunk_[0], &chunk_[0], &chunk_[0] + chunk_.size());
+      return traits_type::to_int_type(chunk_[0]);
+    }
+
+   private:
+    std::size_t size_;
+    std::size_t generated_ = 0;
+    std::size_t blocks_ = 0;
+    bool done_ = false;
+    std::string chunk_;
+  };
+
+#ifdef ADM_TEST_HAVE_GETRUSAGE
+  /// peak resident set size of this process in bytes
+  std::size_t peakRss() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+  }
+#endif
+}  // namespace
+
+TEST_CASE("xml_parser/streaming_same_as_parse") {
+  using namespace adm;
+  for (auto filename : {"xml_parser/audio_block_format_objects.xml",
+                        "xml_parser/audio_channel_format.xml",
+                        "xml_parser/audio_object.xml",
+                        "xml_parser/labels.xml",
+                        "xml_parser/with_common_definitions.xml",
+                        "xml_parser/find_audio_format_extended_ebu.xml"}) {
+    SECTION(filename) {
+      auto expected = parseXml(filename);
+      std::ifstream stream(filename);
+      CountingHandler handler;
+      auto document = parseXmlStreaming(stream, handler);
+      REQUIRE(adm_test::toXml(document) == adm_test::toXml(expected));
+      REQUIRE(handler.objects ==
+              document->getElements<AudioObject>().size());
+    }
+  }
+
+  SECTION("recursive_node_search") {
+    auto options = xml::ParserOptions::recursive_node_search;
+    auto filename = "xml_parser/find_audio_format_extended_itu.xml";
+    auto expected = parseXml(filename, options);
+    std::ifstream stream(filename);
+    xml::StreamingParserHandler handler;
+    REQUIRE(adm_test::toXml(parseXmlStreaming(stream, handler, options)) ==
+            adm_test::toXml(expected));
+  }
+
+  SECTION("markup") {
+    // attribute values containing '>', comments and CDATA
+    std::string xml =
+        "<?xml version=\"1.0\"?>\n"
+        "<!DOCTYPE ebuCoreMain [ <!ENTITY e \"<x>\"> ]>\n"
+        "<ebuCoreMain><!-- <audioFormatExtended> -->\n"
+        "<coreMetadata><format>"
+        "<audioFormatExtended version=\"ITU-R_BS.2076-2\">"
+        "<audioObject audioObjectID=\"AO_1001\" audioObjectName=\"a > b\">"
+        "<!-- </audioObject> --><![CDATA[</audioObject>]]></audioObject>"
+        "<audioChannelFormat audioChannelFormatID=\"AC_00031001\" "
+        "audioChannelFormatName='x'><audioBlockFormat>"
+        "<position coordinate=\"azimuth\">0</position>"
+        "<position coordinate=\"elevation\">0</position>"
+        "</audioBlockFormat>"
+        "<!-- <frequency typeDefinition=\"lowPass\">1</frequency> -->"
+        "<frequency typeDefinition=\"lowPass\">120</frequency>"
+        "</audioChannelFormat>"
+        "</audioFormatExtended></format></coreMetadata></ebuCoreMain>";
+    std::istringstream expectedStream(xml);
+    auto expected = parseXml(expectedStream);
+    std::istringstream stream(xml);
+    CountingHandler handler;
+    auto document = parseXmlStreaming(stream, handler);
+    REQUIRE(adm_test::toXml(document) == adm_test::toXml(expected));
+    auto object = document->lookup(parseAudioObjectId("AO_1001"));
+    REQUIRE(object->get<AudioObjectName>() == "a > b");
+    REQUIRE(handler.blocks == 1);
+    REQUIRE(handler.lastChannelFormat->has<Frequency>());
+  }
+}
+
+TEST_CASE("xml_parser/streaming_consume_blocks") {
+  using namespace adm;
+  std::ifstream stream("xml_parser/audio_block_format_objects.xml");
+  CountingHandler handler;
+  handler.consumeBlocks = true;
+  auto document = parseXmlStreaming(stream, handler);
+
+  REQUIRE(handler.blocks > 0);
+  REQUIRE(handler.channelFormats == 1);
+  auto channelFormat = handler.lastChannelFormat;
+  REQUIRE(document->lookup(channelFormat->get<AudioChannelFormatId>()) ==
+          channelFormat);
+  REQUIRE(channelFormat->getElements<AudioBlockFormatObjects>().empty());
+}
+
+TEST_CASE("xml_parser/streaming_errors") {
+  using namespace adm;
+  xml::StreamingParserHandler handler;
+  {
+    std::istringstream stream("");
+    REQUIRE_THROWS_AS(parseXmlStreaming(stream, handler),
+                      error::XmlParsingError);
+  }
+  {
+    std::istringstream stream("<ebuCoreMain></ebuCoreMain>");
+    REQUIRE_THROWS_AS(parseXmlStreaming(stream, handler),
+                      error::XmlParsingError);
+  }
+  {
+    std::istringstream stream(
+        "<ebuCoreMain><coreMetadata><format><audioFormatExtended>"
+        "<audioObject audioObjectID=\"AO_1001\" audioObjectName=\"a\">");
+    REQUIRE_THROWS_AS(parseXmlStreaming(stream, handler),
+                      error::XmlParsingError);
+  }
+  {
+    std::ifstream stream(
+        "xml_parser/audio_channel_format_duplicate_id.xml");
+    REQUIRE_THROWS_AS(parseXmlStreaming(stream, handler),
+                      error::XmlParsingDuplicateId);
+  }
+}
+
+/// parse a large generated document, consuming the blocks, and check that
+/// memory use does not grow with the size of the document
+///
+/// The size defaults to something which runs quickly; set
+/// ADM_STREAMING_TEST_BYTES to test with larger (e.g. multi-GB) documents.
+TEST_CASE("xml_parser/streaming_bounded_memory") {
+  using namespace adm;
+  std::size_t size = 64u << 20;
+  if (auto sizeEnv = std::getenv("ADM_STREAMING_TEST_BYTES")) {
+    size = static_cast<std::size_t>(std::strtoull(sizeEnv, nullptr, 10));
+  }
+
+  // make sure anything allocated once is already counted
+  getCommonDefinitions();
+#ifdef ADM_TEST_HAVE_GETRUSAGE
+  auto rssBefore = peakRss();
+#endif
+
+  SyntheticDocumentBuf buf(size);
+  std::istream stream(&buf);
+  CountingHandler handler;
+  handler.consumeBlocks = true;
+  auto document = parseXmlStreaming(stream, handler);
+
+  REQUIRE(handler.blocks == buf.blocks());
+  REQUIRE(handler.channelFormats == 1);
+  REQUIRE(handler.lastChannelFormat->has<Frequency>());
+#ifdef ADM_TEST_HAVE_GETRUSAGE
+  auto growth = peakRss() - rssBefore;
+  INFO("document size " << size << " bytes, peak RSS grew by " << growth);
+  REQUIRE(growth < (16u << 20));
+#endif
+}
@@ -1,8 +1,20 @@
 #include <catch2/catch.hpp>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
 #include "adm/private/rapidxml_utils.hpp"
-#include "adm/private/rapidxml_wrapper.hpp"
+#include "rapidxml/rapidxml_utils.hpp"
+#include "adm/document.hpp"
 #include "adm/errors.hpp"
 #include "adm/parse.hpp"
+#include "adm/utilities/id_assignment.hpp"
+#include "adm/write.hpp"
+#include "helper/document_fixtures.hpp"
+
+using namespace adm_test;
 
 TEST_CASE("line_number_calculation") {
   using namespace adm;
@@ -45,3 +57,349 @@ TEST_CASE("empty document") {
         error::XmlParsingError);
   }
 }
+
+TEST_CASE("parse_from_memory") {
+  using namespace adm;
+  auto filename = "xml_parser/audio_block_format_objects.xml";
+  auto expected = toXml(parseXml(filename));
+
+  std::ifstream file(filename);
+  std::string data{std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>()};
+
+  SECTION("copy") {
+    // not null-terminated
+    std::vector<char> buffer(data.begin(), data.end());
+    REQUIRE(toXml(parseXml(buffer.data(), buffer.size())) == expected);
+  }
+
+  SECTION("in situ") {
+    std::vector<char> buffer(data.begin(), data.end());
+    REQUIRE_THROWS_AS(parseXmlInSitu(buffer.data(), buffer.size() - 1),
+                      std::invalid_argument);
+    buffer.push_back('\0');
+    REQUIRE(toXml(parseXmlInSitu(buffer.data(), data.size())) == expected);
+  }
+
+  SECTION("mapped") {
+    REQUIRE(toXml(parseXmlMapped(filename)) == expected);
+    // the file is not modified by parsing in place
+    REQUIRE(toXml(parseXmlMapped(filename)) == expected);
+    REQUIRE_THROWS_AS(parseXmlMapped("xml_parser/does_not_exist.xml"),
+                      std::runtime_error);
+  }
+}
+
+namespace {
+  /// parse data with options, returning either the document written as XML
+  /// or the error
+  std::string parseToXmlOrError(const std::string& data,
+                                adm::xml::ParserOptions options) {
+    try {
+      std::stringstream xml;
+      adm::writeXml(xml, adm::parseXml(data.data(), data.size(), options));
+      return xml.str();
+    } catch (const std::exception& e) {
+      return std::string("error: ") + e.what();
+    }
+  }
+
+  std::string readFile(const std::string& filename) {
+    std::ifstream file(filename);
+    return {std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()};
+  }
+}  // namespace
+
+TEST_CASE("parse_parallel") {
+  using namespace adm;
+  auto checkSame = [](const std::string& data) {
+    auto expected = parseToXmlOrError(data, xml::ParserOptions::none);
+    REQUIRE(parseToXmlOrError(data, xml::ParserOptions::parallel) ==
+            expected);
+    return expected;
+  };
+
+  SECTION("files") {
+    for (std::string name :
+         {"audio_block_format_objects", "audio_channel_format",
+          "audio_channel_format_duplicate_id", "audio_object",
+          "audio_object_complementary_audio_objects",
+          "audio_object_duplicate_id", "audio_object_track_refs",
+          "audio_pack_format_hoa", "audio_programme_duplicate_id",
+          "audio_track_uid", "audio_track_uid_duplicate_id",
+          "audio_block_format_objects_gain_unit_error", "time_format",
+          "with_common_definitions", "unresolved_references/audio_object_1"}) {
+      INFO(name);
+      checkSame(readFile("xml_parser/" + name + ".xml"));
+    }
+  }
+
+  SECTION("large document") {
+    // enough elements to be split between several workers
+    auto document = Document::create();
+    auto programme = AudioProgramme::create(AudioProgrammeName{"p"});
+    auto content = AudioContent::create(AudioContentName{"c"});
+    programme->addReference(content);
+    document->add(programme);
+    for (int i = 0; i < 200; i++) {
+      auto object = AudioObject::create(AudioObjectName{"o"});
+      auto pack = AudioPackFormat::create(AudioPackFormatName{"p"},
+                                          TypeDefinition::OBJECTS);
+      auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                                TypeDefinition::OBJECTS);
+      for (int b = 0; b < 20; b++) {
+        channel->add(AudioBlockFormatObjects{
+            SphericalPosition{Azimuth(static_cast<float>(b))},
+            Rtime{std::chrono::milliseconds(10 * b)},
+            Duration{std::chrono::milliseconds(10)}});
+      }
+      auto trackUid = AudioTrackUid::create();
+      pack->addReference(channel);
+      trackUid->setReference(channel);
+      trackUid->setReference(pack);
+      object->addReference(pack);
+      object->addReference(trackUid);
+      content->addReference(object);
+      document->add(object);
+    }
+    std::stringstream stream;
+    writeXml(stream, document);
+    std::string data = stream.str();
+
+    REQUIRE(checkSame(data).compare(0, 6, "error:") != 0);
+
+    // duplicate IDs are reported for the same element
+    auto end = data.find("</audioFormatExtended>");
+    std::string duplicateAtEnd = data;
+    duplicateAtEnd.insert(end, "<audioTrackUID UID=\"ATU_00000001\"/>\n");
+    REQUIRE(checkSame(duplicateAtEnd).compare(0, 6, "error:") == 0);
+
+    auto start = data.find("<audioTrackUID ");
+    std::string duplicateAtStart = data;
+    duplicateAtStart.insert(start, "<audioTrackUID UID=\"ATU_00000002\"/>\n");
+    REQUIRE(checkSame(duplicateAtStart).compare(0, 6, "error:") == 0);
+
+    // and errors other than duplicate IDs
+    std::string badTime = data;
+    auto time = badTime.find("rtime=\"") + 7;
+    badTime.replace(time, 2, "xx");
+    REQUIRE(checkSame(badTime).compare(0, 6, "error:") == 0);
+  }
+}
+
+TEST_CASE("parse_lazy_block_formats") {
+  using namespace adm;
+  auto lazy = xml::ParserOptions::lazy_block_formats;
+
+  SECTION("same as eager") {
+    for (std::string name :
+         {"audio_block_format_objects", "audio_block_format_direct_speakers",
+          "audio_block_format_hoa", "audio_block_format_binaural",
+          "time_format"}) {
+      INFO(name);
+      auto data = readFile("xml_parser/" + name + ".xml");
+      auto expected = parseToXmlOrError(data, xml::ParserOptions::none);
+      REQUIRE(parseToXmlOrError(data, lazy) == expected);
+      REQUIRE(parseToXmlOrError(data, lazy | xml::ParserOptions::parallel) ==
+              expected);
+    }
+  }
+
+  SECTION("end tags in comments") {
+    auto data = readFile("xml_parser/audio_block_format_objects.xml");
+    auto end = data.rfind("</audioBlockFormat>");
+    data.insert(end, "<!-- </audioChannelFormat> -->\n");
+    data.insert(end, "<?pi </audioChannelFormat> ?>\n");
+    auto expected = parseToXmlOrError(data, xml::ParserOptions::none);
+    REQUIRE(expected.compare(0, 6, "error:") != 0);
+    REQUIRE(parseToXmlOrError(data, lazy) == expected);
+  }
+
+  SECTION("errors are reported on access") {
+    auto filename = "xml_parser/audio_block_format_objects_gain_unit_error.xml";
+    std::string expected;
+    try {
+      parseXml(filename);
+    } catch (const error::XmlParsingUnexpectedAttrError& e) {
+      expected = e.what();
+    }
+    REQUIRE(!expected.empty());
+
+    auto document = parseXml(filename, lazy);
+    auto channelFormat =
+        document->lookup(parseAudioChannelFormatId("AC_00031001"));
+    REQUIRE(channelFormat);
+    for (int i = 0; i < 2; i++) {
+      try {
+        channelFormat->getElements<AudioBlockFormatObjects>();
+        FAIL("expected an error");
+      } catch (const error::XmlParsingUnexpectedAttrError& e) {
+        REQUIRE(e.what() == expected);
+      }
+    }
+  }
+
+  SECTION("copy and add") {
+    auto filename = "xml_parser/audio_block_format_objects.xml";
+    auto id = parseAudioChannelFormatId("AC_00031001");
+    auto channelFormat = parseXml(filename, lazy)->lookup(id);
+    auto copy = channelFormat->copy();
+    auto expected = parseXml(filename)
+                        ->lookup(id)
+                        ->getElements<AudioBlockFormatObjects>()
+                        .size();
+    REQUIRE(expected == 3);
+
+    // blocks added after parsing come after the parsed blocks
+    channelFormat->add(AudioBlockFormatObjects{SphericalPosition{}});
+    auto blocks = channelFormat->getElements<AudioBlockFormatObjects>();
+    REQUIRE(blocks.size() == expected + 1);
+    auto lastCounter = blocks[expected - 1]
+                           .get<AudioBlockFormatId>()
+                           .get<AudioBlockFormatIdCounter>()
+                           .get();
+    REQUIRE(blocks[expected]
+                .get<AudioBlockFormatId>()
+                .get<AudioBlockFormatIdCounter>()
+                .get() == lastCounter + 1);
+
+    // copies load their own blocks
+    REQUIRE(copy->getElements<AudioBlockFormatObjects>().size() == expected);
+
+    auto cleared = parseXml(filename, lazy)->lookup(id);
+    cleared->clearAudioBlockFormats();
+    REQUIRE(cleared->getElements<AudioBlockFormatObjects>().empty());
+  }
+}
+
+TEST_CASE("parse_filter") {
+  using namespace adm;
+  using std::chrono::milliseconds;
+
+  auto document = Document::create();
+  for (int i = 0; i < 4; i++) {
+    auto object = AudioObject::create(AudioObjectName{"o"});
+    auto pack = AudioPackFormat::create(AudioPackFormatName{"p"},
+                                        TypeDefinition::OBJECTS);
+    auto channel = AudioChannelFormat::create(AudioChannelFormatName{"c"},
+                                              TypeDefinition::OBJECTS);
+    for (int b = 0; b < 20; b++) {
+      channel->add(AudioBlockFormatObjects{SphericalPosition{},
+                                           Rtime{milliseconds(10 * b)},
+                                           Duration{milliseconds(10)}});
+    }
+    auto trackUid = AudioTrackUid::create();
+    pack->addReference(channel);
+    trackUid->setReference(channel);
+    trackUid->setReference(pack);
+    object->addReference(pack);
+    object->addReference(trackUid);
+    document->add(object);
+  }
+  // a block without an rtime is always kept
+  auto staticChannel = AudioChannelFormat::create(
+      AudioChannelFormatName{"s"}, TypeDefinition::OBJECTS);
+  staticChannel->add(AudioBlockFormatObjects{SphericalPosition{}});
+  document->add(staticChannel);
+
+  std::stringstream stream;
+  writeXml(stream, document);
+  std::string data = stream.str();
+
+  auto channelFormats = [](const std::shared_ptr<Document>& parsed) {
+    std::vector<std::shared_ptr<AudioChannelFormat>> result;
+    for (auto& channel : parsed->getElements<AudioChannelFormat>()) {
+      if (!isCommonDefinitionsId(channel->get<AudioChannelFormatId>()))
+        result.push_back(channel);
+    }
+    return result;
+  };
+  // all ways of parsing should give the same result
+  auto parseAll = [&](const xml::ParseFilter& filter) {
+    auto parsed = parseXml(data.data(), data.size(),
+                           xml::ParserOptions::none, filter);
+    auto expected = toXml(parsed);
+    REQUIRE(toXml(parseXml(data.data(), data.size(),
+                           xml::ParserOptions::lazy_block_formats,
+                           filter)) == expected);
+    REQUIRE(toXml(parseXml(data.data(), data.size(),
+                           xml::ParserOptions::parallel, filter)) ==
+            expected);
+    std::istringstream input(data);
+    xml::StreamingParserHandler handler;
+    REQUIRE(toXml(parseXmlStreaming(input, handler,
+                                    xml::ParserOptions::none, filter)) ==
+            expected);
+    return parsed;
+  };
+
+  SECTION("no filter") {
+    auto parsed = parseAll(xml::ParseFilter{});
+    REQUIRE(toXml(parsed) == data);
+  }
+
+  SECTION("skip blocks") {
+    xml::ParseFilter filter;
+    filter.skip = xml::ElementKinds::audioBlockFormat;
+    auto parsed = parseAll(filter);
+    auto channels = channelFormats(parsed);
+    REQUIRE(channels.size() == 5);
+    for (auto& channel : channels)
+      REQUIRE(channel->getElements<AudioBlockFormatObjects>().empty());
+    REQUIRE(parsed->getElements<AudioTrackUid>().size() == 4);
+  }
+
+  SECTION("skip kinds with references to them") {
+    xml::ParseFilter filter;
+    filter.skip = xml::ElementKinds::audioTrackUid |
+                  xml::ElementKinds::audioChannelFormat;
+    auto parsed = parseAll(filter);
+    REQUIRE(parsed->getElements<AudioTrackUid>().empty());
+    REQUIRE(channelFormats(parsed).empty());
+    REQUIRE(parsed->getElements<AudioObject>().size() == 4);
+    for (auto& object : parsed->getElements<AudioObject>()) {
+      REQUIRE(object->getReferences<AudioPackFormat>().size() == 1);
+      REQUIRE(object->getReferences<AudioTrackUid>().empty());
+    }
+  }
+
+  SECTION("time window") {
+    xml::ParseFilter filter;
+    filter.blockStart = Time{milliseconds(50)};
+    filter.blockEnd = Time{milliseconds(100)};
+    auto parsed = parseAll(filter);
+    auto channels = channelFormats(parsed);
+    REQUIRE(channels.size() == 5);
+    for (std::size_t i = 0; i < 4; i++) {
+      auto blocks = channels[i]->getElements<AudioBlockFormatObjects>();
+      REQUIRE(blocks.size() == 5);
+      REQUIRE(blocks.front().get<Rtime>().get().asNanoseconds() ==
+              milliseconds(50));
+      REQUIRE(blocks.back().get<Rtime>().get().asNanoseconds() ==
+              milliseconds(90));
+      // block IDs are as in the document
+      REQUIRE(blocks.front()
+                  .get<AudioBlockFormatId>()
+                  .get<AudioBlockFormatIdCounter>()
+                  .get() == 6u);
+    }
+    REQUIRE(channels[4]->getElements<AudioBlockFormatObjects>().size() == 1);
+  }
+
+  SECTION("skipped blocks are not allocated") {
+    xml::ParseFilter filter;
+    filter.blockStart = Time{milliseconds(50)};
+    filter.blockEnd = Time{milliseconds(100)};
+    for (auto options :
+         {xml::ParserOptions::none, xml::ParserOptions::lazy_block_formats}) {
+      auto parsed = parseXml(data.data(), data.size(), options, filter);
+      for (auto& channel : channelFormats(parsed)) {
+        auto blocks = channel->getElements<AudioBlockFormatObjects>().size();
+        // space may be left for more blocks, but not for the 20 in the
+        // document
+        REQUIRE(channel->capacity() < 2 * blocks);
+      }
+    }
+  }
+}
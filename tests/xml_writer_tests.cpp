@@ -4,7 +4,18 @@
 #include "adm/utilities/id_assignment.hpp"
 #include "adm/utilities/object_creation.hpp"
 #include "adm/write.hpp"
+#include "adm/serial/frame_header.hpp"
 #include "helper/file_comparator.hpp"
+#include "rapidxml/rapidxml.hpp"
+#include "rapidxml/rapidxml_print.hpp"
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define ADM_TEST_HAVE_GETRUSAGE
+#endif
 
 std::shared_ptr<const adm::Document> createSimpleScene();
 
@@ -114,6 +125,156 @@ TEST_CASE("write_objects_silent_track_ref") {
   CHECK_THAT(xml.str(), EqualsXmlFile("write_objects_silent_track_ref"));
 }
 
+namespace {
+  /// parse xml with rapidxml and print it again
+  std::string rapidxmlReprint(const std::string& xml) {
+    std::vector<char> buffer(xml.begin(), xml.end());
+    buffer.push_back('\0');
+    rapidxml::xml_document<> document;
+    document.parse<rapidxml::parse_declaration_node>(buffer.data());
+    std::string printed;
+    rapidxml::print(std::back_inserter(printed), document);
+    return printed;
+  }
+
+#ifdef ADM_TEST_HAVE_GETRUSAGE
+  /// peak resident set size of this process in bytes
+  std::size_t peakRss() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    return static_cast<std::size_t>(usage.ru_maxrss) * 1024;
+#endif
+  }
+#endif
+
+  /// discards everything written to it, counting the characters
+  class CountingBuf : public std::streambuf {
+   public:
+    std::size_t count = 0;
+
+   protected:
+    int_type overflow(int_type c) override {
+      ++count;
+      return c;
+    }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+      count += static_cast<std::size_t>(n);
+      return n;
+    }
+  };
+}  // namespace
+
+TEST_CASE("write_escaped_strings") {
+  // the writer formats and escapes text in the same way as rapidxml
+  using namespace adm;
+  auto document = Document::create();
+  document->add(AudioProgramme::create(
+      AudioProgrammeName("\"quoted\" & <tagged>"),
+      Labels{Label("it's \"both\""), Label(""),
+             Label(LabelValue("a > b"), LabelLanguage("'en'"))}));
+  document->add(AudioObject::create(AudioObjectName("it's & <more>")));
+
+  std::stringstream xml;
+  writeXml(xml, document);
+  REQUIRE(rapidxmlReprint(xml.str()) == xml.str());
+
+  std::stringstream sadmXml;
+  FrameFormat format{FrameFormatId{FrameIndex{1}},
+                     Start{std::chrono::seconds(0)},
+                     Duration{std::chrono::seconds(1)}, FrameType::FULL};
+  writeXml(sadmXml, document, FrameHeader{format});
+  REQUIRE(rapidxmlReprint(sadmXml.str()) == sadmXml.str());
+}
+
+TEST_CASE("write_parallel") {
+  // the parallel writer gives the same output as the sequential one
+  using namespace adm;
+  auto document = createSimpleScene()->deepCopy();
+  for (int c = 0; c < 50; c++) {
+    auto channel = AudioChannelFormat::create(
+        AudioChannelFormatName("c" + std::to_string(c)),
+        c % 2 ? TypeDefinition::OBJECTS : TypeDefinition::DIRECT_SPEAKERS);
+    document->add(channel);
+    for (int i = 0; i < c; i++) {
+      if (c % 2) {
+        channel->add(AudioBlockFormatObjects(
+            SphericalPosition(Azimuth(static_cast<float>(i))),
+            Rtime(std::chrono::milliseconds(10 * i))));
+      } else {
+        channel->add(AudioBlockFormatDirectSpeakers(
+            SphericalSpeakerPosition(Azimuth(static_cast<float>(i))),
+            Rtime(std::chrono::milliseconds(10 * i))));
+      }
+    }
+  }
+
+  for (auto options :
+       {xml::WriterOptions::none, xml::WriterOptions::itu_structure,
+        xml::WriterOptions::write_default_values}) {
+    std::stringstream expected;
+    writeXml(expected, document, options);
+    std::stringstream xml;
+    writeXml(xml, document, options | xml::WriterOptions::parallel);
+    REQUIRE(xml.str() == expected.str());
+  }
+
+  FrameFormat format{FrameFormatId{FrameIndex{1}},
+                     Start{std::chrono::seconds(0)},
+                     Duration{std::chrono::seconds(1)}, FrameType::FULL,
+                     TimeReference::LOCAL};
+  for (auto options : {xml::SadmWriterOptions::none,
+                       xml::SadmWriterOptions::core_metadata}) {
+    std::stringstream expected;
+    writeXml(expected, document, FrameHeader{format}, options);
+    std::stringstream xml;
+    writeXml(xml, document, FrameHeader{format},
+             options | xml::SadmWriterOptions::parallel);
+    REQUIRE(xml.str() == expected.str());
+  }
+}
+
+/// the writer should not need memory proportional to the size of the
+/// output, in addition to the document itself
+TEST_CASE("write_bounded_memory") {
+  using namespace adm;
+  // many small channels, so that building the document doesn't leave a
+  // high peak from reallocating one large vector of blocks
+  auto document = Document::create();
+  for (int c = 0; c < 2000; c++) {
+    auto channel = AudioChannelFormat::create(AudioChannelFormatName("c"),
+                                              TypeDefinition::OBJECTS);
+    document->add(channel);
+    for (int i = 0; i < 50; i++) {
+      channel->add(AudioBlockFormatObjects(
+          SphericalPosition(Azimuth(30), Elevation(10), Distance(0.5)),
+          Rtime(std::chrono::milliseconds(10 * i)),
+          Duration(std::chrono::milliseconds(10)), Gain::fromLinear(0.5)));
+    }
+  }
+
+  // write a small document first so that anything allocated once is
+  // already counted
+  CountingBuf buf;
+  std::ostream stream(&buf);
+  writeXml(stream, createSimpleScene());
+#ifdef ADM_TEST_HAVE_GETRUSAGE
+  auto rssBefore = peakRss();
+#endif
+
+  buf.count = 0;
+  writeXml(stream, document);
+  auto size = buf.count;
+  REQUIRE(size > 100000 * 200);
+#ifdef ADM_TEST_HAVE_GETRUSAGE
+  auto growth = peakRss() - rssBefore;
+  INFO("output size " << size << " bytes, peak RSS grew by " << growth);
+  REQUIRE(growth < size / 8);
+#endif
+}
+
 std::shared_ptr<const adm::Document> createSimpleScene() {
   using namespace adm;
   auto document = Document::create();